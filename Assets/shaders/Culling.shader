@@ -0,0 +1 @@
+#Compute shaders/spv/Culling.comp.spv
\ No newline at end of file
@@ -0,0 +1,2 @@
+#Vertex shaders/spv/DeferredColorBindless.vert.spv
+#Fragment shaders/spv/DeferredColorBindless.frag.spv
\ No newline at end of file
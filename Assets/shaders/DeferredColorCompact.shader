@@ -0,0 +1,2 @@
+#Vertex shaders/spv/DeferredColorCompact.vert.spv
+#Fragment shaders/spv/DeferredColor.frag.spv
\ No newline at end of file
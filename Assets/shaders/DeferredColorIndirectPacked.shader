@@ -0,0 +1,2 @@
+#Vertex shaders/spv/DeferredColorIndirect.vert.spv
+#Fragment shaders/spv/DeferredColorBindlessPacked.frag.spv
\ No newline at end of file
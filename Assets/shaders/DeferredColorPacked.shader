@@ -0,0 +1,2 @@
+#Vertex shaders/spv/DeferredColor.vert.spv
+#Fragment shaders/spv/DeferredColorPacked.frag.spv
\ No newline at end of file
@@ -0,0 +1,2 @@
+#Vertex shaders/spv/DeferredLight.vert.spv
+#Fragment shaders/spv/DeferredLightPacked.frag.spv
\ No newline at end of file
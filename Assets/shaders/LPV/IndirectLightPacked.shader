@@ -0,0 +1 @@
+#Compute shaders/spv/LPV/IndirectLightPacked.comp.spv
\ No newline at end of file
@@ -0,0 +1,2 @@
+#Vertex shaders/spv/LPV/ReflectiveShadowMapCompact.vert.spv
+#Fragment shaders/spv/LPV/ReflectiveShadowMap.frag.spv
\ No newline at end of file
@@ -0,0 +1,2 @@
+#Vertex shaders/spv/ScreenQuad.vert.spv
+#Fragment shaders/spv/PostProcess/SSAOPacked.frag.spv
\ No newline at end of file
@@ -0,0 +1,2 @@
+#Vertex shaders/spv/ShadowIndirect.vert.spv
+#Fragment shaders/spv/Shadow.frag.spv
\ No newline at end of file
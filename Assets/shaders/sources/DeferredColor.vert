@@ -9,9 +9,18 @@ layout(set = 0,binding = 0) uniform UniformBufferObject
 	mat4 projViewOld;
 } ubo;
 
+#define MAX_INSTANCES 256
+
+//transforms of the instanced draws of the frame, a draw reads instanceOffset + gl_InstanceIndex
+layout(set = 0,binding = 1) uniform UniformBufferInstance
+{
+	mat4 transforms[MAX_INSTANCES];
+} instances;
+
 layout(push_constant) uniform PushConsts
 {
 	mat4 transform;
+	int instanceOffset;
 } pushConsts;
 
 layout(location = 0) in vec3 inPosition;
@@ -39,17 +48,18 @@ out gl_PerVertex
 
 void main() 
 {
-	fragPosition = pushConsts.transform * vec4(inPosition, 1.0);
+	mat4 transform = pushConsts.instanceOffset < 0 ? pushConsts.transform : instances.transforms[pushConsts.instanceOffset + gl_InstanceIndex];
+	fragPosition = transform * vec4(inPosition, 1.0);
     vec4 pos =  ubo.projView * fragPosition;
     gl_Position = pos;
     
     fragColor = inColor;
 	fragTexCoord = inTexCoord;
-    fragNormal =  transpose(inverse(mat3(pushConsts.transform))) * normalize(inNormal);
+    fragNormal =  transpose(inverse(mat3(transform))) * normalize(inNormal);
     
     fragTangent = inTangent;
 
     fragProjPosition = pos;
-    fragOldProjPosition = ubo.projViewOld * pushConsts.transform * vec4(inPosition, 1.0);;
+    fragOldProjPosition = ubo.projViewOld * transform * vec4(inPosition, 1.0);;
     fragViewPosition = ubo.view * fragPosition;
 }
\ No newline at end of file
@@ -0,0 +1,80 @@
+#version 450
+#extension GL_ARB_separate_shader_objects : enable
+#extension GL_ARB_shading_language_420pack : enable
+
+#include "VertexCompact.glsl"
+
+layout(set = 0,binding = 0) uniform UniformBufferObject 
+{    
+	mat4 projView;
+    mat4 view;
+	mat4 projViewOld;
+} ubo;
+
+const int MAX_BONES = 100;
+
+layout(set = 0,binding = 1) uniform UniformBufferObjectAnim
+{    
+	mat4 boneTransforms[MAX_BONES];
+} boneUbo;
+
+
+layout(push_constant) uniform PushConsts
+{
+	mat4 transform;
+	vec4 positionScale;
+	vec4 positionOffset;
+} pushConsts;
+
+layout(location = 0) in uvec2 inPosition;
+layout(location = 1) in uint inNormal;
+layout(location = 2) in uint inTangent;
+layout(location = 3) in uint inTexCoord;
+layout(location = 4) in uint inBoneIndices;
+layout(location = 5) in uint inBoneWeights;
+
+
+layout(location = 0) out vec4 fragColor;
+layout(location = 1) out vec2 fragTexCoord;
+layout(location = 2) out vec4 fragPosition;
+layout(location = 3) out vec3 fragNormal;
+layout(location = 4) out vec3 fragTangent;
+layout(location = 5) out vec4 fragProjPosition;
+layout(location = 6) out vec4 fragOldProjPosition;
+layout(location = 7) out vec4 fragViewPosition;
+
+
+
+out gl_PerVertex
+{
+    vec4 gl_Position;
+};
+
+mat4 getSkinMat()
+{
+	uvec4 indices = decodeBoneIndices(inBoneIndices);
+	vec4 weights = decodeBoneWeights(inBoneWeights);
+    mat4 boneTransform = boneUbo.boneTransforms[indices[0]] * weights[0];
+    boneTransform += boneUbo.boneTransforms[indices[1]] * weights[1];
+    boneTransform += boneUbo.boneTransforms[indices[2]] * weights[2];
+    boneTransform += boneUbo.boneTransforms[indices[3]] * weights[3];
+    return boneTransform;
+}
+
+void main() 
+{
+	vec3 position = decodePosition(inPosition, pushConsts.positionScale, pushConsts.positionOffset);
+	fragPosition = pushConsts.transform * (getSkinMat() * vec4(position, 1.0));
+    vec4 pos =  ubo.projView * fragPosition;
+    gl_Position = pos;
+    
+    fragColor = vec4(1.0);
+	fragTexCoord = decodeTexCoord(inTexCoord);
+    fragNormal =  transpose(inverse(mat3(pushConsts.transform))) * decodeOct(inNormal);
+    
+    fragTangent = decodeOct(inTangent);
+
+    fragProjPosition = pos;
+    fragOldProjPosition = ubo.projViewOld * pushConsts.transform * vec4(position, 1.0);
+    fragViewPosition = ubo.view * fragPosition;
+}
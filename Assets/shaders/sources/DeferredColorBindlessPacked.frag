@@ -0,0 +1,146 @@
+#version 450
+#extension GL_ARB_separate_shader_objects : enable
+#extension GL_ARB_shading_language_420pack : enable
+#extension GL_EXT_nonuniform_qualifier : enable
+
+#include "GBufferPacked.glsl"
+#include "MaterialBindless.glsl"
+
+#define PI 3.1415926535897932384626433832795
+#define GAMMA 2.2
+const float PBR_WORKFLOW_SEPARATE_TEXTURES = 0.0f;
+const float PBR_WORKFLOW_METALLIC_ROUGHNESS = 1.0f;
+const float PBR_WORKFLOW_SPECULAR_GLOSINESS = 2.0f;
+
+layout(location = 0) in vec4 fragColor;
+layout(location = 1) in vec2 fragTexCoord;
+layout(location = 2) in vec4 fragPosition;
+layout(location = 3) in vec3 fragNormal;
+layout(location = 4) in vec3 fragTangent;
+layout(location = 5) in vec4 fragProjPosition;
+layout(location = 6) in vec4 fragOldProjPosition;
+layout(location = 7) in vec4 fragViewPosition;
+
+layout(location = 8) flat in uint fragMaterial;
+
+layout(set = 2,binding = 0) uniform UBO
+{
+	mat4 view;
+	float nearPlane;
+	float farPlane;
+	float padding;
+	float padding2;
+}ubo;
+
+//bind to framebuffer, positions are rebuilt from the depth buffer
+layout(location = 0) out vec4 outColor;
+layout(location = 1) out vec2 outNormal;
+layout(location = 2) out vec4 outPBR;
+layout(location = 3) out vec2 outVelocity;
+
+
+vec4 gammaCorrectTexture(vec4 samp)
+{
+	return vec4(pow(samp.rgb, vec3(GAMMA)), samp.a);
+}
+
+vec3 gammaCorrectTextureRGB(vec4 samp)
+{
+	return vec3(pow(samp.rgb, vec3(GAMMA)));
+}
+
+
+vec4 getAlbedo(MaterialData material)
+{
+	return (1.0 - material.usingAlbedoMap) * material.albedoColor + material.usingAlbedoMap * sampleMaterialMap(material.albedoMap, fragTexCoord);
+}
+
+vec3 getMetallic(MaterialData material)
+{
+	return (1.0 - material.usingMetallicMap) * material.metallicColor.rgb + material.usingMetallicMap * sampleMaterialMap(material.metallicMap, fragTexCoord).rgb;
+}
+
+float getRoughness(MaterialData material)
+{
+	return (1.0 - material.usingRoughnessMap) *  material.roughnessColor.r + material.usingRoughnessMap * sampleMaterialMap(material.roughnessMap, fragTexCoord).r;
+}
+
+float getAO(MaterialData material)
+{
+	return (1.0 - material.usingAOMap) + material.usingAOMap * gammaCorrectTextureRGB(sampleMaterialMap(material.aoMap, fragTexCoord)).r;
+}
+
+vec3 getEmissive(MaterialData material)
+{
+	return (1.0 - material.usingEmissiveMap) * material.emissiveColor.rgb + material.usingEmissiveMap * gammaCorrectTextureRGB(sampleMaterialMap(material.emissiveMap, fragTexCoord));
+}
+
+vec3 getNormalFromMap(MaterialData material)
+{
+	if (material.usingNormalMap < 0.1)
+		return normalize(fragNormal);
+	
+	vec3 tangentNormal = sampleMaterialMap(material.normalMap, fragTexCoord).xyz * 2.0 - 1.0;
+	
+	vec3 Q1 = dFdx(fragPosition.xyz);
+	vec3 Q2 = dFdy(fragPosition.xyz);
+	vec2 st1 = dFdx(fragTexCoord);
+	vec2 st2 = dFdy(fragTexCoord);
+	
+	vec3 N = normalize(fragNormal);
+	vec3 T = normalize(Q1*st2.t - Q2*st1.t);
+	vec3 B = -normalize(cross(N, T));
+	mat3 TBN = mat3(T, B, N);
+	
+	return normalize(TBN * tangentNormal);
+}
+
+
+float linearDepth(float depth)
+{
+	float z = depth * 2.0f - 1.0f; 
+	return (2.0f * ubo.nearPlane * ubo.farPlane) / (ubo.farPlane + ubo.nearPlane - z * (ubo.farPlane - ubo.nearPlane));	
+}
+
+
+void main()
+{
+	MaterialData material = materials[fragMaterial];
+	vec4 texColor = getAlbedo(material) * fragColor;
+	if(texColor.w < 0.01)
+		discard;
+
+	float metallic = 0.0;
+	float roughness = 0.0;
+	float ao		= getAO(material);
+
+	if(material.workflow == PBR_WORKFLOW_SEPARATE_TEXTURES)
+	{
+		metallic  = getMetallic(material).x;
+		roughness = getRoughness(material);
+	}
+	else if( material.workflow == PBR_WORKFLOW_METALLIC_ROUGHNESS)
+	{
+		vec3 tex = sampleMaterialMap(material.metallicMap, fragTexCoord).rgb;
+		//ao  	  = tex.r;
+		metallic  = tex.b;
+ 		roughness = tex.g;
+	}
+	else if( material.workflow == PBR_WORKFLOW_SPECULAR_GLOSINESS)
+	{
+		vec3 tex = sampleMaterialMap(material.metallicMap, fragTexCoord).rgb;
+		metallic = tex.b;
+		roughness = tex.g * material.roughnessColor.r;
+	}
+
+	vec3 emissive   = getEmissive(material);
+
+ 
+    outColor    	= gammaCorrectTexture(texColor);
+	outNormal   	= encodeNormal(getNormalFromMap(material));
+	outPBR      	= vec4(metallic, roughness, ao, encodeEmissive(emissive));
+
+    vec2 a = (fragProjPosition.xy / fragProjPosition.w) * 0.5 + 0.5;
+    vec2 b = (fragOldProjPosition.xy / fragOldProjPosition.w) * 0.5 + 0.5;
+    outVelocity = a - b;
+}
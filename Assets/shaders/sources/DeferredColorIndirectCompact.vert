@@ -0,0 +1,63 @@
+#version 450
+#extension GL_ARB_separate_shader_objects : enable
+#extension GL_ARB_shading_language_420pack : enable
+
+#include "VertexCompact.glsl"
+#include "GPUCulling.glsl"
+
+layout(set = 0,binding = 0) uniform UniformBufferObject 
+{    
+	mat4 projView;
+    mat4 view;
+	mat4 projViewOld;
+} ubo;
+
+//the culling pass writes the instance into firstInstance, every command draws one.
+layout(std430, set = 0, binding = 1) readonly buffer InstanceBuffer
+{
+	InstanceData instances[];
+};
+
+layout(location = 0) in uvec2 inPosition;
+layout(location = 1) in uint inNormal;
+layout(location = 2) in uint inTangent;
+layout(location = 3) in uint inTexCoord;
+
+
+layout(location = 0) out vec4 fragColor;
+layout(location = 1) out vec2 fragTexCoord;
+layout(location = 2) out vec4 fragPosition;
+layout(location = 3) out vec3 fragNormal;
+layout(location = 4) out vec3 fragTangent;
+layout(location = 5) out vec4 fragProjPosition;
+layout(location = 6) out vec4 fragOldProjPosition;
+layout(location = 7) out vec4 fragViewPosition;
+layout(location = 8) flat out uint fragMaterial;
+
+
+
+out gl_PerVertex
+{
+    vec4 gl_Position;
+};
+
+void main() 
+{
+	InstanceData instance = instances[gl_InstanceIndex];
+	mat4 transform = instance.transform;
+	fragMaterial = instance.lod.w;
+	vec3 position = decodePosition(inPosition, instance.positionScale, instance.positionOffset);
+	fragPosition = transform * vec4(position, 1.0);
+    vec4 pos =  ubo.projView * fragPosition;
+    gl_Position = pos;
+    
+    fragColor = vec4(1.0);
+	fragTexCoord = decodeTexCoord(inTexCoord);
+    fragNormal =  transpose(inverse(mat3(transform))) * decodeOct(inNormal);
+    
+    fragTangent = decodeOct(inTangent);
+
+    fragProjPosition = pos;
+    fragOldProjPosition = ubo.projViewOld * transform * vec4(position, 1.0);
+    fragViewPosition = ubo.view * fragPosition;
+}
@@ -0,0 +1,48 @@
+//encoding of the compact G-buffer layout (maple::GBuffer::isCompact)
+//NORMALS : octahedral world normal in RG16, PBR : metallic, roughness, ao, emissive intensity in RGBA8
+
+//octahedral encoding remapped to unorm
+vec2 encodeNormal(vec3 n)
+{
+	n /= abs(n.x) + abs(n.y) + abs(n.z);
+	vec2 e = n.xy;
+	if (n.z < 0.0)
+	{
+		//the lower hemisphere is folded over the diagonals.
+		e = (1.0 - abs(n.yx)) * vec2(n.x >= 0.0 ? 1.0 : -1.0, n.y >= 0.0 ? 1.0 : -1.0);
+	}
+	return e * 0.5 + 0.5;
+}
+
+vec3 decodeNormal(vec2 packed)
+{
+	vec2 e = packed * 2.0 - 1.0;
+	vec3 n = vec3(e.xy, 1.0 - abs(e.x) - abs(e.y));
+	float t = max(-n.z, 0.0);
+	n.x += n.x >= 0.0 ? -t : t;
+	n.y += n.y >= 0.0 ? -t : t;
+	return normalize(n);
+}
+
+//only the intensity is stored as k / (1 + k), the color is taken from the albedo (white for black albedo).
+float encodeEmissive(vec3 emissive)
+{
+	float k = max(emissive.r, max(emissive.g, emissive.b));
+	return k / (1.0 + k);
+}
+
+vec3 decodeEmissive(float packed, vec3 albedo)
+{
+	float p = min(packed, 254.0 / 255.0);
+	float k = p / (1.0 - p);
+	float m = max(albedo.r, max(albedo.g, albedo.b));
+	vec3 tint = m > 0.01 ? albedo / m : vec3(1.0);
+	return tint * k * step(0.5 / 255.0, packed);
+}
+
+//reconstruction is GBuffer::getReconstruction(projView), the result is in the space projView maps from.
+vec3 reconstructPosition(mat4 reconstruction, vec2 uv, float depth)
+{
+	vec4 position = reconstruction * vec4(uv, depth, 1.0);
+	return position.xyz / position.w;
+}
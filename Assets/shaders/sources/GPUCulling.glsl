@@ -0,0 +1,12 @@
+//instances of the GPU driven passes (maple::gpu_culling::InstanceData), shared by the culling shader and the indirect vertex stages.
+
+struct InstanceData
+{
+	mat4  transform;
+	vec4  positionScale;        //compact layout only
+	vec4  positionOffset;
+	vec4  boundsMin;            //world space, w : largest scale of the transform
+	vec4  boundsMax;            //w : radius of the bounds in world space
+	uvec4 lod;                  //x : first entry in LodBuffer, y : lod count, z : first vertex in the geometry pool, w : material slot
+	uvec4 flags;                //x : vertex format, y : casts shadows
+};
@@ -0,0 +1,41 @@
+#version 450
+#extension GL_ARB_separate_shader_objects : enable
+#extension GL_ARB_shading_language_420pack : enable
+
+#include "../VertexCompact.glsl"
+
+layout(location = 0) in uvec2 inPosition;
+layout(location = 1) in uint inNormal;
+layout(location = 2) in uint inTangent;
+layout(location = 3) in uint inTexCoord;
+
+layout(set = 0,binding = 0) uniform UniformBufferObject 
+{    
+    mat4 lightProjection;
+    mat4 viewMatrix;
+} ubo;
+
+layout(push_constant) uniform PushConsts
+{
+	mat4 transform;
+	vec4 positionScale;
+	vec4 positionOffset;
+} pushConsts;
+
+layout(location = 0) out vec4 fragPosition;
+layout(location = 1) out vec2 fragTexCoord;
+layout(location = 2) out vec3 fragNormal;
+layout(location = 3) out vec4 fragColor;
+
+void main()
+{
+    vec4 worldPosition =  pushConsts.transform * vec4(decodePosition(inPosition, pushConsts.positionScale, pushConsts.positionOffset), 1.0);
+    fragPosition = worldPosition;
+    
+    fragColor = vec4(1.0);
+	fragTexCoord = decodeTexCoord(inTexCoord);
+
+    fragNormal =  normalize(transpose(inverse(mat3(  pushConsts.transform ) ) ) * decodeOct(inNormal));
+
+	gl_Position = ubo.lightProjection * worldPosition;
+}
@@ -0,0 +1,39 @@
+//bindless materials (maple::MaterialTable), every texture of the scene in one array and every material in one buffer
+//needs GL_EXT_nonuniform_qualifier, instanced draws mix materials.
+
+struct MaterialData
+{
+	vec4  albedoColor;
+	vec4  roughnessColor;
+	vec4  metallicColor;
+	vec4  emissiveColor;
+	float usingAlbedoMap;
+	float usingMetallicMap;
+	float usingRoughnessMap;
+	float usingNormalMap;
+	float usingAOMap;
+	float usingEmissiveMap;
+	float workflow;
+	float padding;
+	//slots in uTextures, maps a material does not have point to the default textures
+	int   albedoMap;
+	int   metallicMap;
+	int   roughnessMap;
+	int   normalMap;
+	int   aoMap;
+	int   emissiveMap;
+	int   padding0;
+	int   padding1;
+};
+
+layout(set = 1, binding = 0) uniform sampler2D uTextures[];
+
+layout(std430, set = 1, binding = 1) readonly buffer MaterialBuffer
+{
+	MaterialData materials[];
+};
+
+vec4 sampleMaterialMap(int slot, vec2 uv)
+{
+	return texture(uTextures[nonuniformEXT(slot)], uv);
+}
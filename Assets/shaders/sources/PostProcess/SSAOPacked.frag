@@ -0,0 +1,74 @@
+#version 450
+
+#include "../GBufferPacked.glsl"
+
+const int SSAO_KERNEL_SIZE = 64;
+
+layout (set = 0,binding = 0) uniform sampler2D uDepthSampler;
+layout (set = 0,binding = 1) uniform sampler2D uNormalSampler;
+layout (set = 0,binding = 2) uniform sampler2D uSsaoNoise;
+layout (set = 0,binding = 4) uniform UBOSSAOKernel
+{
+	vec4 samples[SSAO_KERNEL_SIZE];
+} uboSSAOKernel;
+
+layout (set = 0,binding = 5) uniform UBO 
+{
+	mat4 projection;
+	float ssaoRadius;
+	mat4 view;
+	mat4 reconstruction;
+} ubo;
+
+vec3 viewPosition(vec2 uv)
+{
+	return reconstructPosition(ubo.reconstruction, uv, textureLod(uDepthSampler, uv, 0).r);
+}
+
+layout (location = 0) in vec2 inUV;
+
+layout (location = 0) out float outColor;
+
+void main() 
+{
+	ivec2 noiseDim = textureSize(uSsaoNoise, 0);
+	ivec2 texDim = textureSize(uDepthSampler, 0); 
+
+	vec3 fragPos = viewPosition(inUV);
+	vec3 normal = normalize(mat3(ubo.view) * decodeNormal(texture(uNormalSampler, inUV).xy));
+	
+	// Get a random vector using a noise lookup
+
+	const vec2 noiseScale = vec2(float(texDim.x)/float(noiseDim.x), float(texDim.y)/(noiseDim.y));  
+	
+	// Create TBN matrix
+ 	vec3 randomVec = normalize(texture(uSsaoNoise, inUV * noiseScale).xyz);
+    	vec3 tangent = normalize(randomVec - normal * dot(randomVec, normal));
+    	vec3 bitangent = cross(normal, tangent);
+    	mat3 TBN = mat3(tangent, bitangent, normal);
+
+	// Calculate occlusion value
+	float occlusion = 0.0f;
+	// remove banding
+	const float bias = 0.025;
+	for(int i = 0; i < SSAO_KERNEL_SIZE; i++)
+	{		
+		vec3 samplePos = TBN * uboSSAOKernel.samples[i].xyz; 
+		samplePos = fragPos + samplePos * ubo.ssaoRadius; 
+		
+		// project
+		vec4 offset = vec4(samplePos, 1.0f);
+		offset = ubo.projection * offset; 
+		offset.xyz /= offset.w; 
+		offset.xyz = offset.xyz * 0.5f + 0.5f; 
+		
+		float sampleDepth = viewPosition(offset.xy).z;
+
+		float rangeCheck = smoothstep(0.0f, 1.0f, ubo.ssaoRadius / abs(fragPos.z - sampleDepth));
+		occlusion += (sampleDepth >= (samplePos.z + bias) ? 1.0f : 0.0f) * rangeCheck;           
+	}
+
+	occlusion = 1.0 - (occlusion / float(SSAO_KERNEL_SIZE));
+
+	outColor =  occlusion;
+}
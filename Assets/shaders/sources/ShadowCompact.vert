@@ -0,0 +1,35 @@
+#version 450
+#extension GL_ARB_separate_shader_objects : enable
+#extension GL_ARB_shading_language_420pack : enable
+
+#include "VertexCompact.glsl"
+
+layout(push_constant) uniform PushConsts
+{
+	mat4 transform;
+	uint cascadeIndex;
+	vec4 positionScale;
+	vec4 positionOffset;
+} pushConsts;
+
+layout(set = 0,binding = 0) uniform UniformBufferObject
+{
+    mat4 projView[4];
+} ubo;
+
+out gl_PerVertex
+{
+    vec4 gl_Position;
+};
+
+//the other attributes are declared so the reflected stride matches the vertex buffer
+layout(location = 0) in uvec2 inPosition;
+layout(location = 1) in uint inNormal;
+layout(location = 2) in uint inTangent;
+layout(location = 3) in uint inTexCoord;
+
+void main()
+{
+    vec3 position = decodePosition(inPosition, pushConsts.positionScale, pushConsts.positionOffset);
+    gl_Position = ubo.projView[pushConsts.cascadeIndex] * pushConsts.transform *  vec4(position, 1.0); 
+}
@@ -0,0 +1,40 @@
+#version 450
+#extension GL_ARB_separate_shader_objects : enable
+#extension GL_ARB_shading_language_420pack : enable
+
+#include "VertexCompact.glsl"
+#include "GPUCulling.glsl"
+
+layout(push_constant) uniform PushConsts
+{
+	uint cascadeIndex;
+} pushConsts;
+
+layout(set = 0,binding = 0) uniform UniformBufferObject
+{
+    mat4 projView[4];
+} ubo;
+
+//the culling pass writes the instance into firstInstance, every command draws one.
+layout(std430, set = 0, binding = 1) readonly buffer InstanceBuffer
+{
+	InstanceData instances[];
+};
+
+out gl_PerVertex
+{
+    vec4 gl_Position;
+};
+
+//the other attributes are declared so the reflected stride matches the vertex buffer
+layout(location = 0) in uvec2 inPosition;
+layout(location = 1) in uint inNormal;
+layout(location = 2) in uint inTangent;
+layout(location = 3) in uint inTexCoord;
+
+void main()
+{
+    InstanceData instance = instances[gl_InstanceIndex];
+    vec3 position = decodePosition(inPosition, instance.positionScale, instance.positionOffset);
+    gl_Position = ubo.projView[pushConsts.cascadeIndex] * instance.transform * vec4(position, 1.0); 
+}
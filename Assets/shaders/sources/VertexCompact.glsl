@@ -0,0 +1,34 @@
+//unpacking of the compact vertex layouts (maple::CompactVertex / maple::CompactSkinnedVertex)
+
+//positions are unorm16 inside the mesh bounds
+vec3 decodePosition(uvec2 packed, vec4 scale, vec4 offset)
+{
+	vec3 position = vec3(unpackUnorm2x16(packed.x), unpackUnorm2x16(packed.y).x);
+	return offset.xyz + position * scale.xyz;
+}
+
+//octahedral encoding, snorm16x2
+vec3 decodeOct(uint packed)
+{
+	vec2 e = unpackSnorm2x16(packed);
+	vec3 n = vec3(e.xy, 1.0 - abs(e.x) - abs(e.y));
+	float t = max(-n.z, 0.0);
+	n.x += n.x >= 0.0 ? -t : t;
+	n.y += n.y >= 0.0 ? -t : t;
+	return normalize(n);
+}
+
+vec2 decodeTexCoord(uint packed)
+{
+	return unpackHalf2x16(packed);
+}
+
+uvec4 decodeBoneIndices(uint packed)
+{
+	return uvec4(packed & 0xffu, (packed >> 8) & 0xffu, (packed >> 16) & 0xffu, packed >> 24);
+}
+
+vec4 decodeBoneWeights(uint packed)
+{
+	return unpackUnorm4x8(packed);
+}
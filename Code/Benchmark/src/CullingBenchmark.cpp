@@ -0,0 +1,73 @@
+//////////////////////////////////////////////////////////////////////////////
+// This file is part of the Maple Engine                              		//
+//////////////////////////////////////////////////////////////////////////////
+#include "Math/BoundingBoxSoA.h"
+#include "Math/Frustum.h"
+
+#include <cstdio>
+#include <cstdlib>
+#include <numeric>
+#include <random>
+#include <vector>
+#include <glm/gtc/matrix_transform.hpp>
+
+using namespace maple;
+
+namespace
+{
+	//culls the boxes in ranges with unaligned begins and ends and refines a list of every index,
+	//both have to match one batch over every box.
+	auto checkRanges(uint32_t count) -> bool
+	{
+		std::mt19937                          random(4321);
+		std::uniform_real_distribution<float> position(-100.f, 100.f);
+
+		BoundingBoxSoA soa;
+		soa.resize(count);
+		for (uint32_t i = 0; i < count; i++)
+		{
+			const glm::vec3 center{position(random), position(random), position(random)};
+			soa.set(i, BoundingBox{center - 1.f, center + 1.f});
+		}
+
+		Frustum frustum;
+		frustum.from(glm::perspective(glm::radians(60.f), 16.f / 9.f, 0.1f, 150.f) * glm::lookAt(glm::vec3{0.f}, glm::vec3{1.f, 0.f, 1.f}, glm::vec3{0.f, 1.f, 0.f}));
+
+		std::vector<uint32_t> all;
+		soa.cull(frustum, all);
+
+		std::vector<uint32_t> ranges;
+		for (uint32_t begin = 0, step = 1; begin < count; begin += step, step = step % 13 + 2)
+		{
+			soa.cull(frustum, begin, begin + step, ranges);
+		}
+		std::vector<uint32_t> refined(count);
+		std::iota(refined.begin(), refined.end(), 0u);
+		soa.refine(frustum, refined);
+		return all == ranges && all == refined;
+	}
+}        // namespace
+
+//CullingBenchmark [count] [iterations]
+//the boxes and the frustum come from a fixed seed, so runs are comparable between builds.
+int main(int argc, char **argv)
+{
+	const uint32_t count      = argc > 1 ? static_cast<uint32_t>(std::strtoul(argv[1], nullptr, 10)) : 100000;
+	const uint32_t iterations = argc > 2 ? static_cast<uint32_t>(std::strtoul(argv[2], nullptr, 10)) : 50;
+
+	for (uint32_t size : {0u, 1u, 3u, 7u, 8u, 9u, 31u, 1000u})
+	{
+		if (!checkRanges(size))
+		{
+			std::printf("range culling or refining of %u boxes does not match the full batch\n", size);
+			return 1;
+		}
+	}
+
+	const auto result = BoundingBoxSoA::benchmark(count, iterations);
+	std::printf("culling %u boxes, %u iterations\n", count, iterations);
+	std::printf("  Frustum::isInside : %.3f ms (%u visible)\n", result.scalarMs, result.scalarVisible);
+	std::printf("  batched           : %.3f ms (%u visible)\n", result.simdMs, result.simdVisible);
+	std::printf("  batch refresh     : %.3f ms\n", result.updateMs);
+	return 0;
+}
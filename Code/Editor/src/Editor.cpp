@@ -29,6 +29,7 @@
 
 #include "IconsMaterialDesignIcons.h"
 #include "ImGui/ImGuiHelpers.h"
+#include "Scene/Component/BoundingBox.h"
 #include "Scene/Component/Component.h"
 #include "Scene/Component/Light.h"
 #include "Scene/Component/Sprite.h"
@@ -621,23 +622,8 @@ namespace maple
 				case maple::FileType::OBJ: {
 					if (meshRoot)
 					{
-						auto  name        = StringUtils::getFileNameWithoutExtension(filePath);
-						auto  modelEntity = scene->createEntity(name);
-						auto &model       = modelEntity.addComponent<component::Model>(filePath);
-						if (model.resource->getMeshes().size() == 1)
-						{
-							modelEntity.addComponent<component::MeshRenderer>(model.resource->getMeshes().begin()->second);
-						}
-						else
-						{
-							for (auto &mesh : model.resource->getMeshes())
-							{
-								auto child = scene->createEntity(mesh.first);
-								child.addComponent<component::MeshRenderer>(mesh.second);
-								child.setParent(modelEntity);
-							}
-						}
-						model.type = component::PrimitiveType::File;
+						//the meshes show up once the file has been loaded in the background.
+						auto modelEntity = scene->addMesh(filePath, false);
 						modelEntity.setParent(meshRoot);
 					}
 				}
@@ -762,58 +748,23 @@ namespace maple
 
 	auto Editor::clickObject(const Ray& ray) -> void
 	{
-		auto& registry = getSceneManager()->getCurrentScene()->getRegistry();
+		auto scene = getSceneManager()->getCurrentScene();
+		auto& registry = scene->getRegistry();
+		auto& culling = scene->getGlobalComponent<component::CullingData>();
 
-		float        closestDist = INFINITY;
 		entt::entity closestEntity = entt::null;
 		auto frustum = camera->getFrustum(editorCameraTransform.getWorldMatrixInverse());
-		auto calculateClosest = [&](Mesh* mesh, component::Transform& trans, entt::entity entity)
-		{
-			if (mesh != nullptr)
-			{
-				auto& worldTransform = trans.getWorldMatrix();
-
-				if (mesh->getBoundingBox() != nullptr)
-				{
-					auto  bbCopy = mesh->getBoundingBox()->transform(worldTransform);
-
-					if (frustum.isInside(bbCopy)) 
-					{
-						float dist = ray.hit(bbCopy);
-						if (dist < INFINITY && dist < closestDist)
-						{
-							closestDist = dist;
-							closestEntity = entity;
-						}
-					}
-				}
-			}
-		};
-
-		using Query = ecs::Chain
-			::Write<component::MeshRenderer>
-			::Write<component::Transform>
-			::To<ecs::Query>;
-
-		Query meshQuery(registry, entt::null);
-
-		for (auto entity : meshQuery)
-		{
-			auto [mesh, trans] = meshQuery.convert(entity);
-			calculateClosest(mesh.getMesh().get(), trans, entity);
-		}
-
-		using SkinnedQuery = ecs::Chain
-			::Write<component::SkinnedMeshRenderer>
-			::Write<component::Transform>
-			::To<ecs::Query>;
 
-		SkinnedQuery skinedQuery(registry, entt::null);
+		//only the scene bvh nodes along the ray are visited, leaves are tested against their tight world box.
+		uint32_t closestIndex = 0;
+		float closestDist = culling.tree.raycast(ray, [&](uint32_t index) {
+			auto box = culling.worldBounds.get(index);
+			return frustum.isInside(box) ? ray.hit(box) : INFINITY;
+		}, closestIndex);
 
-		for (auto entity : skinedQuery)
+		if (closestDist < INFINITY && registry.valid(culling.entities[closestIndex]))
 		{
-			auto [mesh, trans] = skinedQuery.convert(entity);
-			calculateClosest(mesh.getMesh().get(), trans, entity);
+			closestEntity = culling.entities[closestIndex];
 		}
 
 		if (closestEntity == entt::null)
@@ -6,6 +6,7 @@
 #include "Engine/Vientiane/ReflectiveShadowMap.h"
 #include "Engine/Vientiane/LightPropagationVolume.h"
 #include "Engine/Renderer/FinalPass.h"
+#include "Engine/Renderer/GPUCulling.h"
 #include "Engine/Renderer/PostProcessRenderer.h"
 #include "Scene/Component/BoundingBox.h"
 
@@ -38,6 +39,7 @@ namespace maple
 		TRIVIAL_COMPONENT(component::LPVGrid, false, "LPV Grid");
 		TRIVIAL_COMPONENT(component::ReflectiveShadowData, false, "Reflective Shadow Map");
 		TRIVIAL_COMPONENT(component::ShadowMapData, false, "Shadow Map");
+		TRIVIAL_COMPONENT(component::GPUCullingData, false, "GPU Culling");
 		TRIVIAL_COMPONENT(component::BoundingBoxComponent, false, "BoundingBox");
 		TRIVIAL_COMPONENT(component::SSAOData, false, "SSAO Data");
 		TRIVIAL_COMPONENT(component::DeltaTime, false, "Delta Time");
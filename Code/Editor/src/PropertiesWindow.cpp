@@ -26,6 +26,7 @@
 
 #include "Loaders/Loader.h"
 
+#include "Engine/Renderer/GPUCulling.h"
 #include "Engine/Renderer/GridRenderer.h"
 #include "Engine/Renderer/PostProcessRenderer.h"
 #include "Engine/Camera.h"
@@ -133,6 +134,31 @@ namespace MM
 		ImGui::Columns(2);
 		ImGui::Separator();
 		ImGuiHelper::property("Cascade Split Lambda", shadowMap.cascadeSplitLambda);
+		ImGuiHelper::property("Static Shadow Cache", shadowMap.staticCache);
+		ImGuiHelper::property("Cache Margin", shadowMap.cascadeCacheMargin, 0.f, 1.f, maple::ImGuiHelper::PropertyFlag::DragFloat);
+		ImGuiHelper::property("LOD Bias", shadowMap.lodBias, 0.f, 64.f, maple::ImGuiHelper::PropertyFlag::DragFloat);
+		for (uint32_t i = 0; i < shadowMap.shadowMapNum; i++)
+		{
+			ImGuiHelper::property("Cascade " + std::to_string(i) + " Interval", shadowMap.cascadeUpdateInterval[i], 1, 16);
+		}
+		ImGui::Columns(1);
+	}
+
+	template <>
+	inline auto ComponentEditorWidget<component::GPUCullingData>(entt::registry& reg, entt::registry::entity_type e) -> void
+	{
+		auto& culling = reg.get<component::GPUCullingData>(e);
+		ImGui::Columns(2);
+		ImGui::Separator();
+		if (culling.cullingShader != nullptr)
+		{
+			ImGuiHelper::property("GPU Driven Culling", culling.enable);
+			ImGuiHelper::showProperty("Instances", std::to_string(culling.active ? culling.instances.size() : 0));
+		}
+		else
+		{
+			ImGuiHelper::showProperty("GPU Driven Culling", "Not Supported");
+		}
 		ImGui::Columns(1);
 	}
 
@@ -483,6 +509,11 @@ namespace MM
 	inline auto ComponentEditorWidget<component::SkinnedMeshRenderer>(entt::registry& reg, entt::registry::entity_type e) -> void
 	{
 		auto& mesh = reg.get<component::SkinnedMeshRenderer>(e);
+		if (mesh.getMesh() == nullptr)
+		{
+			ImGui::TextUnformatted("Loading...");
+			return;
+		}
 
 		auto& materials = mesh.getMesh()->getMaterial();
 
@@ -562,6 +593,11 @@ namespace MM
 	inline auto ComponentEditorWidget<component::MeshRenderer>(entt::registry &reg, entt::registry::entity_type e) -> void
 	{
 		auto &mesh = reg.get<component::MeshRenderer>(e);
+		if (mesh.getMesh() == nullptr)
+		{
+			ImGui::TextUnformatted("Loading...");
+			return;
+		}
 
 		auto & materials = mesh.getMesh()->getMaterial();
 	
@@ -147,8 +147,10 @@ namespace maple
 		auto& graph = editor.getCurrentScene()->getGlobalComponent<capture_graph::component::RenderGraph>();
 
 
-		if (graph.nodes.size() != idMap.size()) 
+		//the graph is only compiled again when the frame changes.
+		if (graph.version != version) 
 		{
+			version = graph.version;
 			links.clear();
 
 			for (auto& node : graph.nodes)
@@ -192,7 +194,8 @@ namespace maple
 		{
 			if (node.second.graphNode->nodeType == capture_graph::NodeType::RenderPass) 
 			{
-				if (ImGui::Selectable(node.first.c_str())) 
+				auto label = node.second.graphNode->culled ? node.first + " (culled)" : node.first;
+				if (ImGui::Selectable(label.c_str())) 
 				{
 					current = &node.second;
 				}
@@ -58,6 +58,7 @@ namespace maple
 
 		std::unordered_map<std::string, NodeInfo> idMap;
 		std::vector< Link > links;
+		uint32_t version = 0;
 		ed::EditorContext* context = nullptr;
 
 		NodeInfo* current = nullptr;
@@ -7,9 +7,68 @@
 #include "Math/MathUtils.h"
 
 #include <algorithm>
+#include <cmath>
+
+#if defined(__SSE__) || defined(_M_X64) || defined(_M_AMD64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 1)
+#	include <xmmintrin.h>
+#	define MAPLE_ANIMATION_SSE
+#endif
 
 namespace maple
 {
+	auto AnimationBakedTracks::evaluate(float time, float* out) const -> void
+	{
+		const float frame = std::clamp(time * sampleRate, 0.f, static_cast<float>(frameCount - 1));
+		const auto  index = std::min(static_cast<uint32_t>(frame), frameCount - 1);
+		const auto  next  = std::min(index + 1, frameCount - 1);
+		const float alpha = frame - static_cast<float>(index);
+
+		const float* s0 = &samples[index * channelCount];
+		const float* s1 = &samples[next * channelCount];
+
+		uint32_t i = 0;
+#ifdef MAPLE_ANIMATION_SSE
+		const auto a = _mm_set1_ps(alpha);
+		for (; i + 4 <= channelCount; i += 4)
+		{
+			const auto v0 = _mm_loadu_ps(s0 + i);
+			const auto v1 = _mm_loadu_ps(s1 + i);
+			_mm_storeu_ps(out + i, _mm_add_ps(v0, _mm_mul_ps(_mm_sub_ps(v1, v0), a)));
+		}
+#endif
+		for (; i < channelCount; i++)
+		{
+			out[i] = s0[i] + (s1[i] - s0[i]) * alpha;
+		}
+	}
+
+	auto AnimationClip::bake(float sampleRate) -> void
+	{
+		baked = {};
+		if (sampleRate <= 0 || length <= 0 || getPropertyCount() == 0)
+			return;
+
+		baked.sampleRate   = sampleRate;
+		baked.channelCount = getPropertyCount();
+		baked.frameCount   = static_cast<uint32_t>(std::ceil(length * sampleRate)) + 1;
+		baked.samples.resize(static_cast<size_t>(baked.frameCount) * baked.channelCount);
+
+		uint32_t channel = 0;
+		for (auto& curve : curves)
+		{
+			for (auto& property : curve.properties)
+			{
+				uint32_t cursor = 0;
+				for (uint32_t frame = 0; frame < baked.frameCount; frame++)
+				{
+					const float time = std::min(frame / sampleRate, length);
+					baked.samples[frame * baked.channelCount + channel] = property.curve.evaluate(time, cursor);
+				}
+				channel++;
+			}
+		}
+	}
+
 	Animation::Animation(const std::string& filePath):
 		filePath(filePath)
 	{
@@ -30,4 +89,4 @@ namespace maple
 	{
 		clips.emplace_back(clip);
 	}
-};
\ No newline at end of file
+};
@@ -55,6 +55,23 @@ namespace maple
 		ClampForever = 8,
 	};
 
+	/**
+	 * every property of a clip resampled at a fixed rate. samples are frame major, so the channels of two neighbouring
+	 * frames are contiguous and one lerp over them evaluates the whole clip.
+	 * channels follow the properties of the clip in curve order.
+	 */
+	struct AnimationBakedTracks
+	{
+		float sampleRate = 0;
+		uint32_t frameCount = 0;
+		uint32_t channelCount = 0;
+		std::vector<float> samples;
+
+		inline auto isBaked() const { return frameCount > 0; }
+		//writes channelCount values to out.
+		auto evaluate(float time, float* out) const -> void;
+	};
+
 	struct AnimationClip
 	{
 		AnimationClip() :length(0), fps(0), wrapMode(AnimationWrapMode::Default) {}
@@ -63,6 +80,17 @@ namespace maple
 		float fps;
 		AnimationWrapMode wrapMode;
 		std::vector<AnimationCurveWrapper> curves;
+		AnimationBakedTracks baked;
+
+		inline auto getPropertyCount() const 
+		{
+			uint32_t count = 0;
+			for (auto& curve : curves)
+				count += static_cast<uint32_t>(curve.properties.size());
+			return count;
+		}
+
+		auto bake(float sampleRate) -> void;
 	};
 
 	enum class FadeState
@@ -4,6 +4,7 @@
 
 #include "AnimationCurve.h"
 #include "Math/MathUtils.h"
+#include <algorithm>
 
 namespace maple
 {
@@ -11,48 +12,73 @@ namespace maple
     {
 		AnimationCurve curve;
 		float tangent = (valueEnd - valueStart) / (timeEnd - timeStart);
-		curve.addKey(timeStart, valueEnd, tangent, tangent);
+		curve.addKey(timeStart, valueStart, tangent, tangent);
 		curve.addKey(timeEnd, valueEnd, tangent, tangent);
 		return curve;
     }
 
     auto AnimationCurve::addKey(float time, float value, float inTangent, float outTangent) -> void
     {
-		keys.push_back({ time, value, inTangent, outTangent });
+		//keys are expected in time order, keep them sorted for the binary search anyway.
+		Key key{ time, value, inTangent, outTangent };
+		if (keys.empty() || keys.back().time <= time)
+		{
+			keys.push_back(key);
+		}
+		else
+		{
+			auto iter = std::upper_bound(keys.begin(), keys.end(), time, [](float t, const Key& k) { return t < k.time; });
+			keys.insert(iter, key);
+		}
     }
 
+	auto AnimationCurve::findSegment(float time) const -> uint32_t
+	{
+		//index of the last key at or before time, callers already handled both ends.
+		auto iter = std::upper_bound(keys.begin(), keys.end(), time, [](float t, const Key& k) { return t < k.time; });
+		return static_cast<uint32_t>(iter - keys.begin()) - 1;
+	}
+
     auto AnimationCurve::evaluate(float time) const -> float
     {
+		uint32_t cursor = 0;
+		return evaluate(time, cursor);
+    }
+
+	auto AnimationCurve::evaluate(float time, uint32_t& cursor) const -> float
+	{
 		if (keys.empty())
 		{
 			return 0;
 		}
 
-		const auto& back = keys.back();
-		if (time >= back.time)
+		if (time >= keys.back().time)
 		{
-			return back.value;
+			return keys.back().value;
 		}
 
-		for (int i = 0; i < keys.size(); ++i)
+		if (time < keys.front().time)
 		{
-			const auto& key = keys[i];
+			return keys.front().value;
+		}
 
-			if (time < key.time)
+		const auto count = static_cast<uint32_t>(keys.size());
+		if (cursor + 1 < count && keys[cursor].time <= time)
+		{
+			if (time >= keys[cursor + 1].time)
 			{
-				if (i == 0)
-				{
-					return key.value;
-				}
-				else
-				{
-					return evaluate(time, keys[i - 1], key);
-				}
+				cursor++;
+				if (cursor + 1 >= count || time >= keys[cursor + 1].time)
+					cursor = findSegment(time);
 			}
 		}
+		else
+		{
+			cursor = findSegment(time);
+		}
 
-		return 0;
-    }
+		return evaluate(time, keys[cursor], keys[cursor + 1]);
+	}
 
     float AnimationCurve::evaluate(float time, const Key& k0, const Key& k1)
     {
@@ -60,4 +86,4 @@ namespace maple
 		float dt = std::abs((time - k0.time) / (k1.time - k0.time));
 		return MathUtils::lerp(k0.value, k1.value, dt, false);
     }
-};
\ No newline at end of file
+};
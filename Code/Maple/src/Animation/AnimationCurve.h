@@ -4,6 +4,7 @@
 
 #pragma once
 
+#include <cstdint>
 #include <vector>
 
 namespace maple
@@ -23,11 +24,17 @@ namespace maple
 		static auto linear(float timeStart, float valueStart, float timeEnd, float valueEnd) ->AnimationCurve;
 		auto addKey(float time, float value, float inTangent, float outTangent) -> void;
 		auto evaluate(float time) const -> float;
+		//cursor keeps the segment of the last call, playback usually stays in it or moves to the next one.
+		auto evaluate(float time, uint32_t & cursor) const -> float;
+
+		inline auto getKeyCount() const { return keys.size(); }
+		inline auto getEndTime() const { return keys.empty() ? 0.f : keys.back().time; }
 
 	private:
 		static auto evaluate(float time, const Key& k0, const Key& k1) -> float;
+		auto findSegment(float time) const -> uint32_t;
 
 	private:
 		std::vector<Key> keys;
 	};
-};
\ No newline at end of file
+};
@@ -4,59 +4,118 @@
 #include "AnimationSystem.h"
 #include "Animator.h"
 #include "Scene/Component/Transform.h"
+#include "Scene/Component/Sprite.h"
 #include "Math/MathUtils.h"
+#include "Engine/Profiler.h"
 #include <ecs/ecs.h>
+#include <unordered_map>
 
 namespace maple
 {
+	namespace sprite_animation
+	{
+		using Entity = ecs::Chain
+			::Write<component::AnimatedSprite>
+			::To<ecs::Entity>;
+
+		using WorldAccess = ecs::Chain
+			::Read<component::DeltaTime>
+			::To<ecs::Entity>;
+
+		inline auto system(Entity entity, ecs::World world)
+		{
+			auto [sprite] = entity;
+			sprite.onUpdate(world.getComponent<component::DeltaTime>().dt);
+		}
+	}
+
 	namespace animation 
 	{
 		using Entity = ecs::Chain
 			::Write<component::Animator>
 			::To<ecs::Entity>;
 
-		inline auto sample(Entity entity, 
-			component::Animator & animator, 
+		inline auto bind(Entity entity, component::Animator& animator) -> void
+		{
+			PROFILE_FUNCTION();
+			auto currentEntity = entity.castTo<maple::Entity>();
+			auto& clips = animator.animation->getClips();
+
+			animator.targets.clear();
+			animator.clipTargets.clear();
+
+			//rotation and translation curves of one bone share the path, so every path is only searched once.
+			std::unordered_map<std::string, int32_t> paths;
+
+			for (auto& clip : clips)
+			{
+				auto& curveTargets = animator.clipTargets.emplace_back();
+				curveTargets.reserve(clip->curves.size());
+				for (auto& curve : clip->curves)
+				{
+					auto [iter, inserted] = paths.try_emplace(curve.path, -1);
+					if (inserted)
+					{
+						auto find = currentEntity.findByPath(curve.path);
+						if (find.valid())
+						{
+							if (find.hasComponent<component::Transform>())
+							{
+								iter->second = static_cast<int32_t>(animator.targets.size());
+								animator.targets.emplace_back(find);
+							}
+						}
+					}
+					curveTargets.emplace_back(iter->second);
+				}
+			}
+
+			animator.poses.resize(animator.targets.size());
+			animator.transforms.resize(animator.targets.size());
+			animator.boundAnimation = animator.animation.get();
+			animator.hierarchyVersion = component::Hierarchy::getVersion();
+		}
+
+		inline auto sample(component::Animator & animator, 
 			component::Animator::AnimationState & state,
-			float time, float weight, bool firstState, bool lastState) -> void
+			float time, float weight, bool firstState) -> void
 		{
 			const auto& clip = *animator.animation->getClips()[state.clipIndex];
-			if (state.targets.size() == 0)
+			const auto& curveTargets = animator.clipTargets[state.clipIndex];
+
+			//baked clips evaluate every channel with one lerp, the others look keys up from their cursors.
+			const float* values = nullptr;
+			if (clip.baked.isBaked())
 			{
-				state.targets.resize(clip.curves.size(), nullptr);
+				animator.channels.resize(clip.baked.channelCount);
+				clip.baked.evaluate(time, animator.channels.data());
+				values = animator.channels.data();
+			}
+			else if (state.cursors.size() != clip.getPropertyCount())
+			{
+				state.cursors.assign(clip.getPropertyCount(), 0);
 			}
 
-			auto currentEntity = entity.castTo<maple::Entity>();
-
+			uint32_t channel = 0;
 			for (int i = 0; i < clip.curves.size(); ++i)
 			{
 				const auto& curve = clip.curves[i];
-				auto target = state.targets[i];
-				if (target == nullptr)
+				const auto slot = curveTargets[i];
+				if (slot < 0 || animator.transforms[slot] == nullptr)
 				{
-					auto find = currentEntity.findByPath(curve.path);
-					if (find.valid())
-					{
-						target = find.tryGetComponent<component::Transform>();
-						state.targets[i] = target;
-					}
-					else
-					{
-						continue;
-					}
+					channel += static_cast<uint32_t>(curve.properties.size());
+					continue;
 				}
 
 				glm::vec3 localPos(0);
 				glm::vec3 localRot(0);
-				glm::vec3 localscale(0);
 				bool setPos = false;
 				bool setRot = false;
-				bool setScale = false;
 
-				for (int j = 0; j < curve.properties.size(); ++j)
+				for (int j = 0; j < curve.properties.size(); ++j, ++channel)
 				{
 					auto type = curve.properties[j].type;
-					float value = curve.properties[j].curve.evaluate(time);
+					float value = values != nullptr ? values[channel] : curve.properties[j].curve.evaluate(time, state.cursors[channel]);
 
 					switch (type)
 					{
@@ -86,33 +145,38 @@ namespace maple
 						setRot = true;
 						break;
 					}
+				}
 
-					if (setPos)
+				//states are blended into the pose, the transform itself is written once after all states.
+				auto& pose = animator.poses[slot];
+				auto target = animator.transforms[slot];
+				if (setPos)
+				{
+					if (firstState)
 					{
-						glm::vec3 pos;
-						if (firstState)
-						{
-							pos = localPos * weight;
-						}
-						else
-						{
-							pos = target->getLocalPosition() + localPos * weight;
-						}
-						target->setLocalPosition(pos);
+						pose.position = localPos * weight;
 					}
-					if (setRot)
+					else
 					{
-						glm::vec3 rot;
-						if (firstState)
-						{
-							rot = glm::radians(localRot * weight);
-						}
-						else
-						{
-							rot = target->getLocalOrientation() + glm::radians(localRot * weight);
-						}
-						target->setLocalOrientation(rot);
+						if (!pose.hasPosition)
+							pose.position = target->getLocalPosition();
+						pose.position += localPos * weight;
+					}
+					pose.hasPosition = true;
+				}
+				if (setRot)
+				{
+					if (firstState)
+					{
+						pose.rotation = glm::radians(localRot * weight);
 					}
+					else
+					{
+						if (!pose.hasRotation)
+							pose.rotation = target->getLocalOrientation();
+						pose.rotation += glm::radians(localRot * weight);
+					}
+					pose.hasRotation = true;
 				}
 			}
 		}
@@ -122,6 +186,27 @@ namespace maple
 			auto [animator] = entity;
 			auto & dt = world.getComponent<component::DeltaTime>();
 
+			if (animator.animation == nullptr)
+				return;
+
+			if (animator.boundAnimation != animator.animation.get() || animator.hierarchyVersion != component::Hierarchy::getVersion())
+			{
+				bind(entity, animator);
+			}
+
+			//a bone which lost its transform or was destroyed keeps its slot but is not animated.
+			for (size_t i = 0; i < animator.targets.size(); i++)
+			{
+				auto& target = animator.targets[i];
+				animator.transforms[i] = target.valid() ? target.tryGetComponent<component::Transform>() : nullptr;
+			}
+
+			for (auto& pose : animator.poses)
+			{
+				pose.hasPosition = false;
+				pose.hasRotation = false;
+			}
+
 			if (animator.seekTo >= 0)
 			{
 				animator.time = animator.seekTo;
@@ -226,14 +311,7 @@ namespace maple
 					break;
 				}
 
-				bool lastState = false;
-				auto j = i;
-				if (++j == animator.states.end())
-				{
-					lastState = true;
-				}
-
-				sample(entity, animator, state, state.playingTime, state.weight, firstState, lastState);
+				sample(animator, state, state.playingTime, state.weight, firstState);
 
 				firstState = false;
 
@@ -251,15 +329,37 @@ namespace maple
 					++i;
 				}
 			}
+
+			for (size_t i = 0; i < animator.transforms.size(); i++)
+			{
+				auto& pose = animator.poses[i];
+				auto target = animator.transforms[i];
+				if (target == nullptr)
+					continue;
+				if (pose.hasPosition)
+					target->setLocalPosition(pose.position);
+				if (pose.hasRotation)
+					target->setLocalOrientation(pose.rotation);
+			}
+
 			if (animator.stopped)
 			{
 				animator.states.clear();
 			}
 		}
 
+		//bones are found through the names and the hierarchy, and posed through the stored transform pointers.
+		using WorldAccess = ecs::Chain
+			::Read<component::DeltaTime>
+			::Read<component::NameComponent>
+			::Read<component::Hierarchy>
+			::Write<component::Transform>
+			::To<ecs::Entity>;
+
 		auto registerAnimationSystem(std::shared_ptr<ExecutePoint> executePoint) -> void
 		{
-			executePoint->registerSystem<animation::system>();
+			executePoint->registerSystem<animation::system, WorldAccess>();
+			executePoint->registerSystem<sprite_animation::system, sprite_animation::WorldAccess>();
 		}
 	}
 };
@@ -3,6 +3,7 @@
 //////////////////////////////////////////////////////////////////////////////
 #pragma once
 #include "Scene/Component/Component.h"
+#include "Scene/Entity/Entity.h"
 #include "Animation.h"
 
 namespace maple 
@@ -53,7 +54,7 @@ namespace maple
 			{
 				int32_t clipIndex;
 				float playStartTime;
-				std::vector<component::Transform*> targets;
+				std::vector<uint32_t> cursors;        //one key cursor per property, unused for baked clips
 				FadeState fadeState;
 				float fadeStartTime;
 				float fadeLength;
@@ -64,6 +65,23 @@ namespace maple
 
 			std::vector<AnimationState> states;
 			std::shared_ptr<Animation> animation;
+
+			//curve targets are resolved once per clip and shared by every state playing it.
+			struct TargetPose
+			{
+				glm::vec3 position;
+				glm::vec3 rotation;
+				bool hasPosition;
+				bool hasRotation;
+			};
+
+			const Animation* boundAnimation = nullptr;
+			uint32_t hierarchyVersion = UINT32_MAX;
+			std::vector<std::vector<int32_t>> clipTargets;        //per clip, per curve index into targets or -1
+			std::vector<Entity> targets;                                  //bones are kept as entities, entt moves component storage around
+			std::vector<component::Transform*> transforms;               //resolved from targets at the start of every update
+			std::vector<TargetPose> poses;
+			std::vector<float> channels;
 		};
 	}
 }
\ No newline at end of file
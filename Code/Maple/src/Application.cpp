@@ -5,6 +5,7 @@
 #include "Application.h"
 #include "Engine/Camera.h"
 #include "Engine/Profiler.h"
+#include "Engine/Renderer/GeometryPool.h"
 #include "Engine/Renderer/Renderer2D.h"
 #include "Engine/Terrain.h"
 #include "Engine/Timestep.h"
@@ -44,7 +45,7 @@ namespace maple
 		graphicsContext = GraphicsContext::create();
 
 		sceneManager  = std::make_unique<SceneManager>();
-		threadPool    = std::make_unique<ThreadPool>(4);
+		threadPool    = std::make_unique<ThreadPool>(std::max<int32_t>(1, std::thread::hardware_concurrency() - 1));
 		texturePool   = std::make_unique<TexturePool>();
 		luaVm         = std::make_unique<LuaVirtualMachine>();
 		monoVm        = std::make_shared<MonoVirtualMachine>();
@@ -63,6 +64,9 @@ namespace maple
 		graphicsContext->init();
 		renderDevice->init();
 
+		if (graphicsContext->isIndirectCountSupported())
+			geometryPool = std::make_shared<GeometryPool>();
+
 		timer.start();
 		luaVm->init();
 		monoVm->init();
@@ -93,6 +97,7 @@ namespace maple
 			{
 				sceneManager->apply();
 				executeAll();
+				loaderFactory->update();        //gpu part of the assets parsed in the background
 				onUpdate(timestep);
 
 				renderDevice->begin();
@@ -29,6 +29,7 @@ namespace maple
 	class MonoVirtualMachine;
 	class ExecutePoint;
 	class AssetsLoaderFactory;
+	class GeometryPool;
 
 	enum class EditorState
 	{
@@ -109,6 +110,12 @@ namespace maple
 		{
 			return get()->threadPool;
 		}
+
+		inline static auto &getJobSystem()
+		{
+			return get()->threadPool->getJobSystem();
+		}
+
 		template <class T>
 		inline auto getAppDelegate()
 		{
@@ -119,6 +126,12 @@ namespace maple
 		{
 			return get()->texturePool;
 		}
+		//nullptr if the device can not draw indirectly with a count, see GeometryPool.
+		inline static auto &getGeometryPool()
+		{
+			return get()->geometryPool;
+		}
+
 		inline static auto &getLuaVirtualMachine()
 		{
 			return get()->luaVm;
@@ -185,6 +198,7 @@ namespace maple
 		std::shared_ptr<RenderGraph>        renderGraph;
 		std::shared_ptr<ExecutePoint>       executePoint;
 		std::shared_ptr<AssetsLoaderFactory> loaderFactory;
+		std::shared_ptr<GeometryPool>        geometryPool;
 
 
 		EventDispatcher                                                  dispatcher;
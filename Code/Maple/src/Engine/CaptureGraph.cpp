@@ -0,0 +1,329 @@
+//////////////////////////////////////////////////////////////////////////////
+// This file is part of the Maple Engine                              		//
+//////////////////////////////////////////////////////////////////////////////
+#include "CaptureGraph.h"
+#include "Others/HashCode.h"
+#include "RHI/DescriptorSet.h"
+#include "RHI/Pipeline.h"
+#include "RHI/Shader.h"
+
+#include <algorithm>
+
+namespace maple
+{
+	namespace capture_graph
+	{
+		namespace
+		{
+			inline auto contains(const std::vector<std::shared_ptr<Texture>> &textures, const Texture *texture)
+			{
+				for (auto &t : textures)
+				{
+					if (t.get() == texture)
+						return true;
+				}
+				return false;
+			}
+
+			inline auto add(std::vector<std::shared_ptr<Texture>> &textures, const std::shared_ptr<Texture> &texture)
+			{
+				if (texture != nullptr && !contains(textures, texture.get()))
+					textures.emplace_back(texture);
+			}
+
+			inline auto isTransient(const component::RenderGraph &graph, const Texture *texture)
+			{
+				for (auto &t : graph.transients)
+				{
+					if (t.get() == texture)
+						return true;
+				}
+				return false;
+			}
+
+			inline auto getPixelSize(TextureFormat format) -> size_t
+			{
+				switch (format)
+				{
+					case TextureFormat::R8:
+						return 1;
+					case TextureFormat::RG8:
+						return 2;
+					case TextureFormat::RGB8:
+					case TextureFormat::RGB:
+						return 3;
+					case TextureFormat::RGBA16:
+						return 8;
+					case TextureFormat::RGB16:
+						return 6;
+					case TextureFormat::RGB32:
+						return 12;
+					case TextureFormat::RGBA32:
+						return 16;
+					default:
+						return 4;
+				}
+			}
+
+			struct Lifetime
+			{
+				std::shared_ptr<Texture2D> texture;
+				size_t                     bytes = 0;
+				//pass indices, first > last for a target no pass touches.
+				int32_t first = 0;
+				int32_t last  = -1;
+				//only a target whose content starts in a clearing pass can follow another one in the same memory.
+				bool shareable = false;
+
+				inline auto overlaps(const Lifetime &other) const
+				{
+					return first <= last && other.first <= other.last && first <= other.last && other.first <= last;
+				}
+			};
+
+			inline auto cull(component::RenderGraph &graph, std::vector<bool> &kept) -> void
+			{
+				auto &passes = graph.records;
+				kept.assign(passes.size(), true);
+
+				//removing a pass can leave the passes feeding it without readers, so this runs until nothing changes.
+				for (bool changed = true; changed;)
+				{
+					changed = false;
+					for (size_t i = 0; i < passes.size(); i++)
+					{
+						if (!kept[i] || passes[i].writes.empty())
+							continue;
+
+						bool needed = false;
+						for (auto &write : passes[i].writes)
+						{
+							if (!isTransient(graph, write.get()))
+							{
+								needed = true;
+								break;
+							}
+
+							for (size_t j = 0; j < passes.size() && !needed; j++)
+							{
+								needed = j != i && kept[j] && contains(passes[j].reads, write.get());
+							}
+
+							if (needed)
+								break;
+						}
+
+						if (!needed)
+						{
+							kept[i] = false;
+							changed = true;
+						}
+					}
+				}
+
+				//a shader is only skipped if every pass it runs is culled.
+				graph.culled.clear();
+				for (size_t i = 0; i < passes.size(); i++)
+				{
+					if (kept[i] || std::find(graph.culled.begin(), graph.culled.end(), passes[i].shader) != graph.culled.end())
+						continue;
+
+					bool culled = true;
+					for (size_t j = 0; j < passes.size(); j++)
+					{
+						if (passes[j].shader == passes[i].shader)
+							culled &= !kept[j];
+					}
+					if (culled)
+						graph.culled.emplace_back(passes[i].shader);
+				}
+			}
+
+			inline auto alias(component::RenderGraph &graph) -> void
+			{
+				auto &passes = graph.records;
+
+				std::vector<Lifetime> lifetimes;
+				for (auto &texture : graph.transients)
+				{
+					auto &lifetime   = lifetimes.emplace_back();
+					lifetime.texture = texture;
+					lifetime.bytes   = size_t(texture->getWidth()) * texture->getHeight() * getPixelSize(texture->getFormat());
+
+					for (int32_t i = 0; i < static_cast<int32_t>(passes.size()); i++)
+					{
+						const bool read  = contains(passes[i].reads, texture.get());
+						const bool write = contains(passes[i].writes, texture.get());
+						if (!read && !write)
+							continue;
+
+						if (lifetime.first > lifetime.last)
+						{
+							lifetime.first = i;
+							//anything but a cleared target keeps what it had at the start of the frame (cleared there, or written earlier).
+							lifetime.shareable = write && !read && passes[i].clear;
+							if (!lifetime.shareable)
+								lifetime.first = 0;
+						}
+						lifetime.last = i;
+					}
+				}
+
+				std::stable_sort(lifetimes.begin(), lifetimes.end(), [](const Lifetime &left, const Lifetime &right) {
+					return left.bytes > right.bytes;
+				});
+
+				//greedy placement, the largest target of a slot owns the memory.
+				std::vector<std::vector<const Lifetime *>> slots;
+				std::vector<std::pair<std::shared_ptr<Texture2D>, std::shared_ptr<Texture2D>>> aliases;
+
+				for (auto &lifetime : lifetimes)
+				{
+					bool placed = false;
+					for (auto &slot : slots)
+					{
+						if (!lifetime.shareable)
+							break;
+
+						bool overlaps = false;
+						for (auto other : slot)
+						{
+							overlaps |= lifetime.overlaps(*other);
+						}
+
+						if (!overlaps)
+						{
+							slot.emplace_back(&lifetime);
+							aliases.emplace_back(lifetime.texture, slot.front()->texture);
+							placed = true;
+							break;
+						}
+					}
+
+					if (!placed)
+						slots.push_back({&lifetime});
+				}
+
+				if (aliases != graph.aliases)
+				{
+					graph.aliases        = std::move(aliases);
+					graph.aliasesChanged = true;
+				}
+			}
+
+			inline auto compile(component::RenderGraph &graph) -> void
+			{
+				std::vector<bool> kept;
+				cull(graph, kept);
+				alias(graph);
+
+				graph.nodes.clear();
+				for (size_t i = 0; i < graph.records.size(); i++)
+				{
+					auto &pass = graph.records[i];
+					input(pass.name, graph, pass.reads);
+					output(pass.name, graph, pass.writes);
+					getRenderPassNode(pass.name, graph)->culled = isCulled(graph, pass.shader);
+				}
+				graph.version++;
+			}
+		}        // namespace
+
+		auto beginFrame(component::RenderGraph &graph) -> void
+		{
+			graph.frameHash  = 0;
+			graph.lastShader = nullptr;
+			if (graph.capture)
+				graph.records.clear();
+		}
+
+		auto discardAliases(component::RenderGraph &graph) -> void
+		{
+			for (auto &alias : graph.aliases)
+			{
+				alias.first->discardContent();
+				alias.second->discardContent();
+			}
+		}
+
+		auto endFrame(component::RenderGraph &graph) -> void
+		{
+			if (graph.capture)
+			{
+				compile(graph);
+				graph.compiledHash = graph.frameHash;
+				graph.capture      = false;
+			}
+			else if (graph.frameHash != graph.compiledHash)
+			{
+				//captured by the next frame, the compiled graph stays in use until then.
+				graph.capture = true;
+			}
+		}
+
+		auto addPass(component::RenderGraph &graph, const PipelineInfo &info, const std::vector<std::shared_ptr<DescriptorSet>> &sets) -> void
+		{
+			auto shader = info.shader.get();
+
+			//the draws of one pass go through here one by one, only the first one counts in the hash so the number of draws does not matter.
+			if (shader != graph.lastShader)
+			{
+				graph.lastShader = shader;
+				HashCode::hashCode(graph.frameHash, shader, info.clearTargets, info.depthTarget.get(), info.depthArrayTarget.get());
+
+				for (auto &color : info.colorTargets)
+				{
+					if (color != nullptr)
+						HashCode::hashCode(graph.frameHash, color.get());
+				}
+
+				for (auto &set : sets)
+				{
+					for (auto &descriptor : set->getDescriptors())
+					{
+						for (auto &texture : descriptor.textures)
+						{
+							if (texture != nullptr && isTransient(graph, texture.get()))
+								HashCode::hashCode(graph.frameHash, texture.get(), descriptor.type);
+						}
+					}
+				}
+
+				if (graph.capture)
+				{
+					auto &pass  = graph.records.emplace_back();
+					pass.shader = shader;
+					pass.name   = shader->getName();
+					pass.clear  = info.clearTargets;
+				}
+			}
+
+			if (!graph.capture || graph.records.empty())
+				return;
+
+			auto &pass = graph.records.back();
+
+			for (auto &set : sets)
+			{
+				for (auto &descriptor : set->getDescriptors())
+				{
+					for (auto &texture : descriptor.textures)
+					{
+						add(pass.reads, texture);
+						//storage images are written as well.
+						if (descriptor.type == DescriptorType::Image)
+							add(pass.writes, texture);
+					}
+				}
+			}
+
+			add(pass.reads, info.depthTarget);
+			add(pass.writes, info.depthArrayTarget);
+
+			for (auto &color : info.colorTargets)
+			{
+				add(pass.writes, color);
+			}
+		}
+	}        // namespace capture_graph
+};           // namespace maple
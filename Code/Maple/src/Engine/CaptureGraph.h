@@ -10,10 +10,21 @@
 
 namespace maple
 {
+	class Shader;
+	class DescriptorSet;
+	struct PipelineInfo;
+
+	/**
+	 * frame graph made of the passes issued through Pipeline::get(info, sets, graph).
+	 * a frame only hashes what its passes read and write, the passes are captured and the graph is compiled again
+	 * when the hash changes. compiling culls the passes whose outputs nobody reads and lets transient targets with
+	 * disjoint lifetimes share their memory, those are discarded at the start of every frame so their first transition
+	 * starts from undefined and waits for the previous user of the memory.
+	 */
 	namespace capture_graph
 	{
 
-		enum class NodeType 
+		enum class NodeType
 		{
 			RenderPass,
 			Image,
@@ -26,16 +37,67 @@ namespace maple
 			std::unordered_set<std::shared_ptr<GraphNode>> inputs;
 			std::unordered_set<std::shared_ptr<GraphNode>> outputs;
 			std::shared_ptr<Texture> texture;
-		};	
+			bool culled = false;
+		};
+
+		//consecutive calls with the same shader are one pass.
+		struct PassRecord
+		{
+			const Shader *                        shader = nullptr;
+			std::string                           name;
+			std::vector<std::shared_ptr<Texture>> reads;
+			std::vector<std::shared_ptr<Texture>> writes;
+			//the first write clears the color targets
+			bool clear = false;
+		};
 
 		namespace component
 		{
 			struct RenderGraph
 			{
+				//compiled graph, shown by the editor. version changes with every compile.
 				std::unordered_map<std::string, std::shared_ptr<GraphNode>> nodes;
+				uint32_t                                                     version = 0;
+
+				//targets living inside one frame, only these are culled or aliased.
+				std::vector<std::shared_ptr<Texture2D>> transients;
+
+				//texture -> owner of the memory it is placed in, applied by the owner of the textures (GBuffer::setAliases).
+				std::vector<std::pair<std::shared_ptr<Texture2D>, std::shared_ptr<Texture2D>>> aliases;
+				bool                                                                             aliasesChanged = false;
+
+				std::vector<const Shader *> culled;
+
+				std::vector<PassRecord> records;
+				size_t                  frameHash    = 0;
+				size_t                  compiledHash = 0;
+				const Shader *          lastShader   = nullptr;
+				bool                    capture      = true;
 			};
 		}
 
+		//starts recording a new frame, before the first pass (also the ones issued while preparing the frame).
+		auto MAPLE_EXPORT beginFrame(component::RenderGraph &graph) -> void;
+
+		//before the first use of any aliased target in the frame, their content is not kept across frames.
+		auto MAPLE_EXPORT discardAliases(component::RenderGraph &graph) -> void;
+
+		//compiles the frame if it was captured and schedules a capture if the frame differs from the compiled one.
+		auto MAPLE_EXPORT endFrame(component::RenderGraph &graph) -> void;
+
+		auto MAPLE_EXPORT addPass(component::RenderGraph &graph, const PipelineInfo &info, const std::vector<std::shared_ptr<DescriptorSet>> &sets) -> void;
+
+		//nothing kept by the compiled graph reads what the pass writes, it can be skipped.
+		inline auto isCulled(const component::RenderGraph &graph, const Shader *shader) -> bool
+		{
+			for (auto culled : graph.culled)
+			{
+				if (culled == shader)
+					return true;
+			}
+			return false;
+		}
+
 		inline auto getRenderPassNode(const std::string& name, component::RenderGraph& graph)
 		{
 			if (auto node = graph.nodes.find(name); node != graph.nodes.end())
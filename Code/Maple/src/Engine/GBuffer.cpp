@@ -4,12 +4,24 @@
 
 #include "GBuffer.h"
 #include "Others/Randomizer.h"
+#include "FileSystem/File.h"
 
 namespace maple
 {
+	namespace
+	{
+		bool compactEnabled = true;
+
+		inline auto isPlaceholder(bool compact, int32_t index)
+		{
+			return compact && (index == POSITION || index == VIEW_POSITION || index == VIEW_NORMALS);
+		}
+	}        // namespace
+
 	GBuffer::GBuffer(uint32_t width, uint32_t height) :
-	    width(width), height(height)
+	    width(width), height(height), compact(isCompactLayoutEnabled())
 	{
+		aliasOf.fill(-1);
 		formats[PREV_DISPLAY]     = TextureFormat::RGBA8;
 		formats[SCREEN]           = TextureFormat::RGBA8;
 		formats[SSAO_SCREEN]      = TextureFormat::RGB8;
@@ -25,9 +37,55 @@ namespace maple
 		formats[VOLUMETRIC_LIGHT] = TextureFormat::RGB8;
 		formats[PSEUDO_SKY]       = TextureFormat::RGBA8;
 		formats[INDIRECT_LIGHTING] = TextureFormat::RGBA32;
+		if (compact)
+		{
+			formats[POSITION]          = TextureFormat::RGBA8;
+			formats[VIEW_POSITION]     = TextureFormat::RGBA8;
+			formats[VIEW_NORMALS]      = TextureFormat::RGBA8;
+			formats[NORMALS]           = TextureFormat::RG16;
+			formats[PBR]               = TextureFormat::RGBA8;
+			formats[VELOCITY]          = TextureFormat::RG16F;
+			formats[INDIRECT_LIGHTING] = TextureFormat::RGBA16;
+		}
 		buildTexture();
 	}
 
+	auto GBuffer::isCompactLayoutSupported() -> bool
+	{
+		static const bool compiled =
+		    File::fileExists("shaders/spv/DeferredColorPacked.frag.spv") &&
+		    File::fileExists("shaders/spv/DeferredLightPacked.frag.spv") &&
+		    File::fileExists("shaders/spv/SSRPacked.frag.spv") &&
+		    File::fileExists("shaders/spv/PostProcess/SSAOPacked.frag.spv") &&
+		    File::fileExists("shaders/spv/LPV/IndirectLightPacked.comp.spv");
+		return compiled;
+	}
+
+	auto GBuffer::isCompactLayoutEnabled() -> bool
+	{
+		return compactEnabled && isCompactLayoutSupported();
+	}
+
+	auto GBuffer::setCompactLayout(bool enable) -> void
+	{
+		compactEnabled = enable;
+	}
+
+	auto GBuffer::getReconstruction(const glm::mat4 &projView) -> glm::mat4
+	{
+		//uv and depth back to ndc, the screen quad maps ndc.xy * 0.5 + 0.5 to uv in both apis.
+		glm::mat4 toNdc(1.f);
+		toNdc[0][0] = 2.f;
+		toNdc[1][1] = 2.f;
+		toNdc[3][0] = -1.f;
+		toNdc[3][1] = -1.f;
+#ifndef GLM_FORCE_DEPTH_ZERO_TO_ONE
+		toNdc[2][2] = 2.f;
+		toNdc[3][2] = -1.f;
+#endif
+		return glm::inverse(projView) * toNdc;
+	}
+
 	auto GBuffer::resize(uint32_t width, uint32_t height, CommandBuffer *commandBuffer) -> void
 	{
 		this->width  = width;
@@ -62,16 +120,77 @@ namespace maple
 
 		for (int32_t i = COLOR; i < LENGTH; i++)
 		{
-			if (i == VOLUMETRIC_LIGHT)
-			{
-				screenTextures[i]->buildTexture(formats[i], width / 2.f, height / 2.f, false, false, false);
-			}
-			else
+			buildTexture(i);
+		}
+		applyAliases();
+		depthBuffer->resize(width, height, commandBuffer);
+	}
+
+	auto GBuffer::buildTexture(int32_t index) -> void
+	{
+		if (isPlaceholder(compact, index))
+		{
+			screenTextures[index]->buildTexture(formats[index], 1, 1, false, false, false);
+		}
+		else if (index == VOLUMETRIC_LIGHT)
+		{
+			screenTextures[index]->buildTexture(formats[index], width / 2.f, height / 2.f, false, false, false);
+		}
+		else
+		{
+			screenTextures[index]->buildTexture(formats[index], width, height, false, false, false);
+		}
+	}
+
+	auto GBuffer::applyAliases() -> void
+	{
+		for (int32_t i = COLOR; i < LENGTH; i++)
+		{
+			//not supported by the backend or the owner is too small, the texture keeps its own memory.
+			if (aliasOf[i] != -1 && !screenTextures[i]->aliasMemory(screenTextures[aliasOf[i]]))
+				aliasOf[i] = -1;
+		}
+	}
+
+	auto GBuffer::getTransients() const -> std::vector<std::shared_ptr<Texture2D>>
+	{
+		std::vector<std::shared_ptr<Texture2D>> transients;
+		for (int32_t i = COLOR; i < LENGTH; i++)
+		{
+			if (i != SCREEN && i != PREV_DISPLAY)
+				transients.emplace_back(screenTextures[i]);
+		}
+		return transients;
+	}
+
+	auto GBuffer::setAliases(const std::vector<std::pair<std::shared_ptr<Texture2D>, std::shared_ptr<Texture2D>>> &aliases) -> void
+	{
+		auto indexOf = [&](const std::shared_ptr<Texture2D> &texture) -> int32_t {
+			for (int32_t i = COLOR; i < LENGTH; i++)
 			{
-				screenTextures[i]->buildTexture(formats[i], width, height, false, false, false);
+				if (screenTextures[i] == texture)
+					return i;
 			}
+			return -1;
+		};
+
+		std::array<int32_t, GBufferTextures::LENGTH> next;
+		next.fill(-1);
+		for (auto &[texture, owner] : aliases)
+		{
+			const auto index = indexOf(texture);
+			if (index != -1)
+				next[index] = indexOf(owner);
 		}
-		depthBuffer->resize(width, height, commandBuffer);
+
+		for (int32_t i = COLOR; i < LENGTH; i++)
+		{
+			//an owner moving to another texture or no owner at all, the texture needs its own memory back first.
+			if (aliasOf[i] != -1 && aliasOf[i] != next[i])
+				buildTexture(i);
+		}
+		aliasOf = next;
+		applyAliases();
 	}
 
 	auto GBuffer::getGBufferTextureName(GBufferTextures index) -> const char *
@@ -6,6 +6,7 @@
 #include <array>
 #include <glm/glm.hpp>
 #include <memory>
+#include <vector>
 
 namespace maple
 {
@@ -30,11 +31,29 @@ namespace maple
 		LENGTH
 	};
 
+	/**
+	 * in the compact layout positions are not stored, they are rebuilt from the depth buffer (getReconstruction),
+	 * NORMALS holds the octahedral world normal (RG16), PBR is RGBA8 (metallic, roughness, ao, emissive intensity)
+	 * and VELOCITY is RG16F. POSITION, VIEW_POSITION and VIEW_NORMALS are then 1x1 placeholders.
+	 */
 	class GBuffer
 	{
 	  public:
 		GBuffer(uint32_t width, uint32_t height);
 
+		//the layout is chosen when the GBuffer and the renderers are created, so it has to be set before.
+		static auto isCompactLayoutSupported() -> bool;
+		static auto isCompactLayoutEnabled() -> bool;
+		static auto setCompactLayout(bool enable) -> void;
+
+		//turns (uv, depth, 1) of a texel into a homogeneous position in the space projView maps from.
+		static auto getReconstruction(const glm::mat4 &projView) -> glm::mat4;
+
+		inline auto isCompact() const
+		{
+			return compact;
+		}
+
 		inline auto getWidth() const
 		{
 			return width;
@@ -65,14 +84,26 @@ namespace maple
 		}
 		static auto getGBufferTextureName(GBufferTextures index) -> const char *;
 
+		//targets whose content does not outlive the frame, SCREEN and PREV_DISPLAY are kept for the next one.
+		auto getTransients() const -> std::vector<std::shared_ptr<Texture2D>>;
+
+		//texture -> owner pairs placing the textures in the memory of their owner (capture_graph), kept across resizes.
+		auto setAliases(const std::vector<std::pair<std::shared_ptr<Texture2D>, std::shared_ptr<Texture2D>>> &aliases) -> void;
+
 	  private:
+		auto buildTexture(int32_t index) -> void;
+		auto applyAliases() -> void;
+
 		std::array<std::shared_ptr<Texture2D>, GBufferTextures::LENGTH> screenTextures;
 		std::array<TextureFormat, GBufferTextures::LENGTH>              formats;
+		//index of the texture owning the memory, -1 for textures with their own.
+		std::array<int32_t, GBufferTextures::LENGTH> aliasOf;
 		std::shared_ptr<TextureDepth>                                   depthBuffer;
 		std::shared_ptr<Texture2D>                                      ssaoNoiseMap;
 
 	  private:
 		uint32_t width;
 		uint32_t height;
+		bool     compact = false;
 	};
 }        // namespace maple
@@ -57,7 +57,7 @@ namespace maple
 	auto Material::loadMaterial(const std::string &name, const std::string &path) -> void
 	{
 		this->name                    = name;
-		pbrMaterialTextures.albedo    = Texture2D::create(name, path);
+		pbrMaterialTextures.albedo    = createTexture(name, path);
 		pbrMaterialTextures.normal    = nullptr;
 		pbrMaterialTextures.roughness = nullptr;
 		pbrMaterialTextures.metallic  = nullptr;
@@ -191,9 +191,14 @@ namespace maple
 		pbrMaterialTextures = textures;
 	}
 
+	auto Material::createTexture(const std::string &name, const std::string &path) -> std::shared_ptr<Texture2D>
+	{
+		return Texture2D::create(name, path, {}, {false, true, true, true});
+	}
+
 	auto Material::setAlbedoTexture(const std::string &path) -> void
 	{
-		setAlbedo(Texture2D::create(path, path));
+		setAlbedo(createTexture(path, path));
 	}
 
 	auto Material::setAlbedo(const std::shared_ptr<Texture2D> &texture) -> void
@@ -210,7 +215,7 @@ namespace maple
 	auto Material::setNormalTexture(const std::string &path) -> void
 	{
 		PROFILE_FUNCTION();
-		auto tex = Texture2D::create(path, path);
+		auto tex = createTexture(path, path);
 		if (tex)
 		{
 			pbrMaterialTextures.normal        = tex;
@@ -222,7 +227,7 @@ namespace maple
 	auto Material::setRoughnessTexture(const std::string &path) -> void
 	{
 		PROFILE_FUNCTION();
-		auto tex = Texture2D::create(path, path);
+		auto tex = createTexture(path, path);
 		if (tex)
 		{
 			pbrMaterialTextures.roughness        = tex;
@@ -235,7 +240,7 @@ namespace maple
 	auto Material::setMetallicTexture(const std::string &path) -> void
 	{
 		PROFILE_FUNCTION();
-		auto tex = Texture2D::create(path, path);
+		auto tex = createTexture(path, path);
 		if (tex)
 		{
 			pbrMaterialTextures.metallic        = tex;
@@ -248,7 +253,7 @@ namespace maple
 	auto Material::setAOTexture(const std::string &path) -> void
 	{
 		PROFILE_FUNCTION();
-		auto tex = Texture2D::create(path, path);
+		auto tex = createTexture(path, path);
 		if (tex)
 		{
 			pbrMaterialTextures.ao        = tex;
@@ -260,7 +265,7 @@ namespace maple
 	auto Material::setEmissiveTexture(const std::string &path) -> void
 	{
 		PROFILE_FUNCTION();
-		auto tex = Texture2D::create(path, path);
+		auto tex = createTexture(path, path);
 		if (tex)
 		{
 			pbrMaterialTextures.emissive        = tex;
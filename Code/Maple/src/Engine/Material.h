@@ -102,6 +102,9 @@ namespace maple
 
 		auto setMaterialProperites(const MaterialProperties &properties) -> void;
 		auto setTextures(const PBRMataterialTextures &textures) -> void;
+		//material maps are loaded from their cooked block compressed copy, mips included.
+		static auto createTexture(const std::string &name, const std::string &path) -> std::shared_ptr<Texture2D>;
+
 		auto setAlbedoTexture(const std::string &path) -> void;
 		auto setAlbedo(const std::shared_ptr<Texture2D> &texture) -> void;
 		auto setNormalTexture(const std::string &path) -> void;
@@ -234,17 +237,17 @@ namespace maple
 				setShader(shaderFilePath);
 
 			if (!albedoFilePath.empty())
-				pbrMaterialTextures.albedo = Texture2D::create("albedo", albedoFilePath);
+				pbrMaterialTextures.albedo = createTexture("albedo", albedoFilePath);
 			if (!normalFilePath.empty())
-				pbrMaterialTextures.normal = Texture2D::create("roughness", normalFilePath);
+				pbrMaterialTextures.normal = createTexture("roughness", normalFilePath);
 			if (!metallicFilePath.empty())
-				pbrMaterialTextures.metallic = Texture2D::create("metallic", metallicFilePath);
+				pbrMaterialTextures.metallic = createTexture("metallic", metallicFilePath);
 			if (!roughnessFilePath.empty())
-				pbrMaterialTextures.roughness = Texture2D::create("roughness", roughnessFilePath);
+				pbrMaterialTextures.roughness = createTexture("roughness", roughnessFilePath);
 			if (!emissiveFilePath.empty())
-				pbrMaterialTextures.emissive = Texture2D::create("emissive", emissiveFilePath);
+				pbrMaterialTextures.emissive = createTexture("emissive", emissiveFilePath);
 			if (!aoFilePath.empty())
-				pbrMaterialTextures.ao = Texture2D::create("ao", aoFilePath);
+				pbrMaterialTextures.ao = createTexture("ao", aoFilePath);
 		}
 
 		auto getShaderPath() const -> std::string;
@@ -7,41 +7,166 @@
 #include "Mesh.h"
 
 #include "Application.h"
+#include "FileSystem/File.h"
+#include "Loaders/Loader.h"
+#include "Loaders/MeshCache.h"
+#include "Renderer/GeometryPool.h"
 #include "Vertex.h"
+#include "VertexCompression.h"
 #define _USE_MATH_DEFINES
 #include "Math/BoundingBox.h"
+#include <algorithm>
 #include <math.h>
 
 namespace maple
 {
+	namespace
+	{
+		bool compactEnabled = true;
+	}
+
 	Mesh::Mesh(const std::shared_ptr<VertexBuffer> &vertexBuffer, const std::shared_ptr<IndexBuffer> &indexBuffer) :
 	    vertexBuffer(vertexBuffer), indexBuffer(indexBuffer)
 	{
 
 	}
 
-	Mesh::Mesh(const std::vector<uint32_t> &indices, const std::vector<Vertex> &vertices)
+	Mesh::~Mesh()
+	{
+		if (auto pool = geometryPool.lock())
+			pool->release(geometryRange);
+	}
+
+	Mesh::Mesh(const std::vector<uint32_t> &indices, const std::vector<Vertex> &vertices, bool compact)
 	{
 		boundingBox = std::make_shared<BoundingBox>();
 		for (auto &vertex : vertices)
 		{
 			boundingBox->merge(vertex.pos);
 		}
-		vertexBuffer = VertexBuffer::create();
-		vertexBuffer->setData(sizeof(Vertex) * vertices.size(), vertices.data());
-		indexBuffer = IndexBuffer::create(indices.data(), indices.size());
+
+		std::vector<CompactVertex> compactVertices;
+		if (compact && isCompactVertices() && VertexCompression::compress(vertices, compactVertices, positionScale, positionOffset))
+		{
+			vertexFormat = VertexFormat::Compact;
+			createBuffers(indices, compactVertices);
+			return;
+		}
+		createBuffers(indices, vertices);
 	}
 
-	Mesh::Mesh(const std::vector<uint32_t>& indices, const std::vector<SkinnedVertex>& vertices)
+	Mesh::Mesh(const std::vector<uint32_t>& indices, const std::vector<SkinnedVertex>& vertices, bool compact)
 	{
 		boundingBox = std::make_shared<BoundingBox>();
 		for (auto& vertex : vertices)
 		{
 			boundingBox->merge(vertex.pos);
 		}
+
+		std::vector<CompactSkinnedVertex> compactVertices;
+		if (compact && isCompactVertices() && VertexCompression::compress(vertices, compactVertices, positionScale, positionOffset))
+		{
+			vertexFormat = VertexFormat::Compact;
+			createBuffers(indices, compactVertices);
+			return;
+		}
+		createBuffers(indices, vertices);
+	}
+
+	template <typename T>
+	auto Mesh::createBuffers(const std::vector<uint32_t> &indices, const std::vector<T> &vertices) -> void
+	{
+		MeshCache::record(this, vertices.data(), sizeof(T), static_cast<uint32_t>(vertices.size()), indices);
+		if (AssetsLoaderFactory::isLoadingThread())
+		{
+			//parsed in the background, the buffers are created by the upload step on the main thread.
+			AssetsLoaderFactory::deferUpload(lifetime, [this, indices, vertices]() {
+				uploadGeometry(vertices.data(), sizeof(T), static_cast<uint32_t>(vertices.size()), indices.data(), static_cast<uint32_t>(indices.size()));
+			});
+			return;
+		}
+		uploadGeometry(vertices.data(), sizeof(T), static_cast<uint32_t>(vertices.size()), indices.data(), static_cast<uint32_t>(indices.size()));
+	}
+
+	auto Mesh::uploadGeometry(const void *vertices, uint32_t stride, uint32_t vertexCount, const uint32_t *indices, uint32_t indexCount) -> void
+	{
+		if (isPooled())
+			return;
+
+		//the pool only exists where the geometry can be drawn indirectly.
+		auto app = Application::get();
+		if (app != nullptr)
+		{
+			auto &pool = Application::getGeometryPool();
+			if (pool != nullptr && pool->allocate(stride, vertices, vertexCount, indices, indexCount, geometryRange))
+			{
+				geometryPool = pool;
+				vertexBuffer.reset();
+				indexBuffer.reset();
+				return;
+			}
+		}
+
 		vertexBuffer = VertexBuffer::create();
-		vertexBuffer->setData(sizeof(SkinnedVertex) * vertices.size(), vertices.data());
-		indexBuffer = IndexBuffer::create(indices.data(), indices.size());
+		vertexBuffer->setData(stride * vertexCount, vertices);
+		indexBuffer = IndexBuffer::create(indices, indexCount);
+	}
+
+	auto Mesh::getIndexBuffer() const -> IndexBuffer *
+	{
+		if (isPooled())
+		{
+			auto pool = geometryPool.lock();
+			return pool != nullptr ? pool->getIndexBuffer(geometryRange.format) : nullptr;
+		}
+		return indexBuffer.get();
+	}
+
+	auto Mesh::getVertexBuffer() const -> VertexBuffer *
+	{
+		if (isPooled())
+		{
+			auto pool = geometryPool.lock();
+			return pool != nullptr ? pool->getVertexBuffer(geometryRange.format) : nullptr;
+		}
+		return vertexBuffer.get();
+	}
+
+	auto Mesh::isCompactVertexSupported() -> bool
+	{
+		static const bool compiled =
+		    File::fileExists("shaders/spv/DeferredColorCompact.vert.spv") &&
+		    File::fileExists("shaders/spv/DeferredColorAnimCompact.vert.spv") &&
+		    File::fileExists("shaders/spv/ShadowCompact.vert.spv") &&
+		    File::fileExists("shaders/spv/LPV/ReflectiveShadowMapCompact.vert.spv");
+		return compiled;
+	}
+
+	auto Mesh::isCompactVertices() -> bool
+	{
+		return compactEnabled && isCompactVertexSupported();
+	}
+
+	auto Mesh::setCompactVertices(bool enable) -> void
+	{
+		compactEnabled = enable;
+	}
+
+	auto Mesh::getLod(uint32_t lod) const -> MeshLod
+	{
+		if (lods.empty())
+			return {0, isPooled() ? geometryRange.indexCount : indexBuffer->getCount(), 0.f};
+		return lods[std::min<size_t>(lod, lods.size() - 1)];
+	}
+
+	auto Mesh::selectLod(float maxError) const -> uint32_t
+	{
+		uint32_t lod = 0;
+		for (uint32_t i = 1; i < lods.size() && lods[i].error <= maxError; i++)
+		{
+			lod = i;
+		}
+		return lod;
 	}
 
 	auto Mesh::setIndicies(uint32_t range) -> void
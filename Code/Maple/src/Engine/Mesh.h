@@ -21,19 +21,47 @@ namespace maple
 		TERRAIN,
 	};
 
+	enum class VertexFormat : uint32_t
+	{
+		Full,
+		Compact,        //CompactVertex or CompactSkinnedVertex, drawn with the *Compact shader variants
+	};
+
+	//a range of the index buffer, lod 0 is the full mesh and the simplified ones follow it.
+	struct MeshLod
+	{
+		uint32_t indexOffset = 0;
+		uint32_t indexCount  = 0;
+		float    error       = 0.f;        //largest distance to the full mesh, in model units
+	};
+
+	//where the vertices and indices of a mesh sit in the GeometryPool.
+	struct GeometryRange
+	{
+		VertexFormat format       = VertexFormat::Full;
+		uint32_t     vertexOffset = 0;
+		uint32_t     vertexCount  = 0;
+		uint32_t     indexOffset  = 0;
+		uint32_t     indexCount   = 0;
+	};
+
 	class DescriptorSet;
 	class Camera;
 	class BoundingBox;
 	class Material;
+	class GeometryPool;
 
 	class MAPLE_EXPORT Mesh
 	{
 	  public:
 		Mesh() = default;
+		virtual ~Mesh();
+		NO_COPYABLE(Mesh);
 		Mesh(const std::shared_ptr<VertexBuffer> &vertexBuffer,
 		     const std::shared_ptr<IndexBuffer> & indexBuffer);
-		Mesh(const std::vector<uint32_t>& indices, const std::vector<Vertex>& vertices);
-		Mesh(const std::vector<uint32_t>& indices, const std::vector<SkinnedVertex>& vertices);
+		//compact is asked for by the importers, the vertices are quantized if the mesh allows it (VertexCompression.h).
+		Mesh(const std::vector<uint32_t>& indices, const std::vector<Vertex>& vertices, bool compact = false);
+		Mesh(const std::vector<uint32_t>& indices, const std::vector<SkinnedVertex>& vertices, bool compact = false);
 
 		inline auto setMaterial(const std::shared_ptr<Material> &material)
 		{
@@ -69,14 +97,21 @@ namespace maple
 
 		inline auto& getSubMeshIndex() const { return subMeshIndex; }
 
-		inline auto &getIndexBuffer()
+		//the GeometryPool buffers once the mesh sits in the pool, its own ones are released then.
+		auto getIndexBuffer() const -> IndexBuffer *;
+		auto getVertexBuffer() const -> VertexBuffer *;
+
+		//where the mesh starts in the buffers above, 0 unless it is pooled.
+		inline auto getFirstIndex() const
 		{
-			return indexBuffer;
+			return geometryRange.indexOffset;
 		}
-		inline auto &getVertexBuffer()
+
+		inline auto getVertexOffset() const
 		{
-			return vertexBuffer;
+			return static_cast<int32_t>(geometryRange.vertexOffset);
 		}
+
 		inline auto &getMaterial()
 		{
 			return materials;
@@ -103,6 +138,21 @@ namespace maple
 			return boundingBox;
 		}
 
+		inline auto setBoundingBox(const std::shared_ptr<BoundingBox> &box)
+		{
+			boundingBox = box;
+		}
+
+		inline auto setVertexBuffer(const std::shared_ptr<VertexBuffer> &buffer)
+		{
+			vertexBuffer = buffer;
+		}
+
+		inline auto setIndexBuffer(const std::shared_ptr<IndexBuffer> &buffer)
+		{
+			indexBuffer = buffer;
+		}
+
 		inline auto &getName() const
 		{
 			return name;
@@ -112,6 +162,66 @@ namespace maple
 			this->name = name;
 		}
 
+		inline auto getVertexFormat() const
+		{
+			return vertexFormat;
+		}
+
+		inline auto isCompact() const
+		{
+			return vertexFormat == VertexFormat::Compact;
+		}
+
+		//compact positions are rebuilt as positionOffset + positionScale * position.
+		inline auto &getPositionScale() const
+		{
+			return positionScale;
+		}
+
+		inline auto &getPositionOffset() const
+		{
+			return positionOffset;
+		}
+
+		inline auto setVertexFormat(VertexFormat format, const glm::vec4 &scale, const glm::vec4 &offset)
+		{
+			vertexFormat   = format;
+			positionScale  = scale;
+			positionOffset = offset;
+		}
+
+		inline auto setLods(const std::vector<MeshLod> &lods)
+		{
+			this->lods = lods;
+		}
+
+		inline auto &getLods() const
+		{
+			return lods;
+		}
+
+		inline auto getLodCount() const -> uint32_t
+		{
+			return lods.empty() ? 1 : static_cast<uint32_t>(lods.size());
+		}
+
+		//copies static layouts into the GeometryPool, the mesh only creates buffers of its own when that is not possible.
+		auto uploadGeometry(const void *vertices, uint32_t stride, uint32_t vertexCount, const uint32_t *indices, uint32_t indexCount) -> void;
+
+		inline auto isPooled() const
+		{
+			return geometryRange.indexCount > 0;
+		}
+
+		inline auto &getGeometryRange() const
+		{
+			return geometryRange;
+		}
+
+		auto getLod(uint32_t lod) const -> MeshLod;
+		//the coarsest lod whose error stays below maxError.
+		auto selectLod(float maxError) const -> uint32_t;
+
 		virtual auto getType() -> MeshType
 		{
 			return MeshType::MESH;
@@ -126,6 +236,11 @@ namespace maple
 		static auto createSphere(uint32_t xSegments = 64, uint32_t ySegments = 64) -> std::shared_ptr<Mesh>;
 		static auto createPlane(float w, float h, const glm::vec3 &normal) -> std::shared_ptr<Mesh>;
 
+		//the compact layouts are only used once their shader variants are compiled.
+		static auto isCompactVertexSupported() -> bool;
+		static auto isCompactVertices() -> bool;
+		static auto setCompactVertices(bool enable) -> void;
+
 		static auto generateNormals(std::vector<Vertex> &vertices, const std::vector<uint32_t> &indices) -> void;
 		static auto generateTangents(std::vector<Vertex> &vertices, const std::vector<uint32_t> &indices) -> void;
 
@@ -148,6 +263,9 @@ namespace maple
 	  protected:
 		static auto generateTangent(const glm::vec3 &a, const glm::vec3 &b, const glm::vec3 &c, const glm::vec2 &ta, const glm::vec2 &tb, const glm::vec2 &tc) -> glm::vec3;
 
+		template <typename T>
+		auto createBuffers(const std::vector<uint32_t> &indices, const std::vector<T> &vertices) -> void;
+
 		std::shared_ptr<IndexBuffer>   indexBuffer;
 		std::shared_ptr<VertexBuffer>  vertexBuffer;
 		std::shared_ptr<Texture>       texture;
@@ -162,6 +280,18 @@ namespace maple
 		uint32_t subMeshCount = 0;
 		std::vector<uint32_t> subMeshIndex;
 
+		VertexFormat vertexFormat = VertexFormat::Full;
+		glm::vec4    positionScale{1.f};
+		glm::vec4    positionOffset{0.f};
+
+		std::vector<MeshLod> lods;
+
+		GeometryRange               geometryRange;
+		std::weak_ptr<GeometryPool> geometryPool;
+
+		//uploads deferred by the constructor only hold it weakly, they are dropped together with the mesh.
+		std::shared_ptr<void> lifetime = std::make_shared<bool>();
+
 		/// Skinned mesh blend indices (max 4 per bone)
 		std::vector<glm::ivec4> blendIndices;
 		/// Skinned mesh index buffer (max 4 per bone)
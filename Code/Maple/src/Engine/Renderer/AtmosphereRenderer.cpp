@@ -103,6 +103,10 @@ namespace maple
 					data.uniformObject.centerPoint = { atmosphere.getData().centerPoint.x * 1000.f, atmosphere.getData().centerPoint.y * 1000.f, atmosphere.getData().centerPoint.z * 1000.f, atmosphere.getData().g };
 					data.pipeline = Pipeline::get(info, {data.descriptorSet}, graph);
 
+					//the pseudo sky target is not read this frame.
+					if (capture_graph::isCulled(graph, info.shader.get()))
+						data.pipeline = nullptr;
+
 					break;
 				}
 			}
@@ -137,6 +141,7 @@ namespace maple
 		auto registerAtmosphere(ExecuteQueue& begin, ExecuteQueue& renderer, std::shared_ptr<ExecutePoint> executePoint) -> void
 		{
 			executePoint->registerGlobalComponent<component::AtmosphereData>();
+			executePoint->registerShaders({"shaders/Atmosphere.shader"});
 
 			executePoint->registerWithinQueue<begin_scene::system>(begin);
 			executePoint->registerWithinQueue<on_render::system>(renderer);
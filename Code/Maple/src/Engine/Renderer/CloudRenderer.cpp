@@ -346,6 +346,13 @@ namespace maple
 			executePoint->registerGlobalComponent<Timer>();
 			executePoint->registerGlobalComponent<component::CloudRenderData>();
 			executePoint->registerGlobalComponent<component::WeatherPass>();
+			executePoint->registerShaders({
+			    "shaders/Cloud.shader",
+			    "shaders/CloudScreen.shader",
+			    "shaders/Weather.shader",
+			    "shaders/PerlinWorley.shader",
+			    "shaders/Worley.shader",
+			});
 
 			executePoint->registerWithinQueue<begin_scene::system>(begin);
 			executePoint->registerWithinQueue<on_render::system>(renderer);
@@ -17,15 +17,20 @@
 #include "Engine/Mesh.h"
 #include "Engine/CaptureGraph.h"
 
+#include "FileSystem/File.h"
+
 #include "Scene/Component/MeshRenderer.h"
 #include "Scene/Component/Light.h"
 #include "Scene/Component/Transform.h"
 #include "Scene/Component/Component.h"
+#include "Scene/Component/BoundingBox.h"
 #include "Scene/Scene.h"
 
 #include "FileSystem/Skeleton.h"
 
+#include "GPUCulling.h"
 #include "PostProcessRenderer.h"
+#include "SkinningPalette.h"
 
 #include "Engine/Vientiane/ReflectiveShadowMap.h"
 #include "Engine/Vientiane/LightPropagationVolume.h"
@@ -41,12 +46,29 @@ namespace maple
 {
 	namespace component
 	{
+		auto DeferredData::isBindlessSupported() -> bool
+		{
+			const std::string layout = GBuffer::isCompactLayoutEnabled() ? "Packed" : "";
+			return MaterialTable::isSupported() &&
+			       File::fileExists("shaders/spv/DeferredColorBindless.vert.spv") &&
+			       File::fileExists("shaders/spv/DeferredColorBindless" + layout + ".frag.spv");
+		}
+
 		DeferredData::DeferredData()
 		{
-			deferredColorShader = Shader::create("shaders/DeferredColor.shader");
-			deferredColorAnimShader = Shader::create("shaders/DeferredColorAnim.shader");
+			//the variants writing the compact G-buffer share the vertex stages.
+			const std::string layout = GBuffer::isCompactLayoutEnabled() ? "Packed" : "";
+
+			deferredColorShader = Shader::create("shaders/DeferredColor" + layout + ".shader");
+			deferredColorAnimShader = Shader::create("shaders/DeferredColorAnim" + layout + ".shader");
+
+			if (Mesh::isCompactVertexSupported())
+			{
+				deferredColorCompactShader     = Shader::create("shaders/DeferredColorCompact" + layout + ".shader");
+				deferredColorAnimCompactShader = Shader::create("shaders/DeferredColorAnimCompact" + layout + ".shader");
+			}
 
-			deferredLightShader = Shader::create("shaders/DeferredLight.shader");
+			deferredLightShader = Shader::create("shaders/DeferredLight" + layout + ".shader");
 			stencilShader = Shader::create("shaders/Outline.shader");
 			commandQueue.reserve(1000);
 
@@ -75,6 +97,12 @@ namespace maple
 			info.layoutIndex      = 2;
 			descriptorColorSet[2] = DescriptorSet::create(info);
 
+			for (auto &descriptor : descriptorColorSet[0]->getDescriptors())
+			{
+				if (descriptor.name == "UniformBufferInstance")
+					instancingSupported = true;
+			}
+
 			info.shader           = deferredLightShader.get();
 			info.layoutIndex      = 0;
 			descriptorLightSet[0] = DescriptorSet::create(info);
@@ -86,6 +114,71 @@ namespace maple
 			preintegratedFG = Texture2D::create("preintegrated", "textures/ibl_brdf_lut.png", { TextureFormat::RG16F, TextureFilter::Linear, TextureFilter::Linear, TextureWrap::ClampToEdge });
 
 			stencilDescriptorSet = DescriptorSet::create({0,stencilShader.get()});
+
+			auto getCameraUniforms = [](const std::vector<std::shared_ptr<DescriptorSet>> &sets) {
+				CameraUniforms uniforms;
+				uniforms.projView    = sets[0]->getUniformHandle("UniformBufferObject", "projView");
+				uniforms.view        = sets[0]->getUniformHandle("UniformBufferObject", "view");
+				uniforms.projViewOld = sets[0]->getUniformHandle("UniformBufferObject", "projViewOld");
+				uniforms.depthView   = sets[2]->getUniformHandle("UBO", "view");
+				uniforms.nearPlane   = sets[2]->getUniformHandle("UBO", "nearPlane");
+				uniforms.farPlane    = sets[2]->getUniformHandle("UBO", "farPlane");
+				return uniforms;
+			};
+
+			colorUniforms   = getCameraUniforms(descriptorColorSet);
+			animUniforms    = getCameraUniforms(descriptorAnimSet);
+			stencilProjView = stencilDescriptorSet->getUniformHandle("UniformBufferObject", "projView");
+			boneTransforms  = descriptorAnimSet[0]->getUniformHandle("UniformBufferObject", "boneTransforms");
+
+			if (instancingSupported)
+				instanceTransforms = descriptorColorSet[0]->getUniformHandle("UniformBufferInstance", "transforms");
+
+			if (isBindlessSupported())
+			{
+				deferredColorBindlessShader = Shader::create("shaders/DeferredColorBindless" + layout + ".shader");
+				if (deferredColorCompactShader != nullptr && File::fileExists("shaders/spv/DeferredColorBindlessCompact.vert.spv"))
+					deferredColorBindlessCompactShader = Shader::create("shaders/DeferredColorBindlessCompact" + layout + ".shader");
+
+				materialTable = std::make_shared<MaterialTable>(deferredColorBindlessShader, 1);
+
+				descriptorBindlessSet.resize(3);
+				descriptorBindlessSet[0] = DescriptorSet::create({0, deferredColorBindlessShader.get()});
+				descriptorBindlessSet[1] = materialTable->getDescriptorSet();
+				descriptorBindlessSet[2] = DescriptorSet::create({2, deferredColorBindlessShader.get()});
+
+				bindlessUniforms           = getCameraUniforms(descriptorBindlessSet);
+				bindlessInstanceTransforms = descriptorBindlessSet[0]->getUniformHandle("UniformBufferInstance", "transforms");
+				bindlessInstanceMaterials  = descriptorBindlessSet[0]->getUniformHandle("UniformBufferInstanceMaterial", "materials");
+			}
+			else if (MaterialTable::isSupported())
+			{
+				//the device enabled descriptor indexing, only the binaries of the MapleShaders target are missing.
+				LOGW("DeferredData : bindless materials are off, shaders/spv/DeferredColorBindless{0} is not compiled", layout);
+			}
+
+			auto &light = descriptorLightSet[0];
+			lightUniforms.lights                   = light->getUniformHandle("UniformBufferLight", "lights");
+			lightUniforms.cameraPosition           = light->getUniformHandle("UniformBufferLight", "cameraPosition");
+			lightUniforms.viewMatrix               = light->getUniformHandle("UniformBufferLight", "viewMatrix");
+			lightUniforms.lightView                = light->getUniformHandle("UniformBufferLight", "lightView");
+			lightUniforms.shadowTransform          = light->getUniformHandle("UniformBufferLight", "shadowTransform");
+			lightUniforms.splitDepths              = light->getUniformHandle("UniformBufferLight", "splitDepths");
+			lightUniforms.biasMat                  = light->getUniformHandle("UniformBufferLight", "biasMat");
+			lightUniforms.shadowMapSize            = light->getUniformHandle("UniformBufferLight", "shadowMapSize");
+			lightUniforms.shadowFade               = light->getUniformHandle("UniformBufferLight", "shadowFade");
+			lightUniforms.cascadeTransitionFade    = light->getUniformHandle("UniformBufferLight", "cascadeTransitionFade");
+			lightUniforms.maxShadowDistance        = light->getUniformHandle("UniformBufferLight", "maxShadowDistance");
+			lightUniforms.initialBias              = light->getUniformHandle("UniformBufferLight", "initialBias");
+			lightUniforms.lightCount               = light->getUniformHandle("UniformBufferLight", "lightCount");
+			lightUniforms.shadowCount              = light->getUniformHandle("UniformBufferLight", "shadowCount");
+			lightUniforms.mode                     = light->getUniformHandle("UniformBufferLight", "mode");
+			lightUniforms.indirectLightAttenuation = light->getUniformHandle("UniformBufferLight", "indirectLightAttenuation");
+			lightUniforms.enableIndirectLight      = light->getUniformHandle("UniformBufferLight", "enableIndirectLight");
+			lightUniforms.enableShadow             = light->getUniformHandle("UniformBufferLight", "enableShadow");
+			lightUniforms.cubeMapMipLevels         = light->getUniformHandle("UniformBufferLight", "cubeMapMipLevels");
+			lightUniforms.ssaoEnable               = light->getUniformHandle("UniformBufferLight", "ssaoEnable");
+			lightUniforms.reconstruction           = light->getUniformHandle("UniformBufferLight", "reconstruction");
 		}
 	}        // namespace component
 
@@ -97,6 +190,9 @@ namespace maple
 			::Read<component::CameraView>
 			::Read<component::RendererData>
 			::Read<component::SSAOData>
+			::Read<component::CullingData>
+			::Read<component::SkinningPalette>
+			::Read<component::GPUCullingData>
 			::ReadIfExist<component::LPVGrid>
 			::To<ecs::Entity>;
 
@@ -123,40 +219,77 @@ namespace maple
 			::ReadIfExist<component::StencilComponent>
 			::To<ecs::Query>;
 
-		using BoneMeshQuery = ecs::Chain
-			::Write<component::BoneComponent>
-			::Write<component::Transform>
-			::To<ecs::Query>;
-
 		using LightEntity = LightDefine::To<ecs::Entity>;
 
-		inline auto beginScene(Entity entity, Query lightQuery, EnvQuery env, MeshQuery meshQuery, SkinnedMeshQuery skinnedMeshQuery, BoneMeshQuery boneQuery, ecs::World world)
+		//states shared by every command of the G-buffer pass, the commands only change the shader, culling, blending and depth.
+		inline auto getColorPipelineInfo(const component::DeferredData &data, GBuffer *gbuffer) -> PipelineInfo
+		{
+			PipelineInfo pipelineInfo{};
+			pipelineInfo.shader = data.deferredColorShader;
+			pipelineInfo.polygonMode = PolygonMode::Fill;
+			pipelineInfo.blendMode = BlendMode::SrcAlphaOneMinusSrcAlpha;
+			pipelineInfo.clearTargets = false;
+			pipelineInfo.swapChainTarget = false;
+
+			if (gbuffer->isCompact())
+			{
+				pipelineInfo.colorTargets[0] = gbuffer->getBuffer(GBufferTextures::COLOR);
+				pipelineInfo.colorTargets[1] = gbuffer->getBuffer(GBufferTextures::NORMALS);
+				pipelineInfo.colorTargets[2] = gbuffer->getBuffer(GBufferTextures::PBR);
+				pipelineInfo.colorTargets[3] = gbuffer->getBuffer(GBufferTextures::VELOCITY);
+			}
+			else
+			{
+				pipelineInfo.colorTargets[0] = gbuffer->getBuffer(GBufferTextures::COLOR);
+				pipelineInfo.colorTargets[1] = gbuffer->getBuffer(GBufferTextures::POSITION);
+				pipelineInfo.colorTargets[2] = gbuffer->getBuffer(GBufferTextures::NORMALS);
+				pipelineInfo.colorTargets[3] = gbuffer->getBuffer(GBufferTextures::PBR);
+				pipelineInfo.colorTargets[4] = gbuffer->getBuffer(GBufferTextures::VIEW_POSITION);
+				pipelineInfo.colorTargets[5] = gbuffer->getBuffer(GBufferTextures::VIEW_NORMALS);
+				pipelineInfo.colorTargets[6] = gbuffer->getBuffer(GBufferTextures::VELOCITY);
+			}
+			return pipelineInfo;
+		}
+
+		inline auto beginScene(Entity entity, Query lightQuery, EnvQuery env, MeshQuery meshQuery, SkinnedMeshQuery skinnedMeshQuery, ecs::World world)
 		{
-			auto [data, shadowData, cameraView,renderData,ssao] = entity;
+			auto [data, shadowData, cameraView,renderData,ssao,culling,palette,gpuCulling] = entity;
 			data.commandQueue.clear();
+			data.renderQueue.clear();
 			auto descriptorSet = data.descriptorColorSet[0];
 
 			if (cameraView.cameraTransform == nullptr)
 				return;
 
-			data.stencilDescriptorSet->setUniform("UniformBufferObject", "projView", &cameraView.projView);
+			data.stencilDescriptorSet->setUniform(data.stencilProjView, &cameraView.projView);
 
-			data.descriptorColorSet[0]->setUniform("UniformBufferObject", "projView", &cameraView.projView);
-			data.descriptorColorSet[0]->setUniform("UniformBufferObject", "view", &cameraView.view);
-			data.descriptorColorSet[0]->setUniform("UniformBufferObject", "projViewOld", &cameraView.projViewOld);
+			data.descriptorColorSet[0]->setUniform(data.colorUniforms.projView, &cameraView.projView);
+			data.descriptorColorSet[0]->setUniform(data.colorUniforms.view, &cameraView.view);
+			data.descriptorColorSet[0]->setUniform(data.colorUniforms.projViewOld, &cameraView.projViewOld);
 
-			data.descriptorColorSet[2]->setUniform("UBO", "view", &cameraView.view);
-			data.descriptorColorSet[2]->setUniform("UBO", "nearPlane", &cameraView.nearPlane);
-			data.descriptorColorSet[2]->setUniform("UBO", "farPlane", &cameraView.farPlane);
+			data.descriptorColorSet[2]->setUniform(data.colorUniforms.depthView, &cameraView.view);
+			data.descriptorColorSet[2]->setUniform(data.colorUniforms.nearPlane, &cameraView.nearPlane);
+			data.descriptorColorSet[2]->setUniform(data.colorUniforms.farPlane, &cameraView.farPlane);
 
-			data.descriptorAnimSet[0]->setUniform("UniformBufferObject", "projView", &cameraView.projView);
-			data.descriptorAnimSet[0]->setUniform("UniformBufferObject", "view", &cameraView.view);
-			data.descriptorAnimSet[0]->setUniform("UniformBufferObject", "projViewOld", &cameraView.projViewOld);
+			data.descriptorAnimSet[0]->setUniform(data.animUniforms.projView, &cameraView.projView);
+			data.descriptorAnimSet[0]->setUniform(data.animUniforms.view, &cameraView.view);
+			data.descriptorAnimSet[0]->setUniform(data.animUniforms.projViewOld, &cameraView.projViewOld);
 
-			data.descriptorAnimSet[2]->setUniform("UBO", "view", &cameraView.view);
-			data.descriptorAnimSet[2]->setUniform("UBO", "nearPlane", &cameraView.nearPlane);
-			data.descriptorAnimSet[2]->setUniform("UBO", "farPlane", &cameraView.farPlane);
+			data.descriptorAnimSet[2]->setUniform(data.animUniforms.depthView, &cameraView.view);
+			data.descriptorAnimSet[2]->setUniform(data.animUniforms.nearPlane, &cameraView.nearPlane);
+			data.descriptorAnimSet[2]->setUniform(data.animUniforms.farPlane, &cameraView.farPlane);
 
+			if (data.materialTable != nullptr)
+			{
+				data.descriptorBindlessSet[0]->setUniform(data.bindlessUniforms.projView, &cameraView.projView);
+				data.descriptorBindlessSet[0]->setUniform(data.bindlessUniforms.view, &cameraView.view);
+				data.descriptorBindlessSet[0]->setUniform(data.bindlessUniforms.projViewOld, &cameraView.projViewOld);
+
+				data.descriptorBindlessSet[2]->setUniform(data.bindlessUniforms.depthView, &cameraView.view);
+				data.descriptorBindlessSet[2]->setUniform(data.bindlessUniforms.nearPlane, &cameraView.nearPlane);
+				data.descriptorBindlessSet[2]->setUniform(data.bindlessUniforms.farPlane, &cameraView.farPlane);
+				data.materialTable->beginFrame();
+			}
 
 			component::Light *directionaLight = nullptr;
 
@@ -186,34 +319,36 @@ namespace maple
 			//auto cubeMapMipLevels = envData->environmentMap ? envData->environmentMap->getMipMapLevels() - 1 : 0;
 			int32_t renderMode = 0;
 			auto cameraPos = glm::vec4{cameraView.cameraTransform->getWorldPosition(), 1.f};
-			data.descriptorLightSet[0]->setUniform("UniformBufferLight", "lights", lights, sizeof(component::LightData) * numLights, false);
-			data.descriptorLightSet[0]->setUniform("UniformBufferLight", "cameraPosition", &cameraPos);
-			data.descriptorLightSet[0]->setUniform("UniformBufferLight", "viewMatrix", &cameraView.view);
-			data.descriptorLightSet[0]->setUniform("UniformBufferLight", "lightView", &lightView);
-			data.descriptorLightSet[0]->setUniform("UniformBufferLight", "shadowTransform", shadowTransforms);
-			data.descriptorLightSet[0]->setUniform("UniformBufferLight", "splitDepths", splitDepth);
-			data.descriptorLightSet[0]->setUniform("UniformBufferLight", "biasMat", &BIAS_MATRIX);
-			data.descriptorLightSet[0]->setUniform("UniformBufferLight", "shadowMapSize", &shadowData.shadowMapSize);
-			data.descriptorLightSet[0]->setUniform("UniformBufferLight", "shadowFade", &shadowData.shadowFade);
-			data.descriptorLightSet[0]->setUniform("UniformBufferLight", "cascadeTransitionFade", &shadowData.cascadeTransitionFade);
-			data.descriptorLightSet[0]->setUniform("UniformBufferLight", "maxShadowDistance", &shadowData.maxShadowDistance);
-			data.descriptorLightSet[0]->setUniform("UniformBufferLight", "initialBias", &shadowData.initialBias);
-			data.descriptorLightSet[0]->setUniform("UniformBufferLight", "lightCount", &numLights);
-			data.descriptorLightSet[0]->setUniform("UniformBufferLight", "shadowCount", &numShadows);
-			data.descriptorLightSet[0]->setUniform("UniformBufferLight", "mode", &renderMode);
+			data.descriptorLightSet[0]->setUniform(data.lightUniforms.lights, lights, sizeof(component::LightData) * numLights);
+			data.descriptorLightSet[0]->setUniform(data.lightUniforms.cameraPosition, &cameraPos);
+			data.descriptorLightSet[0]->setUniform(data.lightUniforms.viewMatrix, &cameraView.view);
+			const auto reconstruction = GBuffer::getReconstruction(cameraView.projView);
+			data.descriptorLightSet[0]->setUniform(data.lightUniforms.reconstruction, &reconstruction);
+			data.descriptorLightSet[0]->setUniform(data.lightUniforms.lightView, &lightView);
+			data.descriptorLightSet[0]->setUniform(data.lightUniforms.shadowTransform, shadowTransforms);
+			data.descriptorLightSet[0]->setUniform(data.lightUniforms.splitDepths, splitDepth);
+			data.descriptorLightSet[0]->setUniform(data.lightUniforms.biasMat, &BIAS_MATRIX);
+			data.descriptorLightSet[0]->setUniform(data.lightUniforms.shadowMapSize, &shadowData.shadowMapSize);
+			data.descriptorLightSet[0]->setUniform(data.lightUniforms.shadowFade, &shadowData.shadowFade);
+			data.descriptorLightSet[0]->setUniform(data.lightUniforms.cascadeTransitionFade, &shadowData.cascadeTransitionFade);
+			data.descriptorLightSet[0]->setUniform(data.lightUniforms.maxShadowDistance, &shadowData.maxShadowDistance);
+			data.descriptorLightSet[0]->setUniform(data.lightUniforms.initialBias, &shadowData.initialBias);
+			data.descriptorLightSet[0]->setUniform(data.lightUniforms.lightCount, &numLights);
+			data.descriptorLightSet[0]->setUniform(data.lightUniforms.shadowCount, &numShadows);
+			data.descriptorLightSet[0]->setUniform(data.lightUniforms.mode, &renderMode);
 
 			if (entity.hasComponent<component::LPVGrid>()) 
 			{
 				auto & lpvData = entity.getComponent< component::LPVGrid>();
-				data.descriptorLightSet[0]->setUniform("UniformBufferLight", "indirectLightAttenuation", &lpvData.indirectLightAttenuation);
+				data.descriptorLightSet[0]->setUniform(data.lightUniforms.indirectLightAttenuation, &lpvData.indirectLightAttenuation);
 			}
 
 			if (directionaLight != nullptr) 
 			{
 				int32_t enableIndirect = directionaLight->enableLPV ? 1 : 0;
-				data.descriptorLightSet[0]->setUniform("UniformBufferLight", "enableIndirectLight", &enableIndirect);
+				data.descriptorLightSet[0]->setUniform(data.lightUniforms.enableIndirectLight, &enableIndirect);
 				int32_t enableShadow = directionaLight->castShadow ? 1 : 0;
-				data.descriptorLightSet[0]->setUniform("UniformBufferLight", "enableShadow", &enableShadow);
+				data.descriptorLightSet[0]->setUniform(data.lightUniforms.enableShadow, &enableShadow);
 			}
 
 			data.descriptorLightSet[0]->setTexture("uPreintegratedFG", data.preintegratedFG);
@@ -227,161 +362,171 @@ namespace maple
 				if (evnData.getPrefilteredEnvironment() != nullptr)
 				{
 					int32_t cubeMapMipLevels = evnData.getPrefilteredEnvironment()->getMipMapLevels() - 1;
-					data.descriptorLightSet[0]->setUniform("UniformBufferLight", "cubeMapMipLevels", &cubeMapMipLevels);
+					data.descriptorLightSet[0]->setUniform(data.lightUniforms.cubeMapMipLevels, &cubeMapMipLevels);
 				}
 	
 			}
 
 			int32_t ssaoEnable = ssao.enable ? 1 : 0;
-			data.descriptorLightSet[0]->setUniform("UniformBufferLight", "ssaoEnable", &ssaoEnable);
+			data.descriptorLightSet[0]->setUniform(data.lightUniforms.ssaoEnable, &ssaoEnable);
 			
 
 
-			PipelineInfo pipelineInfo{};
-			pipelineInfo.shader = data.deferredColorShader;
-			pipelineInfo.polygonMode = PolygonMode::Fill;
-			pipelineInfo.blendMode = BlendMode::SrcAlphaOneMinusSrcAlpha;
-			pipelineInfo.clearTargets = false;
-			pipelineInfo.swapChainTarget = false;
+			auto pipelineInfo = getColorPipelineInfo(data, renderData.gbuffer);
 
-			std::unordered_map<entt::entity, std::shared_ptr<glm::mat4[]>> boneTransform;
+			auto getBindlessShader = [&](const Mesh *mesh) {
+				return mesh->isCompact() ? data.deferredColorBindlessCompactShader : data.deferredColorBindlessShader;
+			};
+
+			auto getColorShader = [&](const Mesh *mesh, bool skinned, bool bindless) {
+				if (bindless)
+					return getBindlessShader(mesh);
+				if (mesh->isCompact())
+					return skinned ? data.deferredColorAnimCompactShader : data.deferredColorCompactShader;
+				return skinned ? data.deferredColorAnimShader : data.deferredColorShader;
+			};
+
+			//pixels covered by one unit at distance 1, orthographic cameras do not scale with the distance.
+			const bool  perspective   = cameraView.proj[2][3] != 0.f;
+			const float pixelsPerUnit = std::abs(cameraView.proj[1][1]) * renderData.gbuffer->getHeight() * 0.5f;
+
+			auto selectLod = [&](const Mesh *mesh, const glm::mat4 &worldTransform) -> uint32_t {
+				if (mesh->getLodCount() <= 1 || data.lodBias <= 0.f || mesh->getBoundingBox() == nullptr)
+					return 0;
+				auto &     box    = mesh->getBoundingBox();
+				const auto scale  = std::max(glm::length(glm::vec3(worldTransform[0])), std::max(glm::length(glm::vec3(worldTransform[1])), glm::length(glm::vec3(worldTransform[2]))));
+				const auto center = glm::vec3(worldTransform * glm::vec4(box->center(), 1.f));
+				const auto radius = glm::length(box->size()) * 0.5f * scale;
+				//the closest point of the bounds decides, a large mesh is not simplified while the camera is next to it.
+				const auto distance = perspective ? std::max(glm::length(center - glm::vec3(cameraPos)) - radius, cameraView.nearPlane) : 1.f;
+				return mesh->selectLod(data.lodBias * distance / (pixelsPerUnit * std::max(scale, 0.0001f)));
+			};
 
 			auto forEachMesh = [&](const glm::mat4 & worldTransform, std::shared_ptr<Mesh> mesh, bool hasStencil, component::SkinnedMeshRenderer * skinnedMesh, maple::Entity parent)
 			{
-				//culling
-				auto bb = mesh->getBoundingBox()->transform(worldTransform);
+				auto& cmd = data.commandQueue.emplace_back();
+				cmd.mesh = mesh.get();
+				cmd.transform = worldTransform;
+				cmd.lod = selectLod(mesh.get(), worldTransform);
 
-				auto inside = cameraView.frustum.isInside(bb);
-
-				if (inside)
+				if (skinnedMesh) 
 				{
-					auto& cmd = data.commandQueue.emplace_back();
-					cmd.mesh = mesh.get();
-					cmd.transform = worldTransform;
-
-					if (skinnedMesh) 
-					{
-						if (boneTransform[parent.getHandle()] != nullptr)//same parent 
-						{
-							cmd.boneTransforms = boneTransform[parent.getHandle()];
-						}
-						else
-						{
-							auto ptr = std::shared_ptr <glm::mat4[]>(new glm::mat4[100]);
-
-							for (auto boneEntity : boneQuery)
-							{
-								auto ent = boneQuery.convert(boneEntity);
-								auto [bone, trans] = ent;
-								auto mapleEntity = ent.castTo<maple::Entity>();
-								if (mapleEntity.isParent(parent)) 
-								{
-									ptr[bone.boneIndex] = trans.getWorldMatrix() * trans.getOffsetMatrix();
-								}
-							}
-
-							/*for (auto child : parent.getChildren())
-							{
-								if (child.hasComponent<component::BoneComponent>())
-								{
-									auto& bone = child.getComponent<component::BoneComponent>();
-									auto& transform = child.getComponent<component::Transform>();
-									ptr[bone.boneIndex] = transform.getWorldMatrix() * transform.getOffsetMatrix();
-								}
-							}*/
-							cmd.boneTransforms = ptr;
-							boneTransform[parent.getHandle()] = ptr;
-						}
-					}
+					//the palette is computed once per skeleton before the passes start.
+					cmd.boneTransforms = palette.get(parent.getHandle());
+				}
 
-					if (mesh->getSubMeshCount() <= 1)
-					{
-						cmd.material = !mesh->getMaterial().empty() ? mesh->getMaterial()[0].get() : data.defaultMaterial.get();
-						if (skinnedMesh)
-						{
-							cmd.material->setShader(data.deferredColorAnimShader);
-						}
-						cmd.material->bind();
-					}
-					else
+				if (mesh->getSubMeshCount() <= 1)
+				{
+					cmd.material = !mesh->getMaterial().empty() ? mesh->getMaterial()[0].get() : data.defaultMaterial.get();
+					if (skinnedMesh)
 					{
-						cmd.material = nullptr;
+						cmd.material->setShader(data.deferredColorAnimShader);
 					}
 
-					auto depthTest = data.depthTest;
+					//the outline pass and skinned meshes keep the per material sets.
+					if (data.bindless && data.materialTable != nullptr && !skinnedMesh && !hasStencil && getBindlessShader(mesh.get()) != nullptr)
+						cmd.materialIndex = data.materialTable->getIndex(cmd.material);
 
-					pipelineInfo.shader = skinnedMesh != nullptr ? data.deferredColorAnimShader : data.deferredColorShader;
+					if (cmd.materialIndex < 0)
+						cmd.material->bind();
+				}
+				else
+				{
+					cmd.material = nullptr;
+				}
 
-					pipelineInfo.colorTargets[0] = renderData.gbuffer->getBuffer(GBufferTextures::COLOR);
-					pipelineInfo.colorTargets[1] = renderData.gbuffer->getBuffer(GBufferTextures::POSITION);
-					pipelineInfo.colorTargets[2] = renderData.gbuffer->getBuffer(GBufferTextures::NORMALS);
-					pipelineInfo.colorTargets[3] = renderData.gbuffer->getBuffer(GBufferTextures::PBR);
-					pipelineInfo.colorTargets[4] = renderData.gbuffer->getBuffer(GBufferTextures::VIEW_POSITION);
-					pipelineInfo.colorTargets[5] = renderData.gbuffer->getBuffer(GBufferTextures::VIEW_NORMALS);
-					pipelineInfo.colorTargets[6] = renderData.gbuffer->getBuffer(GBufferTextures::VELOCITY);
+				auto depthTest = data.depthTest;
 
-					if (cmd.material != nullptr)
-					{
-						pipelineInfo.cullMode = cmd.material->isFlagOf(Material::RenderFlags::TwoSided) ? CullMode::None : CullMode::Back;
-						pipelineInfo.transparencyEnabled = cmd.material->isFlagOf(Material::RenderFlags::AlphaBlend);
-					}
-					else
-					{
-						pipelineInfo.cullMode = CullMode::Back;
-						pipelineInfo.transparencyEnabled = false;
-					}
+				pipelineInfo.shader = getColorShader(mesh.get(), skinnedMesh != nullptr, cmd.materialIndex >= 0);
 
-					if (cmd.material == nullptr || (depthTest && cmd.material->isFlagOf(Material::RenderFlags::DepthTest)))
-					{
-						pipelineInfo.depthTarget = renderData.gbuffer->getDepthBuffer();
-					}
+				if (cmd.material != nullptr)
+				{
+					pipelineInfo.cullMode = cmd.material->isFlagOf(Material::RenderFlags::TwoSided) ? CullMode::None : CullMode::Back;
+					pipelineInfo.transparencyEnabled = cmd.material->isFlagOf(Material::RenderFlags::AlphaBlend);
+				}
+				else
+				{
+					pipelineInfo.cullMode = CullMode::Back;
+					pipelineInfo.transparencyEnabled = false;
+				}
 
-					if (hasStencil)
-					{
-						pipelineInfo.shader = data.stencilShader;
-						pipelineInfo.stencilTest = true;
-						pipelineInfo.stencilMask = 0x00;
-						pipelineInfo.stencilFunc = StencilType::Notequal;
-						pipelineInfo.stencilFail = StencilType::Keep;
-						pipelineInfo.stencilDepthFail = StencilType::Keep;
-						pipelineInfo.stencilDepthPass = StencilType::Replace;
-						pipelineInfo.depthTest = true;
-						cmd.stencilPipelineInfo = pipelineInfo;
-						cmd.stencilPipelineInfo.colorTargets[0] = renderData.gbuffer->getBuffer(GBufferTextures::SCREEN);
-						cmd.stencilPipelineInfo.colorTargets[1] = nullptr;
-						cmd.stencilPipelineInfo.colorTargets[2] = nullptr;
-						cmd.stencilPipelineInfo.colorTargets[3] = nullptr;
-
-						pipelineInfo.shader = skinnedMesh != nullptr ? data.deferredColorAnimShader : data.deferredColorShader;
-						pipelineInfo.stencilMask = 0xFF;
-						pipelineInfo.stencilFunc = StencilType::Always;
-						pipelineInfo.stencilFail = StencilType::Keep;
-						pipelineInfo.stencilDepthFail = StencilType::Keep;
-						pipelineInfo.stencilDepthPass = StencilType::Replace;
-						pipelineInfo.depthTest = true;
-					}
+				if (cmd.material == nullptr || (depthTest && cmd.material->isFlagOf(Material::RenderFlags::DepthTest)))
+				{
+					pipelineInfo.depthTarget = renderData.gbuffer->getDepthBuffer();
+				}
 
-					cmd.pipelineInfo = pipelineInfo;
+				if (hasStencil)
+				{
+					pipelineInfo.shader = data.stencilShader;
+					pipelineInfo.stencilTest = true;
+					pipelineInfo.stencilMask = 0x00;
+					pipelineInfo.stencilFunc = StencilType::Notequal;
+					pipelineInfo.stencilFail = StencilType::Keep;
+					pipelineInfo.stencilDepthFail = StencilType::Keep;
+					pipelineInfo.stencilDepthPass = StencilType::Replace;
+					pipelineInfo.depthTest = true;
+					cmd.stencilPipelineInfo = pipelineInfo;
+					cmd.stencilPipelineInfo.colorTargets[0] = renderData.gbuffer->getBuffer(GBufferTextures::SCREEN);
+					cmd.stencilPipelineInfo.colorTargets[1] = nullptr;
+					cmd.stencilPipelineInfo.colorTargets[2] = nullptr;
+					cmd.stencilPipelineInfo.colorTargets[3] = nullptr;
+
+					pipelineInfo.shader = getColorShader(mesh.get(), skinnedMesh != nullptr, false);
+					pipelineInfo.stencilMask = 0xFF;
+					pipelineInfo.stencilFunc = StencilType::Always;
+					pipelineInfo.stencilFail = StencilType::Keep;
+					pipelineInfo.stencilDepthFail = StencilType::Keep;
+					pipelineInfo.stencilDepthPass = StencilType::Replace;
+					pipelineInfo.depthTest = true;
 				}
+
+				cmd.pipelineInfo = pipelineInfo;
+				//hashed here once per command, the render loop only looks the pipeline up.
+				cmd.pipelineKey = Pipeline::getKey(pipelineInfo);
 			};
 
-			for (auto entityHandle : meshQuery)
+			//culled through the scene bvh, subtrees fully inside the frustum are taken without testing each mesh.
+			auto &visible = data.visibleMeshes;
+			visible.clear();
+			culling.cull(cameraView.frustum, visible);
+
+			for (auto index : visible)
 			{
-				auto [mesh, trans] = meshQuery.convert(entityHandle);
+				//drawn by gpu_culling::drawIndirect.
+				if (gpuCulling.isHandled(index))
+					continue;
+
+				auto entityHandle = culling.entities[index];
+				if (!culling.skinned[index])
 				{
+					auto [mesh, trans] = meshQuery.convert(entityHandle);
 					const auto& worldTransform = trans.getWorldMatrix();
 					forEachMesh(worldTransform, mesh.getMesh(), meshQuery.hasComponent<component::StencilComponent>(entityHandle), nullptr, {});
 				}
+				else
+				{
+					auto entity = skinnedMeshQuery.convert(entityHandle);
+					auto [mesh, trans] = entity;
+					auto mapleEntity = entity.castTo<maple::Entity>();
+					const auto& worldTransform = trans.getWorldMatrix();
+					forEachMesh(worldTransform, mesh.getMesh(), skinnedMeshQuery.hasComponent<component::StencilComponent>(entityHandle), &mesh, mapleEntity.getParent());
+				}
 			}
 
-			for (auto entityHandle : skinnedMeshQuery)
+			const uint32_t maxInstances = data.instancing && data.instancingSupported ? component::DeferredData::MAX_INSTANCES : 0;
+			data.renderQueue.build(data.commandQueue, cameraView.view, cameraView.nearPlane, cameraView.farPlane, maxInstances);
+
+			auto &instanceTransforms = data.renderQueue.getInstanceTransforms();
+			if (!instanceTransforms.empty())
 			{
-				auto entity = skinnedMeshQuery.convert(entityHandle);
-				auto [mesh, trans] = entity;
-				auto mapleEntity = entity.castTo<maple::Entity>();
+				data.descriptorColorSet[0]->setUniform(data.instanceTransforms, instanceTransforms.data(), static_cast<uint32_t>(sizeof(glm::mat4) * instanceTransforms.size()));
+
+				//bindless draws take their slots out of the same buffer.
+				if (data.materialTable != nullptr)
 				{
-					const auto& worldTransform = trans.getWorldMatrix();
-					forEachMesh(worldTransform, mesh.getMesh(), skinnedMeshQuery.hasComponent<component::StencilComponent>(entityHandle), &mesh, mapleEntity.getParent());
+					auto &instanceMaterials = data.renderQueue.getInstanceMaterials();
+					data.descriptorBindlessSet[0]->setUniform(data.bindlessInstanceTransforms, instanceTransforms.data(), static_cast<uint32_t>(sizeof(glm::mat4) * instanceTransforms.size()));
+					data.descriptorBindlessSet[0]->setUniform(data.bindlessInstanceMaterials, instanceMaterials.data(), static_cast<uint32_t>(sizeof(uint32_t) * instanceMaterials.size()));
 				}
 			}
 		}
@@ -393,130 +538,241 @@ namespace maple
 			::Read<component::RendererData>
 			::Read<component::SSAOData>
 			::Write<capture_graph::component::RenderGraph>
+			::Read<component::GPUCullingData>
 			::To<ecs::Entity>;
 
-		inline auto onRender(RenderEntity entity, ecs::World world)
+		//records the draws [from, to) of one pipeline run into the given buffer.
+		inline auto recordDraws(component::DeferredData &data, Pipeline *pipeline, CommandBuffer *commandBuffer, size_t from, size_t to) -> void
 		{
-			auto [data, shadowData, cameraView, renderData,ssao,graph] = entity;
-
-			data.descriptorColorSet[0]->update();
-			data.descriptorColorSet[2]->update();
-
-			data.descriptorAnimSet[0]->update();
-			data.descriptorAnimSet[2]->update();
-
-			data.stencilDescriptorSet->update();
-
-			std::shared_ptr<Pipeline> pipeline;
-
-			for (auto& command : data.commandQueue)
+			auto &draws  = data.renderQueue.getDraws();
+			auto &shader = data.commandQueue[draws[from].command].pipelineInfo.shader;
+
+			//chunks are recorded at the same time, each one works on copies of the push constants and color sets.
+			//a run has one shader, either every command of it is bindless or none is.
+			const bool bindless      = data.commandQueue[draws[from].command].materialIndex >= 0;
+			auto       pushConstants = shader->getPushConstants();
+			auto       colorSets     = bindless ? data.descriptorBindlessSet : data.descriptorColorSet;
+			Material * boundMaterial = nullptr;
+			bool       setsBound     = false;
+
+			//only the material changes inside a run, the sets are bound again when it does.
+			for (auto index = from; index < to; index++)
 			{
-				pipeline = Pipeline::get(command.pipelineInfo);
-
-				if (renderData.commandBuffer)
-					renderData.commandBuffer->bindPipeline(pipeline.get());
-				else
-					pipeline->bind(renderData.commandBuffer);
-
-				auto shader = command.boneTransforms != nullptr ?
-					data.deferredColorAnimShader : data.deferredColorShader;
-
-				auto& pushConstants = shader->getPushConstants()[0];
+				auto &draw    = draws[index];
+				auto &command = data.commandQueue[draw.command];
 
 				if (command.boneTransforms != nullptr)
 				{
-					data.descriptorAnimSet[0]->setUniform("UniformBufferObject", "boneTransforms", command.boneTransforms.get());
+					data.descriptorAnimSet[0]->setUniform(data.boneTransforms, command.boneTransforms);
 					data.descriptorAnimSet[0]->update();
 				}
 
-				pushConstants.setValue("transform", &command.transform);
-				shader->bindPushConstants(renderData.commandBuffer, pipeline.get());
-			
+				const int32_t instanceOffset = draw.instanceCount > 1 ? static_cast<int32_t>(draw.instanceOffset) : -1;
+				pushConstants[0].setValue("transform", &command.transform);
+				pushConstants[0].setValue("instanceOffset", &instanceOffset);
+				pushConstants[0].setValue("positionScale", &command.mesh->getPositionScale());
+				pushConstants[0].setValue("positionOffset", &command.mesh->getPositionOffset());
+				pushConstants[0].setValue("materialIndex", &command.materialIndex);
+				shader->bindPushConstants(commandBuffer, pipeline, pushConstants);
 
 				if (command.mesh->getSubMeshCount() > 1)
 				{
 					auto& materials = command.mesh->getMaterial();
 					auto& indices = command.mesh->getSubMeshIndex();
 					auto start = 0;
-					command.mesh->getVertexBuffer()->bind(renderData.commandBuffer, pipeline.get());
-					command.mesh->getIndexBuffer()->bind(renderData.commandBuffer);
+					command.mesh->getVertexBuffer()->bind(commandBuffer, pipeline);
+					command.mesh->getIndexBuffer()->bind(commandBuffer);
 
 					for (auto i = 0; i <= indices.size(); i++)
 					{
 						auto& material = materials[i];
-						auto end = i == indices.size() ? command.mesh->getIndexBuffer()->getCount() : indices[i];
+						auto end = i == indices.size() ? command.mesh->getLod(0).indexCount : indices[i];
 						material->bind();
 
 						if (command.boneTransforms != nullptr)
 						{
 							data.descriptorAnimSet[1] = material->getDescriptorSet();
 							material->bind();
-							Renderer::bindDescriptorSets(pipeline.get(), renderData.commandBuffer, 0, data.descriptorAnimSet);
+							Renderer::bindDescriptorSets(pipeline, commandBuffer, 0, data.descriptorAnimSet);
 						}
 						else 
 						{
-							data.descriptorColorSet[1] = material->getDescriptorSet();
+							colorSets[1] = material->getDescriptorSet();
 							material->bind();
-							Renderer::bindDescriptorSets(pipeline.get(), renderData.commandBuffer, 0, data.descriptorColorSet);
+							Renderer::bindDescriptorSets(pipeline, commandBuffer, 0, colorSets);
 						}
 
-						Renderer::drawIndexed(renderData.commandBuffer, DrawType::Triangle, end - start, start);
+						Renderer::drawIndexed(commandBuffer, DrawType::Triangle, end - start, command.mesh->getFirstIndex() + start, command.mesh->getVertexOffset());
 
 						start = end;
 					}
 
 					command.mesh->getVertexBuffer()->unbind();
 					command.mesh->getIndexBuffer()->unbind();
+					boundMaterial = nullptr;
 				}
 				else
 				{
-
 					if (command.boneTransforms != nullptr)
 					{
 						data.descriptorAnimSet[1] = command.material->getDescriptorSet();
-						Renderer::bindDescriptorSets(pipeline.get(), renderData.commandBuffer, 0, data.descriptorAnimSet);
+						Renderer::bindDescriptorSets(pipeline, commandBuffer, 0, data.descriptorAnimSet);
+						boundMaterial = nullptr;
 					}
-					else
+					else if (bindless)
 					{
-						data.descriptorColorSet[1] = command.material->getDescriptorSet();
-						Renderer::bindDescriptorSets(pipeline.get(), renderData.commandBuffer, 0, data.descriptorColorSet);
+						//the material comes from the push constants or the instance buffer, the sets never change.
+						if (!setsBound)
+							Renderer::bindDescriptorSets(pipeline, commandBuffer, 0, colorSets);
+						setsBound = true;
+					}
+					else if (command.material != boundMaterial)
+					{
+						colorSets[1] = command.material->getDescriptorSet();
+						Renderer::bindDescriptorSets(pipeline, commandBuffer, 0, colorSets);
+						boundMaterial = command.material;
 					}
 
-					Renderer::drawMesh(renderData.commandBuffer, pipeline.get(), command.mesh);
+					if (draw.instanceCount > 1)
+						Renderer::drawMeshInstanced(commandBuffer, pipeline, command.mesh, draw.instanceCount, command.lod);
+					else
+						Renderer::drawMesh(commandBuffer, pipeline, command.mesh, command.lod);
 				}
-				/*if (command.stencilPipelineInfo.stencilTest)
+			}
+		}
+
+		inline auto onRender(RenderEntity entity, ecs::World world)
+		{
+			auto [data, shadowData, cameraView, renderData,ssao,graph,gpuCulling] = entity;
+
+			data.descriptorColorSet[0]->update();
+			data.descriptorColorSet[2]->update();
+
+			data.descriptorAnimSet[0]->update();
+			data.descriptorAnimSet[2]->update();
+
+			data.stencilDescriptorSet->update();
+
+			if (data.materialTable != nullptr)
+			{
+				data.descriptorBindlessSet[0]->update();
+				data.descriptorBindlessSet[2]->update();
+				data.materialTable->update();
+			}
+
+			auto &draws = data.renderQueue.getDraws();
+
+			//draws come sorted by pipeline and material, every run of one pipeline is a pass recorded in chunks on the workers.
+			for (size_t runBegin = 0; runBegin < draws.size();)
+			{
+				auto &first    = data.commandQueue[draws[runBegin].command];
+				auto  pipeline = Pipeline::get(first.pipelineInfo, first.pipelineKey);
+
+				//every draw writes the same targets, the first one stands for the pass in the graph.
+				if (runBegin == 0)
+					capture_graph::addPass(graph, first.pipelineInfo, data.descriptorColorSet);
+
+				//skinned and multi material meshes change shared descriptor sets per draw, their runs are recorded by one thread.
+				size_t runEnd = runBegin;
+				bool   serial = false;
+				for (; runEnd < draws.size() && draws[runEnd].pipelineHash == draws[runBegin].pipelineHash; runEnd++)
 				{
-					auto stencilPipeline = Pipeline::get(command.stencilPipelineInfo);
+					auto &command = data.commandQueue[draws[runEnd].command];
+					serial |= command.boneTransforms != nullptr || command.mesh->getSubMeshCount() > 1;
+				}
 
-					if (renderData.commandBuffer)
-						renderData.commandBuffer->bindPipeline(stencilPipeline.get());
-					else
-						stencilPipeline->bind(renderData.commandBuffer);
+				const auto count = static_cast<uint32_t>(runEnd - runBegin);
+				Renderer::drawParallel(renderData.commandBuffer, pipeline.get(), 0, count, serial ? count : Renderer::DRAWS_PER_CHUNK, [&, runBegin](CommandBuffer *commandBuffer, uint32_t begin, uint32_t end) {
+					recordDraws(data, pipeline.get(), commandBuffer, runBegin + begin, runBegin + end);
+				});
 
-					auto& pushConstants = data.stencilShader->getPushConstants()[0];
-					pushConstants.setValue("transform", &command.transform);
-					data.stencilShader->bindPushConstants(renderData.commandBuffer, stencilPipeline.get());
+				runBegin = runEnd;
+			}
 
-					Renderer::bindDescriptorSets(stencilPipeline.get(), renderData.commandBuffer, 0, { data.stencilDescriptorSet });
-					Renderer::drawMesh(renderData.commandBuffer, stencilPipeline.get(), command.mesh);
+			//static meshes culled on the gpu, one indirect draw per vertex layout on top of the cpu draws.
+			if (gpuCulling.active)
+			{
+				auto pipelineInfo                = getColorPipelineInfo(data, renderData.gbuffer);
+				pipelineInfo.cullMode            = CullMode::Back;
+				pipelineInfo.transparencyEnabled = false;
+				if (data.depthTest)
+					pipelineInfo.depthTarget = renderData.gbuffer->getDepthBuffer();
 
-					if (renderData.commandBuffer)
-						renderData.commandBuffer->unbindPipeline();
-					else
-						stencilPipeline->end(renderData.commandBuffer);
-				}*/
+				const std::vector<std::shared_ptr<DescriptorSet>> sets = {gpuCulling.colorSet[0], data.descriptorBindlessSet[1], data.descriptorBindlessSet[2]};
+
+				for (uint32_t format = 0; format < component::GPUCullingData::FORMATS; format++)
+				{
+					pipelineInfo.shader = gpuCulling.colorShaders[format];
+					if (pipelineInfo.shader == nullptr)
+						continue;
+
+					auto pipeline = Pipeline::get(pipelineInfo, sets, graph);
+					pipeline->bind(renderData.commandBuffer);
+					Renderer::bindDescriptorSets(pipeline.get(), renderData.commandBuffer, 0, sets);
+					gpu_culling::drawIndirect(gpuCulling, renderData.commandBuffer, pipeline.get(), 0, static_cast<VertexFormat>(format));
+					pipeline->end(renderData.commandBuffer);
+				}
+			}
+		}
+
+		using PrewarmEntity = ecs::Chain
+			::Write<component::DeferredData>
+			::Read<component::RendererData>
+			::To<ecs::Entity>;
+
+		//compiles every permutation a mesh may ask the G-buffer pass for in one parallel batch, at startup and whenever the
+		//targets get new storage (resize, aliasing), instead of one stall per new permutation while playing.
+		inline auto prewarm(PrewarmEntity entity, ecs::World world)
+		{
+			auto [data, renderData] = entity;
+
+			if (data.prewarmedVersion == Texture::getTargetVersion() || renderData.gbuffer == nullptr)
+				return;
+
+			const auto base = getColorPipelineInfo(data, renderData.gbuffer);
+
+			std::vector<PipelineInfo> infos;
+			for (auto &shader : {data.deferredColorShader, data.deferredColorAnimShader, data.deferredColorCompactShader, data.deferredColorAnimCompactShader, data.deferredColorBindlessShader, data.deferredColorBindlessCompactShader})
+			{
+				if (shader == nullptr)
+					continue;
+
+				//same choices as beginScene : two sided, alpha blended and depth tested materials.
+				for (uint32_t permutation = 0; permutation < 8; permutation++)
+				{
+					auto &info               = infos.emplace_back(base);
+					info.shader              = shader;
+					info.cullMode            = (permutation & 1) ? CullMode::None : CullMode::Back;
+					info.transparencyEnabled = (permutation & 2) != 0;
+					info.depthTarget         = (permutation & 4) ? renderData.gbuffer->getDepthBuffer() : nullptr;
+				}
 			}
 
-			if (renderData.commandBuffer)
-				renderData.commandBuffer->unbindPipeline();
-			else if (pipeline)
-				pipeline->end(renderData.commandBuffer);
+			Pipeline::prewarm(infos);
+			data.prewarmedVersion = Texture::getTargetVersion();
 		}
 
 		auto registerDeferredOffScreenRenderer(ExecuteQueue &begin, ExecuteQueue &renderer, std::shared_ptr<ExecutePoint> executePoint) -> void
 		{
 			executePoint->registerGlobalComponent<component::DeferredData>();
+
+			const std::string layout = GBuffer::isCompactLayoutEnabled() ? "Packed" : "";
+			executePoint->registerShaders({
+			    "shaders/DeferredColor" + layout + ".shader",
+			    "shaders/DeferredColorAnim" + layout + ".shader",
+			    "shaders/Outline.shader",
+			});
+			if (Mesh::isCompactVertexSupported())
+				executePoint->registerShaders({"shaders/DeferredColorCompact" + layout + ".shader", "shaders/DeferredColorAnimCompact" + layout + ".shader"});
+			if (component::DeferredData::isBindlessSupported())
+			{
+				executePoint->registerShaders({"shaders/DeferredColorBindless" + layout + ".shader"});
+				if (Mesh::isCompactVertexSupported() && File::fileExists("shaders/spv/DeferredColorBindlessCompact.vert.spv"))
+					executePoint->registerShaders({"shaders/DeferredColorBindlessCompact" + layout + ".shader"});
+			}
+
 			executePoint->registerWithinQueue<deferred_offscreen::beginScene>(begin);
+			executePoint->registerWithinQueue<deferred_offscreen::prewarm>(renderer);
 			executePoint->registerWithinQueue<deferred_offscreen::onRender>(renderer);
 		}
 	}        // namespace deferred_offscreen
@@ -541,7 +797,8 @@ namespace maple
 
 			auto descriptorSet = data.descriptorLightSet[0];
 			descriptorSet->setTexture("uColorSampler", rendererData.gbuffer->getBuffer(GBufferTextures::COLOR));
-			descriptorSet->setTexture("uPositionSampler", rendererData.gbuffer->getBuffer(GBufferTextures::POSITION));
+			if (!rendererData.gbuffer->isCompact())
+				descriptorSet->setTexture("uPositionSampler", rendererData.gbuffer->getBuffer(GBufferTextures::POSITION));
 			descriptorSet->setTexture("uNormalSampler", rendererData.gbuffer->getBuffer(GBufferTextures::NORMALS));
 
 			//descriptorSet->setTexture("uViewPositionSampler", gBuffer->getBuffer(GBufferTextures::VIEW_POSITION));
@@ -580,6 +837,7 @@ namespace maple
 		auto registerDeferredLighting(ExecuteQueue& begin, ExecuteQueue& renderer, std::shared_ptr<ExecutePoint> executePoint) -> void
 		{
 			executePoint->registerGlobalComponent<component::DeferredData>();
+			executePoint->registerShaders({GBuffer::isCompactLayoutEnabled() ? "shaders/DeferredLightPacked.shader" : "shaders/DeferredLight.shader"});
 			executePoint->registerWithinQueue<deferred_lighting::onRender>(renderer);
 		}
 	};
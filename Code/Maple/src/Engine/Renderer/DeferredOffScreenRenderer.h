@@ -3,7 +3,9 @@
 //////////////////////////////////////////////////////////////////////////////
 #pragma once
 
+#include "MaterialTable.h"
 #include "Renderer.h"
+#include "RenderQueue.h"
 
 #include "Engine/Material.h"
 #include "Engine/Mesh.h"
@@ -21,25 +23,94 @@ namespace maple
 	{
 		struct DeferredData
 		{
+			//capacity of the per frame instance buffer declared by DeferredColor.vert.
+			static constexpr uint32_t MAX_INSTANCES = 256;
+
 			std::vector<RenderCommand>                  commandQueue;
+			RenderQueue                                 renderQueue;
+			std::vector<uint32_t>                       visibleMeshes;
 			std::shared_ptr<Material>                   defaultMaterial;
 			std::vector<std::shared_ptr<DescriptorSet>> descriptorColorSet;
 			std::vector<std::shared_ptr<DescriptorSet>> descriptorLightSet;
 			std::vector<std::shared_ptr<DescriptorSet>>	descriptorAnimSet;
+			std::vector<std::shared_ptr<DescriptorSet>> descriptorBindlessSet;        //[1] is the set of the material table
 
 			std::shared_ptr<Texture2D> preintegratedFG;
 			std::shared_ptr<Shader> deferredColorShader;        //stage 0 get all color information
 			std::shared_ptr<Shader> deferredColorAnimShader;   
+			std::shared_ptr<Shader> deferredColorCompactShader;        //meshes in the compact vertex layout, null if it is not compiled
+			std::shared_ptr<Shader> deferredColorAnimCompactShader;
+			std::shared_ptr<Shader> deferredColorBindlessShader;               //null without bindless support or if it is not compiled
+			std::shared_ptr<Shader> deferredColorBindlessCompactShader;
 			std::shared_ptr<Shader> deferredLightShader;        //stage 1 process lighting
 			std::shared_ptr<Shader> stencilShader;
 
 			std::shared_ptr<DescriptorSet> stencilDescriptorSet;
+			std::shared_ptr<MaterialTable> materialTable;
 
 			std::shared_ptr<Mesh>     screenQuad;
 
+			//per frame uniforms, resolved once in the constructor.
+			struct CameraUniforms
+			{
+				UniformHandle projView;
+				UniformHandle view;
+				UniformHandle projViewOld;
+				UniformHandle depthView;
+				UniformHandle nearPlane;
+				UniformHandle farPlane;
+			};
+
+			struct LightUniforms
+			{
+				UniformHandle lights;
+				UniformHandle cameraPosition;
+				UniformHandle viewMatrix;
+				UniformHandle lightView;
+				UniformHandle shadowTransform;
+				UniformHandle splitDepths;
+				UniformHandle biasMat;
+				UniformHandle shadowMapSize;
+				UniformHandle shadowFade;
+				UniformHandle cascadeTransitionFade;
+				UniformHandle maxShadowDistance;
+				UniformHandle initialBias;
+				UniformHandle lightCount;
+				UniformHandle shadowCount;
+				UniformHandle mode;
+				UniformHandle indirectLightAttenuation;
+				UniformHandle enableIndirectLight;
+				UniformHandle enableShadow;
+				UniformHandle cubeMapMipLevels;
+				UniformHandle ssaoEnable;
+				UniformHandle reconstruction;
+			};
+
+			CameraUniforms colorUniforms;
+			CameraUniforms animUniforms;
+			CameraUniforms bindlessUniforms;
+			LightUniforms  lightUniforms;
+			UniformHandle  stencilProjView;
+			UniformHandle  instanceTransforms;
+			UniformHandle  boneTransforms;
+			UniformHandle  bindlessInstanceTransforms;
+			UniformHandle  bindlessInstanceMaterials;
+
 			bool depthTest = true;
+			bool instancing = true;
+			//false when the compiled color shader has no instance buffer, commands are still sorted.
+			bool instancingSupported = false;
+			//single material meshes read their material from the MaterialTable, when the bindless shaders exist.
+			bool bindless = true;
+			//screen space error in pixels a lod may have, 0 always draws the full meshes.
+			float lodBias = 1.f;
+			//Texture::getTargetVersion the G-buffer pipelines were last prewarmed for.
+			uint32_t prewarmedVersion = UINT32_MAX;
 
 			DeferredData();
+
+			//the backend supports bindless textures and the bindless variants of the color shader are compiled.
+			static auto isBindlessSupported() -> bool;
 		};
 	}        // namespace component
 
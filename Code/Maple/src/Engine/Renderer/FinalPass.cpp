@@ -38,16 +38,16 @@ namespace maple
 			auto [finalData, renderData,graph] = entity;
 			float gamma = 2.2;
 
-			finalData.finalDescriptorSet->setUniform("UniformBuffer", "gamma", &gamma);
-			finalData.finalDescriptorSet->setUniform("UniformBuffer", "toneMapIndex", &finalData.toneMapIndex);
-			finalData.finalDescriptorSet->setUniform("UniformBuffer", "exposure", &finalData.exposure);
+			finalData.finalDescriptorSet->setUniform(finalData.uniforms.gamma, &gamma);
+			finalData.finalDescriptorSet->setUniform(finalData.uniforms.toneMapIndex, &finalData.toneMapIndex);
+			finalData.finalDescriptorSet->setUniform(finalData.uniforms.exposure, &finalData.exposure);
 			auto ssaoEnable = 0;
 			auto reflectEnable = 0;
 			auto cloudEnable = false;// envData->cloud ? 1 : 0;
 
-			finalData.finalDescriptorSet->setUniform("UniformBuffer", "ssaoEnable", &ssaoEnable);
-			finalData.finalDescriptorSet->setUniform("UniformBuffer", "reflectEnable", &reflectEnable);
-			finalData.finalDescriptorSet->setUniform("UniformBuffer", "cloudEnable", &cloudEnable);
+			finalData.finalDescriptorSet->setUniform(finalData.uniforms.ssaoEnable, &ssaoEnable);
+			finalData.finalDescriptorSet->setUniform(finalData.uniforms.reflectEnable, &reflectEnable);
+			finalData.finalDescriptorSet->setUniform(finalData.uniforms.cloudEnable, &cloudEnable);
 
 			finalData.finalDescriptorSet->setTexture("uScreenSampler", renderData.gbuffer->getBuffer(GBufferTextures::SCREEN));
 			finalData.finalDescriptorSet->setTexture("uReflectionSampler", renderData.gbuffer->getBuffer(GBufferTextures::SSR_SCREEN));
@@ -81,6 +81,7 @@ namespace maple
 		auto registerFinalPass(ExecuteQueue& renderer, std::shared_ptr<ExecutePoint> executePoint) -> void
 		{
 			executePoint->registerGlobalComponent<component::FinalPass>();
+			executePoint->registerShaders({"shaders/ScreenPass.shader"});
 			executePoint->registerWithinQueue<final_screen_pass::system>(renderer);
 		}
 	};
@@ -92,6 +93,13 @@ namespace maple
 		descriptorInfo.layoutIndex = 0;
 		descriptorInfo.shader = finalShader.get();
 		finalDescriptorSet = DescriptorSet::create(descriptorInfo);
+
+		uniforms.gamma         = finalDescriptorSet->getUniformHandle("UniformBuffer", "gamma");
+		uniforms.toneMapIndex  = finalDescriptorSet->getUniformHandle("UniformBuffer", "toneMapIndex");
+		uniforms.exposure      = finalDescriptorSet->getUniformHandle("UniformBuffer", "exposure");
+		uniforms.ssaoEnable    = finalDescriptorSet->getUniformHandle("UniformBuffer", "ssaoEnable");
+		uniforms.reflectEnable = finalDescriptorSet->getUniformHandle("UniformBuffer", "reflectEnable");
+		uniforms.cloudEnable   = finalDescriptorSet->getUniformHandle("UniformBuffer", "cloudEnable");
 	}
 
 };        // namespace maple
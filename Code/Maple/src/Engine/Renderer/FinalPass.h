@@ -5,11 +5,11 @@
 #include <memory>
 #include <IconsMaterialDesignIcons.h>
 #include "Scene/System/ExecutePoint.h"
+#include "RHI/DescriptorSet.h"
 
 namespace maple
 {
 	class Shader;
-	class DescriptorSet;
 	class Texture;
 
 	namespace component
@@ -20,6 +20,15 @@ namespace maple
 
 			std::shared_ptr<Shader>        finalShader;
 			std::shared_ptr<DescriptorSet> finalDescriptorSet;
+			struct
+			{
+				UniformHandle gamma;
+				UniformHandle toneMapIndex;
+				UniformHandle exposure;
+				UniformHandle ssaoEnable;
+				UniformHandle reflectEnable;
+				UniformHandle cloudEnable;
+			} uniforms;
 			std::shared_ptr<Texture> renderTarget;
 			float exposure = 1.0;
 			int32_t toneMapIndex = 1;
@@ -0,0 +1,354 @@
+//////////////////////////////////////////////////////////////////////////////
+// This file is part of the Maple Engine                              		//
+//////////////////////////////////////////////////////////////////////////////
+
+#include "GPUCulling.h"
+#include "DeferredOffScreenRenderer.h"
+#include "GeometryPool.h"
+#include "MaterialTable.h"
+#include "RendererData.h"
+
+#include "Engine/GBuffer.h"
+#include "Engine/Material.h"
+#include "Engine/Profiler.h"
+#include "Engine/Vientiane/ReflectiveShadowMap.h"
+#include "FileSystem/File.h"
+
+#include "RHI/GraphicsContext.h"
+#include "RHI/IndexBuffer.h"
+#include "RHI/Pipeline.h"
+#include "RHI/StorageBuffer.h"
+#include "RHI/VertexBuffer.h"
+
+#include "Scene/Component/BoundingBox.h"
+#include "Scene/Component/Component.h"
+#include "Scene/Component/MeshRenderer.h"
+#include "Scene/Component/Transform.h"
+
+#include "Application.h"
+
+#include <algorithm>
+#include <ecs/ecs.h>
+
+namespace maple
+{
+	namespace component
+	{
+		GPUCullingData::GPUCullingData()
+		{
+			if (!isSupported())
+				return;
+
+			const std::string layout = GBuffer::isCompactLayoutEnabled() ? "Packed" : "";
+
+			cullingShader                                            = Shader::create("shaders/Culling.shader");
+			colorShaders[static_cast<uint32_t>(VertexFormat::Full)]  = Shader::create("shaders/DeferredColorIndirect" + layout + ".shader");
+			shadowShaders[static_cast<uint32_t>(VertexFormat::Full)] = Shader::create("shaders/ShadowIndirect.shader");
+
+			if (Mesh::isCompactVertexSupported() && File::fileExists("shaders/spv/DeferredColorIndirectCompact.vert.spv"))
+			{
+				colorShaders[static_cast<uint32_t>(VertexFormat::Compact)]  = Shader::create("shaders/DeferredColorIndirectCompact" + layout + ".shader");
+				shadowShaders[static_cast<uint32_t>(VertexFormat::Compact)] = Shader::create("shaders/ShadowIndirectCompact.shader");
+			}
+
+			instanceBuffer = StorageBuffer::create();
+			lodBuffer      = StorageBuffer::create();
+			commandBuffer  = StorageBuffer::create();
+			countBuffer    = StorageBuffer::create();
+
+			cullingSet.emplace_back(DescriptorSet::create({0, cullingShader.get()}));
+			cullingSet[0]->setStorageBuffer("InstanceBuffer", instanceBuffer);
+			cullingSet[0]->setStorageBuffer("LodBuffer", lodBuffer);
+			cullingSet[0]->setStorageBuffer("CommandBuffer", commandBuffer);
+			cullingSet[0]->setStorageBuffer("CountBuffer", countBuffer);
+
+			//both layouts declare the same set 0, the sets of the full layout serve the compact pipelines as well.
+			colorSet.emplace_back(DescriptorSet::create({0, colorShaders[0].get()}));
+			colorSet[0]->setStorageBuffer("InstanceBuffer", instanceBuffer);
+			colorProjView    = colorSet[0]->getUniformHandle("UniformBufferObject", "projView");
+			colorView        = colorSet[0]->getUniformHandle("UniformBufferObject", "view");
+			colorProjViewOld = colorSet[0]->getUniformHandle("UniformBufferObject", "projViewOld");
+
+			shadowSet.emplace_back(DescriptorSet::create({0, shadowShaders[0].get()}));
+			shadowSet[0]->setStorageBuffer("InstanceBuffer", instanceBuffer);
+			shadowProjView = shadowSet[0]->getUniformHandle("UniformBufferObject", "projView");
+		}
+
+		auto GPUCullingData::isSupported() -> bool
+		{
+			return Application::getGeometryPool() != nullptr &&
+			       DeferredData::isBindlessSupported() &&
+			       File::fileExists("shaders/spv/Culling.comp.spv") &&
+			       File::fileExists("shaders/spv/DeferredColorIndirect.vert.spv") &&
+			       File::fileExists("shaders/spv/ShadowIndirect.vert.spv");
+		}
+	}        // namespace component
+
+	namespace gpu_culling
+	{
+		namespace gather
+		{
+			using Entity = ecs::Chain
+				::Write<component::GPUCullingData>
+				::Read<component::CullingData>
+				::Write<component::DeferredData>
+				::To<ecs::Entity>;
+
+			using MeshQuery = ecs::Chain
+				::Write<component::MeshRenderer>
+				::Write<component::Transform>
+				::ReadIfExist<component::StencilComponent>
+				::To<ecs::Query>;
+
+			//the single material the instance would be drawn with, nullptr if the mesh has to go through the cpu passes.
+			//the pipeline states of the indirect draws are fixed : culled back faces, opaque and depth tested.
+			inline auto getMaterial(const component::DeferredData &deferred, const Mesh *mesh) -> Material *
+			{
+				if (mesh->getSubMeshCount() > 1)
+					return nullptr;
+
+				auto material = !mesh->getMaterial().empty() ? mesh->getMaterial()[0].get() : deferred.defaultMaterial.get();
+				if (material == nullptr ||
+				    material->isFlagOf(Material::RenderFlags::TwoSided) ||
+				    material->isFlagOf(Material::RenderFlags::AlphaBlend) ||
+				    !material->isFlagOf(Material::RenderFlags::DepthTest))
+					return nullptr;
+				return material;
+			}
+
+			inline auto isEligible(const component::GPUCullingData &data, const component::CullingData &culling, uint32_t index, const Mesh *mesh, bool hasStencil) -> bool
+			{
+				return !culling.skinned[index] &&
+				       culling.isStatic(index) &&
+				       !hasStencil &&
+				       mesh->isPooled() &&
+				       mesh->getBoundingBox() != nullptr &&
+				       data.colorShaders[static_cast<uint32_t>(mesh->getGeometryRange().format)] != nullptr &&
+				       data.shadowShaders[static_cast<uint32_t>(mesh->getGeometryRange().format)] != nullptr;
+			}
+
+			inline auto build(component::GPUCullingData &data, const component::CullingData &culling, component::DeferredData &deferred, MeshQuery &meshQuery) -> void
+			{
+				PROFILE_FUNCTION();
+				data.handled.assign(culling.entities.size(), 0);
+				data.sources.clear();
+				data.instances.clear();
+				data.lods.clear();
+				data.materials.clear();
+
+				for (uint32_t index = 0; index < culling.entities.size(); index++)
+				{
+					auto entityHandle = culling.entities[index];
+					if (culling.skinned[index])
+						continue;
+
+					auto [meshRenderer, trans] = meshQuery.convert(entityHandle);
+					auto mesh                  = meshRenderer.getMesh().get();
+					if (mesh == nullptr || !isEligible(data, culling, index, mesh, meshQuery.hasComponent<component::StencilComponent>(entityHandle)))
+						continue;
+
+					auto material = getMaterial(deferred, mesh);
+					if (material == nullptr)
+						continue;
+
+					//no slot left in the table, the mesh stays with the per material sets.
+					const auto materialIndex = deferred.materialTable->getIndex(material);
+					if (materialIndex < 0)
+						continue;
+
+					const auto &world  = trans.getWorldMatrix();
+					const auto &range  = mesh->getGeometryRange();
+					const auto  bounds = culling.worldBounds.get(index);
+					const auto  scale  = std::max(glm::length(glm::vec3(world[0])), std::max(glm::length(glm::vec3(world[1])), glm::length(glm::vec3(world[2]))));
+
+					auto &instance          = data.instances.emplace_back();
+					instance.transform      = world;
+					instance.positionScale  = mesh->getPositionScale();
+					instance.positionOffset = mesh->getPositionOffset();
+					instance.boundsMin      = {bounds.min, scale};
+					instance.boundsMax      = {bounds.max, glm::length(mesh->getBoundingBox()->size()) * 0.5f * scale};
+					instance.lod            = {static_cast<uint32_t>(data.lods.size()), mesh->getLodCount(), range.vertexOffset, static_cast<uint32_t>(materialIndex)};
+					instance.flags          = {static_cast<uint32_t>(range.format), meshRenderer.castShadow ? 1 : 0, 0, 0};
+
+					for (uint32_t i = 0; i < mesh->getLodCount(); i++)
+					{
+						const auto lod = mesh->getLod(i);
+						data.lods.push_back({range.indexOffset + lod.indexOffset, lod.indexCount, lod.error, 0});
+					}
+
+					if (std::find(data.materials.begin(), data.materials.end(), material) == data.materials.end())
+						data.materials.emplace_back(material);
+
+					data.sources.push_back({entityHandle, index, mesh, material, meshRenderer.castShadow});
+					data.handled[index] = 1;
+				}
+				data.instancesDirty = true;
+			}
+
+			//static meshes do not move, but their mesh, material or shadow flag can still be edited.
+			inline auto isValid(const component::GPUCullingData &data, const component::CullingData &culling, const component::DeferredData &deferred, MeshQuery &meshQuery) -> bool
+			{
+				PROFILE_FUNCTION();
+				for (auto &source : data.sources)
+				{
+					if (source.index >= culling.entities.size() || culling.entities[source.index] != source.entity)
+						return false;
+
+					auto [meshRenderer, trans] = meshQuery.convert(source.entity);
+					if (meshRenderer.getMesh().get() != source.mesh ||
+					    meshRenderer.castShadow != source.castShadow ||
+					    meshQuery.hasComponent<component::StencilComponent>(source.entity) ||
+					    getMaterial(deferred, source.mesh) != source.material)
+						return false;
+				}
+				return true;
+			}
+
+			inline auto system(Entity entity, MeshQuery meshQuery, ecs::World world)
+			{
+				auto [data, culling, deferred] = entity;
+				auto pool                      = Application::getGeometryPool();
+
+				data.active = false;
+				if (!data.enable || pool == nullptr || data.cullingShader == nullptr || !deferred.bindless || deferred.materialTable == nullptr)
+				{
+					//forces a rebuild once the path is enabled again.
+					data.staticVersion = UINT32_MAX;
+					return;
+				}
+
+				if (data.staticVersion != culling.staticVersion || data.poolVersion != pool->getVersion() || !isValid(data, culling, deferred, meshQuery))
+				{
+					build(data, culling, deferred, meshQuery);
+					data.staticVersion = culling.staticVersion;
+					data.poolVersion   = pool->getVersion();
+				}
+
+				data.active = !data.instances.empty();
+			}
+		}        // namespace gather
+
+		namespace dispatch
+		{
+			using Entity = ecs::Chain
+				::Write<component::GPUCullingData>
+				::Read<component::CameraView>
+				::Read<component::ShadowMapData>
+				::Read<component::RendererData>
+				::Write<component::DeferredData>
+				::To<ecs::Entity>;
+
+			inline auto system(Entity entity, ecs::World world)
+			{
+				auto [data, cameraView, shadowData, renderData, deferred] = entity;
+				if (!data.active || cameraView.cameraTransform == nullptr)
+					return;
+
+				using Data = component::GPUCullingData;
+
+				//slots never move, the lookups only refresh the entries of materials no cpu draw asked for this frame.
+				for (auto material : data.materials)
+				{
+					deferred.materialTable->getIndex(material);
+				}
+
+				const auto instanceCount = static_cast<uint32_t>(data.instances.size());
+				if (data.instancesDirty)
+				{
+					data.instanceBuffer->setData(static_cast<uint32_t>(sizeof(Data::InstanceData) * data.instances.size()), data.instances.data());
+					data.lodBuffer->setData(static_cast<uint32_t>(sizeof(Data::LodData) * data.lods.size()), data.lods.data());
+
+					//every view and format gets room for all instances, the lists never overflow.
+					data.maxDraws = instanceCount;
+					const std::vector<uint8_t> commands(Data::MAX_VIEWS * Data::FORMATS * data.maxDraws * sizeof(DrawIndexedIndirectCommand));
+					data.commandBuffer->setData(static_cast<uint32_t>(commands.size()), commands.data());
+					data.instancesDirty = false;
+				}
+
+				const uint32_t counts[Data::MAX_VIEWS * Data::FORMATS] = {};
+				data.countBuffer->setData(sizeof(counts), counts);
+
+				Data::ViewUniforms uniforms{};
+				const auto         cascades = std::min(shadowData.shadowMapNum, Data::MAX_VIEWS - 1);
+				uniforms.viewCount          = 1 + cascades;
+				uniforms.instanceCount      = instanceCount;
+				uniforms.maxDraws           = data.maxDraws;
+
+				auto setPlanes = [&](uint32_t view, const Frustum &frustum) {
+					for (uint32_t i = 0; i < 6; i++)
+					{
+						auto &plane                   = frustum.getPlane(static_cast<Frustum::FrustumPlane>(i));
+						uniforms.planes[view * 6 + i] = {plane.getNormal(), plane.getDistance()};
+					}
+				};
+
+				//same error per unit as the cpu passes, see deferred_offscreen::beginScene and shadow_map_pass::beginScene.
+				const bool  perspective   = cameraView.proj[2][3] != 0.f;
+				const float pixelsPerUnit = std::abs(cameraView.proj[1][1]) * renderData.gbuffer->getHeight() * 0.5f;
+				setPlanes(0, cameraView.frustum);
+				uniforms.lodParams[0] = {deferred.lodBias / pixelsPerUnit, perspective ? cameraView.nearPlane : 0.f, 0.f, 0.f};
+				uniforms.positions[0] = {cameraView.cameraTransform->getWorldPosition(), 1.f};
+
+				for (uint32_t i = 0; i < cascades; i++)
+				{
+					const auto &projView      = shadowData.shadowProjView[i];
+					const float texelsPerUnit = std::max(
+					    glm::length(glm::vec3(projView[0][0], projView[1][0], projView[2][0])),
+					    glm::length(glm::vec3(projView[0][1], projView[1][1], projView[2][1]))) * shadowData.shadowMapSize * 0.5f;
+
+					setPlanes(1 + i, shadowData.cascadeFrustums[i]);
+					uniforms.lodParams[1 + i] = {shadowData.lodBias / texelsPerUnit, 0.f, 0.f, 0.f};
+				}
+
+				data.cullingSet[0]->setUniformBufferData("UniformBufferObject", &uniforms);
+				data.cullingSet[0]->update();
+
+				data.colorSet[0]->setUniform(data.colorProjView, &cameraView.projView);
+				data.colorSet[0]->setUniform(data.colorView, &cameraView.view);
+				data.colorSet[0]->setUniform(data.colorProjViewOld, &cameraView.projViewOld);
+				data.colorSet[0]->update();
+
+				data.shadowSet[0]->setUniform(data.shadowProjView, shadowData.shadowProjView);
+				data.shadowSet[0]->update();
+
+				//one thread per instance and view, the group count changes with the scene and is not part of the pipeline.
+				PipelineInfo pipelineInfo;
+				pipelineInfo.shader = data.cullingShader;
+				auto pipeline       = Pipeline::get(pipelineInfo);
+				pipeline->bind(renderData.commandBuffer);
+				Renderer::bindDescriptorSets(pipeline.get(), renderData.commandBuffer, 0, data.cullingSet);
+				Renderer::dispatch(renderData.commandBuffer, (instanceCount * uniforms.viewCount + Data::GROUP_SIZE - 1) / Data::GROUP_SIZE, 1, 1);
+				Renderer::memoryBarrier(renderData.commandBuffer, MemoryBarrierFlags::Indirect_Command_Barrier);
+				pipeline->end(renderData.commandBuffer);
+			}
+		}        // namespace dispatch
+
+		auto drawIndirect(const component::GPUCullingData &data, CommandBuffer *commandBuffer, Pipeline *pipeline, uint32_t view, VertexFormat format) -> void
+		{
+			auto pool         = Application::getGeometryPool();
+			auto vertexBuffer = pool->getVertexBuffer(format);
+			auto indexBuffer  = pool->getIndexBuffer(format);
+			if (vertexBuffer == nullptr || indexBuffer == nullptr)
+				return;
+
+			const auto list = view * component::GPUCullingData::FORMATS + static_cast<uint32_t>(format);
+			Renderer::drawIndexedIndirect(commandBuffer, pipeline, vertexBuffer, indexBuffer,
+			                              data.commandBuffer.get(), static_cast<uint32_t>(list * data.maxDraws * sizeof(DrawIndexedIndirectCommand)),
+			                              data.countBuffer.get(), static_cast<uint32_t>(list * sizeof(uint32_t)), data.maxDraws);
+		}
+
+		auto registerGPUCulling(ExecuteQueue &begin, ExecuteQueue &renderer, std::shared_ptr<ExecutePoint> executePoint) -> void
+		{
+			executePoint->registerGlobalComponent<component::GPUCullingData>();
+			if (component::GPUCullingData::isSupported())
+			{
+				const std::string layout = GBuffer::isCompactLayoutEnabled() ? "Packed" : "";
+				executePoint->registerShaders({"shaders/Culling.shader", "shaders/DeferredColorIndirect" + layout + ".shader", "shaders/ShadowIndirect.shader"});
+				if (Mesh::isCompactVertexSupported() && File::fileExists("shaders/spv/DeferredColorIndirectCompact.vert.spv"))
+					executePoint->registerShaders({"shaders/DeferredColorIndirectCompact" + layout + ".shader", "shaders/ShadowIndirectCompact.shader"});
+			}
+			executePoint->registerWithinQueue<gather::system>(begin);
+			executePoint->registerWithinQueue<dispatch::system>(renderer);
+		}
+	}        // namespace gpu_culling
+};           // namespace maple
@@ -0,0 +1,138 @@
+//////////////////////////////////////////////////////////////////////////////
+// This file is part of the Maple Engine                              		//
+//////////////////////////////////////////////////////////////////////////////
+#pragma once
+
+#include "Engine/Mesh.h"
+#include "RHI/DescriptorSet.h"
+#include "RHI/Shader.h"
+#include "Scene/System/ExecutePoint.h"
+
+#include <IconsMaterialDesignIcons.h>
+#include <entt/entity/entity.hpp>
+#include <glm/glm.hpp>
+#include <memory>
+#include <vector>
+
+namespace maple
+{
+	class CommandBuffer;
+	class Material;
+	class Pipeline;
+	class StorageBuffer;
+
+	namespace component
+	{
+		/**
+		 * static single material meshes placed in the GeometryPool are culled and given their lod on the gpu (Culling.comp),
+		 * for the camera and every shadow cascade at once. the G-buffer and shadow passes skip them on the cpu and draw
+		 * each view with one indirect call per vertex format, the cpu only walks them again when the static set changes.
+		 */
+		struct GPUCullingData
+		{
+			constexpr static char *ICON = ICON_MDI_FILTER;
+
+			//the camera and the cascades of ShadowMapData, Shadow.vert has room for four of them.
+			static constexpr uint32_t MAX_VIEWS  = 5;
+			static constexpr uint32_t FORMATS    = 2;
+			static constexpr uint32_t GROUP_SIZE = 64;
+
+			//one element of InstanceBuffer (GPUCulling.glsl), std430.
+			struct InstanceData
+			{
+				glm::mat4  transform;
+				glm::vec4  positionScale;
+				glm::vec4  positionOffset;
+				glm::vec4  boundsMin;        //w : largest scale of the transform
+				glm::vec4  boundsMax;        //w : radius of the bounds
+				glm::uvec4 lod;              //first lod, lod count, first vertex, material slot
+				glm::uvec4 flags;            //vertex format, casts shadows
+			};
+			static_assert(sizeof(InstanceData) == 160, "InstanceData has to match GPUCulling.glsl");
+
+			struct LodData
+			{
+				uint32_t firstIndex;
+				uint32_t indexCount;
+				float    error;
+				uint32_t padding;
+			};
+
+			//UniformBufferObject of Culling.comp, std140.
+			struct ViewUniforms
+			{
+				glm::vec4 planes[MAX_VIEWS * 6];
+				glm::vec4 lodParams[MAX_VIEWS];
+				glm::vec4 positions[MAX_VIEWS];
+				uint32_t  viewCount;
+				uint32_t  instanceCount;
+				uint32_t  maxDraws;
+				uint32_t  padding;
+			};
+
+			bool enable = true;
+			//set every frame, false while the path is disabled, not supported or has nothing to draw.
+			bool active = false;
+
+			//what an instance was built from, checked every frame so an edit which does not move the mesh still rebuilds.
+			struct Source
+			{
+				entt::entity entity;
+				uint32_t     index;
+				Mesh *       mesh;
+				Material *   material;
+				bool         castShadow;
+			};
+
+			//indexed like CullingData, set for the meshes the passes leave to the indirect draws.
+			std::vector<uint8_t>      handled;
+			std::vector<Source>       sources;
+			std::vector<InstanceData> instances;
+			std::vector<LodData>      lods;
+			//the unique materials of the instances, refreshed in the MaterialTable every frame.
+			std::vector<Material *> materials;
+
+			uint32_t staticVersion  = UINT32_MAX;
+			uint32_t poolVersion    = UINT32_MAX;
+			uint32_t maxDraws       = 0;
+			bool     instancesDirty = true;
+
+			std::shared_ptr<Shader> cullingShader;
+			std::shared_ptr<Shader> colorShaders[FORMATS];         //G-buffer, null for a layout which is not compiled
+			std::shared_ptr<Shader> shadowShaders[FORMATS];
+
+			std::vector<std::shared_ptr<DescriptorSet>> cullingSet;
+			std::vector<std::shared_ptr<DescriptorSet>> colorSet;         //set 0, 1 and 2 are the ones of the bindless G-buffer pass
+			std::vector<std::shared_ptr<DescriptorSet>> shadowSet;
+
+			std::shared_ptr<StorageBuffer> instanceBuffer;
+			std::shared_ptr<StorageBuffer> lodBuffer;
+			std::shared_ptr<StorageBuffer> commandBuffer;
+			std::shared_ptr<StorageBuffer> countBuffer;
+
+			UniformHandle colorProjView;
+			UniformHandle colorView;
+			UniformHandle colorProjViewOld;
+			UniformHandle shadowProjView;
+
+			GPUCullingData();
+
+			//indirect draws with a count, the geometry pool and the bindless G-buffer pass are available.
+			static auto isSupported() -> bool;
+
+			inline auto isHandled(uint32_t index) const
+			{
+				return active && index < handled.size() && handled[index] != 0;
+			}
+		};
+	}        // namespace component
+
+	namespace gpu_culling
+	{
+		//before the shadow and G-buffer passes in both queues.
+		auto registerGPUCulling(ExecuteQueue &begin, ExecuteQueue &renderer, std::shared_ptr<ExecutePoint> executePoint) -> void;
+
+		//issues the draws the culling pass wrote for the view (0 is the camera, 1 + i the cascade i), inside a bound pipeline.
+		auto drawIndirect(const component::GPUCullingData &data, CommandBuffer *commandBuffer, Pipeline *pipeline, uint32_t view, VertexFormat format) -> void;
+	};        // namespace gpu_culling
+}        // namespace maple
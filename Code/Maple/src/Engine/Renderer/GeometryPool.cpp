@@ -0,0 +1,146 @@
+//////////////////////////////////////////////////////////////////////////////
+// This file is part of the Maple Engine                              		//
+//////////////////////////////////////////////////////////////////////////////
+#include "GeometryPool.h"
+#include "Engine/Profiler.h"
+#include "Engine/Vertex.h"
+#include "Others/Console.h"
+#include "RHI/IndexBuffer.h"
+#include "RHI/VertexBuffer.h"
+
+namespace maple
+{
+	auto GeometryPool::allocate(uint32_t stride, const void *vertices, uint32_t vertexCount, const uint32_t *indices, uint32_t indexCount, GeometryRange &range) -> bool
+	{
+		PROFILE_FUNCTION();
+		if (vertexCount == 0 || indexCount == 0)
+			return false;
+
+		std::lock_guard<std::mutex> locker(mutex);
+
+		VertexFormat format;
+		auto         layout = getLayout(stride, format);
+		if (layout == nullptr)
+			return false;
+
+		uint32_t vertexOffset = 0;
+		uint32_t indexOffset  = 0;
+		if (!take(layout->freeVertices, vertexCount, vertexOffset))
+		{
+			LOGW("GeometryPool : no room for {0} vertices", vertexCount);
+			return false;
+		}
+
+		if (!take(layout->freeIndices, indexCount, indexOffset))
+		{
+			give(layout->freeVertices, vertexOffset, vertexCount);
+			LOGW("GeometryPool : no room for {0} indices", indexCount);
+			return false;
+		}
+
+		layout->vertexBuffer->setDataSub(vertexCount * stride, vertices, vertexOffset * stride);
+		layout->indexBuffer->setDataSub(indexCount * sizeof(uint32_t), indices, indexOffset * sizeof(uint32_t));
+
+		range.format       = format;
+		range.vertexOffset = vertexOffset;
+		range.vertexCount  = vertexCount;
+		range.indexOffset  = indexOffset;
+		range.indexCount   = indexCount;
+		version++;
+		return true;
+	}
+
+	auto GeometryPool::release(const GeometryRange &range) -> void
+	{
+		if (range.indexCount == 0)
+			return;
+
+		std::lock_guard<std::mutex> locker(mutex);
+		auto &layout = layouts[static_cast<uint32_t>(range.format)];
+		give(layout.freeVertices, range.vertexOffset, range.vertexCount);
+		give(layout.freeIndices, range.indexOffset, range.indexCount);
+		version++;
+	}
+
+	auto GeometryPool::getVertexBuffer(VertexFormat format) const -> VertexBuffer *
+	{
+		return layouts[static_cast<uint32_t>(format)].vertexBuffer.get();
+	}
+
+	auto GeometryPool::getIndexBuffer(VertexFormat format) const -> IndexBuffer *
+	{
+		return layouts[static_cast<uint32_t>(format)].indexBuffer.get();
+	}
+
+	auto GeometryPool::getLayout(uint32_t stride, VertexFormat &format) -> Layout *
+	{
+		if (stride == sizeof(Vertex))
+			format = VertexFormat::Full;
+		else if (stride == sizeof(CompactVertex))
+			format = VertexFormat::Compact;
+		else
+			return nullptr;
+
+		auto &layout = layouts[static_cast<uint32_t>(format)];
+		if (layout.vertexBuffer == nullptr)
+		{
+			const auto vertexCapacity = VERTEX_BUFFER_SIZE / stride;
+			layout.vertexBuffer       = VertexBuffer::create();
+			layout.vertexBuffer->resize(vertexCapacity * stride);
+			layout.indexBuffer = IndexBuffer::create(static_cast<const uint32_t *>(nullptr), MAX_INDICES);
+			layout.freeVertices.push_back({0, vertexCapacity});
+			layout.freeIndices.push_back({0, MAX_INDICES});
+		}
+		return &layout;
+	}
+
+	auto GeometryPool::take(std::vector<Block> &blocks, uint32_t count, uint32_t &offset) -> bool
+	{
+		for (auto iter = blocks.begin(); iter != blocks.end(); iter++)
+		{
+			if (iter->count < count)
+				continue;
+
+			offset = iter->offset;
+			iter->offset += count;
+			iter->count -= count;
+			if (iter->count == 0)
+				blocks.erase(iter);
+			return true;
+		}
+		return false;
+	}
+
+	auto GeometryPool::give(std::vector<Block> &blocks, uint32_t offset, uint32_t count) -> void
+	{
+		//blocks stay sorted by offset, neighbours are merged so the pool does not end up in slivers.
+		auto next = blocks.begin();
+		while (next != blocks.end() && next->offset < offset)
+		{
+			next++;
+		}
+
+		if (next != blocks.begin())
+		{
+			auto prev = next - 1;
+			if (prev->offset + prev->count == offset)
+			{
+				prev->count += count;
+				if (next != blocks.end() && prev->offset + prev->count == next->offset)
+				{
+					prev->count += next->count;
+					blocks.erase(next);
+				}
+				return;
+			}
+		}
+
+		if (next != blocks.end() && offset + count == next->offset)
+		{
+			next->offset = offset;
+			next->count += count;
+			return;
+		}
+		blocks.insert(next, {offset, count});
+	}
+};        // namespace maple
@@ -0,0 +1,66 @@
+//////////////////////////////////////////////////////////////////////////////
+// This file is part of the Maple Engine                              		//
+//////////////////////////////////////////////////////////////////////////////
+#pragma once
+#include "Engine/Core.h"
+#include "Engine/Mesh.h"
+
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace maple
+{
+	class VertexBuffer;
+	class IndexBuffer;
+
+	/**
+	 * one vertex and one index buffer per static vertex layout (Vertex, CompactVertex) shared by the meshes placed in it,
+	 * draws of different meshes need no rebinding and a compute pass can issue all of them with one indirect call.
+	 * the buffers have a fixed size, ranges are handed out first fit and go back to the free lists with their mesh.
+	 */
+	class MAPLE_EXPORT GeometryPool final
+	{
+	  public:
+		static constexpr uint32_t VERTEX_BUFFER_SIZE = 64 * 1024 * 1024;        //bytes per layout
+		static constexpr uint32_t MAX_INDICES        = 8 * 1024 * 1024;         //per layout
+
+		//false if the stride has no pool (skinned layouts) or there is no room left, the mesh keeps using its own buffers.
+		auto allocate(uint32_t stride, const void *vertices, uint32_t vertexCount, const uint32_t *indices, uint32_t indexCount, GeometryRange &range) -> bool;
+		auto release(const GeometryRange &range) -> void;
+
+		//nullptr until the first mesh of the layout is placed.
+		auto getVertexBuffer(VertexFormat format) const -> VertexBuffer *;
+		auto getIndexBuffer(VertexFormat format) const -> IndexBuffer *;
+
+		//changes with every allocation and release.
+		inline auto getVersion() const
+		{
+			return version;
+		}
+
+	  private:
+		struct Block
+		{
+			uint32_t offset;
+			uint32_t count;
+		};
+
+		struct Layout
+		{
+			std::shared_ptr<VertexBuffer> vertexBuffer;
+			std::shared_ptr<IndexBuffer>  indexBuffer;
+			std::vector<Block>            freeVertices;
+			std::vector<Block>            freeIndices;
+		};
+
+		auto getLayout(uint32_t stride, VertexFormat &format) -> Layout *;
+
+		static auto take(std::vector<Block> &blocks, uint32_t count, uint32_t &offset) -> bool;
+		static auto give(std::vector<Block> &blocks, uint32_t offset, uint32_t count) -> void;
+
+		Layout     layouts[2];
+		uint32_t   version = 0;
+		std::mutex mutex;
+	};
+};        // namespace maple
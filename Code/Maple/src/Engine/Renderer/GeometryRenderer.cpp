@@ -85,6 +85,8 @@ namespace maple
 
 			std::vector<std::shared_ptr<DescriptorSet>> pointDescriptorSet;
 			std::vector<std::shared_ptr<DescriptorSet>> lineDescriptorSet;
+			UniformHandle                               pointProjView;
+			UniformHandle                               lineProjView;
 
 			LineVertex* lineBuffer = nullptr;
 			PointVertex* pointBuffer = nullptr;
@@ -107,6 +109,7 @@ namespace maple
 					descriptorInfo.layoutIndex = 0;
 					descriptorInfo.shader = pointShader.get();
 					pointDescriptorSet.emplace_back(DescriptorSet::create(descriptorInfo));
+					pointProjView = pointDescriptorSet[0]->getUniformHandle("UniformBufferObject", "projView");
 
 					pointVertexBuffers = VertexBuffer::create(BufferUsage::Dynamic);
 					pointVertexBuffers->resize(RendererPointBufferSize);
@@ -132,6 +135,7 @@ namespace maple
 					descriptorLineInfo.layoutIndex = 0;
 					descriptorLineInfo.shader = lineShader.get();
 					lineDescriptorSet.emplace_back(DescriptorSet::create(descriptorLineInfo));
+					lineProjView = lineDescriptorSet[0]->getUniformHandle("UniformBufferObject", "projView");
 
 					lineVertexBuffers = VertexBuffer::create(BufferUsage::Dynamic);
 					lineVertexBuffers->resize(RendererLineBufferSize);
@@ -304,8 +308,8 @@ namespace maple
 		inline auto system(Entity entity, ecs::World world) 
 		{
 			auto [render, geometry, cameraView] = entity;
-			geometry.lineDescriptorSet[0]->setUniform("UniformBufferObject", "projView", &cameraView.projView);
-			geometry.pointDescriptorSet[0]->setUniform("UniformBufferObject", "projView", &cameraView.projView);
+			geometry.lineDescriptorSet[0]->setUniform(geometry.lineProjView, &cameraView.projView);
+			geometry.pointDescriptorSet[0]->setUniform(geometry.pointProjView, &cameraView.projView);
 		}
 	}
 
@@ -455,6 +459,7 @@ namespace maple
 		auto registerGeometryRenderer(ExecuteQueue& begin, ExecuteQueue& renderer, std::shared_ptr<ExecutePoint> executePoint) -> void
 		{
 			executePoint->registerGlobalComponent<component::GeometryRenderData>();
+			executePoint->registerShaders({"shaders/BatchPoint.shader", "shaders/BatchLine.shader"});
 			executePoint->registerWithinQueue<on_begin_scene::system>(begin);
 			executePoint->registerWithinQueue<on_render_lines::systemLines>(renderer);
 			executePoint->registerWithinQueue<on_render_lines::systemPoints>(renderer);
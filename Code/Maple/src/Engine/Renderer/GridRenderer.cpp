@@ -42,6 +42,8 @@ namespace maple
 			std::shared_ptr<Mesh> quad;
 			std::shared_ptr<Shader> gridShader;
 			std::shared_ptr<DescriptorSet> descriptorSet;
+			UniformHandle                  projHandle;
+			UniformHandle                  viewHandle;
 
 			struct UniformBufferObject
 			{
@@ -57,6 +59,8 @@ namespace maple
 				gridShader = Shader::create("shaders/Grid.shader");
 				quad = Mesh::createQuad();
 				descriptorSet = DescriptorSet::create({ 0, gridShader.get() });
+				projHandle = descriptorSet->getUniformHandle("UniformBufferObject", "proj");
+				viewHandle = descriptorSet->getUniformHandle("UniformBufferObject", "view");
 			}
 		};
 	}
@@ -72,8 +76,8 @@ namespace maple
 		inline auto system(Entity entity,ecs::World world)
 		{
 			auto [render, grid, camera] = entity;
-			grid.descriptorSet->setUniform("UniformBufferObject", "proj", glm::value_ptr(camera.proj));
-			grid.descriptorSet->setUniform("UniformBufferObject", "view", glm::value_ptr(camera.view));
+			grid.descriptorSet->setUniform(grid.projHandle, glm::value_ptr(camera.proj));
+			grid.descriptorSet->setUniform(grid.viewHandle, glm::value_ptr(camera.view));
 			grid.systemBuffer.cameraPos = glm::vec4(camera.cameraTransform->getWorldPosition(), 1.f);
 			grid.systemBuffer.near_ = camera.nearPlane;
 			grid.systemBuffer.far_ = camera.farPlane;
@@ -120,6 +124,7 @@ namespace maple
 		{
 			executePoint->registerGlobalComponent<component::GridData>();
 			executePoint->registerGlobalComponent<component::GridRender>();
+			executePoint->registerShaders({"shaders/Grid.shader"});
 			executePoint->registerWithinQueue<on_begin::system>(begin);
 			executePoint->registerWithinQueue<on_render::system>(renderer);
 		}
@@ -0,0 +1,152 @@
+//////////////////////////////////////////////////////////////////////////////
+// This file is part of the Maple Engine                              		//
+//////////////////////////////////////////////////////////////////////////////
+#include "MaterialTable.h"
+#include "Engine/Profiler.h"
+#include "RHI/DescriptorSet.h"
+#include "RHI/GraphicsContext.h"
+#include "RHI/StorageBuffer.h"
+#include "RHI/Texture.h"
+
+#include "Application.h"
+
+#include <cstring>
+
+namespace maple
+{
+	namespace
+	{
+		//same fallbacks as Material::updateDescriptorSet.
+		inline auto getDefaultMap(int32_t index) -> std::shared_ptr<Texture2D>
+		{
+			switch (index)
+			{
+				case 0:
+					return Texture2D::create("albedo", "textures/default/default_albedo.png");
+				case 1:
+					return Texture2D::create("metallic", "textures/default/default_specular.png");
+				case 2:
+					return Texture2D::create("roughness", "textures/default/default_roughness.png");
+				case 3:
+					return Texture2D::create("normal", "textures/default/default_normal.png");
+				case 4:
+					return Texture2D::create("ao", "textures/default/default_ao.png");
+				default:
+					return Texture2D::create("emission", "textures/default/default_emission.png");
+			}
+		}
+	}        // namespace
+
+	MaterialTable::MaterialTable(const std::shared_ptr<Shader> &shader, uint32_t layoutIndex) :
+	    maxTextures(Application::getGraphicsContext()->getMaxBindlessTextures())
+	{
+		PROFILE_FUNCTION();
+		descriptorSet = DescriptorSet::create({layoutIndex, shader.get()});
+		buffer        = StorageBuffer::create();
+		descriptorSet->setStorageBuffer("MaterialBuffer", buffer);
+
+		for (int32_t i = 0; i < 6; i++)
+		{
+			defaultMaps[i] = getTextureIndex(getDefaultMap(i), 0);
+		}
+	}
+
+	auto MaterialTable::isSupported() -> bool
+	{
+		return Application::getGraphicsContext()->getMaxBindlessTextures() > 0;
+	}
+
+	auto MaterialTable::beginFrame() -> void
+	{
+		frame++;
+	}
+
+	auto MaterialTable::getIndex(Material *material) -> int32_t
+	{
+		PROFILE_FUNCTION();
+		int32_t slot = -1;
+		if (auto iter = materialSlots.find(material); iter != materialSlots.end())
+		{
+			slot = iter->second;
+			if (entryFrames[slot] == frame)
+				return slot;
+		}
+		else
+		{
+			if (entries.size() >= MAX_MATERIALS)
+				return -1;
+			slot = static_cast<int32_t>(entries.size());
+			entries.emplace_back();
+			entryFrames.emplace_back(0);
+			materialSlots.emplace(material, slot);
+		}
+
+		//properties and maps may change at any time, they are cheap enough to compare every frame.
+		auto &textures = material->getTextures();
+		Entry entry;
+		entry.properties   = material->getProperties();
+		entry.albedoMap    = getTextureIndex(textures.albedo, defaultMaps[0]);
+		entry.metallicMap  = getTextureIndex(textures.metallic, defaultMaps[1]);
+		entry.roughnessMap = getTextureIndex(textures.roughness, defaultMaps[2]);
+		entry.normalMap    = getTextureIndex(textures.normal, defaultMaps[3]);
+		entry.aoMap        = getTextureIndex(textures.ao, defaultMaps[4]);
+		entry.emissiveMap  = getTextureIndex(textures.emissive, defaultMaps[5]);
+
+		if (textures.albedo == nullptr)
+			entry.properties.usingAlbedoMap = 0.f;
+		if (textures.metallic == nullptr)
+			entry.properties.usingMetallicMap = 0.f;
+		if (textures.roughness == nullptr)
+			entry.properties.usingRoughnessMap = 0.f;
+		if (textures.normal == nullptr)
+			entry.properties.usingNormalMap = 0.f;
+		if (textures.ao == nullptr)
+			entry.properties.usingAOMap = 0.f;
+		if (textures.emissive == nullptr)
+			entry.properties.usingEmissiveMap = 0.f;
+
+		if (memcmp(&entries[slot], &entry, sizeof(Entry)) != 0)
+		{
+			entries[slot]  = entry;
+			entriesChanged = true;
+		}
+		entryFrames[slot] = frame;
+		return slot;
+	}
+
+	auto MaterialTable::update() -> void
+	{
+		PROFILE_FUNCTION();
+		if (texturesChanged)
+		{
+			descriptorSet->setTexture("uTextures", textures);
+			texturesChanged = false;
+		}
+
+		if (entriesChanged)
+		{
+			buffer->setData(static_cast<uint32_t>(entries.size() * sizeof(Entry)), entries.data());
+			entriesChanged = false;
+		}
+		descriptorSet->update();
+	}
+
+	auto MaterialTable::getTextureIndex(const std::shared_ptr<Texture> &texture, int32_t fallback) -> int32_t
+	{
+		if (texture == nullptr)
+			return fallback;
+
+		if (auto iter = textureSlots.find(texture.get()); iter != textureSlots.end())
+			return iter->second;
+
+		//a full array draws the map with its fallback, the flags still say the material has it.
+		if (textures.size() >= maxTextures)
+			return fallback;
+
+		const auto slot = static_cast<int32_t>(textures.size());
+		textures.emplace_back(texture);
+		textureSlots.emplace(texture.get(), slot);
+		texturesChanged = true;
+		return slot;
+	}
+};        // namespace maple
@@ -0,0 +1,81 @@
+//////////////////////////////////////////////////////////////////////////////
+// This file is part of the Maple Engine                              		//
+//////////////////////////////////////////////////////////////////////////////
+#pragma once
+#include "Engine/Core.h"
+#include "Engine/Material.h"
+
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
+namespace maple
+{
+	class Shader;
+	class Texture;
+	class DescriptorSet;
+	class StorageBuffer;
+
+	/**
+	 * bindless materials of the G-buffer pass (MaterialBindless.glsl). every texture a material samples sits in one
+	 * runtime sized array and the properties of every material in one storage buffer, a draw only passes the slot of its
+	 * material so draws of different materials share one set and one instanced call.
+	 * slots are never recycled, a material or texture the table has no room for returns -1 and is drawn the usual way.
+	 */
+	class MAPLE_EXPORT MaterialTable
+	{
+	  public:
+		//one element of MaterialBuffer, std430.
+		struct Entry
+		{
+			MaterialProperties properties;
+			int32_t            albedoMap    = 0;
+			int32_t            metallicMap  = 0;
+			int32_t            roughnessMap = 0;
+			int32_t            normalMap    = 0;
+			int32_t            aoMap        = 0;
+			int32_t            emissiveMap  = 0;
+			int32_t            padding[2]   = {};
+		};
+		static_assert(sizeof(Entry) == 128, "Entry has to match MaterialData in MaterialBindless.glsl");
+
+		static constexpr uint32_t MAX_MATERIALS = 4096;
+
+		//layoutIndex is the set of shader holding uTextures and MaterialBuffer.
+		MaterialTable(const std::shared_ptr<Shader> &shader, uint32_t layoutIndex);
+
+		//the backend can index sampler arrays with per draw values.
+		static auto isSupported() -> bool;
+
+		//entries are refreshed from their material once per frame, on the first lookup of the frame.
+		auto beginFrame() -> void;
+		auto getIndex(Material *material) -> int32_t;
+		//uploads what changed this frame, before the sets are bound.
+		auto update() -> void;
+
+		inline auto &getDescriptorSet() const
+		{
+			return descriptorSet;
+		}
+
+	  private:
+		auto getTextureIndex(const std::shared_ptr<Texture> &texture, int32_t fallback) -> int32_t;
+
+		std::shared_ptr<DescriptorSet> descriptorSet;
+		std::shared_ptr<StorageBuffer> buffer;
+
+		std::vector<std::shared_ptr<Texture>>          textures;
+		std::unordered_map<const Texture *, int32_t>   textureSlots;
+		std::vector<Entry>                             entries;
+		std::vector<uint64_t>                          entryFrames;
+		std::unordered_map<const Material *, int32_t> materialSlots;
+
+		//slots of the textures DeferredColor binds for missing maps.
+		int32_t defaultMaps[6] = {};
+
+		uint32_t maxTextures     = 0;
+		uint64_t frame           = 0;
+		bool     texturesChanged = false;
+		bool     entriesChanged  = false;
+	};
+};        // namespace maple
@@ -49,13 +49,17 @@ namespace maple
 
 	component::SSRData::SSRData()
 	{
-		ssrShader = Shader::create("shaders/SSR.shader");
+		ssrShader = Shader::create(GBuffer::isCompactLayoutEnabled() ? "shaders/SSRPacked.shader" : "shaders/SSR.shader");
 		ssrDescriptorSet = DescriptorSet::create({ 0, ssrShader.get() });
+		viewHandle = ssrDescriptorSet->getUniformHandle("UniformBufferObject", "view");
+		projectionHandle = ssrDescriptorSet->getUniformHandle("UniformBufferObject", "projection");
+		reconstructionHandle = ssrDescriptorSet->getUniformHandle("UniformBufferObject", "reconstruction");
 	}
 
 	component::SSAOData::SSAOData()
 	{
-		ssaoShader = Shader::create("shaders/SSAO.shader");
+		//the compact G-buffer has no view space targets, they are rebuilt from depth and normals.
+		ssaoShader = Shader::create(GBuffer::isCompactLayoutEnabled() ? "shaders/SSAOPacked.shader" : "shaders/SSAO.shader");
 		ssaoBlurShader = Shader::create("shaders/SSAOBlur.shader");
 
 		DescriptorInfo info{};
@@ -65,6 +69,10 @@ namespace maple
 		info.shader = ssaoShader.get();
 		info.layoutIndex = 0;
 		ssaoSet[0] = DescriptorSet::create(info);
+		ssaoRadiusHandle = ssaoSet[0]->getUniformHandle("UBO", "ssaoRadius");
+		projectionHandle = ssaoSet[0]->getUniformHandle("UBO", "projection");
+		viewHandle = ssaoSet[0]->getUniformHandle("UBO", "view");
+		reconstructionHandle = ssaoSet[0]->getUniformHandle("UBO", "reconstruction");
 
 		info.shader = ssaoBlurShader.get();
 		info.layoutIndex = 0;
@@ -91,11 +99,20 @@ namespace maple
 				return;
 
 			auto descriptorSet = ssaoData.ssaoSet[0];
-			descriptorSet->setTexture("uViewPositionSampler", renderData.gbuffer->getBuffer(GBufferTextures::VIEW_POSITION));
-			descriptorSet->setTexture("uViewNormalSampler", renderData.gbuffer->getBuffer(GBufferTextures::VIEW_NORMALS));
+			//the packed SSAO reconstructs view position and normal from depth and NORMALS
+			if (!renderData.gbuffer->isCompact())
+			{
+				descriptorSet->setTexture("uViewPositionSampler", renderData.gbuffer->getBuffer(GBufferTextures::VIEW_POSITION));
+				descriptorSet->setTexture("uViewNormalSampler", renderData.gbuffer->getBuffer(GBufferTextures::VIEW_NORMALS));
+			}
+			descriptorSet->setTexture("uDepthSampler", renderData.gbuffer->getDepthBuffer());
+			descriptorSet->setTexture("uNormalSampler", renderData.gbuffer->getBuffer(GBufferTextures::NORMALS));
 			descriptorSet->setTexture("uSsaoNoise", renderData.gbuffer->getSSAONoise());
-			descriptorSet->setUniform("UBO", "ssaoRadius", &ssaoData.ssaoRadius);
-			descriptorSet->setUniform("UBO", "projection", &camera.proj);
+			descriptorSet->setUniform(ssaoData.ssaoRadiusHandle, &ssaoData.ssaoRadius);
+			descriptorSet->setUniform(ssaoData.projectionHandle, &camera.proj);
+			descriptorSet->setUniform(ssaoData.viewHandle, &camera.view);
+			const auto reconstruction = GBuffer::getReconstruction(camera.proj);
+			descriptorSet->setUniform(ssaoData.reconstructionHandle, &reconstruction);
 			descriptorSet->update();
 
 			auto commandBuffer = renderData.commandBuffer;
@@ -110,6 +127,8 @@ namespace maple
 			pipeInfo.depthTest = false;
 			pipeInfo.colorTargets[0] = renderData.gbuffer->getBuffer(GBufferTextures::SSAO_SCREEN);
 			auto pipeline = Pipeline::get(pipeInfo, ssaoData.ssaoSet, graph);
+			if (capture_graph::isCulled(graph, pipeInfo.shader.get()))
+				return;
 
 			if (commandBuffer)
 				commandBuffer->bindPipeline(pipeline.get());
@@ -155,6 +174,8 @@ namespace maple
 			pipeInfo.depthTest = false;
 			pipeInfo.colorTargets[0] = renderData.gbuffer->getBuffer(GBufferTextures::SSAO_BLUR);
 			auto pipeline = Pipeline::get(pipeInfo, ssaoData.ssaoBlurSet, graph);
+			if (capture_graph::isCulled(graph, pipeInfo.shader.get()))
+				return;
 
 			if (commandBuffer)
 				commandBuffer->bindPipeline(pipeline.get());
@@ -177,17 +198,27 @@ namespace maple
 			::Write<component::SSRData>
 			::Read<component::RendererData>
 			::Write<capture_graph::component::RenderGraph>
+			::Read<component::CameraView>
 			::To<ecs::Entity>;
 
 		inline auto system(Entity entity, ecs::World world)
 		{
-			auto [ssrData, render,graph] = entity;
+			auto [ssrData, render,graph,camera] = entity;
 			if (!ssrData.enable)
 				return;
-			ssrData.ssrDescriptorSet->setTexture("uViewPositionSampler", render.gbuffer->getBuffer(GBufferTextures::VIEW_POSITION));
-			ssrData.ssrDescriptorSet->setTexture("uViewNormalSampler", render.gbuffer->getBuffer(GBufferTextures::VIEW_NORMALS));
+			if (!render.gbuffer->isCompact())
+			{
+				ssrData.ssrDescriptorSet->setTexture("uViewPositionSampler", render.gbuffer->getBuffer(GBufferTextures::VIEW_POSITION));
+				ssrData.ssrDescriptorSet->setTexture("uViewNormalSampler", render.gbuffer->getBuffer(GBufferTextures::VIEW_NORMALS));
+			}
+			ssrData.ssrDescriptorSet->setTexture("uDepthSampler", render.gbuffer->getDepthBuffer());
+			ssrData.ssrDescriptorSet->setTexture("uNormalSampler", render.gbuffer->getBuffer(GBufferTextures::NORMALS));
 			ssrData.ssrDescriptorSet->setTexture("uPBRSampler", render.gbuffer->getBuffer(GBufferTextures::PBR));
 			ssrData.ssrDescriptorSet->setTexture("uScreenSampler", render.gbuffer->getBuffer(GBufferTextures::SCREEN));
+			ssrData.ssrDescriptorSet->setUniform(ssrData.viewHandle, &camera.view);
+			ssrData.ssrDescriptorSet->setUniform(ssrData.projectionHandle, &camera.proj);
+			const auto reconstruction = GBuffer::getReconstruction(camera.proj);
+			ssrData.ssrDescriptorSet->setUniform(ssrData.reconstructionHandle, &reconstruction);
 			ssrData.ssrDescriptorSet->update();
 
 			auto commandBuffer = render.commandBuffer;
@@ -203,6 +234,8 @@ namespace maple
 			pipeInfo.colorTargets[0] = render.gbuffer->getBuffer(GBufferTextures::SSR_SCREEN);
 
 			auto pipeline = Pipeline::get(pipeInfo, { ssrData.ssrDescriptorSet }, graph);
+			if (capture_graph::isCulled(graph, pipeInfo.shader.get()))
+				return;
 
 			if (commandBuffer)
 				commandBuffer->bindPipeline(pipeline.get());
@@ -224,6 +257,7 @@ namespace maple
 		auto registerSSAOPass(ExecuteQueue& begin, ExecuteQueue& renderer, std::shared_ptr<ExecutePoint> executePoint) -> void
 		{
 			executePoint->registerGlobalComponent<component::SSAOData>();
+			executePoint->registerShaders({GBuffer::isCompactLayoutEnabled() ? "shaders/SSAOPacked.shader" : "shaders/SSAO.shader", "shaders/SSAOBlur.shader"});
 			executePoint->registerWithinQueue<ssao_pass::system>(renderer);
 			executePoint->registerWithinQueue<ssao_blur_pass::system>(renderer);
 		}
@@ -231,6 +265,7 @@ namespace maple
 		auto registerSSR(ExecuteQueue& renderer, std::shared_ptr<ExecutePoint> executePoint) -> void
 		{
 			executePoint->registerGlobalComponent<component::SSRData>();
+			executePoint->registerShaders({GBuffer::isCompactLayoutEnabled() ? "shaders/SSRPacked.shader" : "shaders/SSR.shader"});
 			executePoint->registerWithinQueue<ssr_pass::system>(renderer);
 		}
 	};
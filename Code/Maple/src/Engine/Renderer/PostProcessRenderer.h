@@ -4,12 +4,12 @@
 #pragma once
 #include <memory>
 #include "Scene/System/ExecutePoint.h"
+#include "RHI/DescriptorSet.h"
 #include <IconsMaterialDesignIcons.h>
 
 namespace maple
 {
 	class Shader;
-	class DescriptorSet;
 
 	namespace component
 	{
@@ -20,6 +20,10 @@ namespace maple
 			std::shared_ptr<Shader>                     ssaoBlurShader;
 			std::vector<std::shared_ptr<DescriptorSet>> ssaoSet;
 			std::vector<std::shared_ptr<DescriptorSet>> ssaoBlurSet;
+			UniformHandle                               ssaoRadiusHandle;
+			UniformHandle                               projectionHandle;
+			UniformHandle                               viewHandle;
+			UniformHandle                               reconstructionHandle;
 			bool  enable = false;
 			float bias = 0.025;
 			float ssaoRadius = 0.25f;
@@ -31,6 +35,9 @@ namespace maple
 			bool                           enable = false;
 			std::shared_ptr<DescriptorSet> ssrDescriptorSet;
 			std::shared_ptr<Shader>        ssrShader;
+			UniformHandle                  viewHandle;
+			UniformHandle                  projectionHandle;
+			UniformHandle                  reconstructionHandle;
 			SSRData();
 		};
 	};
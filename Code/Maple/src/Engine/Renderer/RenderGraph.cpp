@@ -17,6 +17,7 @@
 #include "RHI/GPUProfile.h"
 #include "RHI/IndexBuffer.h"
 #include "RHI/Pipeline.h"
+#include "RHI/Shader.h"
 #include "RHI/VertexBuffer.h"
 
 #include "Scene/Component/Atmosphere.h"
@@ -33,6 +34,7 @@
 #include "AtmosphereRenderer.h"
 #include "CloudRenderer.h"
 #include "DeferredOffScreenRenderer.h"
+#include "GPUCulling.h"
 
 #include "Engine/Vientiane/ReflectiveShadowMap.h"
 #include "Engine/Vientiane/LPVIndirectLighting.h"
@@ -41,6 +43,7 @@
 #include "Renderer2D.h"
 #include "RendererData.h"
 #include "SkyboxRenderer.h"
+#include "SkinningPalette.h"
 #include "GridRenderer.h"
 #include "GeometryRenderer.h"
 #include "FinalPass.h"
@@ -58,13 +61,23 @@ namespace maple
 	{
 		using Entity = ecs::Chain
 			::Read<component::RendererData>
+			::Write<capture_graph::component::RenderGraph>
 			::To<ecs::Entity>;
 
 		inline auto system(Entity entity, ecs::World world)
 		{
-			auto [renderer] = entity;
+			auto [renderer, graph] = entity;
 			if (renderer.gbuffer == nullptr)
 				return;
+
+			//the memory is only rearranged between frames, the previous frame still used the old placement.
+			if (graph.aliasesChanged)
+			{
+				renderer.gbuffer->setAliases(graph.aliases);
+				graph.aliasesChanged = false;
+			}
+			capture_graph::discardAliases(graph);
+
 			auto        swapChain = Application::getGraphicsContext()->getSwapChain();
 			auto        renderTargert = renderer.gbuffer->getBuffer(GBufferTextures::SCREEN);
 
@@ -72,13 +85,43 @@ namespace maple
 			Application::getRenderDevice()->clearRenderTarget(renderTargert, renderer.commandBuffer);
 
 			Application::getRenderDevice()->clearRenderTarget(renderer.gbuffer->getBuffer(GBufferTextures::COLOR), renderer.commandBuffer, { 0, 0, 0, 0 });
-			Application::getRenderDevice()->clearRenderTarget(renderer.gbuffer->getBuffer(GBufferTextures::POSITION), renderer.commandBuffer, { 0, 0, 0, 0 });
 			Application::getRenderDevice()->clearRenderTarget(renderer.gbuffer->getBuffer(GBufferTextures::NORMALS), renderer.commandBuffer, { 0, 0, 0, 0 });
 			Application::getRenderDevice()->clearRenderTarget(renderer.gbuffer->getBuffer(GBufferTextures::PBR), renderer.commandBuffer, { 0, 0, 0, 0 });
-
-			Application::getRenderDevice()->clearRenderTarget(renderer.gbuffer->getBuffer(GBufferTextures::VIEW_POSITION), renderer.commandBuffer, { 0, 0, 0, 0 });
-			Application::getRenderDevice()->clearRenderTarget(renderer.gbuffer->getBuffer(GBufferTextures::VIEW_NORMALS), renderer.commandBuffer, { 0, 0, 0, 0 });
 			Application::getRenderDevice()->clearRenderTarget(renderer.gbuffer->getBuffer(GBufferTextures::VELOCITY), renderer.commandBuffer, { 0, 0, 0, 0 });
+
+			//the compact layout rebuilds positions from the depth buffer, these targets are placeholders there.
+			if (!renderer.gbuffer->isCompact())
+			{
+				Application::getRenderDevice()->clearRenderTarget(renderer.gbuffer->getBuffer(GBufferTextures::POSITION), renderer.commandBuffer, { 0, 0, 0, 0 });
+				Application::getRenderDevice()->clearRenderTarget(renderer.gbuffer->getBuffer(GBufferTextures::VIEW_POSITION), renderer.commandBuffer, { 0, 0, 0, 0 });
+				Application::getRenderDevice()->clearRenderTarget(renderer.gbuffer->getBuffer(GBufferTextures::VIEW_NORMALS), renderer.commandBuffer, { 0, 0, 0, 0 });
+			}
+		}
+	}
+
+	namespace on_begin_frame
+	{
+		using Entity = ecs::Chain
+			::Write<capture_graph::component::RenderGraph>
+			::To<ecs::Entity>;
+
+		inline auto system(Entity entity, ecs::World world)
+		{
+			auto [graph] = entity;
+			capture_graph::beginFrame(graph);
+		}
+	}
+
+	namespace on_end_renderer
+	{
+		using Entity = ecs::Chain
+			::Write<capture_graph::component::RenderGraph>
+			::To<ecs::Entity>;
+
+		inline auto system(Entity entity, ecs::World world)
+		{
+			auto [graph] = entity;
+			capture_graph::endFrame(graph);
 		}
 	}
 
@@ -137,7 +180,9 @@ namespace maple
 			data.gbuffer = gBuffer.get();
 		});
 
-		executePoint->registerGlobalComponent<capture_graph::component::RenderGraph>();
+		executePoint->registerGlobalComponent<capture_graph::component::RenderGraph>([&](capture_graph::component::RenderGraph& graph) {
+			graph.transients = gBuffer->getTransients();
+		});
 		executePoint->registerGlobalComponent<component::CameraView>();
 		executePoint->registerGlobalComponent<component::FinalPass>();
 
@@ -152,10 +197,17 @@ namespace maple
 			DescriptorSet::toggleUpdate(true);
 		};
 
+		//the begin queue stays serial : its systems share state the component access does not cover (the pipeline, shader
+		//and texture caches, materials, DescriptorSet::toggleUpdate) and some of them record into the frame command buffer.
 		executePoint->registerQueue(beginQ);
 		executePoint->registerQueue(renderQ);
+		//first in the frame, the begin queue already issues passes (atmosphere).
+		executePoint->registerWithinQueue<on_begin_frame::system>(beginQ);
 		executePoint->registerWithinQueue<on_begin_renderer::system>(renderQ);
 
+		skinning_palette::registerSkinningPalette(beginQ, executePoint);
+		//ahead of the shadow and G-buffer passes, they skip what it handles.
+		gpu_culling::registerGPUCulling(beginQ, renderQ, executePoint);
 		reflective_shadow_map::registerShadowMap(beginQ, renderQ, executePoint);
 		deferred_offscreen::registerDeferredOffScreenRenderer(beginQ, renderQ, executePoint);
 		light_propagation_volume::registerLPV(beginQ, renderQ, executePoint);
@@ -171,6 +223,11 @@ namespace maple
 		grid_renderer::registerGridRenderer(beginQ, renderQ, executePoint);
 		geometry_renderer::registerGeometryRenderer(beginQ, renderQ, executePoint);
 		final_screen_pass::registerFinalPass(renderQ, executePoint);
+		executePoint->registerWithinQueue<on_end_renderer::system>(renderQ);
+
+		//every shader the renderers above registered is built together before their components ask for it,
+		//the factory keeps them.
+		Shader::create(executePoint->getShaders());
 	}
 
 	auto RenderGraph::beginScene(Scene *scene) -> void
@@ -245,6 +302,8 @@ namespace maple
 		for (auto entity : meshGroup)
 		{
 			const auto &[transform, mesh] = meshGroup.get<Transform, MeshRenderer>(entity);
+			if (mesh.getMesh() == nullptr)        //still loading
+				continue;
 
 			auto &data     = previewData->commandQueue.emplace_back();
 			data.mesh      = mesh.getMesh().get();
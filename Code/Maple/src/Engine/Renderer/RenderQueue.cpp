@@ -0,0 +1,142 @@
+//////////////////////////////////////////////////////////////////////////////
+// This file is part of the Maple Engine                              		//
+//////////////////////////////////////////////////////////////////////////////
+
+#include "RenderQueue.h"
+#include "Engine/Mesh.h"
+#include "Engine/Profiler.h"
+#include "Others/HashCode.h"
+#include <algorithm>
+
+namespace maple
+{
+	namespace
+	{
+		inline auto fold16(size_t value) -> uint64_t
+		{
+			value ^= value >> 32;
+			value ^= value >> 16;
+			return value & 0xFFFF;
+		}
+
+		inline auto foldPointer(const void *ptr) -> uint64_t
+		{
+			//allocations are at least 16 bytes aligned, the low bits carry nothing.
+			return fold16(reinterpret_cast<size_t>(ptr) >> 4);
+		}
+
+		//bindless commands pass their material per instance, any two of them can share a draw.
+		inline auto getMaterialKey(const RenderCommand &command) -> const void *
+		{
+			return command.materialIndex >= 0 ? nullptr : command.material;
+		}
+
+		inline auto quantizeDepth(float depth, float nearPlane, float farPlane) -> uint64_t
+		{
+			const float range = std::max(farPlane - nearPlane, 0.0001f);
+			const float t     = std::clamp((depth - nearPlane) / range, 0.f, 1.f);
+			return static_cast<uint64_t>(t * 65535.f);
+		}
+	}        // namespace
+
+	auto RenderQueue::pipelineHash(const PipelineInfo &info) -> size_t
+	{
+		//only the states which change between commands of one pass, the targets are shared.
+		size_t hash = 0;
+		HashCode::hashCode(hash, info.shader, info.cullMode, info.transparencyEnabled, info.depthTarget, info.depthTest);
+		HashCode::hashCode(hash, info.stencilTest, info.stencilMask, info.stencilFunc, info.stencilFail, info.stencilDepthFail, info.stencilDepthPass);
+		return hash;
+	}
+
+	auto RenderQueue::canInstance(const RenderCommand &command) -> bool
+	{
+		return command.material != nullptr && command.boneTransforms == nullptr && command.mesh->getSubMeshCount() <= 1;
+	}
+
+	auto RenderQueue::clear() -> void
+	{
+		items.clear();
+		draws.clear();
+		instanceTransforms.clear();
+		instanceMaterials.clear();
+	}
+
+	auto RenderQueue::build(const std::vector<RenderCommand> &commands, const glm::mat4 &view, float nearPlane, float farPlane, uint32_t maxInstances) -> void
+	{
+		PROFILE_FUNCTION();
+		clear();
+		items.reserve(commands.size());
+
+		for (uint32_t i = 0; i < commands.size(); i++)
+		{
+			auto &     command = commands[i];
+			const auto hash    = pipelineHash(command.pipelineInfo);
+			const auto depth   = quantizeDepth(-(view * command.transform[3]).z, nearPlane, farPlane);
+			//lods of one mesh are separate draws, they never share an instanced call.
+			const auto mesh    = (foldPointer(command.mesh) + command.lod) & 0xFFFF;
+
+			uint64_t key = 0;
+			if (command.pipelineInfo.transparencyEnabled)
+			{
+				key = (1ull << 63) | ((0xFFFFull - depth) << 47) | (fold16(hash) >> 1 << 32) | (foldPointer(getMaterialKey(command)) << 16) | mesh;
+			}
+			else
+			{
+				key = (fold16(hash) >> 1 << 48) | (foldPointer(getMaterialKey(command)) << 32) | (mesh << 16) | depth;
+			}
+			items.push_back({key, i, hash});
+		}
+
+		//the folded fields can collide, the full values break the ties so equal states always end up next to each other.
+		std::sort(items.begin(), items.end(), [&](const Item &a, const Item &b) {
+			if (a.key != b.key)
+				return a.key < b.key;
+			if (a.pipelineHash != b.pipelineHash)
+				return a.pipelineHash < b.pipelineHash;
+			auto &left  = commands[a.index];
+			auto &right = commands[b.index];
+			if (getMaterialKey(left) != getMaterialKey(right))
+				return getMaterialKey(left) < getMaterialKey(right);
+			if (left.mesh != right.mesh)
+				return left.mesh < right.mesh;
+			if (left.lod != right.lod)
+				return left.lod < right.lod;
+			return a.index < b.index;
+		});
+
+		draws.reserve(items.size());
+		for (uint32_t i = 0; i < items.size();)
+		{
+			auto &   first = commands[items[i].index];
+			uint32_t end   = i + 1;
+
+			if (maxInstances > 0 && canInstance(first))
+			{
+				const auto capacity = maxInstances - static_cast<uint32_t>(instanceTransforms.size());
+				while (end < items.size() && end - i < capacity)
+				{
+					auto &next = commands[items[end].index];
+					if (items[end].pipelineHash != items[i].pipelineHash || next.mesh != first.mesh || next.lod != first.lod || getMaterialKey(next) != getMaterialKey(first) || !canInstance(next))
+						break;
+					end++;
+				}
+			}
+
+			const auto count = end - i;
+			if (count > 1)
+			{
+				draws.push_back({items[i].index, count, static_cast<uint32_t>(instanceTransforms.size()), items[i].pipelineHash});
+				for (auto j = i; j < end; j++)
+				{
+					instanceTransforms.emplace_back(commands[items[j].index].transform);
+					instanceMaterials.emplace_back(static_cast<uint32_t>(std::max(commands[items[j].index].materialIndex, 0)));
+				}
+			}
+			else
+			{
+				draws.push_back({items[i].index, 1, 0, items[i].pipelineHash});
+			}
+			i = end;
+		}
+	}
+};        // namespace maple
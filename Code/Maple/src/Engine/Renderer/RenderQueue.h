@@ -0,0 +1,67 @@
+//////////////////////////////////////////////////////////////////////////////
+// This file is part of the Maple Engine                              		//
+//////////////////////////////////////////////////////////////////////////////
+#pragma once
+#include "Engine/Core.h"
+#include "RHI/Definitions.h"
+#include <cstdint>
+#include <glm/glm.hpp>
+#include <vector>
+
+namespace maple
+{
+	/**
+	 * sorts render commands by a 64 bit key and merges neighbours sharing mesh, lod, material and pipeline into instanced draws.
+	 * key layout from the highest bit : transparent(1) | pipeline(15) | material(16) | mesh + lod(16) | depth(16).
+	 * transparent commands keep the flag and put the inverted depth right after it, so they are drawn back to front.
+ * bindless commands (RenderCommand::materialIndex) leave the material out of the key and merge across materials.
+	 */
+	class MAPLE_EXPORT RenderQueue
+	{
+	  public:
+		struct Draw
+		{
+			uint32_t command;               //index into the command queue
+			uint32_t instanceCount;         //more than one means the transforms live in the instance buffer
+			uint32_t instanceOffset;        //first slot of the draw in the instance buffer
+			size_t   pipelineHash;
+		};
+
+		auto clear() -> void;
+		//maxInstances is the capacity of the instance buffer, 0 disables merging.
+		auto build(const std::vector<RenderCommand> &commands, const glm::mat4 &view, float nearPlane, float farPlane, uint32_t maxInstances) -> void;
+
+		inline auto &getDraws() const
+		{
+			return draws;
+		}
+
+		inline auto &getInstanceTransforms() const
+		{
+			return instanceTransforms;
+		}
+
+		//MaterialTable slot of every instance, 0 for commands which are not bindless.
+		inline auto &getInstanceMaterials() const
+		{
+			return instanceMaterials;
+		}
+
+		static auto pipelineHash(const PipelineInfo &info) -> size_t;
+
+	  private:
+		struct Item
+		{
+			uint64_t key;
+			uint32_t index;
+			size_t   pipelineHash;
+		};
+
+		static auto canInstance(const RenderCommand &command) -> bool;
+
+		std::vector<Item>      items;
+		std::vector<Draw>      draws;
+		std::vector<glm::mat4> instanceTransforms;
+		std::vector<uint32_t>  instanceMaterials;
+	};
+};        // namespace maple
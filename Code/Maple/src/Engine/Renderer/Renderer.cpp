@@ -12,9 +12,9 @@ namespace maple
 		Application::getRenderDevice()->bindDescriptorSets(pipeline, cmdBuffer, dynamicOffset, descriptorSets);
 	}
 
-	auto Renderer::drawIndexed(CommandBuffer *commandBuffer, DrawType type, uint32_t count, uint32_t start) -> void
+	auto Renderer::drawIndexed(CommandBuffer *commandBuffer, DrawType type, uint32_t count, uint32_t start, int32_t vertexOffset) -> void
 	{
-		Application::getRenderDevice()->drawIndexed(commandBuffer, type, count, start);
+		Application::getRenderDevice()->drawIndexed(commandBuffer, type, count, start, vertexOffset);
 	}
 
 	auto Renderer::drawArrays(CommandBuffer* commandBuffer, DrawType type, uint32_t count, uint32_t start /*= 0*/) -> void
@@ -32,12 +32,37 @@ namespace maple
 		Application::getRenderDevice()->memoryBarrier(commandBuffer,flags);
 	}
 
-	auto Renderer::drawMesh(CommandBuffer* cmdBuffer, Pipeline* pipeline, Mesh* mesh) -> void
+	auto Renderer::drawMesh(CommandBuffer* cmdBuffer, Pipeline* pipeline, Mesh* mesh, uint32_t lod) -> void
 	{
+		const auto range = mesh->getLod(lod);
 		mesh->getVertexBuffer()->bind(cmdBuffer, pipeline);
 		mesh->getIndexBuffer()->bind(cmdBuffer);
-		Application::getRenderDevice()->drawIndexed(cmdBuffer, DrawType::Triangle, mesh->getIndexBuffer()->getCount());
+		Application::getRenderDevice()->drawIndexed(cmdBuffer, DrawType::Triangle, range.indexCount, mesh->getFirstIndex() + range.indexOffset, mesh->getVertexOffset());
 		mesh->getVertexBuffer()->unbind();
 		mesh->getIndexBuffer()->unbind();
 	}
+
+	auto Renderer::drawMeshInstanced(CommandBuffer *cmdBuffer, Pipeline *pipeline, Mesh *mesh, uint32_t instanceCount, uint32_t lod) -> void
+	{
+		const auto range = mesh->getLod(lod);
+		mesh->getVertexBuffer()->bind(cmdBuffer, pipeline);
+		mesh->getIndexBuffer()->bind(cmdBuffer);
+		Application::getRenderDevice()->drawIndexedInstanced(cmdBuffer, DrawType::Triangle, range.indexCount, instanceCount, mesh->getFirstIndex() + range.indexOffset, mesh->getVertexOffset());
+		mesh->getVertexBuffer()->unbind();
+		mesh->getIndexBuffer()->unbind();
+	}
+
+	auto Renderer::drawIndexedIndirect(CommandBuffer *cmdBuffer, Pipeline *pipeline, VertexBuffer *vertexBuffer, IndexBuffer *indexBuffer, StorageBuffer *commands, uint32_t offset, StorageBuffer *count, uint32_t countOffset, uint32_t maxDraws) -> void
+	{
+		vertexBuffer->bind(cmdBuffer, pipeline);
+		indexBuffer->bind(cmdBuffer);
+		Application::getRenderDevice()->drawIndexedIndirect(cmdBuffer, commands, offset, count, countOffset, maxDraws);
+		vertexBuffer->unbind();
+		indexBuffer->unbind();
+	}
+
+	auto Renderer::drawParallel(CommandBuffer *cmdBuffer, Pipeline *pipeline, uint32_t layer, uint32_t count, uint32_t grainSize, const std::function<void(CommandBuffer *, uint32_t, uint32_t)> &record) -> void
+	{
+		Application::getRenderDevice()->drawParallel(cmdBuffer, pipeline, layer, count, grainSize, record);
+	}
 };        // namespace maple
@@ -12,14 +12,26 @@
 
 namespace maple
 {
+	class VertexBuffer;
+	class IndexBuffer;
+	class StorageBuffer;
+
 	class MAPLE_EXPORT Renderer
 	{
 	  public:
+		//draws one worker records when a pass is split by drawParallel.
+		static constexpr uint32_t DRAWS_PER_CHUNK = 128;
+
 		static auto bindDescriptorSets(Pipeline *pipeline, CommandBuffer *cmdBuffer, uint32_t dynamicOffset, const std::vector<std::shared_ptr<DescriptorSet>> &descriptorSets) -> void;
-		static auto drawIndexed(CommandBuffer *commandBuffer, DrawType type, uint32_t count, uint32_t start = 0) -> void;
+		static auto drawIndexed(CommandBuffer *commandBuffer, DrawType type, uint32_t count, uint32_t start = 0, int32_t vertexOffset = 0) -> void;
 		static auto drawArrays(CommandBuffer* commandBuffer, DrawType type, uint32_t count, uint32_t start = 0) -> void;
 		static auto dispatch(CommandBuffer* commandBuffer, uint32_t x, uint32_t y, uint32_t z) -> void;
 		static auto memoryBarrier(CommandBuffer* commandBuffer,MemoryBarrierFlags flags) -> void;
-		static auto drawMesh(CommandBuffer* cmdBuffer, Pipeline* pipeline, Mesh* mesh) -> void;
+		static auto drawMesh(CommandBuffer* cmdBuffer, Pipeline* pipeline, Mesh* mesh, uint32_t lod = 0) -> void;
+		static auto drawMeshInstanced(CommandBuffer* cmdBuffer, Pipeline* pipeline, Mesh* mesh, uint32_t instanceCount, uint32_t lod = 0) -> void;
+		//draws out of shared geometry (GeometryPool), see RenderDevice::drawIndexedIndirect.
+		static auto drawIndexedIndirect(CommandBuffer *cmdBuffer, Pipeline *pipeline, VertexBuffer *vertexBuffer, IndexBuffer *indexBuffer, StorageBuffer *commands, uint32_t offset, StorageBuffer *count, uint32_t countOffset, uint32_t maxDraws) -> void;
+		//see RenderDevice::drawParallel.
+		static auto drawParallel(CommandBuffer *cmdBuffer, Pipeline *pipeline, uint32_t layer, uint32_t count, uint32_t grainSize, const std::function<void(CommandBuffer *, uint32_t, uint32_t)> &record) -> void;
 	};
 };        // namespace maple
@@ -315,6 +315,7 @@ namespace maple
 		auto registerRenderer2D(ExecuteQueue& begin, ExecuteQueue& renderer, std::shared_ptr<ExecutePoint> executePoint) -> void
 		{
 			executePoint->registerGlobalComponent<component::Renderer2DData>();
+			executePoint->registerShaders({"shaders/Batch2D.shader"});
 			executePoint->registerWithinQueue<on_begin_scene::system>(begin);
 			executePoint->registerWithinQueue<on_render::system>(renderer);
 		}
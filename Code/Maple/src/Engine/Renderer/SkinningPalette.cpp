@@ -0,0 +1,103 @@
+//////////////////////////////////////////////////////////////////////////////
+// This file is part of the Maple Engine                              		//
+//////////////////////////////////////////////////////////////////////////////
+
+#include "SkinningPalette.h"
+
+#include "Engine/Profiler.h"
+#include "Scene/Component/Component.h"
+#include "Scene/Component/MeshRenderer.h"
+#include "Scene/Component/Transform.h"
+#include "Scene/Entity/Entity.h"
+#include "Thread/ParallelForEach.h"
+
+#include <ecs/ecs.h>
+
+namespace maple
+{
+	namespace skinning_palette
+	{
+		using Entity = ecs::Chain
+			::Write<component::SkinningPalette>
+			::To<ecs::Entity>;
+
+		using BoneQuery = ecs::Chain
+			::Read<component::BoneComponent>
+			::Read<component::Transform>
+			::To<ecs::Query>;
+
+		auto onSkinningChanged(entt::registry &registry, entt::entity entity) -> void
+		{
+			//only the global entity of the scene holds a palette.
+			for (auto global : registry.view<component::SkinningPalette>())
+			{
+				registry.get<component::SkinningPalette>(global).skinningChanged = true;
+			}
+		}
+
+		inline auto bind(component::SkinningPalette &palette, BoneQuery &boneQuery) -> void
+		{
+			PROFILE_FUNCTION();
+			palette.skeletons.clear();
+			palette.lookup.clear();
+
+			for (auto boneEntity : boneQuery)
+			{
+				auto ent   = boneQuery.convert(boneEntity);
+				auto [bone, trans] = ent;
+				if (bone.boneIndex < 0 || bone.boneIndex >= static_cast<int32_t>(component::SkinningPalette::MAX_BONES))
+					continue;
+
+				//the closest ancestor holding the model owns the skeleton.
+				auto root = ent.castTo<maple::Entity>().getParent();
+				while (root.valid() && !root.hasComponent<component::Model>())
+				{
+					root = root.getParent();
+				}
+				if (!root.valid())
+					continue;
+
+				auto [iter, inserted] = palette.lookup.try_emplace(root.getHandle(), static_cast<uint32_t>(palette.skeletons.size()));
+				if (inserted)
+					palette.skeletons.push_back({root.getHandle(), {}});
+
+				auto &bones = palette.skeletons[iter->second].bones;
+				if (bones.size() <= static_cast<size_t>(bone.boneIndex))
+					bones.resize(bone.boneIndex + 1, entt::null);
+				bones[bone.boneIndex] = boneEntity;
+			}
+			palette.matrices.assign((palette.skeletons.size() + 1) * component::SkinningPalette::MAX_BONES, glm::mat4(1.f));
+		}
+
+		inline auto system(Entity entity, BoneQuery boneQuery, ecs::World world)
+		{
+			auto [palette] = entity;
+
+			if (palette.hierarchyVersion != component::Hierarchy::getVersion() || palette.skinningChanged)
+			{
+				bind(palette, boneQuery);
+				palette.hierarchyVersion = component::Hierarchy::getVersion();
+				palette.skinningChanged  = false;
+			}
+
+			//every skeleton writes its own range and touches only its own bones.
+			parallelFor(0, static_cast<uint32_t>(palette.skeletons.size()), 1, [&](uint32_t i) {
+				auto &skeleton = palette.skeletons[i];
+				auto  matrices = &palette.matrices[(i + 1) * component::SkinningPalette::MAX_BONES];
+				for (size_t j = 0; j < skeleton.bones.size(); j++)
+				{
+					if (skeleton.bones[j] == entt::null)
+						continue;
+					auto [bone, trans] = boneQuery.convert(skeleton.bones[j]);
+					matrices[j]        = trans.getWorldMatrix() * trans.getOffsetMatrix();
+				}
+			});
+		}
+
+		auto registerSkinningPalette(ExecuteQueue &begin, std::shared_ptr<ExecutePoint> executePoint) -> void
+		{
+			executePoint->registerGlobalComponent<component::SkinningPalette>();
+			executePoint->registerWithinQueue<skinning_palette::system>(begin);
+		}
+	}        // namespace skinning_palette
+};           // namespace maple
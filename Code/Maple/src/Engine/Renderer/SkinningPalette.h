@@ -0,0 +1,61 @@
+//////////////////////////////////////////////////////////////////////////////
+// This file is part of the Maple Engine                              		//
+//////////////////////////////////////////////////////////////////////////////
+#pragma once
+
+#include "Scene/System/ExecutePoint.h"
+
+#include <entt/entity/entity.hpp>
+#include <entt/entity/fwd.hpp>
+#include <glm/glm.hpp>
+#include <unordered_map>
+#include <vector>
+
+namespace maple
+{
+	namespace component
+	{
+		/**
+		 * bone matrices of every skeleton in the scene, computed once per frame and shared by the passes drawing skinned meshes.
+		 * bones are resolved to their skeleton only when the hierarchy changes or skinned meshes or bones come and go.
+		 */
+		struct SkinningPalette
+		{
+			//same as MAX_BONES in DeferredColorAnim.vert, every skeleton owns a range of this size.
+			static constexpr uint32_t MAX_BONES = 100;
+
+			struct Skeleton
+			{
+				entt::entity              root;         //entity holding the model, parent of the skinned meshes
+				std::vector<entt::entity> bones;        //indexed by BoneComponent::boneIndex
+			};
+
+			std::vector<Skeleton>                      skeletons;
+			std::unordered_map<entt::entity, uint32_t> lookup;
+			std::vector<glm::mat4>                     matrices;        //range 0 stays identity for meshes without a skeleton
+			uint32_t                                   hierarchyVersion = UINT32_MAX;
+			//set when skinned meshes or bones of this scene come and go.
+			bool skinningChanged = true;
+
+			SkinningPalette()
+			{
+				matrices.assign(MAX_BONES, glm::mat4(1.f));
+			}
+
+			//returns the MAX_BONES matrices of the skeleton owned by root.
+			inline auto get(entt::entity root) const -> const glm::mat4 *
+			{
+				if (auto iter = lookup.find(root); iter != lookup.end())
+					return &matrices[(iter->second + 1) * MAX_BONES];
+				return matrices.data();
+			}
+		};
+	}        // namespace component
+
+	namespace skinning_palette
+	{
+		auto registerSkinningPalette(ExecuteQueue &begin, std::shared_ptr<ExecutePoint> executePoint) -> void;
+		//connected to the construction and destruction of skinned mesh renderers and bones, flags the palette of that registry.
+		auto onSkinningChanged(entt::registry &registry, entt::entity entity) -> void;
+	};
+}        // namespace maple
@@ -57,6 +57,7 @@ namespace maple
 			screenMesh = Mesh::createQuad(true);
 			skyboxShader = Shader::create("shaders/Skybox.shader");
 			descriptorSet = DescriptorSet::create({ 0, skyboxShader.get() });
+			lodLevel = descriptorSet->getUniformHandle("UniformBufferObjectLod", "lodLevel");
 			skyboxMesh = Mesh::createCube();
 
 			irradianceMap = TextureCube::create(1);
@@ -193,7 +194,12 @@ namespace maple
 
 				auto pipeline = Pipeline::get(info, { skyboxData.pseudoSkydescriptorSet },graph);
 
-				skyboxData.pseudoSkydescriptorSet->setTexture("uPositionSampler", renderData.gbuffer->getBuffer(GBufferTextures::POSITION));
+				//no clouds read the sky this frame.
+				if (capture_graph::isCulled(graph, info.shader.get()))
+					return;
+
+				//only the size of the target is read, the compact G-buffer keeps a placeholder for the positions.
+				skyboxData.pseudoSkydescriptorSet->setTexture("uPositionSampler", renderData.gbuffer->getBuffer(renderData.gbuffer->isCompact() ? GBufferTextures::COLOR : GBufferTextures::POSITION));
 				skyboxData.pseudoSkydescriptorSet->update();
 
 				pipeline->bind(renderData.commandBuffer);
@@ -236,7 +242,7 @@ namespace maple
 					skyboxData.descriptorSet->setTexture("uCubeMap", skyboxData.irradianceMap);
 				}
 
-				skyboxData.descriptorSet->setUniform("UniformBufferObjectLod", "lodLevel", &skyboxData.cubeMapLevel);
+				skyboxData.descriptorSet->setUniform(skyboxData.lodLevel, &skyboxData.cubeMapLevel);
 				skyboxData.descriptorSet->update();
 
 				auto& constants = skyboxData.skyboxShader->getPushConstants();
@@ -256,6 +262,7 @@ namespace maple
 		auto registerSkyboxRenderer(ExecuteQueue& begin, ExecuteQueue& renderer, std::shared_ptr<ExecutePoint> executePoint) -> void
 		{
 			executePoint->registerGlobalComponent<component::SkyboxData>();
+			executePoint->registerShaders({"shaders/PseudoSky.shader", "shaders/Skybox.shader"});
 			executePoint->registerWithinQueue<skybox_pass::beginScene>(begin);
 			executePoint->registerWithinQueue<skybox_pass::onRender>(renderer);
 		}
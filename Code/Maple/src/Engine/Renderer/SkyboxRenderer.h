@@ -4,6 +4,7 @@
 #pragma once
 
 #include "Renderer.h"
+#include "RHI/DescriptorSet.h"
 #include "Scene/System/ExecutePoint.h"
 namespace maple
 {
@@ -27,6 +28,7 @@ namespace maple
 			std::shared_ptr<Pipeline>      pipeline;
 			std::shared_ptr<DescriptorSet> descriptorSet;
 			std::shared_ptr<Mesh>          skyboxMesh;
+			UniformHandle                  lodLevel;
 
 			bool pseudoSky = false;
 
@@ -8,6 +8,7 @@
 
 #include <glm/glm.hpp>
 #include <glm/gtc/matrix_transform.hpp>
+#include <glm/gtc/type_precision.hpp>
 #include <glm/gtx/hash.hpp>
 #include <array>
 namespace maple
@@ -77,6 +78,25 @@ namespace maple
 		}
 	};
 
+	//quantized layouts of imported meshes (see VertexCompression.h), the shaders unpack them from uint inputs.
+	struct CompactVertex
+	{
+		glm::u16vec4 pos;             //unorm16 inside the mesh bounds, w is unused
+		uint32_t     normal;          //octahedral, snorm16x2
+		uint32_t     tangent;         //octahedral, snorm16x2
+		uint32_t     texCoord;        //half2
+	};
+
+	struct CompactSkinnedVertex
+	{
+		glm::u16vec4 pos;
+		uint32_t     normal;
+		uint32_t     tangent;
+		uint32_t     texCoord;
+		glm::u8vec4  boneIndices;
+		glm::u8vec4  boneWeights;        //unorm8, summing up to 255
+	};
+
 	struct Vertex2D
 	{
 		glm::vec3 vertex;
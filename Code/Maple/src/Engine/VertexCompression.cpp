@@ -0,0 +1,132 @@
+//////////////////////////////////////////////////////////////////////////////
+// This file is part of the Maple Engine                              		//
+//////////////////////////////////////////////////////////////////////////////
+#include "VertexCompression.h"
+
+#include <glm/packing.hpp>
+#include <limits>
+
+namespace maple
+{
+	namespace VertexCompression
+	{
+		namespace
+		{
+			template <typename T>
+			inline auto getBounds(const std::vector<T> &vertices, glm::vec4 &scale, glm::vec4 &offset) -> bool
+			{
+				if (vertices.empty())
+					return false;
+
+				glm::vec3 min(std::numeric_limits<float>::max());
+				glm::vec3 max(std::numeric_limits<float>::lowest());
+				for (auto &vertex : vertices)
+				{
+					if (vertex.color != glm::vec4(1.f))
+						return false;
+					if (glm::any(glm::greaterThan(glm::abs(vertex.texCoord), glm::vec2(MAX_HALF_TEXCOORD))))
+						return false;
+					min = glm::min(min, vertex.pos);
+					max = glm::max(max, vertex.pos);
+				}
+
+				const auto extent = max - min;
+				//rounding to unorm16 moves a position by half a step at most.
+				if (glm::max(extent.x, glm::max(extent.y, extent.z)) / 65535.f * 0.5f > MAX_POSITION_ERROR)
+					return false;
+
+				scale  = glm::vec4(extent, 0.f);
+				offset = glm::vec4(min, 0.f);
+				return true;
+			}
+
+			template <typename T, typename C>
+			inline auto pack(const T &vertex, C &out, const glm::vec3 &invScale, const glm::vec3 &offset)
+			{
+				const auto pos = glm::round(glm::clamp((vertex.pos - offset) * invScale, 0.f, 1.f) * 65535.f);
+				out.pos        = glm::u16vec4(pos.x, pos.y, pos.z, 0);
+				out.normal     = octEncode(vertex.normal);
+				out.tangent    = octEncode(vertex.tangent);
+				out.texCoord   = glm::packHalf2x16(vertex.texCoord);
+			}
+
+			inline auto getInvScale(const glm::vec4 &scale)
+			{
+				//flat meshes have no extent on one axis, every position there is the offset.
+				return glm::vec3(
+				    scale.x > 0.f ? 1.f / scale.x : 0.f,
+				    scale.y > 0.f ? 1.f / scale.y : 0.f,
+				    scale.z > 0.f ? 1.f / scale.z : 0.f);
+			}
+		}        // namespace
+
+		auto octEncode(const glm::vec3 &vector) -> uint32_t
+		{
+			const auto length = glm::abs(vector.x) + glm::abs(vector.y) + glm::abs(vector.z);
+			if (length == 0.f)
+				return glm::packSnorm2x16(glm::vec2(0.f));
+
+			auto n = glm::vec2(vector) / length;
+			if (vector.z < 0.f)
+			{
+				//the lower hemisphere is folded over the diagonals.
+				const glm::vec2 sign(n.x >= 0.f ? 1.f : -1.f, n.y >= 0.f ? 1.f : -1.f);
+				n = (1.f - glm::abs(glm::vec2(n.y, n.x))) * sign;
+			}
+			return glm::packSnorm2x16(n);
+		}
+
+		auto compress(const std::vector<Vertex> &vertices, std::vector<CompactVertex> &out, glm::vec4 &scale, glm::vec4 &offset) -> bool
+		{
+			if (!getBounds(vertices, scale, offset))
+				return false;
+
+			const auto invScale = getInvScale(scale);
+			out.resize(vertices.size());
+			for (size_t i = 0; i < vertices.size(); i++)
+			{
+				pack(vertices[i], out[i], invScale, offset);
+			}
+			return true;
+		}
+
+		auto compress(const std::vector<SkinnedVertex> &vertices, std::vector<CompactSkinnedVertex> &out, glm::vec4 &scale, glm::vec4 &offset) -> bool
+		{
+			for (auto &vertex : vertices)
+			{
+				if (glm::any(glm::lessThan(vertex.boneIndices, glm::vec4(0.f))) || glm::any(glm::greaterThan(vertex.boneIndices, glm::vec4(255.f))))
+					return false;
+			}
+
+			if (!getBounds(vertices, scale, offset))
+				return false;
+
+			const auto invScale = getInvScale(scale);
+			out.resize(vertices.size());
+			for (size_t i = 0; i < vertices.size(); i++)
+			{
+				auto &vertex = vertices[i];
+				pack(vertex, out[i], invScale, offset);
+				out[i].boneIndices = glm::u8vec4(vertex.boneIndices);
+
+				auto       weights = glm::clamp(vertex.boneWeights, 0.f, 1.f);
+				const auto sum     = weights.x + weights.y + weights.z + weights.w;
+				if (sum > 0.f)
+					weights /= sum;
+
+				auto    quantized = glm::ivec4(glm::round(weights * 255.f));
+				int32_t largest   = 0;
+				for (int32_t j = 1; j < 4; j++)
+				{
+					if (quantized[j] > quantized[largest])
+						largest = j;
+				}
+				//rounding can leave the sum a few steps off, the largest weight takes the difference.
+				if (sum > 0.f)
+					quantized[largest] += 255 - (quantized.x + quantized.y + quantized.z + quantized.w);
+				out[i].boneWeights = glm::u8vec4(quantized);
+			}
+			return true;
+		}
+	};        // namespace VertexCompression
+};            // namespace maple
@@ -0,0 +1,30 @@
+//////////////////////////////////////////////////////////////////////////////
+// This file is part of the Maple Engine                              		//
+//////////////////////////////////////////////////////////////////////////////
+#pragma once
+#include "Engine/Core.h"
+#include "Engine/Vertex.h"
+
+#include <vector>
+
+namespace maple
+{
+	/**
+	 * converts imported vertices into the compact layouts, positions are stored as unorm16 inside the bounds
+	 * of the mesh and rebuilt in the shader as offset + scale * position.
+	 * a mesh is left in the full layout if it can not be represented without visible loss.
+	 */
+	namespace VertexCompression
+	{
+		//largest position error allowed, bigger meshes keep float positions.
+		static constexpr float MAX_POSITION_ERROR = 0.0005f;
+		//half floats keep at least 1/1024 of precision up to this range.
+		static constexpr float MAX_HALF_TEXCOORD = 2.f;
+
+		auto MAPLE_EXPORT octEncode(const glm::vec3 &vector) -> uint32_t;
+
+		//false if the vertices need the full layout, vertex colors are not kept in the compact one.
+		auto MAPLE_EXPORT compress(const std::vector<Vertex> &vertices, std::vector<CompactVertex> &out, glm::vec4 &scale, glm::vec4 &offset) -> bool;
+		auto MAPLE_EXPORT compress(const std::vector<SkinnedVertex> &vertices, std::vector<CompactSkinnedVertex> &out, glm::vec4 &scale, glm::vec4 &offset) -> bool;
+	};        // namespace VertexCompression
+};            // namespace maple
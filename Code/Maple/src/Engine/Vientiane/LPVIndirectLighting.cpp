@@ -26,10 +26,17 @@ namespace maple
 			{
 				std::shared_ptr<Shader>                     shader;
 				std::vector<std::shared_ptr<DescriptorSet>> descriptorSets;
+				UniformHandle                               minAABB;
+				UniformHandle                               cellSize;
+				UniformHandle                               reconstruction;
 				IndirectLight() 
 				{
-					shader = Shader::create("shaders/LPV/IndirectLight.shader");
+					//the compact G-buffer has no position target, positions come from the depth buffer.
+					shader = Shader::create(GBuffer::isCompactLayoutEnabled() ? "shaders/LPV/IndirectLightPacked.shader" : "shaders/LPV/IndirectLight.shader");
 					descriptorSets.emplace_back(DescriptorSet::create({0,shader.get()}));
+					minAABB  = descriptorSets[0]->getUniformHandle("UniformBufferObject", "minAABB");
+					cellSize = descriptorSets[0]->getUniformHandle("UniformBufferObject", "cellSize");
+					reconstruction = descriptorSets[0]->getUniformHandle("UniformBufferObject", "reconstruction");
 				}
 			};
 		};
@@ -40,25 +47,30 @@ namespace maple
 			::Read<maple::component::RendererData>
 			::Read<maple::component::LPVGrid>
 			::Read<maple::component::BoundingBoxComponent>
+			::Read<maple::component::CameraView>
 			::To<ecs::Entity>;
 
 		inline auto dispatch(Entity entity, ecs::World world)
 		{
-			auto [renderGraph, indirectLight, renderData, lpv, aabb] = entity;
+			auto [renderGraph, indirectLight, renderData, lpv, aabb, cameraView] = entity;
 			
 			if (lpv.lpvAccumulatorR == nullptr) 
 				return;
 
 			auto commandBuffer = renderData.commandBuffer;
 
-			indirectLight.descriptorSets[0]->setUniform("UniformBufferObject", "minAABB", glm::value_ptr(aabb.box->min));
-			indirectLight.descriptorSets[0]->setUniform("UniformBufferObject", "cellSize", &lpv.cellSize);
+			indirectLight.descriptorSets[0]->setUniform(indirectLight.minAABB, glm::value_ptr(aabb.box->min));
+			indirectLight.descriptorSets[0]->setUniform(indirectLight.cellSize, &lpv.cellSize);
+			const auto reconstruction = GBuffer::getReconstruction(cameraView.projView);
+			indirectLight.descriptorSets[0]->setUniform(indirectLight.reconstruction, glm::value_ptr(reconstruction));
 
 			indirectLight.descriptorSets[0]->setTexture("uRAccumulatorLPV", lpv.lpvAccumulatorR);
 			indirectLight.descriptorSets[0]->setTexture("uGAccumulatorLPV", lpv.lpvAccumulatorG);
 			indirectLight.descriptorSets[0]->setTexture("uBAccumulatorLPV", lpv.lpvAccumulatorB);
 			indirectLight.descriptorSets[0]->setTexture("uWorldNormalSampler", renderData.gbuffer->getBuffer(GBufferTextures::NORMALS));
-			indirectLight.descriptorSets[0]->setTexture("uWorldPositionSampler", renderData.gbuffer->getBuffer(GBufferTextures::POSITION));
+			if (!renderData.gbuffer->isCompact())
+				indirectLight.descriptorSets[0]->setTexture("uWorldPositionSampler", renderData.gbuffer->getBuffer(GBufferTextures::POSITION));
+			indirectLight.descriptorSets[0]->setTexture("uDepthSampler", renderData.gbuffer->getDepthBuffer());
 			indirectLight.descriptorSets[0]->setTexture("uIndirectLight", renderData.gbuffer->getBuffer(GBufferTextures::INDIRECT_LIGHTING));
 			indirectLight.descriptorSets[0]->update();
 
@@ -67,6 +79,8 @@ namespace maple
 			pipelineInfo.groupCountX = renderData.gbuffer->getWidth() / indirectLight.shader->getLocalSizeX();
 			pipelineInfo.groupCountY = renderData.gbuffer->getHeight() / indirectLight.shader->getLocalSizeY();
 			auto pipeline = Pipeline::get(pipelineInfo, indirectLight.descriptorSets, renderGraph);
+			if (capture_graph::isCulled(renderGraph, pipelineInfo.shader.get()))
+				return;
 			pipeline->bind(renderData.commandBuffer);
 			Renderer::bindDescriptorSets(pipeline.get(), renderData.commandBuffer, 0, indirectLight.descriptorSets);
 			Renderer::dispatch(renderData.commandBuffer, pipelineInfo.groupCountX, pipelineInfo.groupCountY, 1);
@@ -76,6 +90,7 @@ namespace maple
 		auto registerLPVIndirectLight(ExecuteQueue& renderer, std::shared_ptr<ExecutePoint> executePoint) -> void
 		{
 			executePoint->registerGlobalComponent<component::IndirectLight>();
+			executePoint->registerShaders({GBuffer::isCompactLayoutEnabled() ? "shaders/LPV/IndirectLightPacked.shader" : "shaders/LPV/IndirectLight.shader"});
 			executePoint->registerWithinQueue<lpv_indirect_lighting::dispatch>(renderer);
 		}
 	}
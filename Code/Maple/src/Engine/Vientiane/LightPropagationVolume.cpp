@@ -90,10 +90,19 @@ namespace maple
 			std::shared_ptr<Shader> shader;
 			std::vector<std::shared_ptr<DescriptorSet>> descriptors;
 			BoundingBox boundingBox;
+			struct
+			{
+				UniformHandle gridSize;
+				UniformHandle minAABB;
+				UniformHandle cellSize;
+			} uniforms;
 			InjectLightData()
 			{
 				shader = Shader::create("shaders/LPV/LightInjection.shader");
 				descriptors.emplace_back(DescriptorSet::create({0,shader.get()}));
+				uniforms.gridSize = descriptors[0]->getUniformHandle("UniformBufferObject", "gridSize");
+				uniforms.minAABB  = descriptors[0]->getUniformHandle("UniformBufferObject", "minAABB");
+				uniforms.cellSize = descriptors[0]->getUniformHandle("UniformBufferObject", "cellSize");
 			}
 		};
 
@@ -101,10 +110,23 @@ namespace maple
 		{
 			std::shared_ptr<Shader> shader;
 			std::vector<std::shared_ptr<DescriptorSet>> descriptors;
+			struct
+			{
+				UniformHandle lightViewMat;
+				UniformHandle minAABB;
+				UniformHandle cellSize;
+				UniformHandle lightDir;
+				UniformHandle rsmArea;
+			} uniforms;
 			InjectGeometryVolume()
 			{
 				shader = Shader::create("shaders/LPV/GeometryInjection.shader");
 				descriptors.emplace_back(DescriptorSet::create({ 0,shader.get() }));
+				uniforms.lightViewMat = descriptors[0]->getUniformHandle("UniformBufferObject", "lightViewMat");
+				uniforms.minAABB      = descriptors[0]->getUniformHandle("UniformBufferObject", "minAABB");
+				uniforms.cellSize     = descriptors[0]->getUniformHandle("UniformBufferObject", "cellSize");
+				uniforms.lightDir     = descriptors[0]->getUniformHandle("UniformBufferObject", "lightDir");
+				uniforms.rsmArea      = descriptors[0]->getUniformHandle("UniformBufferObject", "rsmArea");
 			}
 		};
 
@@ -112,10 +134,19 @@ namespace maple
 		{
 			std::shared_ptr<Shader> shader;
 			std::vector<std::shared_ptr<DescriptorSet>> descriptors;
+			struct
+			{
+				UniformHandle gridDim;
+				UniformHandle occlusionAmplifier;
+				UniformHandle step;
+			} uniforms;
 			PropagationData()
 			{
 				shader = Shader::create("shaders/LPV/LightPropagation.shader");
 				descriptors.emplace_back(DescriptorSet::create({ 0,shader.get() }));
+				uniforms.gridDim            = descriptors[0]->getUniformHandle("UniformObject", "gridDim");
+				uniforms.occlusionAmplifier = descriptors[0]->getUniformHandle("UniformObject", "occlusionAmplifier");
+				uniforms.step               = descriptors[0]->getUniformHandle("UniformObject", "step");
 			}
 		};
 
@@ -124,12 +155,21 @@ namespace maple
 			std::shared_ptr<Shader> shader;
 			std::vector<std::shared_ptr<DescriptorSet>> descriptors;
 			std::shared_ptr<Mesh> sphere;
+			struct
+			{
+				UniformHandle projView;
+				UniformHandle minAABB;
+				UniformHandle cellSize;
+			} uniforms;
 			DebugAABBData()
 			{
 				shader = Shader::create("shaders/LPV/AABBDebug.shader");
 				descriptors.emplace_back(DescriptorSet::create({ 0,shader.get() }));
 				descriptors.emplace_back(DescriptorSet::create({ 1,shader.get() }));
 				sphere = Mesh::createSphere();
+				uniforms.projView = descriptors[0]->getUniformHandle("UniformBufferObjectVert", "projView");
+				uniforms.minAABB  = descriptors[1]->getUniformHandle("UniformBufferObjectFrag", "minAABB");
+				uniforms.cellSize = descriptors[1]->getUniformHandle("UniformBufferObjectFrag", "cellSize");
 			}
 		};
 
@@ -161,13 +201,13 @@ namespace maple
 					injectLight.boundingBox.max = aabb.box->max;
 					auto size = aabb.box->size();
 					auto gridSize = 32.f;
-					injectLight.descriptors[0]->setUniform("UniformBufferObject", "gridSize", &gridSize);
-					injectLight.descriptors[0]->setUniform("UniformBufferObject", "minAABB", glm::value_ptr(injectLight.boundingBox.min));
+					injectLight.descriptors[0]->setUniform(injectLight.uniforms.gridSize, &gridSize);
+					injectLight.descriptors[0]->setUniform(injectLight.uniforms.minAABB, glm::value_ptr(injectLight.boundingBox.min));
 
 					auto maxValue = std::max(size.x, std::max(size.y, size.z));
 					lpv.cellSize = maxValue / 32.f;
 
-					injectLight.descriptors[0]->setUniform("UniformBufferObject", "cellSize", &lpv.cellSize);
+					injectLight.descriptors[0]->setUniform(injectLight.uniforms.cellSize, &lpv.cellSize);
 				}
 			}
 
@@ -217,11 +257,11 @@ namespace maple
 				auto [lpv, geometry,aabb,shadowData,rsm, rendererData] = entity;
 				if (lpv.lpvGridR == nullptr)
 					return;
-				geometry.descriptors[0]->setUniform("UniformBufferObject", "lightViewMat", glm::value_ptr(rsm.lightMatrix));
-				geometry.descriptors[0]->setUniform("UniformBufferObject", "minAABB", glm::value_ptr(aabb.box->min));
-				geometry.descriptors[0]->setUniform("UniformBufferObject", "cellSize", &lpv.cellSize);
-				geometry.descriptors[0]->setUniform("UniformBufferObject", "lightDir", glm::value_ptr(shadowData.lightDir));
-				geometry.descriptors[0]->setUniform("UniformBufferObject", "rsmArea", &rsm.lightArea);
+				geometry.descriptors[0]->setUniform(geometry.uniforms.lightViewMat, glm::value_ptr(rsm.lightMatrix));
+				geometry.descriptors[0]->setUniform(geometry.uniforms.minAABB, glm::value_ptr(aabb.box->min));
+				geometry.descriptors[0]->setUniform(geometry.uniforms.cellSize, &lpv.cellSize);
+				geometry.descriptors[0]->setUniform(geometry.uniforms.lightDir, glm::value_ptr(shadowData.lightDir));
+				geometry.descriptors[0]->setUniform(geometry.uniforms.rsmArea, &rsm.lightArea);
 			}
 
 			inline auto render(Entity entity, ecs::World world)
@@ -270,8 +310,8 @@ namespace maple
 				auto [lpv, data, aabb,renderData] = entity;
 				if (lpv.lpvGridR == nullptr)
 					return;
-				data.descriptors[0]->setUniform("UniformObject", "gridDim", glm::value_ptr(aabb.box->size()));
-				data.descriptors[0]->setUniform("UniformObject", "occlusionAmplifier", &lpv.occlusionAmplifier);
+				data.descriptors[0]->setUniform(data.uniforms.gridDim, glm::value_ptr(aabb.box->size()));
+				data.descriptors[0]->setUniform(data.uniforms.occlusionAmplifier, &lpv.occlusionAmplifier);
 			}
 
 			inline auto render(Entity entity, ecs::World world)
@@ -314,7 +354,7 @@ namespace maple
 					data.descriptors[0]->setTexture("LPVGridR_", lpv.lpvRs[i]);
 					data.descriptors[0]->setTexture("LPVGridG_", lpv.lpvGs[i]);
 					data.descriptors[0]->setTexture("LPVGridB_", lpv.lpvBs[i]);  
-					data.descriptors[0]->setUniform("UniformObject", "step", &i );
+					data.descriptors[0]->setUniform(data.uniforms.step, &i );
 					data.descriptors[0]->update();
 					Renderer::bindDescriptorSets(pipeline.get(), rendererData.commandBuffer, 0, data.descriptors);
 					Renderer::dispatch(rendererData.commandBuffer, pipelineInfo.groupCountX, pipelineInfo.groupCountY, pipelineInfo.groupCountZ);
@@ -339,10 +379,10 @@ namespace maple
 				if (lpv.lpvGridR == nullptr || !lpv.debugAABB)
 					return;
 
-				data.descriptors[0]->setUniform("UniformBufferObjectVert", "projView", glm::value_ptr(cameraView.projView));
+				data.descriptors[0]->setUniform(data.uniforms.projView, glm::value_ptr(cameraView.projView));
 
-				data.descriptors[1]->setUniform("UniformBufferObjectFrag", "minAABB", glm::value_ptr(aabb.box->min));
-				data.descriptors[1]->setUniform("UniformBufferObjectFrag", "cellSize", &lpv.cellSize);
+				data.descriptors[1]->setUniform(data.uniforms.minAABB, glm::value_ptr(aabb.box->min));
+				data.descriptors[1]->setUniform(data.uniforms.cellSize, &lpv.cellSize);
 			}
 
 			inline auto render(Entity entity, ecs::World world)
@@ -423,6 +463,11 @@ namespace maple
 			executePoint->registerGlobalComponent<component::InjectLightData>();
 			executePoint->registerGlobalComponent<component::InjectGeometryVolume>();
 			executePoint->registerGlobalComponent<component::PropagationData>();
+			executePoint->registerShaders({
+			    "shaders/LPV/LightInjection.shader",
+			    "shaders/LPV/GeometryInjection.shader",
+			    "shaders/LPV/LightPropagation.shader",
+			});
 
 			executePoint->registerWithinQueue<inject_light_pass::beginScene>(begin);
 			executePoint->registerWithinQueue<inject_light_pass::render>(renderer);
@@ -436,6 +481,7 @@ namespace maple
 		auto registerLPVDebug(ExecuteQueue& begin, ExecuteQueue& renderer, std::shared_ptr<ExecutePoint> executePoint) -> void
 		{
 			executePoint->registerGlobalComponent<component::DebugAABBData>();
+			executePoint->registerShaders({"shaders/LPV/AABBDebug.shader"});
 			executePoint->registerWithinQueue<aabb_debug::beginScene>(begin);
 			executePoint->registerWithinQueue<aabb_debug::render>(renderer);
 		}
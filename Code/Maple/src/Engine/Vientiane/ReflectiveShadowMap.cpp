@@ -12,6 +12,7 @@
 #include "Engine/Renderer/RendererData.h"
 #include "Engine/CaptureGraph.h"
 #include "Engine/Renderer/GeometryRenderer.h"
+#include "Engine/Renderer/GPUCulling.h"
 
 #include "ImGui/ImGuiHelpers.h"
 #include "Math/Frustum.h"
@@ -31,15 +32,28 @@
 #include "Application.h"
 
 #include <ecs/ecs.h>
+#include <algorithm>
 
 namespace maple
 {
 	namespace        //private block
 	{
-		inline auto updateCascades(const component::CameraView & camera, component::ShadowMapData& shadowData, component::Light *light)
+		inline auto updateCascades(const component::CameraView & camera, component::ShadowMapData& shadowData, component::Light *light, uint32_t staticVersion)
 		{
 			PROFILE_FUNCTION();
 
+			glm::vec3 lightDir = glm::normalize(glm::vec3(light->lightData.direction));
+
+			//a new light direction invalidates every cascade regardless of the schedule.
+			const bool lightChanged  = shadowData.shadowMapsInvalidated || glm::dot(lightDir, shadowData.lightDir) < 0.9999f;
+			const bool staticChanged = staticVersion != shadowData.staticVersion;
+
+			shadowData.shadowMapsInvalidated = false;
+			shadowData.staticVersion         = staticVersion;
+			if (lightChanged)
+				shadowData.lightDir = lightDir;
+			lightDir = shadowData.lightDir;
+
 			float cascadeSplits[SHADOWMAP_MAX];
 
 			const float nearClip  = camera.nearPlane;
@@ -63,6 +77,15 @@ namespace maple
 			for (uint32_t i = 0; i < shadowData.shadowMapNum; i++)
 			{
 				PROFILE_SCOPE("Create Cascade");
+				auto &cache = shadowData.cascadeCache[i];
+				cache.staticDirty |= staticChanged || lightChanged;
+
+				const auto interval = std::max(1u, shadowData.cascadeUpdateInterval[i]);
+				//offset by the cascade index, so the far cascades are not refreshed on the same frame.
+				cache.render = lightChanged || (shadowData.frameIndex + i) % interval == 0;
+				if (!cache.render)
+					continue;
+
 				float splitDist     = cascadeSplits[i];
 				float lastSplitDist = cascadeSplits[i];
 
@@ -92,28 +115,41 @@ namespace maple
 				}
 				radius = std::ceil(radius * 16.0f) / 16.0f;
 
-				glm::vec3 maxExtents = glm::vec3(radius);
+				shadowData.splitDepth[i] = glm::vec4(camera.nearPlane + splitDist * clipRange) * -1.f;
+
+				//keep the projection while the slice stays inside it, otherwise the static layer has to be redrawn.
+				const float cachedRadius = radius * (1.0f + (shadowData.staticCache ? shadowData.cascadeCacheMargin : 0.0f));
+				const bool  covered      = !lightChanged && cache.radius == cachedRadius && glm::length(frustumCenter - cache.center) + radius <= cache.radius;
+				if (covered)
+					continue;
+
+				cache.center      = frustumCenter;
+				cache.radius      = cachedRadius;
+				cache.staticDirty = true;
+
+				glm::vec3 maxExtents = glm::vec3(cachedRadius);
 				glm::vec3 minExtents = -maxExtents;
 
-				glm::vec3 lightDir         = glm::normalize(glm::vec3(light->lightData.direction));
 				glm::mat4 lightViewMatrix  = glm::lookAt(frustumCenter - lightDir * -minExtents.z, frustumCenter, maple::UP);
 				glm::mat4 lightOrthoMatrix = glm::ortho(minExtents.x, maxExtents.x, minExtents.y, maxExtents.y, 0.0f, maxExtents.z - minExtents.z);
 
-				shadowData.splitDepth[i]     = glm::vec4(camera.nearPlane + splitDist * clipRange) * -1.f;
 				shadowData.shadowProjView[i] = lightOrthoMatrix * lightViewMatrix;
 				if (i == 0) 
 				{
 					shadowData.lightMatrix = lightViewMatrix;
-					shadowData.lightDir = lightDir;
 				}
 			}
+			shadowData.frameIndex++;
 		}
 	}        // namespace
 
 	component::ShadowMapData::ShadowMapData()
 	{
 		shadowTexture = TextureDepthArray::create(SHADOWMAP_SiZE_MAX, SHADOWMAP_SiZE_MAX, shadowMapNum);
+		staticShadowTexture = TextureDepthArray::create(SHADOWMAP_SiZE_MAX, SHADOWMAP_SiZE_MAX, shadowMapNum);
 		shader        = Shader::create("shaders/Shadow.shader");
+		if (Mesh::isCompactVertexSupported())
+			compactShader = Shader::create("shaders/ShadowCompact.shader");
 
 		DescriptorInfo createInfo{};
 		createInfo.layoutIndex = 0;
@@ -121,11 +157,16 @@ namespace maple
 
 		descriptorSet.resize(1);
 		descriptorSet[0] = DescriptorSet::create(createInfo);
+		projViewHandle   = descriptorSet[0]->getUniformHandle("UniformBufferObject", "projView");
 		currentDescriptorSets.resize(1);
 		cascadeCommandQueue[0].reserve(500);
 		cascadeCommandQueue[1].reserve(500);
 		cascadeCommandQueue[2].reserve(500);
 		cascadeCommandQueue[3].reserve(500);
+		for (uint32_t i = 0; i < shadowMapNum; i++)
+		{
+			cascadeStaticQueue[i].reserve(500);
+		}
 
 		shadowTexture->setName("uShaderMapSampler");
 	}
@@ -133,10 +174,17 @@ namespace maple
 	component::ReflectiveShadowData::ReflectiveShadowData()
 	{
 		shader = Shader::create("shaders/LPV/ReflectiveShadowMap.shader");
+		if (Mesh::isCompactVertexSupported())
+			compactShader = Shader::create("shaders/LPV/ReflectiveShadowMapCompact.shader");
 		descriptorSets.resize(2);
 		descriptorSets[0] = DescriptorSet::create({ 0, shader.get() });
 		descriptorSets[1] = DescriptorSet::create({ 1, shader.get() });
 
+		uniforms.lightProjection = descriptorSets[0]->getUniformHandle("UniformBufferObject", "lightProjection");
+		uniforms.light           = descriptorSets[1]->getUniformHandle("UBO", "light");
+		uniforms.albedoColor     = descriptorSets[1]->getUniformHandle("UBO", "albedoColor");
+		uniforms.usingAlbedoMap  = descriptorSets[1]->getUniformHandle("UBO", "usingAlbedoMap");
+
 		TextureParameters parameters;
 
 		parameters.format = TextureFormat::RGBA32;
@@ -161,6 +209,8 @@ namespace maple
 			::Write<component::ShadowMapData>
 			::Read<component::CameraView>
 			::Write<component::ReflectiveShadowData>
+			::Read<component::CullingData>
+			::Read<component::GPUCullingData>
 			::To<ecs::Entity>;
 
 		using LightQuery = ecs::Chain
@@ -172,20 +222,18 @@ namespace maple
 			::Write<component::Transform>
 			::To<ecs::Query>;
 
-		using MeshEntity = ecs::Chain
-			::Write<component::MeshRenderer>
-			::Write<component::Transform>
-			::To<ecs::Entity>;
-
 		auto beginScene(Entity entity, LightQuery lightQuery, MeshQuery meshQuery, ecs::World world)
 		{
-			auto [shadowData,cameraView,rsm] = entity;
+			auto [shadowData,cameraView,rsm,culling,gpuCulling] = entity;
 
 			for (uint32_t i = 0; i < shadowData.shadowMapNum; i++)
 			{
 				shadowData.cascadeCommandQueue[i].clear();
+				shadowData.cascadeStaticQueue[i].clear();
 			}
 
+			bool shadowCasting = false;
+
 			if (!lightQuery.empty())
 			{
 				component::Light* directionaLight = nullptr;
@@ -202,11 +250,12 @@ namespace maple
 
 				if (directionaLight && directionaLight->castShadow)
 				{
-					rsm.descriptorSets[1]->setUniform("UBO", "light", &directionaLight->lightData);
+					shadowCasting = true;
+					rsm.descriptorSets[1]->setUniform(rsm.uniforms.light, &directionaLight->lightData);
 
 					if (directionaLight)
 					{
-						updateCascades(cameraView, shadowData,directionaLight);
+						updateCascades(cameraView, shadowData,directionaLight, culling.staticVersion);
 
 						for (uint32_t i = 0; i < shadowData.shadowMapNum; i++)
 						{
@@ -216,27 +265,68 @@ namespace maple
 #pragma omp parallel for num_threads(4)
 						for (int32_t i = 0; i < shadowData.shadowMapNum; i++)
 						{
-							meshQuery.forEach([&, i](MeshEntity meshEntity) {
-								auto [mesh, trans] = meshEntity;
+							auto& cache = shadowData.cascadeCache[i];
+							if (!cache.render)
+								continue;
+
+							//static casters are only collected when their cached layer has to be redrawn.
+							const bool collectStatic = !shadowData.staticCache || cache.staticDirty;
+
+							auto& visible = shadowData.cascadeVisible[i];
+							visible.clear();
+							culling.cull(shadowData.cascadeFrustums[i], visible);
+
+							//cascades are orthographic, a unit covers the same number of texels wherever the caster is.
+							const auto& projView = shadowData.shadowProjView[i];
+							const float texelsPerUnit = std::max(
+								glm::length(glm::vec3(projView[0][0], projView[1][0], projView[2][0])),
+								glm::length(glm::vec3(projView[0][1], projView[1][1], projView[2][1]))) * shadowData.shadowMapSize * 0.5f;
+
+							for (auto index : visible)
+							{
+								//static casters culled on the gpu, drawn by gpu_culling::drawIndirect.
+								if (culling.skinned[index] || gpuCulling.isHandled(index))
+									continue;
+
+								const bool isStatic = shadowData.staticCache && culling.isStatic(index);
+								if (isStatic && !collectStatic)
+									continue;
+
+								auto [mesh, trans] = meshQuery.convert(culling.entities[index]);
 								if (mesh.castShadow) 
 								{
-									auto bb = mesh.getMesh()->getBoundingBox()->transform(trans.getWorldMatrix());
-									auto inside = shadowData.cascadeFrustums[i].isInside(bb);
-									if (inside)
+									auto& queue = isStatic ? shadowData.cascadeStaticQueue[i] : shadowData.cascadeCommandQueue[i];
+									auto& cmd = queue.emplace_back();
+									cmd.mesh = mesh.getMesh().get();
+									cmd.transform = trans.getWorldMatrix();
+
+									if (cmd.mesh->getLodCount() > 1 && shadowData.lodBias > 0.f)
 									{
-										auto& cmd = shadowData.cascadeCommandQueue[i].emplace_back();
-										cmd.mesh = mesh.getMesh().get();
-										cmd.transform = trans.getWorldMatrix();
-
-										if (mesh.getMesh()->getSubMeshCount() <= 1) // at least two subMeshes.
-										{
-											cmd.material = !mesh.getMesh()->getMaterial().empty() ? mesh.getMesh()->getMaterial()[0].get() : nullptr;
-										}
+										const auto& world = cmd.transform;
+										const auto scale = std::max(glm::length(glm::vec3(world[0])), std::max(glm::length(glm::vec3(world[1])), glm::length(glm::vec3(world[2]))));
+										cmd.lod = cmd.mesh->selectLod(shadowData.lodBias / (texelsPerUnit * std::max(scale, 0.0001f)));
 									}
-								}});
+
+									if (mesh.getMesh()->getSubMeshCount() <= 1) // at least two subMeshes.
+									{
+										cmd.material = !mesh.getMesh()->getMaterial().empty() ? mesh.getMesh()->getMaterial()[0].get() : nullptr;
+									}
+								}
+							}
 						}
 
-					shadowData.descriptorSet[0]->setUniform("UniformBufferObject", "projView", shadowData.shadowProjView);
+					shadowData.descriptorSet[0]->setUniform(shadowData.projViewHandle, shadowData.shadowProjView);
+				}
+			}
+
+			if (!shadowCasting)
+			{
+				//clear every cascade and start from scratch once a light casts shadows again.
+				shadowData.shadowMapsInvalidated = true;
+				for (uint32_t i = 0; i < shadowData.shadowMapNum; i++)
+				{
+					shadowData.cascadeCache[i].render      = true;
+					shadowData.cascadeCache[i].staticDirty = true;
 				}
 			}
 		}
@@ -246,11 +336,12 @@ namespace maple
 			::Read<component::RendererData>
 			::Write<capture_graph::component::RenderGraph>
 			::Read<component::ReflectiveShadowData>
+			::Read<component::GPUCullingData>
 			::To<ecs::Entity>;
 
 		inline auto onRender(RenderEntity entity, ecs::World world)
 		{
-			auto [shadowData, rendererData,renderGraph,rsm] = entity;
+			auto [shadowData, rendererData,renderGraph,rsm,gpuCulling] = entity;
 
 			shadowData.descriptorSet[0]->update();
 
@@ -262,33 +353,118 @@ namespace maple
 			pipelineInfo.depthBiasEnabled = false;
 			pipelineInfo.depthArrayTarget = shadowData.shadowTexture;
 			pipelineInfo.clearTargets = true;
-			
-			auto pipeline = Pipeline::get(pipelineInfo, shadowData.descriptorSet, renderGraph);
+
+			//the draws of a cascade only read shared state, they are recorded in chunks on the workers.
+			auto drawCommands = [&](const PipelineInfo& info, std::vector<RenderCommand>& queue, uint32_t cascade, bool compact) {
+				auto pipeline = Pipeline::get(info, shadowData.descriptorSet, renderGraph);
+
+				Renderer::drawParallel(rendererData.commandBuffer, pipeline.get(), cascade, static_cast<uint32_t>(queue.size()), Renderer::DRAWS_PER_CHUNK, [&](CommandBuffer* commandBuffer, uint32_t begin, uint32_t end) {
+					//a copy per chunk, the push constants held by the shader are shared.
+					auto pushConstants = info.shader->getPushConstants();
+
+					for (auto i = begin; i < end; i++)
+					{
+						auto& command = queue[i];
+						Mesh* mesh = command.mesh;
+						if (mesh->isCompact() != compact)
+							continue;
+						const auto& trans = command.transform;
+
+						pushConstants[0].setValue("transform", (void*)&trans);
+						pushConstants[0].setValue("cascadeIndex", (void*)&cascade);
+						pushConstants[0].setValue("positionScale", &mesh->getPositionScale());
+						pushConstants[0].setValue("positionOffset", &mesh->getPositionOffset());
+
+						info.shader->bindPushConstants(commandBuffer, pipeline.get(), pushConstants);
+
+						Renderer::bindDescriptorSets(pipeline.get(), commandBuffer, 0, shadowData.descriptorSet);
+						Renderer::drawMesh(commandBuffer, pipeline.get(), mesh, command.lod);
+					}
+				});
+			};
+
+			//the full layout pass clears the layer, compact meshes are drawn on top with their own pipeline.
+			auto drawQueue = [&](const PipelineInfo& info, std::vector<RenderCommand>& queue, uint32_t cascade) {
+				drawCommands(info, queue, cascade, false);
+
+				if (shadowData.compactShader != nullptr && std::any_of(queue.begin(), queue.end(), [](const RenderCommand& command) { return command.mesh->isCompact(); }))
+				{
+					PipelineInfo compactInfo = info;
+					compactInfo.shader       = shadowData.compactShader;
+					compactInfo.clearTargets = false;
+					drawCommands(compactInfo, queue, cascade, true);
+				}
+			};
+
+			//the casters the culling pass kept for the cascade, drawn on top of a layer the cpu draws already cleared.
+			auto drawIndirect = [&](const PipelineInfo& info, uint32_t cascade) {
+				if (!gpuCulling.active || cascade + 1 >= component::GPUCullingData::MAX_VIEWS)
+					return;
+
+				PipelineInfo indirectInfo = info;
+				indirectInfo.clearTargets = false;
+
+				for (uint32_t format = 0; format < component::GPUCullingData::FORMATS; format++)
+				{
+					indirectInfo.shader = gpuCulling.shadowShaders[format];
+					if (indirectInfo.shader == nullptr)
+						continue;
+
+					auto pipeline = Pipeline::get(indirectInfo, gpuCulling.shadowSet, renderGraph);
+					pipeline->bind(rendererData.commandBuffer, cascade);
+
+					auto pushConstants = indirectInfo.shader->getPushConstants();
+					pushConstants[0].setValue("cascadeIndex", (void*)&cascade);
+					indirectInfo.shader->bindPushConstants(rendererData.commandBuffer, pipeline.get(), pushConstants);
+
+					Renderer::bindDescriptorSets(pipeline.get(), rendererData.commandBuffer, 0, gpuCulling.shadowSet);
+					gpu_culling::drawIndirect(gpuCulling, rendererData.commandBuffer, pipeline.get(), 1 + cascade, static_cast<VertexFormat>(format));
+					pipeline->end(rendererData.commandBuffer);
+				}
+			};
+
+			PipelineInfo staticInfo = pipelineInfo;
+			staticInfo.depthArrayTarget = shadowData.staticShadowTexture;
+
+			PipelineInfo dynamicInfo = pipelineInfo;
+			dynamicInfo.clearTargets = false;
 
 			for (uint32_t i = 0; i < shadowData.shadowMapNum; ++i)
 			{
 				//GPUProfile("Shadow Layer Pass");
-				pipeline->bind(rendererData.commandBuffer, i);
+				auto& cache = shadowData.cascadeCache[i];
+				if (!cache.render)
+					continue;
 
-				for (auto& command : shadowData.cascadeCommandQueue[i])
+				if (!shadowData.staticCache)
 				{
-					Mesh* mesh = command.mesh;
-					shadowData.currentDescriptorSets[0] = shadowData.descriptorSet[0];
-					const auto& trans = command.transform;
-					auto& pushConstants = shadowData.shader->getPushConstants()[0];
+					drawQueue(pipelineInfo, shadowData.cascadeCommandQueue[i], i);
+					drawIndirect(pipelineInfo, i);
+					cache.staticDirty = true;
+					continue;
+				}
 
-					pushConstants.setValue("transform", (void*)&trans);
-					pushConstants.setValue("cascadeIndex", (void*)&i);
+				if (cache.staticDirty)
+				{
+					drawQueue(staticInfo, shadowData.cascadeStaticQueue[i], i);
+					drawIndirect(staticInfo, i);
+				}
+				else if (cache.dynamicCasters == 0 && shadowData.cascadeCommandQueue[i].empty())
+				{
+					//nothing moved inside the cascade, the layer from the last refresh is still valid.
+					continue;
+				}
 
-					shadowData.shader->bindPushConstants(rendererData.commandBuffer, pipeline.get());
+				shadowData.staticShadowTexture->copyLayer(rendererData.commandBuffer, shadowData.shadowTexture.get(), i);
 
-					Renderer::bindDescriptorSets(pipeline.get(), rendererData.commandBuffer, 0, shadowData.descriptorSet);
-					Renderer::drawMesh(rendererData.commandBuffer, pipeline.get(), mesh);
+				if (!shadowData.cascadeCommandQueue[i].empty())
+				{
+					drawQueue(dynamicInfo, shadowData.cascadeCommandQueue[i], i);
 				}
 
-				pipeline->end(rendererData.commandBuffer);
+				cache.staticDirty    = false;
+				cache.dynamicCasters = static_cast<uint32_t>(shadowData.cascadeCommandQueue[i].size());
 			}
-
 		}
 	}
 
@@ -342,7 +518,7 @@ namespace maple
 
 					if (directionaLight)
 					{
-						rsm.descriptorSets[1]->setUniform("UBO", "light", &directionaLight->lightData);
+						rsm.descriptorSets[1]->setUniform(rsm.uniforms.light, &directionaLight->lightData);
 
 						if (directionaLight)
 						{
@@ -366,6 +542,8 @@ namespace maple
 						for (auto meshEntity : meshQuery)
 						{
 							auto [mesh, trans] = meshQuery.convert(meshEntity);
+							if (mesh.getMesh() == nullptr)        //still loading
+								continue;
 
 							auto inside = rsm.frustum.isInside(mesh.getMesh()->getBoundingBox()->transform(trans.getWorldMatrix()));
 
@@ -381,6 +559,9 @@ namespace maple
 								}
 							}
 						}
+
+						//compact meshes come last so the pass switches pipeline once, without clearing the targets again.
+						std::stable_partition(rsm.commandQueue.begin(), rsm.commandQueue.end(), [](const RenderCommand &command) { return !command.mesh->isCompact(); });
 					}
 				}
 			}
@@ -398,7 +579,7 @@ namespace maple
 
 			auto descriptorSet = rsm.descriptorSets[1];
 
-			rsm.descriptorSets[0]->setUniform("UniformBufferObject", "lightProjection", &rsm.projView);
+			rsm.descriptorSets[0]->setUniform(rsm.uniforms.lightProjection, &rsm.projView);
 
 			rsm.descriptorSets[0]->update();
 			rsm.descriptorSets[1]->update();
@@ -423,15 +604,37 @@ namespace maple
 			else
 				pipeline->bind(commandBuffer);
 
+			auto shader = rsm.shader;
 			for (auto& command : rsm.commandQueue)
 			{
 				Mesh* mesh = command.mesh;
+				if (mesh->isCompact() && shader != rsm.compactShader)
+				{
+					pipeInfo.shader       = rsm.compactShader;
+					pipeInfo.clearTargets = false;
+					shader                = rsm.compactShader;
+
+					if (commandBuffer)
+					{
+						pipeline = Pipeline::get(pipeInfo, rsm.descriptorSets, renderGraph);
+						commandBuffer->bindPipeline(pipeline.get());
+					}
+					else
+					{
+						pipeline->end(commandBuffer);
+						pipeline = Pipeline::get(pipeInfo, rsm.descriptorSets, renderGraph);
+						pipeline->bind(commandBuffer);
+					}
+				}
+
 				const auto& trans = command.transform;
-				auto& pushConstants = rsm.shader->getPushConstants()[0];
+				auto& pushConstants = shader->getPushConstants()[0];
 
 				pushConstants.setValue("transform", (void*)&trans);
+				pushConstants.setValue("positionScale", &mesh->getPositionScale());
+				pushConstants.setValue("positionOffset", &mesh->getPositionOffset());
 
-				rsm.shader->bindPushConstants(commandBuffer, pipeline.get());
+				shader->bindPushConstants(commandBuffer, pipeline.get());
 			
 				if (mesh->getSubMeshCount() > 1)
 				{
@@ -443,15 +646,15 @@ namespace maple
 					for (auto i = 0; i <= indices.size(); i++)
 					{
 						auto & material = materials[i];
-						auto end = i == indices.size() ? command.mesh->getIndexBuffer()->getCount() : indices[i];
+						auto end = i == indices.size() ? command.mesh->getLod(0).indexCount : indices[i];
 
-						descriptorSet->setUniform("UBO", "albedoColor", &material->getProperties().albedoColor);
-						descriptorSet->setUniform("UBO", "usingAlbedoMap", &material->getProperties().usingAlbedoMap);
+						descriptorSet->setUniform(rsm.uniforms.albedoColor, &material->getProperties().albedoColor);
+						descriptorSet->setUniform(rsm.uniforms.usingAlbedoMap, &material->getProperties().usingAlbedoMap);
 						descriptorSet->setTexture("uDiffuseMap", material->getTextures().albedo);
 						descriptorSet->update();
 
 						Renderer::bindDescriptorSets(pipeline.get(), commandBuffer, 0, rsm.descriptorSets);
-						Renderer::drawIndexed(commandBuffer, DrawType::Triangle, end - start, start);
+						Renderer::drawIndexed(commandBuffer, DrawType::Triangle, end - start, mesh->getFirstIndex() + start, mesh->getVertexOffset());
 
 						start = end;
 					}
@@ -462,8 +665,8 @@ namespace maple
 				{
 					if (command.material != nullptr)
 					{
-						descriptorSet->setUniform("UBO", "albedoColor", &command.material->getProperties().albedoColor);
-						descriptorSet->setUniform("UBO", "usingAlbedoMap", &command.material->getProperties().usingAlbedoMap);
+						descriptorSet->setUniform(rsm.uniforms.albedoColor, &command.material->getProperties().albedoColor);
+						descriptorSet->setUniform(rsm.uniforms.usingAlbedoMap, &command.material->getProperties().usingAlbedoMap);
 						descriptorSet->setTexture("uDiffuseMap", command.material->getTextures().albedo);
 						descriptorSet->update();
 					}
@@ -485,6 +688,9 @@ namespace maple
 		{
 			executePoint->registerGlobalComponent<component::ShadowMapData>();
 			executePoint->registerGlobalComponent<component::ReflectiveShadowData>();
+			executePoint->registerShaders({"shaders/Shadow.shader", "shaders/LPV/ReflectiveShadowMap.shader"});
+			if (Mesh::isCompactVertexSupported())
+				executePoint->registerShaders({"shaders/ShadowCompact.shader", "shaders/LPV/ReflectiveShadowMapCompact.shader"});
 
 			executePoint->registerWithinQueue<shadow_map_pass::beginScene>(begin);
 			executePoint->registerWithinQueue<shadow_map_pass::onRender>(renderer);
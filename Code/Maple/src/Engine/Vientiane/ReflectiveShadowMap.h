@@ -22,6 +22,7 @@ namespace maple
 
 			bool                                        enable = false;
 			std::shared_ptr<Shader>                     shader;
+			std::shared_ptr<Shader>                     compactShader;        //meshes in the compact vertex layout
 			std::vector<std::shared_ptr<DescriptorSet>> descriptorSets;
 			std::shared_ptr<Texture2D>                  fluxTexture;
 			std::shared_ptr<Texture2D>                  worldTexture;
@@ -32,6 +33,13 @@ namespace maple
 			glm::mat4									projView;
 			glm::mat4									lightMatrix;
 			float										lightArea = 1.0f;
+			struct
+			{
+				UniformHandle lightProjection;
+				UniformHandle light;
+				UniformHandle albedoColor;
+				UniformHandle usingAlbedoMap;
+			} uniforms;
 			ReflectiveShadowData();
 		};
 
@@ -59,10 +67,38 @@ namespace maple
 
 			std::vector<std::shared_ptr<DescriptorSet>> descriptorSet;
 			std::vector<std::shared_ptr<DescriptorSet>> currentDescriptorSets;
+			UniformHandle                               projViewHandle;
 
+			//static casters are rendered once into staticShadowTexture, a refresh copies that layer back
+			//and only draws the casters which moved recently on top.
+			bool  staticCache        = true;
+			float cascadeCacheMargin = 0.1f;
+			//shadow map texels of error a lod may have, coarser than the camera pass since casters are only seen through their shadow.
+			float lodBias = 4.f;
+			//a cascade is refreshed every N frames, far cascades can lag behind the camera.
+			uint32_t cascadeUpdateInterval[SHADOWMAP_MAX] = {1, 1, 2, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4};
+
+			struct CascadeCache
+			{
+				glm::vec3 center         = {};
+				float     radius         = 0.f;
+				bool      render         = true;
+				bool      staticDirty    = true;
+				uint32_t  dynamicCasters = 0;
+			};
+
+			CascadeCache cascadeCache[SHADOWMAP_MAX];
+			uint32_t     frameIndex    = 0;
+			uint32_t     staticVersion = 0;
+
+			//dynamic casters, or every caster when the static cache is disabled.
 			std::vector<RenderCommand>         cascadeCommandQueue[SHADOWMAP_MAX];
+			std::vector<RenderCommand>         cascadeStaticQueue[SHADOWMAP_MAX];
+			std::vector<uint32_t>              cascadeVisible[SHADOWMAP_MAX];
 			std::shared_ptr<Shader>            shader;
+			std::shared_ptr<Shader>            compactShader;        //meshes in the compact vertex layout
 			std::shared_ptr<TextureDepthArray> shadowTexture;
+			std::shared_ptr<TextureDepthArray> staticShadowTexture;
 
 			ShadowMapData();
 		};
@@ -9,6 +9,13 @@
 
 namespace maple
 {
+	//a level of a block compressed image, all levels share the data of the image.
+	struct ImageMip
+	{
+		uint32_t offset;
+		uint32_t size;
+	};
+
 	class Image 
 	{
 	  public:
@@ -100,6 +107,22 @@ namespace maple
 			this->HDR = isHDR;
 		}
 
+		inline auto isCompressed() const noexcept
+		{
+			return pixelFormat == TextureFormat::BC1 || pixelFormat == TextureFormat::BC3;
+		}
+
+		//empty unless the image carries its own mip chain.
+		inline auto &getMips() const noexcept
+		{
+			return mips;
+		}
+
+		inline auto setMips(std::vector<ImageMip> &&mips)
+		{
+			this->mips = std::move(mips);
+		}
+
 	  protected:
 		TextureFormat pixelFormat = TextureFormat::RGBA8;
 		uint32_t      width       = 0;
@@ -110,5 +133,7 @@ namespace maple
 		bool          mipmaps     = false;
 		bool          HDR         = false;
 		std::string   fileName;
+
+		std::vector<ImageMip> mips;
 	};
 }        // namespace maple
@@ -2,6 +2,7 @@
 // This file is part of the Maple Engine                              		//
 //////////////////////////////////////////////////////////////////////////////
 #include "FBXLoader.h"
+#include "MeshOptimizer.h"
 #include "FileSystem/Skeleton.h"
 #include "FileSystem/MeshResource.h"
 
@@ -183,7 +184,7 @@ namespace maple
 
 				if (File::fileExists(filePath))
 				{
-					texture2D = Texture2D::create(filePath, filePath);
+					texture2D = Material::createTexture(filePath, filePath);
 				}
 				else 
 				{
@@ -412,6 +413,9 @@ namespace maple
 				auto clip = loadClip(scene, animIndex, frameRate, sceneBones);
 				if (clip != nullptr) 
 				{
+					//keys come at the scene frame rate, resampling at the same rate keeps them exact.
+					clip->fps = frameRate;
+					clip->bake(frameRate);
 					animation->addClip(clip);
 				}
 			}
@@ -554,15 +558,42 @@ namespace maple
 						loadWeight(geom->getSkin(), skeleton.get(), skinnedVertices);
 					}
 
+					const auto trianglesCount = vertexCount / 3;
+
+					std::vector<uint32_t> subMeshIdx;
+
+					if (fbxMesh->getMaterialCount() > 1)
+					{
+						int32_t rangeStart = 0;
+						int32_t rangeStartVal = materials[rangeStart];
+						for (int32_t triangleIndex = 1; triangleIndex < trianglesCount; triangleIndex++)
+						{
+							if (rangeStartVal != materials[triangleIndex])
+							{
+								rangeStartVal = materials[triangleIndex];
+								subMeshIdx.emplace_back(materials[triangleIndex] * 3);
+							}
+						}
+					}
+
+					//lods are only generated for single material meshes, simplification would mix the submesh ranges.
 					std::shared_ptr<Mesh> mesh;
+					std::vector<MeshLod>  lods;
 					if (skin)
 					{
-						mesh = std::make_shared<Mesh>(indicesArray, skinnedVertices);
+						MeshOptimizer::optimize(skinnedVertices, indicesArray, subMeshIdx);
+						if (subMeshIdx.empty())
+							MeshOptimizer::generateLods(skinnedVertices, indicesArray, lods);
+						mesh = std::make_shared<Mesh>(indicesArray, skinnedVertices, true);
 					}
 					else
 					{
-						mesh = std::make_shared<Mesh>(indicesArray, tempVertices);
+						MeshOptimizer::optimize(tempVertices, indicesArray, subMeshIdx);
+						if (subMeshIdx.empty())
+							MeshOptimizer::generateLods(tempVertices, indicesArray, lods);
+						mesh = std::make_shared<Mesh>(indicesArray, tempVertices, true);
 					}
+					mesh->setLods(lods);
 
 					for (auto i = 0; i < fbxMesh->getMaterialCount(); i++)
 					{
@@ -572,23 +603,8 @@ namespace maple
 
 					mesh->setMaterial(pbrMaterials);
 
-					const auto trianglesCount = vertexCount / 3;
-
-					std::vector<uint32_t> subMeshIdx;
-
 					if (fbxMesh->getMaterialCount() > 1)
 					{
-						int32_t rangeStart = 0;
-						int32_t rangeStartVal = materials[rangeStart];
-						for (int32_t triangleIndex = 1; triangleIndex < trianglesCount; triangleIndex++)
-						{
-							if (rangeStartVal != materials[triangleIndex])
-							{
-								rangeStartVal = materials[triangleIndex];
-								subMeshIdx.emplace_back(materials[triangleIndex] * 3);
-							}
-						}
-
 						mesh->setSubMeshIndex(subMeshIdx);
 						mesh->setSubMeshCount(subMeshIdx.size());
 
@@ -2,6 +2,7 @@
 // This file is part of the Maple Engine                              		//
 //////////////////////////////////////////////////////////////////////////////
 #include "GLTFLoader.h"
+#include "MeshOptimizer.h"
 #include "Engine/Profiler.h"
 #include "Engine/Material.h"
 
@@ -387,7 +388,11 @@ namespace maple
 						LOGW("Unsupported indices data type - {0}", componentTypeByteSize);
 					}
 				}
-				meshes.emplace_back(std::make_shared<Mesh>(indices, vertices));
+				MeshOptimizer::optimize(vertices, indices);
+				std::vector<MeshLod> lods;
+				MeshOptimizer::generateLods(vertices, indices, lods);
+				meshes.emplace_back(std::make_shared<Mesh>(indices, vertices, true));
+				meshes.back()->setLods(lods);
 			}
 			return meshes;
 		}
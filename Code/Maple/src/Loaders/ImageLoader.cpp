@@ -2,6 +2,7 @@
 // This file is part of the Maple Engine                              		//
 //////////////////////////////////////////////////////////////////////////////
 #include "ImageLoader.h"
+#include "TextureCooker.h"
 #include <ktx.h>
 #include <memory>
 #include <stdexcept>
@@ -73,4 +74,21 @@ namespace maple
 		image->setSize(imageSize);
 	}
 
+	auto ImageLoader::loadCompressed(const std::string &name, bool flipY) -> std::unique_ptr<Image>
+	{
+		PROFILE_FUNCTION();
+		const auto cachePath = TextureCooker::getCachePath(name, flipY);
+		if (auto cooked = TextureCooker::load(cachePath))
+			return cooked;
+
+		auto image  = loadAsset(name, true, flipY);
+		auto cooked = TextureCooker::compress(*image);
+		if (cooked == nullptr)
+			return image;
+
+		if (TextureCooker::save(cachePath, *cooked))
+			LOGI("ImageLoader : cooked {0} into {1}", name, cachePath);
+		return cooked;
+	}
+
 }        // namespace maple
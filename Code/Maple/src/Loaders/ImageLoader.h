@@ -15,6 +15,8 @@ namespace maple
     public:
         static auto loadAsset(const std::string& name, bool mipmaps = true, bool flipY = true)->std::unique_ptr<Image>;
         static auto loadAsset(const std::string& name, Image * image)-> void;
+        //the block compressed copy cooked from the file with all its mips, cooked on first use. hdr images come back decoded as usual.
+        static auto loadCompressed(const std::string& name, bool flipY = true)->std::unique_ptr<Image>;
     };
 
 }
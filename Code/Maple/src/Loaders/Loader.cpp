@@ -5,13 +5,50 @@
 #include "GLTFLoader.h"
 #include "OBJLoader.h"
 #include "FBXLoader.h"
+#include "MeshCache.h"
 
+#include "Engine/Profiler.h"
 #include "Others/StringUtils.h"
 #include "Others/Console.h"
+#include "Thread/JobSystem.h"
 #include "Application.h"
 
+#include <algorithm>
+
 namespace maple
 {
+	namespace
+	{
+		//the async load the calling thread is parsing, null everywhere else.
+		thread_local std::shared_ptr<AssetsLoadHandle> currentLoad;
+
+		//the cooked file is used when it is up to date, otherwise the source is parsed and cooked for the next time.
+		inline auto parse(AssetsLoader &loader, const std::string &obj, const std::string &extension, std::vector<std::shared_ptr<IResource>> &out)
+		{
+			if (MeshCache::load(obj, out))
+				return;
+
+			MeshCache::Recorder recorder;
+			loader.load(obj, extension, out);
+			recorder.save(obj, out);
+		}
+	}        // namespace
+
+	auto AssetsLoadHandle::setState(State newState) -> void
+	{
+		{
+			std::lock_guard<std::mutex> locker(stateMutex);
+			state.store(newState, std::memory_order_release);
+		}
+		parsed.notify_all();
+	}
+
+	auto AssetsLoadHandle::waitParsed() -> void
+	{
+		std::unique_lock<std::mutex> locker(stateMutex);
+		parsed.wait(locker, [&]() { return getState() != State::Loading; });
+	}
+
 	AssetsLoaderFactory::AssetsLoaderFactory()
 	{
 		addModelLoader<GLTFLoader>();
@@ -26,21 +63,255 @@ namespace maple
 		if (loader == loaders.end())
 		{
 			LOGE("Unknown file extension {0}", extension);
+			return;
 		}
-		else 
+
+		std::shared_ptr<AssetsLoadHandle> handle;
 		{
+			std::lock_guard<std::mutex> locker(mutex);
 			if (auto iter = cache.find(obj); iter != cache.end())
 			{
 				out.insert(out.end(), iter->second.begin(), iter->second.end());
+				return;
+			}
+			if (auto iter = loading.find(obj); iter != loading.end())
+				handle = iter->second;
+		}
+
+		if (handle != nullptr)
+		{
+			//already requested asynchronously, finish that one instead of parsing the file twice.
+			if (currentLoad != nullptr)
+			{
+				handle->waitParsed();
+				currentLoad->dependencies.emplace_back(handle);
+			}
+			else
+			{
+				wait(handle);
+			}
+			out.insert(out.end(), handle->resources.begin(), handle->resources.end());
+			return;
+		}
+
+		std::vector<std::shared_ptr<IResource>> resources;
+		parse(*loader->second, obj, extension, resources);
+		out.insert(out.end(), resources.begin(), resources.end());
+
+		std::lock_guard<std::mutex> locker(mutex);
+		cache[obj] = std::move(resources);
+	}
+
+	auto AssetsLoaderFactory::loadAsync(const std::string& obj) -> std::shared_ptr<AssetsLoadHandle>
+	{
+		PROFILE_FUNCTION();
+		auto handle    = std::make_shared<AssetsLoadHandle>(obj);
+		auto extension = StringUtils::getExtension(obj);
+		auto loader    = loaders.find(extension);
+		if (loader == loaders.end())
+		{
+			LOGE("Unknown file extension {0}", extension);
+			handle->failed = true;
+			handle->setState(AssetsLoadHandle::State::Failed);
+			return handle;
+		}
+
+		{
+			std::lock_guard<std::mutex> locker(mutex);
+			if (auto iter = cache.find(obj); iter != cache.end())
+			{
+				handle->resources = iter->second;
+				handle->setState(AssetsLoadHandle::State::Ready);
+				return handle;
 			}
-			else 
+			if (auto iter = loading.find(obj); iter != loading.end())
+				return iter->second;
+
+			loading.emplace(obj, handle);
+			pending.emplace_back(handle);
+		}
+
+		Application::getJobSystem()->scheduleBackground([handle, extension, loader = loader->second]() {
+			PROFILE_SCOPE("AssetsLoaderFactory::parse");
+			currentLoad = handle;
+			try
+			{
+				parse(*loader, handle->path, extension, handle->resources);
+			}
+			catch (const std::exception &e)
 			{
-				loader->second ->load(obj, extension, out);
-				cache[obj] = { out.begin(),out.end() };
+				LOGE("Failed to load {0} : {1}", handle->path, e.what());
+				handle->failed = true;
 			}
+			currentLoad = nullptr;
+			handle->setState(AssetsLoadHandle::State::Uploading);
+		});
+		return handle;
+	}
+
+	auto AssetsLoaderFactory::update(float budgetMs) -> void
+	{
+		PROFILE_FUNCTION();
+		std::vector<std::shared_ptr<AssetsLoadHandle>> handles;
+		{
+			std::lock_guard<std::mutex> locker(mutex);
+			if (pending.empty())
+				return;
+			handles = pending;
+		}
+
+		const auto deadline = std::chrono::steady_clock::now() +
+		                      std::chrono::duration_cast<std::chrono::steady_clock::duration>(std::chrono::duration<float, std::milli>(budgetMs));
+
+		for (auto &handle : handles)
+		{
+			if (handle->getState() != AssetsLoadHandle::State::Uploading)
+				continue;
+
+			//a failed load still runs its uploads, resources it put into the cache may be used by others.
+			if (!upload(*handle, &deadline))
+				break;
+
+			if (std::all_of(handle->dependencies.begin(), handle->dependencies.end(), [](auto &dependency) { return dependency->isUploaded(); }))
+				complete(handle);
 		}
 	}
 
+	auto AssetsLoaderFactory::wait(const std::shared_ptr<AssetsLoadHandle>& handle) -> void
+	{
+		PROFILE_FUNCTION();
+		MAPLE_ASSERT(currentLoad == nullptr, "AssetsLoaderFactory : wait() can not be called while parsing");
+		handle->waitParsed();
+		if (handle->isDone())
+			return;
+
+		upload(*handle, nullptr);
+		for (auto &dependency : handle->dependencies)
+		{
+			dependency->waitParsed();
+			upload(*dependency, nullptr);
+		}
+		complete(handle);
+	}
+
+	auto AssetsLoaderFactory::isLoadingThread() -> bool
+	{
+		return currentLoad != nullptr;
+	}
+
+	auto AssetsLoaderFactory::deferUpload(std::function<void()>&& upload) -> void
+	{
+		if (currentLoad == nullptr)
+			upload();
+		else
+			currentLoad->uploads.emplace_back(std::move(upload));
+	}
+
+	auto AssetsLoaderFactory::deferUpload(const std::weak_ptr<void>& owner, std::function<void()>&& upload) -> void
+	{
+		//uploads run on the main thread after the parse finished, the owner can not be released concurrently.
+		deferUpload([owner, upload = std::move(upload)]() {
+			if (!owner.expired())
+				upload();
+		});
+	}
+
+	auto AssetsLoaderFactory::upload(AssetsLoadHandle& handle, const std::chrono::steady_clock::time_point* deadline) -> bool
+	{
+		while (handle.nextUpload < handle.uploads.size())
+		{
+			//the index moves first, an upload can end up waiting on its own handle through emplace.
+			auto upload = std::move(handle.uploads[handle.nextUpload++]);
+			upload();
+			if (deadline != nullptr && handle.nextUpload < handle.uploads.size() && std::chrono::steady_clock::now() >= *deadline)
+				return false;
+		}
+		return true;
+	}
+
+	auto AssetsLoaderFactory::complete(const std::shared_ptr<AssetsLoadHandle>& handle) -> void
+	{
+		{
+			std::lock_guard<std::mutex> locker(mutex);
+			if (!handle->failed)
+				cache[handle->path] = handle->resources;
+			else
+				handle->resources.clear();
+
+			if (auto iter = loading.find(handle->path); iter != loading.end() && iter->second == handle)
+				loading.erase(iter);
+
+			pending.erase(std::remove(pending.begin(), pending.end(), handle), pending.end());
+
+			for (auto iter = owners.begin(); iter != owners.end();)
+			{
+				if (iter->second == handle)
+					iter = owners.erase(iter);
+				else
+					iter++;
+			}
+			//dependencies may point back to this handle.
+			handle->dependencies.clear();
+		}
+		handle->setState(handle->failed ? AssetsLoadHandle::State::Failed : AssetsLoadHandle::State::Ready);
+		completedCount.fetch_add(1, std::memory_order_release);
+	}
+
+	auto AssetsLoaderFactory::acquire(const std::string& obj) -> std::shared_ptr<IResource>
+	{
+		std::shared_ptr<IResource>        res;
+		std::shared_ptr<AssetsLoadHandle> owner;
+		{
+			std::unique_lock<std::mutex> locker(mutex);
+			constructed.wait(locker, [&]() { return constructing.count(obj) == 0; });
+			auto iter = cache.find(obj);
+			if (iter == cache.end())
+			{
+				constructing.emplace(obj);
+				return nullptr;
+			}
+			res = iter->second[0];
+			if (auto ownerIter = owners.find(obj); ownerIter != owners.end() && ownerIter->second != currentLoad)
+				owner = ownerIter->second;
+		}
+
+		//cached, but its gpu part belongs to a load which has not been uploaded yet.
+		if (owner != nullptr)
+		{
+			if (currentLoad != nullptr)
+				currentLoad->dependencies.emplace_back(owner);
+			else
+				wait(owner);
+		}
+		return res;
+	}
+
+	auto AssetsLoaderFactory::publish(const std::string& obj, const std::shared_ptr<IResource>& res, size_t uploadMark) -> void
+	{
+		{
+			std::lock_guard<std::mutex> locker(mutex);
+			cache[obj].emplace_back(res);
+			constructing.erase(obj);
+			if (currentLoad != nullptr && currentLoad->uploads.size() > uploadMark)
+				owners[obj] = currentLoad;
+		}
+		constructed.notify_all();
+	}
+
+	auto AssetsLoaderFactory::cancel(const std::string& obj) -> void
+	{
+		{
+			std::lock_guard<std::mutex> locker(mutex);
+			constructing.erase(obj);
+		}
+		constructed.notify_all();
+	}
+
+	auto AssetsLoaderFactory::getUploadMark() -> size_t
+	{
+		return currentLoad != nullptr ? currentLoad->uploads.size() : 0;
+	}
+
 	auto Loader::load(const std::string& obj, std::vector<std::shared_ptr<IResource>>& out) -> void
 	{
 		Application::getAssetsLoaderFactory()->load(obj, out);
@@ -2,7 +2,12 @@
 // This file is part of the Maple Engine                              		//
 //////////////////////////////////////////////////////////////////////////////
 #pragma once
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <functional>
 #include <memory>
+#include <mutex>
 #include <string>
 #include <vector>
 #include <unordered_map>
@@ -29,9 +34,57 @@ namespace maple
 	private:
 	};
 
+	class MAPLE_EXPORT AssetsLoadHandle
+	{
+	public:
+		enum class State : uint8_t
+		{
+			Loading,          //parsing on a worker thread
+			Uploading,        //waiting for the gpu resources to be created on the main thread
+			Ready,
+			Failed
+		};
+
+		AssetsLoadHandle(const std::string& path) : path(path) {}
+
+		inline auto getState() const { return state.load(std::memory_order_acquire); }
+		inline auto isReady() const { return getState() == State::Ready; }
+		inline auto isDone() const { return getState() == State::Ready || getState() == State::Failed; }
+		inline auto& getPath() const { return path; }
+		//only complete once the handle is ready.
+		inline auto& getResources() const { return resources; }
+
+	private:
+		friend class AssetsLoaderFactory;
+
+		inline auto isUploaded() const
+		{
+			const auto current = getState();
+			return current != State::Loading && nextUpload == uploads.size();
+		}
+
+		//state changes are published under stateMutex, threads waiting for the parse sleep on parsed.
+		auto setState(State newState) -> void;
+		auto waitParsed() -> void;
+
+		std::string path;
+		std::atomic<State> state{ State::Loading };
+		std::mutex stateMutex;
+		std::condition_variable parsed;
+		std::vector<std::shared_ptr<IResource>> resources;
+		//gpu work recorded while parsing, executed on the main thread.
+		std::vector<std::function<void()>> uploads;
+		size_t nextUpload = 0;
+		bool failed = false;
+		//loads which own resources shared with this one (textures), they have to be uploaded first.
+		std::vector<std::shared_ptr<AssetsLoadHandle>> dependencies;
+	};
+
 	class MAPLE_EXPORT AssetsLoaderFactory
 	{
 	public:
+		static constexpr float UPLOAD_BUDGET_MS = 2.f;
+
 		AssetsLoaderFactory();
 
 		template <typename T>
@@ -47,6 +100,25 @@ namespace maple
 
 		auto load(const std::string& obj, std::vector<std::shared_ptr<IResource>>& out) -> void;
 
+		//parses the file on a background worker, requests for the same file share one handle.
+		auto loadAsync(const std::string& obj) -> std::shared_ptr<AssetsLoadHandle>;
+
+		//main thread, once per frame. runs the gpu part of parsed loads until the budget is spent.
+		auto update(float budgetMs = UPLOAD_BUDGET_MS) -> void;
+
+		//blocks until the handle is ready, its uploads run on the calling (main) thread.
+		auto wait(const std::shared_ptr<AssetsLoadHandle>& handle) -> void;
+
+		//true while the calling thread parses an async load, gpu resources have to be created through deferUpload then.
+		static auto isLoadingThread() -> bool;
+		static auto deferUpload(std::function<void()>&& upload) -> void;
+		//for uploads recorded by a constructor, where shared_from_this is not available yet.
+		//the upload is skipped once owner expired, e.g. the object was dropped before the main thread got to it.
+		static auto deferUpload(const std::weak_ptr<void>& owner, std::function<void()>&& upload) -> void;
+
+		//increased whenever a load finishes, scenes use it to refresh meshes which were still loading.
+		inline auto getCompletedCount() const { return completedCount.load(std::memory_order_acquire); }
+
 		inline auto& getSupportExtensions() const{
 			return supportExtensions;
 		}
@@ -57,21 +129,48 @@ namespace maple
 		inline auto &getCache() const { return cache; }
 
 	private:
+		//emplace is called from loading threads as well, a key is only constructed once.
+		auto acquire(const std::string& obj) -> std::shared_ptr<IResource>;
+		auto publish(const std::string& obj, const std::shared_ptr<IResource>& res, size_t uploadMark) -> void;
+		auto cancel(const std::string& obj) -> void;
+		static auto getUploadMark() -> size_t;
+
+		//false if the deadline was hit before all uploads of the handle ran.
+		auto upload(AssetsLoadHandle& handle, const std::chrono::steady_clock::time_point* deadline) -> bool;
+		auto complete(const std::shared_ptr<AssetsLoadHandle>& handle) -> void;
+
 		std::unordered_map<std::string, std::shared_ptr<AssetsLoader>> loaders;
 		std::unordered_set<std::string> supportExtensions;
 		std::unordered_map<std::string, std::vector<std::shared_ptr<IResource>>> cache;
+
+		std::mutex mutex;
+		std::condition_variable constructed;
+		std::unordered_set<std::string> constructing;
+		std::unordered_map<std::string, std::shared_ptr<AssetsLoadHandle>> loading;
+		std::vector<std::shared_ptr<AssetsLoadHandle>> pending;        //in request order
+		//cached resources whose gpu part has not been created yet.
+		std::unordered_map<std::string, std::shared_ptr<AssetsLoadHandle>> owners;
+		std::atomic<uint32_t> completedCount{ 0 };
 	};
 
 	template <typename T, typename ...Args>
 	auto AssetsLoaderFactory::emplace(const std::string& obj, Args&&...args)->std::shared_ptr<T>
 	{
-		auto iter = cache.find(obj);
-		if (iter == cache.end())
+		if (auto res = acquire(obj))
+			return std::static_pointer_cast<T>(res);
+
+		const auto mark = getUploadMark();
+		std::shared_ptr<T> ptr;
+		try
+		{
+			ptr = std::make_shared<T>(std::forward<Args>(args)...);
+		}
+		catch (...)
 		{
-			auto ptr = std::make_shared<T>(std::forward<Args>(args)...);
-			cache[obj].emplace_back(ptr);
-			return std::static_pointer_cast<T>(ptr);
+			cancel(obj);
+			throw;
 		}
-		return std::static_pointer_cast<T>(iter->second[0]);
+		publish(obj, ptr, mark);
+		return ptr;
 	}
 };
@@ -0,0 +1,617 @@
+//////////////////////////////////////////////////////////////////////////////
+// This file is part of the Maple Engine                              		//
+//////////////////////////////////////////////////////////////////////////////
+#include "MeshCache.h"
+#include "Loader.h"
+
+#include "Engine/Material.h"
+#include "Engine/Mesh.h"
+#include "Engine/Profiler.h"
+#include "FileSystem/MeshResource.h"
+#include "FileSystem/Skeleton.h"
+#include "Math/BoundingBox.h"
+#include "Others/Console.h"
+#include "Others/HashCode.h"
+#include "RHI/Texture.h"
+
+#include <array>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <mio.hpp>
+
+namespace maple
+{
+	namespace MeshCache
+	{
+		namespace
+		{
+			constexpr uint32_t    ALIGNMENT     = 16;
+			constexpr int32_t     TEXTURE_SLOTS = 6;
+			constexpr const char *CACHE_FOLDER = "cache/meshes";
+
+			thread_local Recorder *activeRecorder = nullptr;
+
+			inline auto hashFile(const std::string &file, uint64_t &hash) -> bool
+			{
+				std::error_code  error;
+				mio::mmap_source source;
+				source.map(file, error);
+				if (error)
+					return false;
+				hash = HashCode::hashBytes(source.data(), source.size());
+				return true;
+			}
+
+			inline auto getCacheFile(uint64_t hash) -> std::string
+			{
+				char name[32];
+				snprintf(name, sizeof(name), "%016llx.mesh", static_cast<unsigned long long>(hash));
+				return std::string(CACHE_FOLDER) + "/" + name;
+			}
+
+			class Writer
+			{
+			  public:
+				template <typename T>
+				inline auto write(const T &value)
+				{
+					static_assert(std::is_trivially_copyable<T>::value, "only plain data can be written");
+					write(&value, sizeof(T));
+				}
+
+				inline auto write(const void *data, size_t size) -> void
+				{
+					auto bytes = static_cast<const uint8_t *>(data);
+					buffer.insert(buffer.end(), bytes, bytes + size);
+				}
+
+				inline auto write(const std::string &str) -> void
+				{
+					write(static_cast<uint32_t>(str.size()));
+					write(str.data(), str.size());
+				}
+
+				//arrays which are uploaded from the mapping start on an aligned offset.
+				inline auto align() -> void
+				{
+					buffer.resize((buffer.size() + ALIGNMENT - 1) & ~size_t(ALIGNMENT - 1), 0);
+				}
+
+				inline auto &getBuffer() const
+				{
+					return buffer;
+				}
+
+			  private:
+				std::vector<uint8_t> buffer;
+			};
+
+			class Reader
+			{
+			  public:
+				Reader(const uint8_t *data, size_t size) :
+				    data(data), size(size)
+				{
+				}
+
+				template <typename T>
+				inline auto read() -> T
+				{
+					T value{};
+					if (auto ptr = read(sizeof(T)))
+						memcpy(&value, ptr, sizeof(T));
+					return value;
+				}
+
+				inline auto read(size_t bytes) -> const uint8_t *
+				{
+					if (!valid || offset + bytes > size)
+					{
+						valid = false;
+						return nullptr;
+					}
+					auto ptr = data + offset;
+					offset += bytes;
+					return ptr;
+				}
+
+				//element counts are checked against the bytes left, a corrupt count never allocates more than the file holds.
+				inline auto readCount(size_t elementSize) -> uint32_t
+				{
+					const auto count = read<uint32_t>();
+					if (!valid || size_t(count) * elementSize > size - offset)
+					{
+						valid = false;
+						return 0;
+					}
+					return count;
+				}
+
+				inline auto readString() -> std::string
+				{
+					const auto length = read<uint32_t>();
+					auto       ptr    = read(length);
+					return ptr != nullptr ? std::string(reinterpret_cast<const char *>(ptr), length) : std::string{};
+				}
+
+				inline auto align() -> void
+				{
+					offset = (offset + ALIGNMENT - 1) & ~size_t(ALIGNMENT - 1);
+				}
+
+				inline auto getOffset() const
+				{
+					return offset;
+				}
+
+				inline auto isValid() const
+				{
+					return valid;
+				}
+
+			  private:
+				const uint8_t *data;
+				size_t         size;
+				size_t         offset = 0;
+				bool           valid  = true;
+			};
+
+			struct Header
+			{
+				uint32_t magic;
+				uint32_t version;
+				uint64_t sourceHash;
+			};
+
+			//what load parses before anything is created, a file failing halfway leaves no textures or uploads behind.
+			struct TextureEntry
+			{
+				TextureParameters  parameters;
+				TextureLoadOptions loadOptions;
+				std::string        name;
+				std::string        path;
+				uint32_t           width  = 0;
+				uint32_t           height = 0;
+				const uint8_t *    pixels = nullptr;
+			};
+
+			struct MaterialEntry
+			{
+				MaterialProperties                properties;
+				int32_t                           renderFlags = 0;
+				std::array<int32_t, TEXTURE_SLOTS> textures;
+			};
+
+			struct MeshEntry
+			{
+				std::string           key;
+				std::string           name;
+				glm::vec3             min;
+				glm::vec3             max;
+				uint32_t              subMeshCount = 0;
+				std::vector<uint32_t> subMeshIndex;
+				std::vector<int32_t>  materials;
+				VertexFormat          format;
+				glm::vec4             scale;
+				glm::vec4             offset;
+				std::vector<MeshLod>  lods;
+				uint32_t              stride      = 0;
+				uint32_t              vertexCount = 0;
+				uint32_t              indexCount  = 0;
+				const uint8_t *       vertices    = nullptr;
+				const uint8_t *       indices     = nullptr;
+			};
+
+			inline auto getTextureSlots(PBRMataterialTextures &textures) -> std::array<std::shared_ptr<Texture2D> *, TEXTURE_SLOTS>
+			{
+				return {&textures.albedo, &textures.normal, &textures.metallic, &textures.roughness, &textures.ao, &textures.emissive};
+			}
+		}        // namespace
+
+		auto getCachePath(const std::string &source) -> std::string
+		{
+			uint64_t hash = 0;
+			if (!hashFile(source, hash))
+				return "";
+			return getCacheFile(hash);
+		}
+
+		Recorder::Recorder() :
+		    previous(activeRecorder)
+		{
+			activeRecorder = this;
+		}
+
+		Recorder::~Recorder()
+		{
+			activeRecorder = previous;
+		}
+
+		auto record(const Mesh *mesh, const void *vertices, uint32_t stride, uint32_t vertexCount, const std::vector<uint32_t> &indices) -> void
+		{
+			if (activeRecorder == nullptr)
+				return;
+			auto &data  = activeRecorder->meshes[mesh];
+			auto  bytes = static_cast<const uint8_t *>(vertices);
+			data.stride = stride;
+			data.vertices.assign(bytes, bytes + size_t(stride) * vertexCount);
+			data.indices = indices;
+		}
+
+		auto record(const Texture2D *texture, const std::string &name, const std::string &path, const TextureParameters &parameters, const TextureLoadOptions &loadOptions) -> void
+		{
+			if (activeRecorder == nullptr)
+				return;
+			auto &data       = activeRecorder->textures[texture];
+			data.parameters  = parameters;
+			data.loadOptions = loadOptions;
+			data.name        = name;
+			data.path        = path;
+		}
+
+		auto record(const Texture2D *texture, uint32_t width, uint32_t height, const void *pixels, const TextureParameters &parameters, const TextureLoadOptions &loadOptions) -> void
+		{
+			if (activeRecorder == nullptr)
+				return;
+			auto &     data   = activeRecorder->textures[texture];
+			const auto stride = Texture::getStrideFromFormat(parameters.format);
+			data.parameters   = parameters;
+			data.loadOptions  = loadOptions;
+			data.width        = width;
+			data.height       = height;
+			data.valid        = pixels != nullptr && stride != 0;
+			if (data.valid)
+			{
+				auto bytes = static_cast<const uint8_t *>(pixels);
+				data.pixels.assign(bytes, bytes + size_t(stride) * width * height);
+			}
+		}
+
+		auto Recorder::save(const std::string &source, const std::vector<std::shared_ptr<IResource>> &resources) -> bool
+		{
+			PROFILE_FUNCTION();
+			std::shared_ptr<MeshResource> meshResource;
+			std::shared_ptr<Skeleton>     skeleton;
+			for (auto &res : resources)
+			{
+				if (res->getResourceType() == FileType::Model && meshResource == nullptr)
+					meshResource = std::static_pointer_cast<MeshResource>(res);
+				else if (res->getResourceType() == FileType::Skeleton && skeleton == nullptr)
+					skeleton = std::static_pointer_cast<Skeleton>(res);
+				else
+					return false;
+			}
+
+			if (meshResource == nullptr)
+				return false;
+
+			std::vector<const Material *>                     materials;
+			std::unordered_map<const Material *, int32_t>     materialIndices;
+			std::vector<const Texture2D *>                    textureList;
+			std::unordered_map<const Texture2D *, int32_t>    textureIndices;
+
+			for (auto &[name, mesh] : meshResource->getMeshes())
+			{
+				if (meshes.count(mesh.get()) == 0)
+					return false;
+
+				for (auto &material : mesh->getMaterial())
+				{
+					if (material == nullptr || materialIndices.count(material.get()) != 0)
+						continue;
+					materialIndices[material.get()] = static_cast<int32_t>(materials.size());
+					materials.emplace_back(material.get());
+
+					auto textures = material->getTextures();
+					for (auto slot : getTextureSlots(textures))
+					{
+						auto texture = slot->get();
+						if (texture == nullptr || textureIndices.count(texture) != 0)
+							continue;
+						auto iter = this->textures.find(texture);
+						if (iter == this->textures.end() || !iter->second.valid)
+							return false;
+						textureIndices[texture] = static_cast<int32_t>(textureList.size());
+						textureList.emplace_back(texture);
+					}
+				}
+			}
+
+			uint64_t hash = 0;
+			if (!hashFile(source, hash))
+				return false;
+
+			Writer writer;
+			writer.write(Header{MAGIC, VERSION, hash});
+
+			writer.write(static_cast<uint32_t>(textureList.size()));
+			for (auto texture : textureList)
+			{
+				auto &data = this->textures[texture];
+				writer.write(data.parameters);
+				writer.write(data.loadOptions);
+				writer.write(data.name);
+				writer.write(data.path);
+				if (data.path.empty())
+				{
+					writer.write(data.width);
+					writer.write(data.height);
+					writer.write(static_cast<uint32_t>(data.pixels.size()));
+					writer.align();
+					writer.write(data.pixels.data(), data.pixels.size());
+				}
+			}
+
+			writer.write(static_cast<uint32_t>(materials.size()));
+			for (auto material : materials)
+			{
+				writer.write(material->getProperties());
+				writer.write(material->getRenderFlags());
+				auto textures = material->getTextures();
+				for (auto slot : getTextureSlots(textures))
+				{
+					writer.write(*slot != nullptr ? textureIndices[slot->get()] : -1);
+				}
+			}
+
+			writer.write(static_cast<uint32_t>(skeleton ? skeleton->getBones().size() : 0));
+			if (skeleton)
+			{
+				for (auto &bone : skeleton->getBones())
+				{
+					writer.write(bone.id);
+					writer.write(bone.parentIdx);
+					writer.write(bone.name);
+					writer.write(bone.offsetMatrix);
+					writer.write(bone.localTransform);
+					writer.write(static_cast<uint32_t>(bone.children.size()));
+					writer.write(bone.children.data(), bone.children.size() * sizeof(int32_t));
+				}
+			}
+
+			writer.write(static_cast<uint32_t>(meshResource->getMeshes().size()));
+			for (auto &[name, mesh] : meshResource->getMeshes())
+			{
+				auto &data = meshes[mesh.get()];
+				auto &box  = mesh->getBoundingBox();
+				writer.write(name);
+				writer.write(mesh->getName());
+				writer.write(box != nullptr ? box->min : glm::vec3(0));
+				writer.write(box != nullptr ? box->max : glm::vec3(0));
+				writer.write(mesh->getSubMeshCount());
+				writer.write(static_cast<uint32_t>(mesh->getSubMeshIndex().size()));
+				writer.write(mesh->getSubMeshIndex().data(), mesh->getSubMeshIndex().size() * sizeof(uint32_t));
+				writer.write(static_cast<uint32_t>(mesh->getMaterial().size()));
+				for (auto &material : mesh->getMaterial())
+				{
+					writer.write(material != nullptr ? materialIndices[material.get()] : -1);
+				}
+				writer.write(mesh->getVertexFormat());
+				writer.write(mesh->getPositionScale());
+				writer.write(mesh->getPositionOffset());
+				writer.write(static_cast<uint32_t>(mesh->getLods().size()));
+				writer.write(mesh->getLods().data(), mesh->getLods().size() * sizeof(MeshLod));
+				writer.write(data.stride);
+				writer.write(static_cast<uint32_t>(data.vertices.size() / data.stride));
+				writer.write(static_cast<uint32_t>(data.indices.size()));
+				writer.align();
+				writer.write(data.vertices.data(), data.vertices.size());
+				writer.align();
+				writer.write(data.indices.data(), data.indices.size() * sizeof(uint32_t));
+			}
+
+			//written next to the final name first, a crash while writing never leaves a broken cache behind.
+			const auto      path = getCacheFile(hash);
+			const auto      temp = path + ".tmp";
+			std::error_code error;
+			std::filesystem::create_directories(CACHE_FOLDER, error);
+			{
+				std::ofstream file(temp, std::ios::binary | std::ios::trunc);
+				if (!file)
+				{
+					LOGW("MeshCache : can not write {0}", temp);
+					return false;
+				}
+				file.write(reinterpret_cast<const char *>(writer.getBuffer().data()), writer.getBuffer().size());
+			}
+			std::filesystem::remove(path, error);
+			std::filesystem::rename(temp, path, error);
+			if (error)
+			{
+				LOGW("MeshCache : can not write {0} : {1}", path, error.message());
+				return false;
+			}
+			LOGI("MeshCache : cooked {0} into {1}", source, path);
+			return true;
+		}
+
+		auto load(const std::string &source, std::vector<std::shared_ptr<IResource>> &out) -> bool
+		{
+			PROFILE_FUNCTION();
+			uint64_t hash = 0;
+			if (!hashFile(source, hash))
+				return false;
+
+			const auto path = getCacheFile(hash);
+			if (!std::filesystem::exists(path))
+				return false;
+
+			//the mapping is kept alive by the deferred uploads, vertices and indices are read from it directly.
+			auto            mapping = std::make_shared<mio::mmap_source>();
+			std::error_code error;
+			mapping->map(path, error);
+			if (error)
+				return false;
+
+			Reader reader(reinterpret_cast<const uint8_t *>(mapping->data()), mapping->size());
+			const auto header = reader.read<Header>();
+			if (!reader.isValid() || header.magic != MAGIC || header.version != VERSION || header.sourceHash != hash)
+				return false;
+
+			std::vector<TextureEntry> textureEntries(reader.readCount(sizeof(TextureParameters) + sizeof(TextureLoadOptions) + 2 * sizeof(uint32_t)));
+			for (auto &entry : textureEntries)
+			{
+				entry.parameters  = reader.read<TextureParameters>();
+				entry.loadOptions = reader.read<TextureLoadOptions>();
+				entry.name        = reader.readString();
+				entry.path        = reader.readString();
+				if (!entry.path.empty())
+					continue;
+				entry.width       = reader.read<uint32_t>();
+				entry.height      = reader.read<uint32_t>();
+				const auto size   = reader.read<uint32_t>();
+				reader.align();
+				entry.pixels = reader.read(size);
+				if (entry.pixels == nullptr || size != size_t(Texture::getStrideFromFormat(entry.parameters.format)) * entry.width * entry.height)
+					return false;
+			}
+
+			std::vector<MaterialEntry> materialEntries(reader.readCount(sizeof(MaterialProperties) + sizeof(int32_t) * (TEXTURE_SLOTS + 1)));
+			for (auto &entry : materialEntries)
+			{
+				entry.properties  = reader.read<MaterialProperties>();
+				entry.renderFlags = reader.read<int32_t>();
+				for (auto &index : entry.textures)
+				{
+					index = reader.read<int32_t>();
+				}
+			}
+
+			std::shared_ptr<Skeleton> skeleton;
+			if (const auto boneCount = reader.readCount(sizeof(int32_t) * 2 + sizeof(uint32_t) * 2 + sizeof(glm::mat4) * 2); boneCount > 0)
+			{
+				skeleton = std::make_shared<Skeleton>(source);
+				auto &bones = skeleton->getBones();
+				bones.resize(boneCount);
+				for (auto &bone : bones)
+				{
+					bone.id             = reader.read<int32_t>();
+					bone.parentIdx      = reader.read<int32_t>();
+					bone.name           = reader.readString();
+					bone.offsetMatrix   = reader.read<glm::mat4>();
+					bone.localTransform = reader.read<glm::mat4>();
+					bone.children.resize(reader.readCount(sizeof(int32_t)));
+					for (auto &child : bone.children)
+					{
+						child = reader.read<int32_t>();
+					}
+				}
+			}
+
+			std::vector<MeshEntry> meshEntries(reader.readCount(sizeof(uint32_t) * 2 + sizeof(glm::vec3) * 2));
+			for (auto &entry : meshEntries)
+			{
+				entry.key          = reader.readString();
+				entry.name         = reader.readString();
+				entry.min          = reader.read<glm::vec3>();
+				entry.max          = reader.read<glm::vec3>();
+				entry.subMeshCount = reader.read<uint32_t>();
+
+				entry.subMeshIndex.resize(reader.readCount(sizeof(uint32_t)));
+				for (auto &index : entry.subMeshIndex)
+				{
+					index = reader.read<uint32_t>();
+				}
+
+				entry.materials.resize(reader.readCount(sizeof(int32_t)));
+				for (auto &index : entry.materials)
+				{
+					index = reader.read<int32_t>();
+				}
+
+				entry.format = reader.read<VertexFormat>();
+				entry.scale  = reader.read<glm::vec4>();
+				entry.offset = reader.read<glm::vec4>();
+				//cooked while the compact shaders were available, imported again in the full layout.
+				if (entry.format == VertexFormat::Compact && !Mesh::isCompactVertices())
+					return false;
+
+				entry.lods.resize(reader.readCount(sizeof(MeshLod)));
+				for (auto &lod : entry.lods)
+				{
+					lod = reader.read<MeshLod>();
+				}
+
+				entry.stride      = reader.read<uint32_t>();
+				entry.vertexCount = reader.read<uint32_t>();
+				entry.indexCount  = reader.read<uint32_t>();
+				reader.align();
+				entry.vertices = reader.read(size_t(entry.stride) * entry.vertexCount);
+				reader.align();
+				entry.indices = reader.read(size_t(entry.indexCount) * sizeof(uint32_t));
+				if (entry.vertices == nullptr || entry.indices == nullptr)
+					break;
+				if (entry.stride == 0)
+					return false;
+			}
+
+			if (!reader.isValid())
+			{
+				LOGW("MeshCache : {0} is truncated", path);
+				return false;
+			}
+
+			//the whole file is parsed, only now are resources created and uploads scheduled.
+			std::vector<std::shared_ptr<Texture2D>> textures(textureEntries.size());
+			for (size_t i = 0; i < textures.size(); i++)
+			{
+				auto &entry = textureEntries[i];
+				if (!entry.path.empty())
+					textures[i] = Texture2D::create(entry.name, entry.path, entry.parameters, entry.loadOptions);
+				else
+					textures[i] = Texture2D::create(entry.width, entry.height, const_cast<uint8_t *>(entry.pixels), entry.parameters, entry.loadOptions);
+			}
+
+			std::vector<std::shared_ptr<Material>> materials(materialEntries.size());
+			for (size_t i = 0; i < materials.size(); i++)
+			{
+				auto &entry  = materialEntries[i];
+				materials[i] = std::make_shared<Material>();
+				materials[i]->setRenderFlags(entry.renderFlags);
+
+				PBRMataterialTextures pbrTextures;
+				auto                  slots = getTextureSlots(pbrTextures);
+				for (int32_t slot = 0; slot < TEXTURE_SLOTS; slot++)
+				{
+					const auto index = entry.textures[slot];
+					if (index >= 0 && index < static_cast<int32_t>(textures.size()))
+						*slots[slot] = textures[index];
+				}
+				materials[i]->setTextures(pbrTextures);
+				materials[i]->setMaterialProperites(entry.properties);
+			}
+
+			auto meshResource = std::make_shared<MeshResource>(source);
+			for (auto &entry : meshEntries)
+			{
+				auto mesh = std::make_shared<Mesh>();
+				mesh->setName(entry.name);
+				mesh->setBoundingBox(std::make_shared<BoundingBox>(entry.min, entry.max));
+				mesh->setSubMeshCount(entry.subMeshCount);
+				mesh->setSubMeshIndex(entry.subMeshIndex);
+
+				std::vector<std::shared_ptr<Material>> meshMaterials(entry.materials.size());
+				for (size_t i = 0; i < meshMaterials.size(); i++)
+				{
+					const auto index = entry.materials[i];
+					if (index >= 0 && index < static_cast<int32_t>(materials.size()))
+						meshMaterials[i] = materials[index];
+				}
+				mesh->setMaterial(meshMaterials);
+				mesh->setVertexFormat(entry.format, entry.scale, entry.offset);
+				mesh->setLods(entry.lods);
+
+				AssetsLoaderFactory::deferUpload([mesh, mapping, vertices = entry.vertices, indices = entry.indices, stride = entry.stride, vertexCount = entry.vertexCount, indexCount = entry.indexCount]() {
+					mesh->uploadGeometry(vertices, stride, vertexCount, reinterpret_cast<const uint32_t *>(indices), indexCount);
+				});
+				meshResource->addMesh(entry.key, mesh);
+			}
+
+			out.emplace_back(meshResource);
+			if (skeleton)
+				out.emplace_back(skeleton);
+			return true;
+		}
+	};        // namespace MeshCache
+};            // namespace maple
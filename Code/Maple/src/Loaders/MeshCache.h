@@ -0,0 +1,82 @@
+//////////////////////////////////////////////////////////////////////////////
+// This file is part of the Maple Engine                              		//
+//////////////////////////////////////////////////////////////////////////////
+#pragma once
+#include "Engine/Core.h"
+#include "RHI/Definitions.h"
+
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace maple
+{
+	class IResource;
+	class Mesh;
+	class Texture2D;
+
+	/**
+	 * cooked form of an imported model, stored in cache/meshes and keyed by a content hash of the source file.
+	 * it holds the final interleaved vertices, indices, submesh ranges, lods, bounds, materials and the skeleton,
+	 * so loading it is a memory map plus uploads straight from the mapping, nothing is parsed or rebuilt.
+	 */
+	namespace MeshCache
+	{
+		static constexpr uint32_t MAGIC   = 0x48534d4d;        //MMSH
+		static constexpr uint32_t VERSION = 5;
+
+		//false if there is no valid cooked file for the current content of the source.
+		auto MAPLE_EXPORT load(const std::string &source, std::vector<std::shared_ptr<IResource>> &out) -> bool;
+
+		auto MAPLE_EXPORT getCachePath(const std::string &source) -> std::string;
+
+		/**
+		 * collects the data meshes and textures are created from while a loader runs on this thread,
+		 * the loader output can be cooked from it afterwards.
+		 */
+		class MAPLE_EXPORT Recorder
+		{
+		  public:
+			Recorder();
+			~Recorder();
+			NO_COPYABLE(Recorder);
+
+			//writes the cooked file, skipped if the resources contain anything the cache can not restore (animations...).
+			auto save(const std::string &source, const std::vector<std::shared_ptr<IResource>> &resources) -> bool;
+
+		  private:
+			friend auto record(const Mesh *, const void *, uint32_t, uint32_t, const std::vector<uint32_t> &) -> void;
+			friend auto record(const Texture2D *, const std::string &, const std::string &, const TextureParameters &, const TextureLoadOptions &) -> void;
+			friend auto record(const Texture2D *, uint32_t, uint32_t, const void *, const TextureParameters &, const TextureLoadOptions &) -> void;
+
+			struct MeshData
+			{
+				uint32_t              stride = 0;
+				std::vector<uint8_t>  vertices;
+				std::vector<uint32_t> indices;
+			};
+
+			struct TextureData
+			{
+				TextureParameters    parameters;
+				TextureLoadOptions   loadOptions;
+				std::string          name;
+				std::string          path;        //empty for textures created from memory, their pixels are kept instead
+				uint32_t             width  = 0;
+				uint32_t             height = 0;
+				std::vector<uint8_t> pixels;
+				bool                 valid = true;
+			};
+
+			std::unordered_map<const Mesh *, MeshData>         meshes;
+			std::unordered_map<const Texture2D *, TextureData> textures;
+			Recorder *                                         previous = nullptr;
+		};
+
+		//no-ops unless a recorder is active on the calling thread.
+		auto MAPLE_EXPORT record(const Mesh *mesh, const void *vertices, uint32_t stride, uint32_t vertexCount, const std::vector<uint32_t> &indices) -> void;
+		auto MAPLE_EXPORT record(const Texture2D *texture, const std::string &name, const std::string &path, const TextureParameters &parameters, const TextureLoadOptions &loadOptions) -> void;
+		auto MAPLE_EXPORT record(const Texture2D *texture, uint32_t width, uint32_t height, const void *data, const TextureParameters &parameters, const TextureLoadOptions &loadOptions) -> void;
+	};        // namespace MeshCache
+};            // namespace maple
@@ -0,0 +1,815 @@
+//////////////////////////////////////////////////////////////////////////////
+// This file is part of the Maple Engine                              		//
+//////////////////////////////////////////////////////////////////////////////
+#include "MeshOptimizer.h"
+#include "Engine/Mesh.h"
+#include "Others/Console.h"
+#include "Others/HashCode.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <glm/glm.hpp>
+#include <limits>
+#include <unordered_map>
+
+namespace maple
+{
+	namespace MeshOptimizer
+	{
+		namespace
+		{
+			//Forsyth, "Linear-Speed Vertex Cache Optimisation".
+			constexpr uint32_t MAX_CACHE   = 32;
+			constexpr uint32_t MAX_VALENCE = 32;
+
+			struct ScoreTable
+			{
+				float cache[MAX_CACHE];
+				float valence[MAX_VALENCE];
+
+				ScoreTable()
+				{
+					for (uint32_t i = 0; i < MAX_CACHE; i++)
+					{
+						//the last triangle's vertices get a fixed score so it is not simply repeated.
+						cache[i] = i < 3 ? 0.75f : std::pow(1.f - float(i - 3) / float(MAX_CACHE - 3), 1.5f);
+					}
+					valence[0] = 0.f;
+					for (uint32_t i = 1; i < MAX_VALENCE; i++)
+					{
+						//vertices with few triangles left are finished first.
+						valence[i] = 2.f * std::pow(float(i), -0.5f);
+					}
+				}
+			};
+
+			const ScoreTable scoreTable;
+
+			inline auto vertexScore(int32_t cachePosition, uint32_t valence) -> float
+			{
+				if (valence == 0)
+					return -1.f;
+				return (cachePosition >= 0 ? scoreTable.cache[cachePosition] : 0.f) + scoreTable.valence[std::min(valence, MAX_VALENCE - 1)];
+			}
+
+			inline auto getPosition(const uint8_t *vertices, uint32_t stride, uint32_t index)
+			{
+				glm::vec3 position;
+				memcpy(&position, vertices + size_t(index) * stride, sizeof(glm::vec3));
+				return position;
+			}
+
+			inline auto mix(uint64_t hash)
+			{
+				hash ^= hash >> 33;
+				hash *= 0xff51afd7ed558ccdull;
+				hash ^= hash >> 33;
+				return hash;
+			}
+		}        // namespace
+
+		auto analyzeVertexCache(const uint32_t *indices, size_t indexCount, uint32_t vertexCount, uint32_t cacheSize) -> float
+		{
+			if (indexCount < 3)
+				return 0.f;
+
+			//a vertex is still cached if less than cacheSize misses happened since it was loaded.
+			std::vector<uint32_t> timestamps(vertexCount, 0);
+			uint32_t              time   = cacheSize + 1;
+			uint32_t              misses = 0;
+			for (size_t i = 0; i < indexCount; i++)
+			{
+				const auto index = indices[i];
+				if (time - timestamps[index] > cacheSize)
+				{
+					timestamps[index] = time++;
+					misses++;
+				}
+			}
+			return float(misses) / float(indexCount / 3);
+		}
+
+		auto generateWeldRemap(const void *vertices, uint32_t vertexCount, uint32_t stride, std::vector<uint32_t> &remap) -> uint32_t
+		{
+			auto bytes = static_cast<const uint8_t *>(vertices);
+
+			size_t tableSize = 1;
+			while (tableSize < size_t(vertexCount) + vertexCount / 4)
+				tableSize *= 2;
+
+			//open addressing, every slot holds the first vertex seen with that content.
+			std::vector<uint32_t> table(tableSize, ~0u);
+			remap.assign(vertexCount, ~0u);
+
+			uint32_t count = 0;
+			for (uint32_t i = 0; i < vertexCount; i++)
+			{
+				auto vertex = bytes + size_t(i) * stride;
+				auto slot   = mix(HashCode::hashBytes(vertex, stride)) & (tableSize - 1);
+				while (true)
+				{
+					const auto entry = table[slot];
+					if (entry == ~0u)
+					{
+						table[slot] = i;
+						remap[i]    = count++;
+						break;
+					}
+					if (memcmp(bytes + size_t(entry) * stride, vertex, stride) == 0)
+					{
+						remap[i] = remap[entry];
+						break;
+					}
+					slot = (slot + 1) & (tableSize - 1);
+				}
+			}
+			return count;
+		}
+
+		auto weld(void *vertices, uint32_t vertexCount, uint32_t stride, std::vector<uint32_t> &indices) -> uint32_t
+		{
+			std::vector<uint32_t> remap;
+			const auto            count = generateWeldRemap(vertices, vertexCount, stride, remap);
+			if (count == vertexCount)
+				return vertexCount;
+
+			//a vertex only ever moves towards the front, so it can be compacted in place.
+			auto     bytes   = static_cast<uint8_t *>(vertices);
+			uint32_t written = 0;
+			for (uint32_t i = 0; i < vertexCount; i++)
+			{
+				if (remap[i] == written)
+				{
+					if (written != i)
+						memcpy(bytes + size_t(written) * stride, bytes + size_t(i) * stride, stride);
+					written++;
+				}
+			}
+			for (auto &index : indices)
+			{
+				index = remap[index];
+			}
+			return count;
+		}
+
+		auto optimizeVertexCache(uint32_t *indices, size_t indexCount, uint32_t vertexCount) -> void
+		{
+			const size_t faceCount = indexCount / 3;
+			if (faceCount == 0)
+				return;
+
+			//triangles of every vertex, the ones not emitted yet are kept at the front of each list.
+			std::vector<uint32_t> valence(vertexCount, 0);
+			for (size_t i = 0; i < faceCount * 3; i++)
+			{
+				valence[indices[i]]++;
+			}
+
+			std::vector<uint32_t> offsets(size_t(vertexCount) + 1, 0);
+			for (uint32_t i = 0; i < vertexCount; i++)
+			{
+				offsets[i + 1] = offsets[i] + valence[i];
+			}
+
+			std::vector<uint32_t> adjacency(faceCount * 3);
+			{
+				std::vector<uint32_t> fill(offsets.begin(), offsets.end() - 1);
+				for (size_t i = 0; i < faceCount * 3; i++)
+				{
+					adjacency[fill[indices[i]]++] = static_cast<uint32_t>(i / 3);
+				}
+			}
+
+			std::vector<int32_t> cachePosition(vertexCount, -1);
+			std::vector<float>   vertexScores(vertexCount);
+			for (uint32_t i = 0; i < vertexCount; i++)
+			{
+				vertexScores[i] = vertexScore(-1, valence[i]);
+			}
+
+			int64_t            best      = -1;
+			float              bestScore = -1.f;
+			std::vector<float> faceScores(faceCount);
+			std::vector<bool>  emitted(faceCount, false);
+			for (size_t i = 0; i < faceCount; i++)
+			{
+				faceScores[i] = vertexScores[indices[i * 3]] + vertexScores[indices[i * 3 + 1]] + vertexScores[indices[i * 3 + 2]];
+				if (faceScores[i] > bestScore)
+				{
+					best      = i;
+					bestScore = faceScores[i];
+				}
+			}
+
+			std::vector<uint32_t> result;
+			result.reserve(faceCount * 3);
+
+			uint32_t cache[MAX_CACHE + 3];
+			uint32_t newCache[MAX_CACHE + 3];
+			uint32_t cacheCount = 0;
+			size_t   cursor     = 0;
+
+			while (best >= 0)
+			{
+				emitted[best] = true;
+				const uint32_t *face = indices + best * 3;
+				result.insert(result.end(), face, face + 3);
+
+				for (uint32_t k = 0; k < 3; k++)
+				{
+					const auto v     = face[k];
+					auto       begin = adjacency.begin() + offsets[v];
+					auto       end   = begin + valence[v];
+					auto       iter  = std::find(begin, end, static_cast<uint32_t>(best));
+					if (iter != end)
+					{
+						*iter = *(end - 1);
+						valence[v]--;
+					}
+				}
+
+				//the emitted vertices move to the front of the cache, the others are pushed back.
+				uint32_t count = 0;
+				for (uint32_t k = 0; k < 3; k++)
+				{
+					if (std::find(newCache, newCache + count, face[k]) == newCache + count)
+						newCache[count++] = face[k];
+				}
+				for (uint32_t i = 0; i < cacheCount; i++)
+				{
+					if (cache[i] != face[0] && cache[i] != face[1] && cache[i] != face[2])
+						newCache[count++] = cache[i];
+				}
+
+				for (uint32_t i = 0; i < count; i++)
+				{
+					const auto v     = newCache[i];
+					cachePosition[v] = i < MAX_CACHE ? static_cast<int32_t>(i) : -1;
+					vertexScores[v]  = vertexScore(cachePosition[v], valence[v]);
+				}
+
+				best      = -1;
+				bestScore = -1.f;
+				for (uint32_t i = 0; i < count; i++)
+				{
+					const auto v = newCache[i];
+					for (uint32_t j = offsets[v]; j < offsets[v] + valence[v]; j++)
+					{
+						const auto f     = adjacency[j];
+						faceScores[f]    = vertexScores[indices[f * 3]] + vertexScores[indices[f * 3 + 1]] + vertexScores[indices[f * 3 + 2]];
+						if (faceScores[f] > bestScore)
+						{
+							best      = f;
+							bestScore = faceScores[f];
+						}
+					}
+				}
+
+				cacheCount = std::min(count, MAX_CACHE);
+				std::copy(newCache, newCache + cacheCount, cache);
+
+				if (best < 0)
+				{
+					//nothing left around the cache, continue with the next triangle in the source order.
+					while (cursor < faceCount && emitted[cursor])
+						cursor++;
+					best = cursor < faceCount ? static_cast<int64_t>(cursor) : -1;
+				}
+			}
+
+			std::copy(result.begin(), result.end(), indices);
+		}
+
+		auto optimizeOverdraw(uint32_t *indices, size_t indexCount, const void *vertices, uint32_t vertexCount, uint32_t stride, float threshold) -> void
+		{
+			const size_t faceCount = indexCount / 3;
+			if (faceCount < 2)
+				return;
+
+			auto bytes = static_cast<const uint8_t *>(vertices);
+
+			//clusters start where the cache order restarts (all three vertices miss), splitting there costs nothing.
+			std::vector<uint32_t> clusterStarts;
+			{
+				std::vector<uint32_t> timestamps(vertexCount, 0);
+				uint32_t              time = CACHE_SIZE + 1;
+				for (size_t i = 0; i < faceCount; i++)
+				{
+					uint32_t misses = 0;
+					for (uint32_t k = 0; k < 3; k++)
+					{
+						const auto index = indices[i * 3 + k];
+						if (time - timestamps[index] > CACHE_SIZE)
+						{
+							timestamps[index] = time++;
+							misses++;
+						}
+					}
+					if (i == 0 || misses == 3)
+						clusterStarts.emplace_back(static_cast<uint32_t>(i));
+				}
+			}
+
+			if (clusterStarts.size() < 2)
+				return;
+
+			struct Cluster
+			{
+				uint32_t  begin;
+				uint32_t  end;
+				glm::vec3 centroid{0.f};
+				glm::vec3 normal{0.f};
+				float     area = 0.f;
+				float     sortKey = 0.f;
+			};
+
+			std::vector<Cluster> clusters(clusterStarts.size());
+			glm::vec3            meshCentroid(0.f);
+			float                meshArea = 0.f;
+
+			for (size_t c = 0; c < clusters.size(); c++)
+			{
+				auto &cluster = clusters[c];
+				cluster.begin = clusterStarts[c];
+				cluster.end   = c + 1 < clusters.size() ? clusterStarts[c + 1] : static_cast<uint32_t>(faceCount);
+
+				for (uint32_t i = cluster.begin; i < cluster.end; i++)
+				{
+					const auto p0     = getPosition(bytes, stride, indices[i * 3]);
+					const auto p1     = getPosition(bytes, stride, indices[i * 3 + 1]);
+					const auto p2     = getPosition(bytes, stride, indices[i * 3 + 2]);
+					const auto normal = glm::cross(p1 - p0, p2 - p0);
+					const auto area   = glm::length(normal);
+					cluster.centroid += (p0 + p1 + p2) * (area / 3.f);
+					cluster.normal += normal;
+					cluster.area += area;
+				}
+
+				meshCentroid += cluster.centroid;
+				meshArea += cluster.area;
+				if (cluster.area > 0.f)
+					cluster.centroid /= cluster.area;
+			}
+
+			if (meshArea > 0.f)
+				meshCentroid /= meshArea;
+
+			//clusters facing away from the center are in front of the rest from most directions, they go first.
+			for (auto &cluster : clusters)
+			{
+				const auto length = glm::length(cluster.normal);
+				cluster.sortKey   = length > 0.f ? glm::dot(cluster.centroid - meshCentroid, cluster.normal / length) : 0.f;
+			}
+
+			std::stable_sort(clusters.begin(), clusters.end(), [](const Cluster &a, const Cluster &b) {
+				return a.sortKey > b.sortKey;
+			});
+
+			std::vector<uint32_t> result;
+			result.reserve(faceCount * 3);
+			for (auto &cluster : clusters)
+			{
+				result.insert(result.end(), indices + cluster.begin * 3, indices + cluster.end * 3);
+			}
+
+			const auto before = analyzeVertexCache(indices, faceCount * 3, vertexCount);
+			const auto after  = analyzeVertexCache(result.data(), result.size(), vertexCount);
+			if (after <= before * threshold)
+				std::copy(result.begin(), result.end(), indices);
+		}
+
+		auto generateFetchRemap(const uint32_t *indices, size_t indexCount, uint32_t vertexCount, std::vector<uint32_t> &remap) -> uint32_t
+		{
+			remap.assign(vertexCount, ~0u);
+			uint32_t count = 0;
+			for (size_t i = 0; i < indexCount; i++)
+			{
+				auto &index = remap[indices[i]];
+				if (index == ~0u)
+					index = count++;
+			}
+			return count;
+		}
+
+		auto optimize(void *vertices, uint32_t vertexCount, uint32_t stride, std::vector<uint32_t> &indices, const std::vector<uint32_t> &ranges) -> uint32_t
+		{
+			if (indices.empty() || vertexCount == 0)
+				return vertexCount;
+
+			for (auto index : indices)
+			{
+				if (index >= vertexCount)
+				{
+					LOGW("MeshOptimizer : index {0} out of {1} vertices, mesh left as it is", index, vertexCount);
+					return vertexCount;
+				}
+			}
+
+			auto       bytes      = static_cast<uint8_t *>(vertices);
+			const auto oldCount   = vertexCount;
+			const auto acmrBefore = analyzeVertexCache(indices.data(), indices.size(), vertexCount);
+
+			vertexCount = weld(vertices, vertexCount, stride, indices);
+
+			//triangles are only reordered inside their submesh, the boundaries have to be valid triangle offsets.
+			std::vector<uint32_t> bounds = {0};
+			bool                  valid  = true;
+			for (auto range : ranges)
+			{
+				valid &= range % 3 == 0 && range >= bounds.back() && range <= indices.size();
+				bounds.emplace_back(range);
+			}
+			bounds.emplace_back(static_cast<uint32_t>(indices.size()));
+
+			if (valid)
+			{
+				for (size_t i = 0; i + 1 < bounds.size(); i++)
+				{
+					const auto begin = bounds[i];
+					const auto count = bounds[i + 1] - (bounds[i + 1] - begin) % 3 - begin;
+					optimizeVertexCache(indices.data() + begin, count, vertexCount);
+					optimizeOverdraw(indices.data() + begin, count, vertices, vertexCount, stride);
+				}
+			}
+
+			std::vector<uint32_t> remap;
+			const auto            fetched = generateFetchRemap(indices.data(), indices.size(), vertexCount, remap);
+			std::vector<uint8_t> reordered(size_t(fetched) * stride);
+			for (uint32_t i = 0; i < vertexCount; i++)
+			{
+				if (remap[i] != ~0u)
+					memcpy(reordered.data() + size_t(remap[i]) * stride, bytes + size_t(i) * stride, stride);
+			}
+			memcpy(bytes, reordered.data(), reordered.size());
+			for (auto &index : indices)
+			{
+				index = remap[index];
+			}
+
+			LOGI("MeshOptimizer : {0} -> {1} vertices, ACMR {2:.3f} -> {3:.3f}", oldCount, fetched, acmrBefore, analyzeVertexCache(indices.data(), indices.size(), fetched));
+			return fetched;
+		}
+
+		namespace
+		{
+			//Garland and Heckbert, "Surface Simplification Using Quadric Error Metrics".
+			struct Quadric
+			{
+				double a00 = 0, a11 = 0, a22 = 0, a01 = 0, a02 = 0, a12 = 0;
+				double b0 = 0, b1 = 0, b2 = 0, c = 0;
+				double weight = 0;
+
+				inline auto addPlane(const glm::dvec3 &n, double d, double w) -> void
+				{
+					a00 += w * n.x * n.x;
+					a11 += w * n.y * n.y;
+					a22 += w * n.z * n.z;
+					a01 += w * n.x * n.y;
+					a02 += w * n.x * n.z;
+					a12 += w * n.y * n.z;
+					b0 += w * n.x * d;
+					b1 += w * n.y * d;
+					b2 += w * n.z * d;
+					c += w * d * d;
+					weight += w;
+				}
+
+				inline auto operator+=(const Quadric &q) -> Quadric &
+				{
+					a00 += q.a00, a11 += q.a11, a22 += q.a22, a01 += q.a01, a02 += q.a02, a12 += q.a12;
+					b0 += q.b0, b1 += q.b1, b2 += q.b2, c += q.c;
+					weight += q.weight;
+					return *this;
+				}
+
+				//area weighted mean of the squared distances to the planes.
+				inline auto evaluate(const glm::dvec3 &p) const -> double
+				{
+					if (weight <= 0)
+						return 0;
+					const auto r = a00 * p.x * p.x + a11 * p.y * p.y + a22 * p.z * p.z +
+					               2 * (a01 * p.x * p.y + a02 * p.x * p.z + a12 * p.y * p.z) +
+					               2 * (b0 * p.x + b1 * p.y + b2 * p.z) + c;
+					return std::max(r, 0.0) / weight;
+				}
+			};
+
+			struct Collapse
+			{
+				uint32_t from;
+				uint32_t to;
+				double   cost;
+			};
+
+			/**
+			 * half edge collapses, a vertex is always moved onto one of its neighbours so every lod indexes the original vertices.
+			 * vertices on open borders, non manifold edges and attribute seams (one position, several vertices) never move,
+			 * which keeps the silhouette and the uv layout intact.
+			 */
+			class Simplifier
+			{
+			  public:
+				Simplifier(const uint8_t *vertices, uint32_t vertexCount, uint32_t stride, const uint32_t *indices, size_t indexCount) :
+				    triangles(indices, indices + indexCount), remap(vertexCount)
+				{
+					glm::vec3 min(std::numeric_limits<float>::max());
+					glm::vec3 max(std::numeric_limits<float>::lowest());
+					positions.resize(vertexCount);
+					for (uint32_t i = 0; i < vertexCount; i++)
+					{
+						positions[i] = getPosition(vertices, stride, i);
+						min          = glm::min(min, positions[i]);
+						max          = glm::max(max, positions[i]);
+					}
+
+					//quadrics are built in the unit box, the error is scaled back to model units.
+					extent = std::max(glm::max(max.x - min.x, max.y - min.y), max.z - min.z);
+					const auto invExtent = extent > 0.f ? 1.f / extent : 0.f;
+					for (auto &position : positions)
+					{
+						position = (position - min) * invExtent;
+					}
+
+					std::vector<uint32_t> vertexToPosition;
+					const auto positionCount = generateWeldRemap(positions.data(), vertexCount, sizeof(glm::vec3), vertexToPosition);
+					positionIds = std::move(vertexToPosition);
+
+					std::vector<uint32_t> wedges(positionCount, 0);
+					for (auto id : positionIds)
+					{
+						wedges[id]++;
+					}
+
+					locked.assign(positionCount, false);
+					for (uint32_t i = 0; i < positionCount; i++)
+					{
+						locked[i] = wedges[i] > 1;
+					}
+
+					//an edge is interior when it is used once in each direction.
+					std::unordered_map<uint64_t, uint32_t> edges;
+					edges.reserve(triangles.size());
+					auto edgeKey = [&](uint32_t a, uint32_t b) {
+						return (uint64_t(positionIds[a]) << 32) | positionIds[b];
+					};
+					for (size_t i = 0; i < triangles.size(); i += 3)
+					{
+						for (uint32_t e = 0; e < 3; e++)
+						{
+							edges[edgeKey(triangles[i + e], triangles[i + (e + 1) % 3])]++;
+						}
+					}
+					for (size_t i = 0; i < triangles.size(); i += 3)
+					{
+						for (uint32_t e = 0; e < 3; e++)
+						{
+							const auto a       = triangles[i + e];
+							const auto b       = triangles[i + (e + 1) % 3];
+							const auto reverse = edges.find(edgeKey(b, a));
+							if (edges[edgeKey(a, b)] != 1 || reverse == edges.end() || reverse->second != 1)
+							{
+								locked[positionIds[a]] = true;
+								locked[positionIds[b]] = true;
+							}
+						}
+					}
+
+					quadrics.resize(positionCount);
+					for (size_t i = 0; i < triangles.size(); i += 3)
+					{
+						const glm::dvec3 p0     = positions[triangles[i]];
+						const glm::dvec3 p1     = positions[triangles[i + 1]];
+						const glm::dvec3 p2     = positions[triangles[i + 2]];
+						auto             normal = glm::cross(p1 - p0, p2 - p0);
+						const auto       length = glm::length(normal);
+						if (length <= 0)
+							continue;
+						normal /= length;
+						const auto d = -glm::dot(normal, p0);
+						for (uint32_t j = 0; j < 3; j++)
+						{
+							quadrics[positionIds[triangles[i + j]]].addPlane(normal, d, length * 0.5);
+						}
+					}
+				}
+
+				//collapses edges until the triangle count reaches the target or every collapse left costs more than maxError.
+				auto simplify(size_t targetIndexCount, float maxError) -> void
+				{
+					const double maxCost = double(maxError) * maxError;
+					while (triangles.size() > targetIndexCount)
+					{
+						if (!collapsePass(targetIndexCount, maxCost))
+							break;
+					}
+				}
+
+				inline auto &getTriangles() const
+				{
+					return triangles;
+				}
+
+				//largest distance a collapse so far moved the surface, in model units.
+				inline auto getError() const
+				{
+					return float(std::sqrt(error)) * extent;
+				}
+
+				inline auto getExtent() const
+				{
+					return extent;
+				}
+
+			  private:
+				inline auto normal(uint32_t a, uint32_t b, uint32_t c) const
+				{
+					return glm::cross(positions[b] - positions[a], positions[c] - positions[a]);
+				}
+
+				//would moving from onto to fold any triangle which is kept over.
+				auto flips(uint32_t from, uint32_t to) const -> bool
+				{
+					for (auto t = adjacencyOffsets[from]; t < adjacencyOffsets[from + 1]; t++)
+					{
+						const auto base = adjacency[t] * 3;
+						uint32_t   corners[3];
+						bool       removed = false;
+						for (uint32_t j = 0; j < 3; j++)
+						{
+							corners[j] = remap[triangles[base + j]];
+							removed |= positionIds[corners[j]] == positionIds[to];
+						}
+						if (removed)
+							continue;
+
+						const auto before = normal(corners[0], corners[1], corners[2]);
+						for (auto &corner : corners)
+						{
+							if (corner == from)
+								corner = to;
+						}
+						const auto after = normal(corners[0], corners[1], corners[2]);
+						const auto scale = glm::length(before) * glm::length(after);
+						if (scale <= 0.f || glm::dot(before, after) < 0.25f * scale)
+							return true;
+					}
+					return false;
+				}
+
+				auto buildAdjacency() -> void
+				{
+					const auto vertexCount = static_cast<uint32_t>(positions.size());
+					adjacencyOffsets.assign(vertexCount + 1, 0);
+					for (auto index : triangles)
+					{
+						adjacencyOffsets[index + 1]++;
+					}
+					for (uint32_t i = 0; i < vertexCount; i++)
+					{
+						adjacencyOffsets[i + 1] += adjacencyOffsets[i];
+					}
+					adjacency.resize(triangles.size());
+					std::vector<uint32_t> fill(adjacencyOffsets.begin(), adjacencyOffsets.end() - 1);
+					for (size_t i = 0; i < triangles.size(); i++)
+					{
+						adjacency[fill[triangles[i]]++] = static_cast<uint32_t>(i / 3);
+					}
+				}
+
+				auto collapsePass(size_t targetIndexCount, double maxCost) -> bool
+				{
+					buildAdjacency();
+					for (uint32_t i = 0; i < remap.size(); i++)
+					{
+						remap[i] = i;
+					}
+
+					collapses.clear();
+					for (size_t i = 0; i < triangles.size(); i += 3)
+					{
+						for (uint32_t e = 0; e < 3; e++)
+						{
+							const auto a = triangles[i + e];
+							const auto b = triangles[i + (e + 1) % 3];
+							addCollapse(a, b);
+							addCollapse(b, a);
+						}
+					}
+					std::sort(collapses.begin(), collapses.end(), [](const Collapse &a, const Collapse &b) { return a.cost < b.cost; });
+
+					//every collapse removes at least one triangle, one vertex only takes part in one collapse per pass.
+					std::vector<bool> touched(positions.size(), false);
+					size_t            indexCount = triangles.size();
+					bool              progress   = false;
+					for (auto &collapse : collapses)
+					{
+						if (indexCount <= targetIndexCount || collapse.cost > maxCost)
+							break;
+						if (touched[collapse.from] || touched[collapse.to] || flips(collapse.from, collapse.to))
+							continue;
+
+						for (auto t = adjacencyOffsets[collapse.from]; t < adjacencyOffsets[collapse.from + 1]; t++)
+						{
+							const auto base = adjacency[t] * 3;
+							for (uint32_t j = 0; j < 3; j++)
+							{
+								if (positionIds[remap[triangles[base + j]]] == positionIds[collapse.to])
+								{
+									indexCount -= 3;
+									break;
+								}
+							}
+						}
+
+						remap[collapse.from] = collapse.to;
+						quadrics[positionIds[collapse.to]] += quadrics[positionIds[collapse.from]];
+						touched[collapse.from] = true;
+						touched[collapse.to]   = true;
+						error                  = std::max(error, collapse.cost);
+						progress               = true;
+					}
+
+					//triangles which lost their area in position space are dropped, that includes the ones across seams.
+					size_t written = 0;
+					for (size_t i = 0; i < triangles.size(); i += 3)
+					{
+						const auto a = remap[triangles[i]];
+						const auto b = remap[triangles[i + 1]];
+						const auto c = remap[triangles[i + 2]];
+						if (positionIds[a] == positionIds[b] || positionIds[b] == positionIds[c] || positionIds[a] == positionIds[c])
+							continue;
+						triangles[written++] = a;
+						triangles[written++] = b;
+						triangles[written++] = c;
+					}
+					triangles.resize(written);
+					return progress;
+				}
+
+				inline auto addCollapse(uint32_t from, uint32_t to) -> void
+				{
+					const auto fromId = positionIds[from];
+					const auto toId   = positionIds[to];
+					if (locked[fromId] || fromId == toId)
+						return;
+					auto quadric = quadrics[fromId];
+					quadric += quadrics[toId];
+					collapses.push_back({from, to, quadric.evaluate(positions[to])});
+				}
+
+				std::vector<uint32_t>  triangles;
+				std::vector<uint32_t>  remap;
+				std::vector<glm::vec3> positions;
+				std::vector<uint32_t>  positionIds;
+				std::vector<bool>      locked;
+				std::vector<Quadric>   quadrics;
+				std::vector<uint32_t>  adjacency;
+				std::vector<uint32_t>  adjacencyOffsets;
+				std::vector<Collapse>  collapses;
+				double                 error  = 0;
+				float                  extent = 0.f;
+			};
+		}        // namespace
+
+		auto generateLods(const void *vertices, uint32_t vertexCount, uint32_t stride, std::vector<uint32_t> &indices, std::vector<MeshLod> &lods) -> void
+		{
+			lods.clear();
+			const auto baseCount = static_cast<uint32_t>(indices.size());
+			if (baseCount / 3 < LOD_MIN_TRIANGLES * 2 || baseCount % 3 != 0)
+				return;
+
+			Simplifier simplifier(static_cast<const uint8_t *>(vertices), vertexCount, stride, indices.data(), indices.size());
+			lods.push_back({0, baseCount, 0.f});
+
+			while (lods.size() < MAX_LODS)
+			{
+				const auto previous = lods.back().indexCount;
+				if (previous / 3 < LOD_MIN_TRIANGLES * 2)
+					break;
+
+				simplifier.simplify(size_t(previous * LOD_REDUCTION) / 3 * 3, LOD_MAX_ERROR);
+				auto &triangles = simplifier.getTriangles();
+				//stop once the collapses left are too costly to give a noticeably cheaper lod.
+				if (triangles.empty() || triangles.size() > previous * 0.8f)
+					break;
+
+				const auto offset = static_cast<uint32_t>(indices.size());
+				indices.insert(indices.end(), triangles.begin(), triangles.end());
+				optimizeVertexCache(indices.data() + offset, triangles.size(), vertexCount);
+				lods.push_back({offset, static_cast<uint32_t>(triangles.size()), simplifier.getError()});
+			}
+
+			if (lods.size() == 1)
+			{
+				lods.clear();
+				return;
+			}
+
+			for (size_t i = 1; i < lods.size(); i++)
+			{
+				LOGI("MeshOptimizer : lod {0}, {1} triangles, error {2:.5f}", i, lods[i].indexCount / 3, lods[i].error);
+			}
+		}
+	};        // namespace MeshOptimizer
+};            // namespace maple
@@ -0,0 +1,84 @@
+//////////////////////////////////////////////////////////////////////////////
+// This file is part of the Maple Engine                              		//
+//////////////////////////////////////////////////////////////////////////////
+#pragma once
+#include "Engine/Core.h"
+
+#include <cstdint>
+#include <vector>
+
+namespace maple
+{
+	struct MeshLod;
+
+	/**
+	 * processing run by the importers on every mesh before its buffers are created :
+	 * identical vertices are welded, triangles are reordered for the post transform cache (Forsyth) and then
+	 * by cluster so outward facing parts are drawn first, and vertices are laid out in the order they are fetched.
+	 * vertices are handled as raw bytes with the position in the first 12 bytes (Vertex, SkinnedVertex).
+	 */
+	namespace MeshOptimizer
+	{
+		//FIFO size the ACMR is measured with, close to the caches of current hardware.
+		static constexpr uint32_t CACHE_SIZE = 16;
+		//the overdraw ordering is dropped if it costs more than this in ACMR.
+		static constexpr float OVERDRAW_THRESHOLD = 1.05f;
+
+		//lod 0 included.
+		static constexpr uint32_t MAX_LODS = 5;
+		//each lod aims at this fraction of the triangles of the previous one.
+		static constexpr float LOD_REDUCTION = 0.5f;
+		//meshes below twice this are not worth simplifying, the chain also stops there.
+		static constexpr uint32_t LOD_MIN_TRIANGLES = 128;
+		//largest error of a collapse relative to the size of the mesh.
+		static constexpr float LOD_MAX_ERROR = 0.05f;
+
+		//average cache miss ratio : transformed vertices per triangle, 0.5 at best and 3 at worst.
+		auto MAPLE_EXPORT analyzeVertexCache(const uint32_t *indices, size_t indexCount, uint32_t vertexCount, uint32_t cacheSize = CACHE_SIZE) -> float;
+
+		//remap[i] is the new index of vertex i, bitwise identical vertices share one. returns the new vertex count.
+		auto MAPLE_EXPORT generateWeldRemap(const void *vertices, uint32_t vertexCount, uint32_t stride, std::vector<uint32_t> &remap) -> uint32_t;
+
+		//welds in place and rewrites the indices, returns the new vertex count.
+		auto MAPLE_EXPORT weld(void *vertices, uint32_t vertexCount, uint32_t stride, std::vector<uint32_t> &indices) -> uint32_t;
+
+		auto MAPLE_EXPORT optimizeVertexCache(uint32_t *indices, size_t indexCount, uint32_t vertexCount) -> void;
+
+		//expects indices already ordered by optimizeVertexCache.
+		auto MAPLE_EXPORT optimizeOverdraw(uint32_t *indices, size_t indexCount, const void *vertices, uint32_t vertexCount, uint32_t stride, float threshold = OVERDRAW_THRESHOLD) -> void;
+
+		//remap[i] is the new index of vertex i in first use order, unused vertices get ~0u. returns the new vertex count.
+		auto MAPLE_EXPORT generateFetchRemap(const uint32_t *indices, size_t indexCount, uint32_t vertexCount, std::vector<uint32_t> &remap) -> uint32_t;
+
+		/**
+		 * runs all the steps above and returns the new vertex count, the vertices are compacted in place.
+		 * ranges are the submesh boundaries (Mesh::getSubMeshIndex), triangles never move across them.
+		 */
+		auto MAPLE_EXPORT optimize(void *vertices, uint32_t vertexCount, uint32_t stride, std::vector<uint32_t> &indices, const std::vector<uint32_t> &ranges) -> uint32_t;
+
+		/**
+		 * appends a chain of simplified index lists (quadric error edge collapse) behind the indices, every lod draws
+		 * the same vertices. lods gets one entry per level starting with the full mesh and stays empty if nothing was generated.
+		 * expects a single submesh, the ranges of several materials would be mixed up.
+		 */
+		auto MAPLE_EXPORT generateLods(const void *vertices, uint32_t vertexCount, uint32_t stride, std::vector<uint32_t> &indices, std::vector<MeshLod> &lods) -> void;
+
+		template <typename T>
+		inline auto weld(std::vector<T> &vertices, std::vector<uint32_t> &indices) -> void
+		{
+			vertices.resize(weld(vertices.data(), static_cast<uint32_t>(vertices.size()), sizeof(T), indices));
+		}
+
+		template <typename T>
+		inline auto optimize(std::vector<T> &vertices, std::vector<uint32_t> &indices, const std::vector<uint32_t> &ranges = {}) -> void
+		{
+			vertices.resize(optimize(vertices.data(), static_cast<uint32_t>(vertices.size()), sizeof(T), indices, ranges));
+		}
+
+		template <typename T>
+		inline auto generateLods(const std::vector<T> &vertices, std::vector<uint32_t> &indices, std::vector<MeshLod> &lods) -> void
+		{
+			generateLods(vertices.data(), static_cast<uint32_t>(vertices.size()), sizeof(T), indices, lods);
+		}
+	};        // namespace MeshOptimizer
+};            // namespace maple
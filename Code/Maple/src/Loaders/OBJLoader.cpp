@@ -2,6 +2,7 @@
 // This file is part of the Maple Engine                              		//
 //////////////////////////////////////////////////////////////////////////////
 #include "OBJLoader.h"
+#include "MeshOptimizer.h"
 
 #define TINYOBJLOADER_IMPLEMENTATION
 #include <tiny_obj_loader.h>
@@ -26,8 +27,7 @@ namespace maple
 		}
 
 		{        // If texture hasn't been loaded already, load it
-			TextureLoadOptions options(false, true);
-			auto               texture = Texture2D::create(typeName, directory + "/" + name, format, {false,false,false});
+			auto texture = Texture2D::create(typeName, directory + "/" + name, format, {false, false, true, true});
 			texturesLoaded.push_back(texture);        // Store it as texture loaded for entire model, to ensure we won't unnecessary load duplicate textures.
 			return texture;
 		}
@@ -57,7 +57,6 @@ namespace maple
 		{
 			std::vector<Vertex>                  vertices;
 			std::vector<uint32_t>                indices;
-			std::unordered_map<Vertex, uint32_t> uniqueVertices{};
 
 			for (const auto& index : shape.mesh.indices)
 			{
@@ -81,15 +80,13 @@ namespace maple
 
 				vertex.color = { 1.0f, 1.0f, 1.0f, 1.f };
 
-				if (uniqueVertices.count(vertex) == 0)
-				{
-					uniqueVertices[vertex] = static_cast<uint32_t>(vertices.size());
-					vertices.push_back(vertex);
-				}
-
-				indices.emplace_back(uniqueVertices[vertex]);
+				indices.emplace_back(static_cast<uint32_t>(vertices.size()));
+				vertices.push_back(vertex);
 			}
 
+			//shared before the normals and tangents are generated, so they are smoothed across triangles.
+			MeshOptimizer::weld(vertices, indices);
+
 			if (attrib.normals.empty())
 				Mesh::generateNormals(vertices, indices);
 
@@ -141,7 +138,11 @@ namespace maple
 				}*/
 			}
 			pbrMaterial->setTextures(textures);
-			auto mesh = std::make_shared<Mesh>(indices, vertices);
+			MeshOptimizer::optimize(vertices, indices);
+			std::vector<MeshLod> lods;
+			MeshOptimizer::generateLods(vertices, indices, lods);
+			auto mesh = std::make_shared<Mesh>(indices, vertices, true);
+			mesh->setLods(lods);
 			mesh->setMaterial(pbrMaterial);
 			mesh->setName(shape.name);
 			meshes->addMesh(shape.name, mesh);
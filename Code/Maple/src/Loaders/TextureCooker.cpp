@@ -0,0 +1,404 @@
+//////////////////////////////////////////////////////////////////////////////
+// This file is part of the Maple Engine                              		//
+//////////////////////////////////////////////////////////////////////////////
+#include "TextureCooker.h"
+#include "Engine/Profiler.h"
+#include "Others/Console.h"
+#include "Others/HashCode.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <ktx.h>
+#include <mio.hpp>
+#include <vector>
+
+namespace maple
+{
+	namespace TextureCooker
+	{
+		namespace
+		{
+			constexpr const char *CACHE_FOLDER = "cache/textures";
+			constexpr uint32_t    GL_DXT1      = 0x83F1;        //GL_COMPRESSED_RGBA_S3TC_DXT1_EXT
+			constexpr uint32_t    GL_DXT5      = 0x83F3;        //GL_COMPRESSED_RGBA_S3TC_DXT5_EXT
+
+			inline auto to565(const float color[3]) -> uint16_t
+			{
+				auto r = static_cast<uint16_t>(std::clamp(color[0], 0.f, 255.f) * 31.f / 255.f + 0.5f);
+				auto g = static_cast<uint16_t>(std::clamp(color[1], 0.f, 255.f) * 63.f / 255.f + 0.5f);
+				auto b = static_cast<uint16_t>(std::clamp(color[2], 0.f, 255.f) * 31.f / 255.f + 0.5f);
+				return (r << 11) | (g << 5) | b;
+			}
+
+			inline auto from565(uint16_t color, int32_t out[3]) -> void
+			{
+				const int32_t r = (color >> 11) & 31;
+				const int32_t g = (color >> 5) & 63;
+				const int32_t b = color & 31;
+				out[0]          = (r << 3) | (r >> 2);
+				out[1]          = (g << 2) | (g >> 4);
+				out[2]          = (b << 3) | (b >> 2);
+			}
+
+			//endpoints are fitted along the principal axis of the block colors, then every texel takes the closest of the 4 palette entries.
+			inline auto encodeColor(const uint8_t block[16][4], uint8_t *out) -> void
+			{
+				float mean[3] = {};
+				for (int32_t i = 0; i < 16; i++)
+					for (int32_t c = 0; c < 3; c++)
+						mean[c] += block[i][c] / 16.f;
+
+				float cov[6] = {};
+				float min[3] = {255.f, 255.f, 255.f};
+				float max[3] = {};
+				for (int32_t i = 0; i < 16; i++)
+				{
+					const float d[3] = {block[i][0] - mean[0], block[i][1] - mean[1], block[i][2] - mean[2]};
+					cov[0] += d[0] * d[0];
+					cov[1] += d[0] * d[1];
+					cov[2] += d[0] * d[2];
+					cov[3] += d[1] * d[1];
+					cov[4] += d[1] * d[2];
+					cov[5] += d[2] * d[2];
+					for (int32_t c = 0; c < 3; c++)
+					{
+						min[c] = std::min<float>(min[c], block[i][c]);
+						max[c] = std::max<float>(max[c], block[i][c]);
+					}
+				}
+
+				//power iteration, seeded with the diagonal of the bounding box.
+				float axis[3] = {max[0] - min[0], max[1] - min[1], max[2] - min[2]};
+				for (int32_t iter = 0; iter < 4; iter++)
+				{
+					const float next[3] = {
+					    cov[0] * axis[0] + cov[1] * axis[1] + cov[2] * axis[2],
+					    cov[1] * axis[0] + cov[3] * axis[1] + cov[4] * axis[2],
+					    cov[2] * axis[0] + cov[4] * axis[1] + cov[5] * axis[2]};
+					const float length = std::max({std::abs(next[0]), std::abs(next[1]), std::abs(next[2])});
+					if (length < 1e-6f)
+						break;
+					for (int32_t c = 0; c < 3; c++)
+						axis[c] = next[c] / length;
+				}
+
+				float minT = 0;
+				float maxT = 0;
+				for (int32_t i = 0; i < 16; i++)
+				{
+					const float t = (block[i][0] - mean[0]) * axis[0] + (block[i][1] - mean[1]) * axis[1] + (block[i][2] - mean[2]) * axis[2];
+					minT          = std::min(minT, t);
+					maxT          = std::max(maxT, t);
+				}
+
+				const float lengthSq = axis[0] * axis[0] + axis[1] * axis[1] + axis[2] * axis[2];
+				float       start[3];
+				float       end[3];
+				for (int32_t c = 0; c < 3; c++)
+				{
+					const float scale = lengthSq > 0 ? axis[c] / lengthSq : 0;
+					start[c]          = mean[c] + scale * maxT;
+					end[c]            = mean[c] + scale * minT;
+					//pull the endpoints in a little, the interpolated entries then cover the extremes better.
+					const float inset = (start[c] - end[c]) / 16.f;
+					start[c] -= inset;
+					end[c] += inset;
+				}
+
+				auto c0 = to565(start);
+				auto c1 = to565(end);
+				if (c0 < c1)
+					std::swap(c0, c1);
+
+				uint32_t indices = 0;
+				if (c0 != c1)
+				{
+					int32_t palette[4][3];
+					from565(c0, palette[0]);
+					from565(c1, palette[1]);
+					for (int32_t c = 0; c < 3; c++)
+					{
+						palette[2][c] = (2 * palette[0][c] + palette[1][c]) / 3;
+						palette[3][c] = (palette[0][c] + 2 * palette[1][c]) / 3;
+					}
+					for (int32_t i = 0; i < 16; i++)
+					{
+						uint32_t best     = 0;
+						int32_t  bestDist = INT32_MAX;
+						for (uint32_t p = 0; p < 4; p++)
+						{
+							const int32_t dr   = block[i][0] - palette[p][0];
+							const int32_t dg   = block[i][1] - palette[p][1];
+							const int32_t db   = block[i][2] - palette[p][2];
+							const int32_t dist = dr * dr + dg * dg + db * db;
+							if (dist < bestDist)
+							{
+								bestDist = dist;
+								best     = p;
+							}
+						}
+						indices |= best << (i * 2);
+					}
+				}
+
+				out[0] = c0 & 0xff;
+				out[1] = c0 >> 8;
+				out[2] = c1 & 0xff;
+				out[3] = c1 >> 8;
+				memcpy(out + 4, &indices, sizeof(uint32_t));
+			}
+
+			//8 interpolated alpha values between the block's min and max.
+			inline auto encodeAlpha(const uint8_t block[16][4], uint8_t *out) -> void
+			{
+				uint8_t a0 = 0;
+				uint8_t a1 = 255;
+				for (int32_t i = 0; i < 16; i++)
+				{
+					a0 = std::max(a0, block[i][3]);
+					a1 = std::min(a1, block[i][3]);
+				}
+
+				uint64_t indices = 0;
+				if (a0 != a1)
+				{
+					int32_t palette[8] = {a0, a1};
+					for (int32_t p = 1; p < 7; p++)
+						palette[p + 1] = ((7 - p) * a0 + p * a1) / 7;
+
+					for (int32_t i = 0; i < 16; i++)
+					{
+						uint64_t best     = 0;
+						int32_t  bestDist = INT32_MAX;
+						for (uint64_t p = 0; p < 8; p++)
+						{
+							const int32_t dist = std::abs(block[i][3] - palette[p]);
+							if (dist < bestDist)
+							{
+								bestDist = dist;
+								best     = p;
+							}
+						}
+						indices |= best << (i * 3);
+					}
+				}
+
+				out[0] = a0;
+				out[1] = a1;
+				for (int32_t i = 0; i < 6; i++)
+					out[2 + i] = static_cast<uint8_t>(indices >> (i * 8));
+			}
+
+			inline auto compressLevel(const uint8_t *pixels, uint32_t width, uint32_t height, bool alpha, uint8_t *out) -> void
+			{
+				const uint32_t blockSize = alpha ? 16 : 8;
+				uint8_t        block[16][4];
+				for (uint32_t by = 0; by < (height + 3) / 4; by++)
+				{
+					for (uint32_t bx = 0; bx < (width + 3) / 4; bx++)
+					{
+						//the edge texels are repeated into blocks hanging over the image.
+						for (uint32_t i = 0; i < 16; i++)
+						{
+							const auto x = std::min(bx * 4 + i % 4, width - 1);
+							const auto y = std::min(by * 4 + i / 4, height - 1);
+							memcpy(block[i], pixels + (size_t(y) * width + x) * 4, 4);
+						}
+						if (alpha)
+						{
+							encodeAlpha(block, out);
+							encodeColor(block, out + 8);
+						}
+						else
+						{
+							encodeColor(block, out);
+						}
+						out += blockSize;
+					}
+				}
+			}
+
+			//box filter, the last row or column is reused for odd sizes.
+			inline auto downsample(const std::vector<uint8_t> &pixels, uint32_t width, uint32_t height) -> std::vector<uint8_t>
+			{
+				const auto           w = std::max(1u, width / 2);
+				const auto           h = std::max(1u, height / 2);
+				std::vector<uint8_t> out(size_t(w) * h * 4);
+				for (uint32_t y = 0; y < h; y++)
+				{
+					const auto y0 = std::min(y * 2, height - 1);
+					const auto y1 = std::min(y * 2 + 1, height - 1);
+					for (uint32_t x = 0; x < w; x++)
+					{
+						const auto x0 = std::min(x * 2, width - 1);
+						const auto x1 = std::min(x * 2 + 1, width - 1);
+						for (uint32_t c = 0; c < 4; c++)
+						{
+							const uint32_t sum = pixels[(size_t(y0) * width + x0) * 4 + c] + pixels[(size_t(y0) * width + x1) * 4 + c] +
+							                     pixels[(size_t(y1) * width + x0) * 4 + c] + pixels[(size_t(y1) * width + x1) * 4 + c];
+							out[(size_t(y) * w + x) * 4 + c] = static_cast<uint8_t>((sum + 2) / 4);
+						}
+					}
+				}
+				return out;
+			}
+
+			inline auto getLevelSize(uint32_t width, uint32_t height, uint32_t level, uint32_t blockSize) -> uint32_t
+			{
+				const auto w = std::max(1u, width >> level);
+				const auto h = std::max(1u, height >> level);
+				return ((w + 3) / 4) * ((h + 3) / 4) * blockSize;
+			}
+		}        // namespace
+
+		auto getCachePath(const std::string &source, bool flipY) -> std::string
+		{
+			std::error_code  error;
+			mio::mmap_source file;
+			file.map(source, error);
+			if (error)
+				return "";
+
+			//the orientation and the cooker version are part of the key, a change of either cooks again.
+			auto hash = HashCode::hashBytes(file.data(), file.size());
+			hash      = (hash ^ (flipY ? 1 : 0)) * 1099511628211ull;
+			hash      = (hash ^ VERSION) * 1099511628211ull;
+
+			char name[32];
+			snprintf(name, sizeof(name), "%016llx.ktx", static_cast<unsigned long long>(hash));
+			return std::string(CACHE_FOLDER) + "/" + name;
+		}
+
+		auto load(const std::string &cachePath) -> std::unique_ptr<Image>
+		{
+			PROFILE_FUNCTION();
+			if (cachePath.empty() || !std::filesystem::exists(cachePath))
+				return nullptr;
+
+			ktxTexture *texture = nullptr;
+			if (ktxTexture_CreateFromNamedFile(cachePath.c_str(), KTX_TEXTURE_CREATE_LOAD_IMAGE_DATA_BIT, &texture) != KTX_SUCCESS)
+			{
+				LOGW("TextureCooker : {0} is not a valid ktx file", cachePath);
+				return nullptr;
+			}
+
+			std::unique_ptr<Image> image;
+			if ((texture->glInternalformat == GL_DXT1 || texture->glInternalformat == GL_DXT5) && texture->numDimensions == 2 &&
+			    texture->numFaces == 1 && texture->numLayers == 1)
+			{
+				std::vector<ImageMip> mips;
+				for (uint32_t level = 0; level < texture->numLevels; level++)
+				{
+					ktx_size_t offset = 0;
+					ktxTexture_GetImageOffset(texture, level, 0, 0, &offset);
+					mips.push_back({static_cast<uint32_t>(offset), static_cast<uint32_t>(ktxTexture_GetImageSize(texture, level))});
+				}
+
+				auto data = malloc(texture->dataSize);
+				memcpy(data, ktxTexture_GetData(texture), texture->dataSize);
+				const auto alpha = texture->glInternalformat == GL_DXT5;
+				image            = std::make_unique<Image>(alpha ? TextureFormat::BC3 : TextureFormat::BC1, texture->baseWidth, texture->baseHeight,
+                                                data, static_cast<uint32_t>(texture->dataSize), 4, texture->numLevels > 1);
+				image->setMips(std::move(mips));
+			}
+			ktxTexture_Destroy(texture);
+			return image;
+		}
+
+		auto save(const std::string &cachePath, const Image &image) -> bool
+		{
+			PROFILE_FUNCTION();
+			if (!image.isCompressed() || cachePath.empty())
+				return false;
+
+			ktxTextureCreateInfo info{};
+			info.glInternalformat = image.getPixelFormat() == TextureFormat::BC3 ? GL_DXT5 : GL_DXT1;
+			info.baseWidth        = image.getWidth();
+			info.baseHeight       = image.getHeight();
+			info.baseDepth        = 1;
+			info.numDimensions    = 2;
+			info.numLevels        = static_cast<uint32_t>(image.getMips().size());
+			info.numLayers        = 1;
+			info.numFaces         = 1;
+			info.isArray          = KTX_FALSE;
+			info.generateMipmaps  = KTX_FALSE;
+
+			ktxTexture *texture = nullptr;
+			if (ktxTexture_Create(&info, KTX_TEXTURE_CREATE_ALLOC_STORAGE, &texture) != KTX_SUCCESS)
+				return false;
+
+			const auto data = static_cast<const uint8_t *>(image.getData());
+			for (uint32_t level = 0; level < info.numLevels; level++)
+			{
+				const auto &mip = image.getMips()[level];
+				ktxTexture_SetImageFromMemory(texture, level, 0, 0, data + mip.offset, mip.size);
+			}
+
+			//written next to the final name first, a crash while writing never leaves a broken cache behind.
+			const auto      temp = cachePath + ".tmp";
+			std::error_code error;
+			std::filesystem::create_directories(CACHE_FOLDER, error);
+			const auto result = ktxTexture_WriteToNamedFile(texture, temp.c_str());
+			ktxTexture_Destroy(texture);
+			if (result != KTX_SUCCESS)
+			{
+				LOGW("TextureCooker : can not write {0}", temp);
+				return false;
+			}
+			std::filesystem::remove(cachePath, error);
+			std::filesystem::rename(temp, cachePath, error);
+			if (error)
+			{
+				LOGW("TextureCooker : can not write {0} : {1}", cachePath, error.message());
+				return false;
+			}
+			return true;
+		}
+
+		auto compress(const Image &image) -> std::unique_ptr<Image>
+		{
+			PROFILE_FUNCTION();
+			if (image.getPixelFormat() != TextureFormat::RGBA8 || image.isHDR() || image.getData() == nullptr)
+				return nullptr;
+
+			const auto width  = image.getWidth();
+			const auto height = image.getHeight();
+			const auto pixels = static_cast<const uint8_t *>(image.getData());
+
+			//BC1 has no alpha worth using, BC3 is only paid for when a texel is not opaque.
+			bool alpha = false;
+			for (size_t i = 3; i < size_t(width) * height * 4 && !alpha; i += 4)
+				alpha = pixels[i] != 255;
+
+			const uint32_t blockSize = alpha ? 16 : 8;
+			const uint32_t levels    = static_cast<uint32_t>(std::floor(std::log2(std::max(width, height)))) + 1;
+
+			std::vector<ImageMip> mips;
+			uint32_t              size = 0;
+			for (uint32_t level = 0; level < levels; level++)
+			{
+				mips.push_back({size, getLevelSize(width, height, level, blockSize)});
+				size += mips.back().size;
+			}
+
+			auto                 data = static_cast<uint8_t *>(malloc(size));
+			std::vector<uint8_t> level(pixels, pixels + size_t(width) * height * 4);
+			for (uint32_t i = 0; i < levels; i++)
+			{
+				const auto w = std::max(1u, width >> i);
+				const auto h = std::max(1u, height >> i);
+				compressLevel(level.data(), w, h, alpha, data + mips[i].offset);
+				if (i + 1 < levels)
+					level = downsample(level, w, h);
+			}
+
+			auto compressed = std::make_unique<Image>(alpha ? TextureFormat::BC3 : TextureFormat::BC1, width, height, data, size, 4, true);
+			compressed->setMips(std::move(mips));
+			return compressed;
+		}
+	};        // namespace TextureCooker
+};            // namespace maple
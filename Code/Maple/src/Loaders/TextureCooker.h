@@ -0,0 +1,33 @@
+//////////////////////////////////////////////////////////////////////////////
+// This file is part of the Maple Engine                              		//
+//////////////////////////////////////////////////////////////////////////////
+#pragma once
+#include "Engine/Core.h"
+#include "FileSystem/Image.h"
+
+#include <memory>
+#include <string>
+
+namespace maple
+{
+	/**
+	 * cooked form of 8 bit images : BC1 (opaque) or BC3 (with alpha) blocks with a full mip chain,
+	 * stored as KTX files in cache/textures and keyed by a content hash of the source file.
+	 * the runtime uploads the stored blocks as they are, nothing is decoded or generated.
+	 */
+	namespace TextureCooker
+	{
+		static constexpr uint32_t VERSION = 1;
+
+		//empty if the source can not be read.
+		auto MAPLE_EXPORT getCachePath(const std::string &source, bool flipY) -> std::string;
+
+		//null if there is no valid cooked file.
+		auto MAPLE_EXPORT load(const std::string &cachePath) -> std::unique_ptr<Image>;
+
+		auto MAPLE_EXPORT save(const std::string &cachePath, const Image &image) -> bool;
+
+		//builds the mip chain of an RGBA8 image and compresses every level.
+		auto MAPLE_EXPORT compress(const Image &image) -> std::unique_ptr<Image>;
+	};        // namespace TextureCooker
+};            // namespace maple
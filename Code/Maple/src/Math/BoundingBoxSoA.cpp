@@ -0,0 +1,313 @@
+//////////////////////////////////////////////////////////////////////////////
+// This file is part of the Maple Engine                              		//
+//////////////////////////////////////////////////////////////////////////////
+#include "BoundingBoxSoA.h"
+#include "Frustum.h"
+#include "Engine/Profiler.h"
+
+#include <chrono>
+#include <random>
+#include <glm/gtc/matrix_transform.hpp>
+
+#if defined(__AVX__)
+#	include <immintrin.h>
+#	define MAPLE_CULL_AVX
+#elif defined(__SSE2__) || defined(_M_X64) || defined(_M_AMD64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#	include <emmintrin.h>
+#	define MAPLE_CULL_SSE
+#endif
+
+namespace maple
+{
+	namespace
+	{
+		//undefined boxes are always visible, a finite value keeps 0 * extent out of NaN land.
+		constexpr float HUGE_EXTENT = 1e30f;
+
+		struct SimdPlanes
+		{
+			float nx[6], ny[6], nz[6], d[6];
+			float ax[6], ay[6], az[6];
+		};
+
+		inline auto loadPlanes(const Frustum &frustum)
+		{
+			SimdPlanes planes;
+			for (int32_t i = 0; i < 6; i++)
+			{
+				auto &plane  = frustum.getPlane(static_cast<Frustum::FrustumPlane>(i));
+				auto  normal = plane.getNormal();
+				planes.nx[i] = normal.x;
+				planes.ny[i] = normal.y;
+				planes.nz[i] = normal.z;
+				planes.d[i]  = plane.getDistance();
+				planes.ax[i] = std::abs(normal.x);
+				planes.ay[i] = std::abs(normal.y);
+				planes.az[i] = std::abs(normal.z);
+			}
+			return planes;
+		}
+
+		inline auto isInside(const SimdPlanes &plane, float cx, float cy, float cz, float ex, float ey, float ez)
+		{
+			for (int32_t p = 0; p < 6; p++)
+			{
+				const float dist = cx * plane.nx[p] + cy * plane.ny[p] + cz * plane.nz[p] + plane.d[p] + ex * plane.ax[p] + ey * plane.ay[p] + ez * plane.az[p];
+				if (dist < 0.f)
+					return false;
+			}
+			return true;
+		}
+
+#if defined(MAPLE_CULL_AVX)
+		constexpr uint32_t GROUP_SIZE = 8;
+
+		//one bit per box which is inside or intersecting, the six pointers address GROUP_SIZE consecutive floats.
+		inline auto testGroup(const SimdPlanes &plane, const float *centerX, const float *centerY, const float *centerZ, const float *extentX, const float *extentY, const float *extentZ) -> uint32_t
+		{
+			const auto cx = _mm256_loadu_ps(centerX);
+			const auto cy = _mm256_loadu_ps(centerY);
+			const auto cz = _mm256_loadu_ps(centerZ);
+			const auto ex = _mm256_loadu_ps(extentX);
+			const auto ey = _mm256_loadu_ps(extentY);
+			const auto ez = _mm256_loadu_ps(extentZ);
+
+			auto inside = _mm256_castsi256_ps(_mm256_set1_epi32(-1));
+			for (int32_t p = 0; p < 6; p++)
+			{
+				//distance of the center plus the projected radius, negative means fully outside.
+				auto dist = _mm256_add_ps(_mm256_mul_ps(cx, _mm256_set1_ps(plane.nx[p])), _mm256_set1_ps(plane.d[p]));
+				dist      = _mm256_add_ps(dist, _mm256_mul_ps(cy, _mm256_set1_ps(plane.ny[p])));
+				dist      = _mm256_add_ps(dist, _mm256_mul_ps(cz, _mm256_set1_ps(plane.nz[p])));
+				dist      = _mm256_add_ps(dist, _mm256_mul_ps(ex, _mm256_set1_ps(plane.ax[p])));
+				dist      = _mm256_add_ps(dist, _mm256_mul_ps(ey, _mm256_set1_ps(plane.ay[p])));
+				dist      = _mm256_add_ps(dist, _mm256_mul_ps(ez, _mm256_set1_ps(plane.az[p])));
+				inside    = _mm256_and_ps(inside, _mm256_cmp_ps(dist, _mm256_setzero_ps(), _CMP_GE_OQ));
+			}
+			return static_cast<uint32_t>(_mm256_movemask_ps(inside));
+		}
+#elif defined(MAPLE_CULL_SSE)
+		constexpr uint32_t GROUP_SIZE = 4;
+
+		//one bit per box which is inside or intersecting, the six pointers address GROUP_SIZE consecutive floats.
+		inline auto testGroup(const SimdPlanes &plane, const float *centerX, const float *centerY, const float *centerZ, const float *extentX, const float *extentY, const float *extentZ) -> uint32_t
+		{
+			const auto cx = _mm_loadu_ps(centerX);
+			const auto cy = _mm_loadu_ps(centerY);
+			const auto cz = _mm_loadu_ps(centerZ);
+			const auto ex = _mm_loadu_ps(extentX);
+			const auto ey = _mm_loadu_ps(extentY);
+			const auto ez = _mm_loadu_ps(extentZ);
+
+			auto inside = _mm_castsi128_ps(_mm_set1_epi32(-1));
+			for (int32_t p = 0; p < 6; p++)
+			{
+				//distance of the center plus the projected radius, negative means fully outside.
+				auto dist = _mm_add_ps(_mm_mul_ps(cx, _mm_set1_ps(plane.nx[p])), _mm_set1_ps(plane.d[p]));
+				dist      = _mm_add_ps(dist, _mm_mul_ps(cy, _mm_set1_ps(plane.ny[p])));
+				dist      = _mm_add_ps(dist, _mm_mul_ps(cz, _mm_set1_ps(plane.nz[p])));
+				dist      = _mm_add_ps(dist, _mm_mul_ps(ex, _mm_set1_ps(plane.ax[p])));
+				dist      = _mm_add_ps(dist, _mm_mul_ps(ey, _mm_set1_ps(plane.ay[p])));
+				dist      = _mm_add_ps(dist, _mm_mul_ps(ez, _mm_set1_ps(plane.az[p])));
+				inside    = _mm_and_ps(inside, _mm_cmpge_ps(dist, _mm_setzero_ps()));
+			}
+			return static_cast<uint32_t>(_mm_movemask_ps(inside));
+		}
+#endif
+
+		inline auto emit(uint32_t mask, uint32_t base, std::vector<uint32_t> &visible)
+		{
+			for (uint32_t j = 0; mask != 0; j++, mask >>= 1)
+			{
+				if (mask & 1)
+					visible.emplace_back(base + j);
+			}
+		}
+	}        // namespace
+
+	auto BoundingBoxSoA::resize(uint32_t newCount) -> void
+	{
+		count = newCount;
+		for (auto array : {&centerX, &centerY, &centerZ, &extentX, &extentY, &extentZ})
+		{
+			array->resize(newCount, 0.f);
+		}
+	}
+
+	auto BoundingBoxSoA::clear() -> void
+	{
+		resize(0);
+	}
+
+	auto BoundingBoxSoA::set(uint32_t index, const BoundingBox &box) -> void
+	{
+		if (!box.isDefined())
+		{
+			centerX[index] = centerY[index] = centerZ[index] = 0.f;
+			extentX[index] = extentY[index] = extentZ[index] = HUGE_EXTENT;
+			return;
+		}
+		const auto center = box.center();
+		const auto extent = box.size() * 0.5f;
+		centerX[index]    = center.x;
+		centerY[index]    = center.y;
+		centerZ[index]    = center.z;
+		extentX[index]    = extent.x;
+		extentY[index]    = extent.y;
+		extentZ[index]    = extent.z;
+	}
+
+	auto BoundingBoxSoA::set(uint32_t index, const BoundingBox &localBox, const glm::mat4 &transform) -> void
+	{
+		if (!localBox.isDefined())
+		{
+			set(index, localBox);
+			return;
+		}
+		//Arvo : the new extent is the local extent projected by the absolute rotation/scale part.
+		const auto center = glm::vec3(transform * glm::vec4(localBox.center(), 1.f));
+		const auto local  = localBox.size() * 0.5f;
+		const auto absMat = glm::mat3(glm::abs(transform[0]), glm::abs(transform[1]), glm::abs(transform[2]));
+		const auto extent = absMat * local;
+
+		centerX[index] = center.x;
+		centerY[index] = center.y;
+		centerZ[index] = center.z;
+		extentX[index] = extent.x;
+		extentY[index] = extent.y;
+		extentZ[index] = extent.z;
+	}
+
+	auto BoundingBoxSoA::get(uint32_t index) const -> BoundingBox
+	{
+		const glm::vec3 center{centerX[index], centerY[index], centerZ[index]};
+		const glm::vec3 extent{extentX[index], extentY[index], extentZ[index]};
+		return {center - extent, center + extent};
+	}
+
+	auto BoundingBoxSoA::cull(const Frustum &frustum, std::vector<uint32_t> &visible) const -> void
+	{
+		cull(frustum, 0, count, visible);
+	}
+
+	auto BoundingBoxSoA::cull(const Frustum &frustum, uint32_t begin, uint32_t end, std::vector<uint32_t> &visible) const -> void
+	{
+		PROFILE_FUNCTION();
+		end              = std::min(end, count);
+		const auto plane = loadPlanes(frustum);
+
+		//only full groups are loaded, the remaining boxes of the range are tested one by one below.
+		uint32_t i = begin;
+#if defined(MAPLE_CULL_AVX) || defined(MAPLE_CULL_SSE)
+		for (; i + GROUP_SIZE <= end; i += GROUP_SIZE)
+		{
+			emit(testGroup(plane, &centerX[i], &centerY[i], &centerZ[i], &extentX[i], &extentY[i], &extentZ[i]), i, visible);
+		}
+#endif
+		for (; i < end; i++)
+		{
+			if (isInside(plane, centerX[i], centerY[i], centerZ[i], extentX[i], extentY[i], extentZ[i]))
+				visible.emplace_back(i);
+		}
+	}
+
+	auto BoundingBoxSoA::refine(const Frustum &frustum, std::vector<uint32_t> &indices, size_t begin) const -> void
+	{
+		PROFILE_FUNCTION();
+		const auto plane = loadPlanes(frustum);
+		auto       write = begin;
+		auto       i     = begin;
+#if defined(MAPLE_CULL_AVX) || defined(MAPLE_CULL_SSE)
+		//the indices are scattered, each group is gathered into small contiguous arrays first.
+		float gathered[6][GROUP_SIZE];
+		for (; i + GROUP_SIZE <= indices.size(); i += GROUP_SIZE)
+		{
+			for (uint32_t j = 0; j < GROUP_SIZE; j++)
+			{
+				const auto index = indices[i + j];
+				gathered[0][j]   = centerX[index];
+				gathered[1][j]   = centerY[index];
+				gathered[2][j]   = centerZ[index];
+				gathered[3][j]   = extentX[index];
+				gathered[4][j]   = extentY[index];
+				gathered[5][j]   = extentZ[index];
+			}
+
+			auto mask = testGroup(plane, gathered[0], gathered[1], gathered[2], gathered[3], gathered[4], gathered[5]);
+			for (uint32_t j = 0; mask != 0; j++, mask >>= 1)
+			{
+				if (mask & 1)
+					indices[write++] = indices[i + j];
+			}
+		}
+#endif
+		for (; i < indices.size(); i++)
+		{
+			const auto index = indices[i];
+			if (isInside(plane, centerX[index], centerY[index], centerZ[index], extentX[index], extentY[index], extentZ[index]))
+				indices[write++] = index;
+		}
+		indices.resize(write);
+	}
+
+	auto BoundingBoxSoA::benchmark(uint32_t count, uint32_t iterations) -> BenchmarkResult
+	{
+		using Clock = std::chrono::high_resolution_clock;
+
+		std::mt19937                          random(1234);
+		std::uniform_real_distribution<float> position(-1000.f, 1000.f);
+		std::uniform_real_distribution<float> size(0.5f, 10.f);
+		std::uniform_real_distribution<float> angle(0.f, 6.2831853f);
+
+		std::vector<BoundingBox> locals(count);
+		std::vector<glm::mat4>   transforms(count);
+		for (uint32_t i = 0; i < count; i++)
+		{
+			auto extent   = glm::vec3{size(random), size(random), size(random)};
+			locals[i]     = {-extent, extent};
+			transforms[i] = glm::rotate(glm::translate(glm::mat4(1.f), {position(random), position(random), position(random)}), angle(random), glm::normalize(glm::vec3{1.f, 2.f, 3.f}));
+		}
+
+		Frustum frustum;
+		frustum.from(glm::perspective(glm::radians(60.f), 16.f / 9.f, 0.1f, 800.f) * glm::lookAt(glm::vec3{0.f}, glm::vec3{1.f, 0.f, 1.f}, glm::vec3{0.f, 1.f, 0.f}));
+
+		BenchmarkResult result{};
+		iterations = std::max(iterations, 1u);
+
+		auto start = Clock::now();
+		for (uint32_t it = 0; it < iterations; it++)
+		{
+			result.scalarVisible = 0;
+			for (uint32_t i = 0; i < count; i++)
+			{
+				auto bb = locals[i].transform(transforms[i]);
+				result.scalarVisible += frustum.isInside(bb) ? 1 : 0;
+			}
+		}
+		result.scalarMs = std::chrono::duration<double, std::milli>(Clock::now() - start).count() / iterations;
+
+		BoundingBoxSoA soa;
+		soa.resize(count);
+		start = Clock::now();
+		for (uint32_t it = 0; it < iterations; it++)
+		{
+			for (uint32_t i = 0; i < count; i++)
+			{
+				soa.set(i, locals[i], transforms[i]);
+			}
+		}
+		result.updateMs = std::chrono::duration<double, std::milli>(Clock::now() - start).count() / iterations;
+
+		std::vector<uint32_t> visible;
+		visible.reserve(count);
+		start = Clock::now();
+		for (uint32_t it = 0; it < iterations; it++)
+		{
+			visible.clear();
+			soa.cull(frustum, visible);
+		}
+		result.simdMs      = std::chrono::duration<double, std::milli>(Clock::now() - start).count() / iterations;
+		result.simdVisible = static_cast<uint32_t>(visible.size());
+		return result;
+	}
+};        // namespace maple
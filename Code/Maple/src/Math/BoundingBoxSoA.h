@@ -0,0 +1,61 @@
+//////////////////////////////////////////////////////////////////////////////
+// This file is part of the Maple Engine                              		//
+//////////////////////////////////////////////////////////////////////////////
+#pragma once
+#include "BoundingBox.h"
+#include "Engine/Core.h"
+#include <cstdint>
+#include <glm/glm.hpp>
+#include <vector>
+
+namespace maple
+{
+	class Frustum;
+
+	/**
+	 * world space boxes stored as center/extent arrays, so the frustum test can run on 4 (SSE) or 8 (AVX) boxes at once.
+	 */
+	class MAPLE_EXPORT BoundingBoxSoA
+	{
+	  public:
+		struct BenchmarkResult
+		{
+			double   scalarMs;        //transform + Frustum::isInside per box, every frame
+			double   updateMs;        //refreshing every box of the batch, only paid for moved boxes
+			double   simdMs;          //batched frustum test
+			uint32_t scalarVisible;
+			uint32_t simdVisible;
+		};
+
+		auto resize(uint32_t count) -> void;
+		auto clear() -> void;
+
+		auto set(uint32_t index, const BoundingBox &box) -> void;
+		//transforms a local box into a tight world space box (handles rotation, unlike BoundingBox::transform).
+		auto set(uint32_t index, const BoundingBox &localBox, const glm::mat4 &transform) -> void;
+		auto get(uint32_t index) const -> BoundingBox;
+
+		//appends the indices of the boxes inside or intersecting the frustum.
+		auto cull(const Frustum &frustum, std::vector<uint32_t> &visible) const -> void;
+		auto cull(const Frustum &frustum, uint32_t begin, uint32_t end, std::vector<uint32_t> &visible) const -> void;
+		//drops the entries of indices from begin on whose box is outside the frustum, the order of the rest is kept.
+		auto refine(const Frustum &frustum, std::vector<uint32_t> &indices, size_t begin = 0) const -> void;
+
+		inline auto size() const
+		{
+			return count;
+		}
+
+		//compares Frustum::isInside(BoundingBox::transform(...)) per box against the batched test.
+		static auto benchmark(uint32_t count, uint32_t iterations) -> BenchmarkResult;
+
+	  private:
+		std::vector<float> centerX;
+		std::vector<float> centerY;
+		std::vector<float> centerZ;
+		std::vector<float> extentX;
+		std::vector<float> extentY;
+		std::vector<float> extentZ;
+		uint32_t           count = 0;
+	};
+};        // namespace maple
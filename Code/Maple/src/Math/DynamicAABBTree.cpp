@@ -0,0 +1,301 @@
+//////////////////////////////////////////////////////////////////////////////
+// This file is part of the Maple Engine                              		//
+//////////////////////////////////////////////////////////////////////////////
+#include "DynamicAABBTree.h"
+#include <algorithm>
+
+namespace maple
+{
+	namespace
+	{
+		//fat boxes grow by a part of their size, so jittering objects do not reinsert every frame.
+		constexpr float FAT_RATIO  = 0.1f;
+		constexpr float FAT_MARGIN = 0.05f;
+
+		inline auto fatten(const BoundingBox &box)
+		{
+			const auto margin = box.size() * FAT_RATIO + glm::vec3(FAT_MARGIN);
+			return BoundingBox{box.min - margin, box.max + margin};
+		}
+
+		inline auto combine(const BoundingBox &a, const BoundingBox &b)
+		{
+			return BoundingBox{glm::min(a.min, b.min), glm::max(a.max, b.max)};
+		}
+
+		inline auto surfaceArea(const BoundingBox &box)
+		{
+			const auto size = box.size();
+			return 2.f * (size.x * size.y + size.y * size.z + size.z * size.x);
+		}
+
+		inline auto contains(const BoundingBox &outer, const BoundingBox &inner)
+		{
+			return outer.min.x <= inner.min.x && outer.min.y <= inner.min.y && outer.min.z <= inner.min.z &&
+			       outer.max.x >= inner.max.x && outer.max.y >= inner.max.y && outer.max.z >= inner.max.z;
+		}
+	}        // namespace
+
+	auto DynamicAABBTree::classify(const Frustum &frustum, const BoundingBox &box) -> Containment
+	{
+		const auto center = box.center();
+		const auto extent = box.size() * 0.5f;
+		auto       result = Containment::Inside;
+		for (int32_t i = 0; i < 6; i++)
+		{
+			auto &     plane  = frustum.getPlane(static_cast<Frustum::FrustumPlane>(i));
+			const auto normal = plane.getNormal();
+			const auto dist   = plane.getDistance(center);
+			const auto radius = glm::dot(extent, glm::abs(normal));
+			if (dist + radius < 0.f)
+				return Containment::Outside;
+			if (dist - radius < 0.f)
+				result = Containment::Intersect;
+		}
+		return result;
+	}
+
+	auto DynamicAABBTree::overlap(const BoundingBox &a, const BoundingBox &b) -> bool
+	{
+		return !(a.max.x < b.min.x || a.min.x > b.max.x || a.max.y < b.min.y || a.min.y > b.max.y || a.max.z < b.min.z || a.min.z > b.max.z);
+	}
+
+	auto DynamicAABBTree::createProxy(const BoundingBox &box, uint32_t userData) -> int32_t
+	{
+		MAPLE_ASSERT(box.isDefined(), "DynamicAABBTree : proxy needs a defined box");
+		const auto proxy      = allocateNode();
+		nodes[proxy].box      = fatten(box);
+		nodes[proxy].userData = userData;
+		nodes[proxy].height   = 0;
+		insertLeaf(proxy);
+		proxyCount++;
+		return proxy;
+	}
+
+	auto DynamicAABBTree::destroyProxy(int32_t proxy) -> void
+	{
+		MAPLE_ASSERT(proxy >= 0 && proxy < static_cast<int32_t>(nodes.size()) && nodes[proxy].isLeaf(), "DynamicAABBTree : invalid proxy");
+		removeLeaf(proxy);
+		freeNode(proxy);
+		proxyCount--;
+	}
+
+	auto DynamicAABBTree::moveProxy(int32_t proxy, const BoundingBox &box) -> bool
+	{
+		MAPLE_ASSERT(proxy >= 0 && proxy < static_cast<int32_t>(nodes.size()) && nodes[proxy].isLeaf(), "DynamicAABBTree : invalid proxy");
+		if (contains(nodes[proxy].box, box))
+			return false;
+
+		removeLeaf(proxy);
+		nodes[proxy].box = fatten(box);
+		insertLeaf(proxy);
+		return true;
+	}
+
+	auto DynamicAABBTree::clear() -> void
+	{
+		nodes.clear();
+		root       = NullNode;
+		freeList   = NullNode;
+		proxyCount = 0;
+	}
+
+	auto DynamicAABBTree::allocateNode() -> int32_t
+	{
+		if (freeList == NullNode)
+		{
+			nodes.emplace_back();
+			return static_cast<int32_t>(nodes.size()) - 1;
+		}
+		const auto node = freeList;
+		freeList        = nodes[node].parent;
+		nodes[node]     = Node{};
+		return node;
+	}
+
+	auto DynamicAABBTree::freeNode(int32_t node) -> void
+	{
+		nodes[node].parent = freeList;
+		nodes[node].height = -1;
+		freeList           = node;
+	}
+
+	auto DynamicAABBTree::insertLeaf(int32_t leaf) -> void
+	{
+		if (root == NullNode)
+		{
+			root               = leaf;
+			nodes[root].parent = NullNode;
+			return;
+		}
+
+		//find the best sibling by the surface area heuristic, descending while it is cheaper.
+		const auto leafBox = nodes[leaf].box;
+		auto       index   = root;
+		while (!nodes[index].isLeaf())
+		{
+			const auto left  = nodes[index].left;
+			const auto right = nodes[index].right;
+
+			const float area         = surfaceArea(nodes[index].box);
+			const float combinedArea = surfaceArea(combine(nodes[index].box, leafBox));
+
+			//cost of creating a new parent here and the inheritance cost pushed down to the children.
+			const float cost            = 2.f * combinedArea;
+			const float inheritanceCost = 2.f * (combinedArea - area);
+
+			auto childCost = [&](int32_t child) {
+				const float newArea = surfaceArea(combine(leafBox, nodes[child].box));
+				if (nodes[child].isLeaf())
+					return newArea + inheritanceCost;
+				return newArea - surfaceArea(nodes[child].box) + inheritanceCost;
+			};
+
+			const float costLeft  = childCost(left);
+			const float costRight = childCost(right);
+
+			if (cost < costLeft && cost < costRight)
+				break;
+
+			index = costLeft < costRight ? left : right;
+		}
+
+		const auto sibling   = index;
+		const auto oldParent = nodes[sibling].parent;
+		const auto newParent = allocateNode();
+
+		nodes[newParent].parent = oldParent;
+		nodes[newParent].box    = combine(leafBox, nodes[sibling].box);
+		nodes[newParent].height = nodes[sibling].height + 1;
+		nodes[newParent].left   = sibling;
+		nodes[newParent].right  = leaf;
+		nodes[sibling].parent   = newParent;
+		nodes[leaf].parent      = newParent;
+
+		if (oldParent != NullNode)
+		{
+			if (nodes[oldParent].left == sibling)
+				nodes[oldParent].left = newParent;
+			else
+				nodes[oldParent].right = newParent;
+		}
+		else
+		{
+			root = newParent;
+		}
+
+		//walk back up, refitting boxes and rebalancing.
+		index = nodes[leaf].parent;
+		while (index != NullNode)
+		{
+			index = balance(index);
+
+			const auto left     = nodes[index].left;
+			const auto right    = nodes[index].right;
+			nodes[index].height = 1 + std::max(nodes[left].height, nodes[right].height);
+			nodes[index].box    = combine(nodes[left].box, nodes[right].box);
+
+			index = nodes[index].parent;
+		}
+	}
+
+	auto DynamicAABBTree::removeLeaf(int32_t leaf) -> void
+	{
+		if (leaf == root)
+		{
+			root = NullNode;
+			return;
+		}
+
+		const auto parent      = nodes[leaf].parent;
+		const auto grandParent = nodes[parent].parent;
+		const auto sibling     = nodes[parent].left == leaf ? nodes[parent].right : nodes[parent].left;
+
+		if (grandParent != NullNode)
+		{
+			if (nodes[grandParent].left == parent)
+				nodes[grandParent].left = sibling;
+			else
+				nodes[grandParent].right = sibling;
+			nodes[sibling].parent = grandParent;
+			freeNode(parent);
+
+			auto index = grandParent;
+			while (index != NullNode)
+			{
+				index = balance(index);
+
+				const auto left     = nodes[index].left;
+				const auto right    = nodes[index].right;
+				nodes[index].box    = combine(nodes[left].box, nodes[right].box);
+				nodes[index].height = 1 + std::max(nodes[left].height, nodes[right].height);
+
+				index = nodes[index].parent;
+			}
+		}
+		else
+		{
+			root                  = sibling;
+			nodes[sibling].parent = NullNode;
+			freeNode(parent);
+		}
+	}
+
+	auto DynamicAABBTree::balance(int32_t a) -> int32_t
+	{
+		//rotates the higher grand child up when the children heights differ by more than one,
+		//returns the new root of the subtree.
+		if (nodes[a].isLeaf() || nodes[a].height < 2)
+			return a;
+
+		const auto b       = nodes[a].left;
+		const auto c       = nodes[a].right;
+		const auto diff = nodes[c].height - nodes[b].height;
+
+		auto rotate = [&](int32_t up, int32_t other, bool upIsRight) {
+			//'up' replaces 'a', 'a' takes the lower child of 'up'.
+			const auto f = nodes[up].left;
+			const auto g = nodes[up].right;
+
+			nodes[up].left   = a;
+			nodes[up].parent = nodes[a].parent;
+			nodes[a].parent  = up;
+
+			if (nodes[up].parent != NullNode)
+			{
+				if (nodes[nodes[up].parent].left == a)
+					nodes[nodes[up].parent].left = up;
+				else
+					nodes[nodes[up].parent].right = up;
+			}
+			else
+			{
+				root = up;
+			}
+
+			const auto higher = nodes[f].height > nodes[g].height ? f : g;
+			const auto lower  = higher == f ? g : f;
+
+			nodes[up].right     = higher;
+			nodes[lower].parent = a;
+			if (upIsRight)
+				nodes[a].right = lower;
+			else
+				nodes[a].left = lower;
+
+			nodes[a].box     = combine(nodes[other].box, nodes[lower].box);
+			nodes[up].box    = combine(nodes[a].box, nodes[higher].box);
+			nodes[a].height  = 1 + std::max(nodes[other].height, nodes[lower].height);
+			nodes[up].height = 1 + std::max(nodes[a].height, nodes[higher].height);
+			return up;
+		};
+
+		if (diff > 1)
+			return rotate(c, b, true);
+
+		if (diff < -1)
+			return rotate(b, c, false);
+
+		return a;
+	}
+};        // namespace maple
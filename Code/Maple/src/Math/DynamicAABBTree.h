@@ -0,0 +1,257 @@
+//////////////////////////////////////////////////////////////////////////////
+// This file is part of the Maple Engine                              		//
+//////////////////////////////////////////////////////////////////////////////
+#pragma once
+#include "BoundingBox.h"
+#include "Frustum.h"
+#include "Ray.h"
+#include "Engine/Core.h"
+#include "Others/Console.h"
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+namespace maple
+{
+	/**
+	 * bounding volume hierarchy over fat world space boxes, balanced with tree rotations on insertion.
+	 * a proxy is only reinserted when its box leaves the fat one, so small movements only cost a containment test.
+	 */
+	class MAPLE_EXPORT DynamicAABBTree
+	{
+	  public:
+		static constexpr int32_t NullNode = -1;
+
+		auto createProxy(const BoundingBox &box, uint32_t userData) -> int32_t;
+		auto destroyProxy(int32_t proxy) -> void;
+		//returns true if the proxy had to be reinserted.
+		auto moveProxy(int32_t proxy, const BoundingBox &box) -> bool;
+		auto clear() -> void;
+
+		inline auto getUserData(int32_t proxy) const
+		{
+			return nodes[proxy].userData;
+		}
+
+		inline auto &getFatBox(int32_t proxy) const
+		{
+			return nodes[proxy].box;
+		}
+
+		inline auto getProxyCount() const
+		{
+			return proxyCount;
+		}
+
+		inline auto getHeight() const
+		{
+			return root == NullNode ? 0 : nodes[root].height;
+		}
+
+		//func(userData) for every proxy inside or intersecting the frustum.
+		template <typename Func>
+		auto query(const Frustum &frustum, const Func &func) const -> void;
+
+		//func(userData) for every proxy overlapping the box.
+		template <typename Func>
+		auto query(const BoundingBox &box, const Func &func) const -> void;
+
+		//func(userData) returns the exact hit distance of a proxy (INFINITY for a miss),
+		//subtrees further away than the closest hit are skipped. returns the closest distance.
+		template <typename Func>
+		auto raycast(const Ray &ray, const Func &func, uint32_t &userData) const -> float;
+
+	  private:
+		static constexpr int32_t STACK_SIZE = 256;
+
+		//traversal stack, kept on the stack for balanced trees and spilled to the heap for degenerate ones.
+		template <typename T>
+		class Stack
+		{
+		  public:
+			inline auto push(const T &value) -> void
+			{
+				if (top < STACK_SIZE)
+					fixed[top] = value;
+				else
+					spilled.emplace_back(value);
+				top++;
+			}
+
+			inline auto pop() -> T
+			{
+				if (--top < STACK_SIZE)
+					return fixed[top];
+				const T value = spilled.back();
+				spilled.pop_back();
+				return value;
+			}
+
+			inline auto empty() const
+			{
+				return top == 0;
+			}
+
+		  private:
+			T              fixed[STACK_SIZE];
+			std::vector<T> spilled;
+			int32_t        top = 0;
+		};
+
+		enum class Containment
+		{
+			Outside,
+			Intersect,
+			Inside
+		};
+
+		struct Node
+		{
+			BoundingBox box;
+			//next free node while the node is in the free list.
+			int32_t  parent   = NullNode;
+			int32_t  left     = NullNode;
+			int32_t  right    = NullNode;
+			int32_t  height   = -1;
+			uint32_t userData = 0;
+
+			inline auto isLeaf() const
+			{
+				return left == NullNode;
+			}
+		};
+
+		static auto classify(const Frustum &frustum, const BoundingBox &box) -> Containment;
+		static auto overlap(const BoundingBox &a, const BoundingBox &b) -> bool;
+
+		auto allocateNode() -> int32_t;
+		auto freeNode(int32_t node) -> void;
+		auto insertLeaf(int32_t leaf) -> void;
+		auto removeLeaf(int32_t leaf) -> void;
+		auto balance(int32_t node) -> int32_t;
+
+		template <typename Func>
+		auto collect(int32_t node, const Func &func) const -> void;
+
+		std::vector<Node> nodes;
+		int32_t           root       = NullNode;
+		int32_t           freeList   = NullNode;
+		uint32_t          proxyCount = 0;
+	};
+
+	template <typename Func>
+	auto DynamicAABBTree::collect(int32_t node, const Func &func) const -> void
+	{
+		Stack<int32_t> stack;
+		stack.push(node);
+		while (!stack.empty())
+		{
+			auto &current = nodes[stack.pop()];
+			if (current.isLeaf())
+			{
+				func(current.userData);
+				continue;
+			}
+			stack.push(current.left);
+			stack.push(current.right);
+		}
+	}
+
+	template <typename Func>
+	auto DynamicAABBTree::query(const Frustum &frustum, const Func &func) const -> void
+	{
+		if (root == NullNode)
+			return;
+
+		Stack<int32_t> stack;
+		stack.push(root);
+		while (!stack.empty())
+		{
+			const auto  id      = stack.pop();
+			auto &      current = nodes[id];
+			const auto  result  = classify(frustum, current.box);
+			if (result == Containment::Outside)
+				continue;
+
+			//a subtree fully inside the frustum is taken without further tests.
+			if (result == Containment::Inside || current.isLeaf())
+			{
+				collect(id, func);
+				continue;
+			}
+			stack.push(current.left);
+			stack.push(current.right);
+		}
+	}
+
+	template <typename Func>
+	auto DynamicAABBTree::query(const BoundingBox &box, const Func &func) const -> void
+	{
+		if (root == NullNode)
+			return;
+
+		Stack<int32_t> stack;
+		stack.push(root);
+		while (!stack.empty())
+		{
+			auto &current = nodes[stack.pop()];
+			if (!overlap(current.box, box))
+				continue;
+
+			if (current.isLeaf())
+			{
+				func(current.userData);
+				continue;
+			}
+			stack.push(current.left);
+			stack.push(current.right);
+		}
+	}
+
+	template <typename Func>
+	auto DynamicAABBTree::raycast(const Ray &ray, const Func &func, uint32_t &userData) const -> float
+	{
+		float closest = INFINITY;
+		if (root == NullNode)
+			return closest;
+
+		struct Entry
+		{
+			int32_t node;
+			float   distance;
+		};
+
+		Stack<Entry> stack;
+		stack.push({root, ray.hit(nodes[root].box)});
+		while (!stack.empty())
+		{
+			const auto entry = stack.pop();
+			if (entry.distance >= closest)
+				continue;
+
+			auto &current = nodes[entry.node];
+			if (current.isLeaf())
+			{
+				const float dist = func(current.userData);
+				if (dist < closest)
+				{
+					closest  = dist;
+					userData = current.userData;
+				}
+				continue;
+			}
+
+			//push the far child first, so the near one is visited first and tightens the bound early.
+			Entry left{current.left, ray.hit(nodes[current.left].box)};
+			Entry right{current.right, ray.hit(nodes[current.right].box)};
+			if (left.distance < right.distance)
+				std::swap(left, right);
+
+			if (left.distance < closest)
+				stack.push(left);
+			if (right.distance < closest)
+				stack.push(right);
+		}
+		return closest;
+	}
+};        // namespace maple
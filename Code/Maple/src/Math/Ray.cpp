@@ -6,6 +6,8 @@
 #include "MathUtils.h"
 #include "BoundingBox.h"
 
+#include <algorithm>
+
 namespace maple 
 {
 	auto Ray::getClosestPoint(const Ray& ray) const ->glm::vec3
@@ -38,74 +40,31 @@ namespace maple
 		if (box.contains(origin))
 			return 0.0f;
 
-		float dist = INFINITY;
-
-		if (origin.x < box.min.x && direction.x > 0.0f)
-		{
-			float x = (box.min.x - origin.x) / direction.x;
-			if (x < dist)
-			{
-				auto point = origin + x * direction;
-				if (point.y >= box.min.y && point.y <= box.max.y && point.z >= box.min.z && point.z <= box.max.z)
-					dist = x;
-			}
-		}
-		if (origin.x > box.max.x && direction.x < 0.0f)
-		{
-			float x = (box.max.x - origin.x) / direction.x;
-			if (x < dist)
-			{
-				auto point = origin + x * direction;
-				if (point.y >= box.min.y && point.y <= box.max.y && point.z >= box.min.z && point.z <= box.max.z)
-					dist = x;
-			}
-		}
-
-		if (origin.y < box.min.y && direction.y > 0.0f)
-		{
-			float x = (box.min.y - origin.y) / direction.y;
-			if (x < dist)
-			{
-				auto point = origin + x * direction;
-				if (point.x >= box.min.x && point.x <= box.max.x && point.z >= box.min.z && point.z <= box.max.z)
-					dist = x;
-			}
-		}
-		if (origin.y > box.max.y && direction.y < 0.0f)
+		//slab test, one entry/exit interval per axis. this runs for every node visited by a tree raycast.
+		float enter = 0.0f;
+		float exit  = INFINITY;
+		for (int32_t i = 0; i < 3; i++)
 		{
-			float x = (box.max.y - origin.y) / direction.y;
-			if (x < dist)
+			if (std::abs(direction[i]) < MathUtils::EPS)
 			{
-				auto point = origin + x * direction;
-				if (point.x >= box.min.x && point.x <= box.max.x && point.z >= box.min.z && point.z <= box.max.z)
-					dist = x;
+				if (origin[i] < box.min[i] || origin[i] > box.max[i])
+					return INFINITY;
+				continue;
 			}
-		}
-
 
-		if (origin.z < box.min.z && direction.z > 0.0f)
-		{
-			float x = (box.min.z - origin.z) / direction.z;
-			if (x < dist)
-			{
-				auto point = origin + x * direction;
-				if (point.x >= box.min.x && point.x <= box.max.x && point.y >= box.min.y && point.y <= box.max.y)
-					dist = x;
-			}
-		}
+			const float inv = 1.0f / direction[i];
+			float       t0  = (box.min[i] - origin[i]) * inv;
+			float       t1  = (box.max[i] - origin[i]) * inv;
+			if (t0 > t1)
+				std::swap(t0, t1);
 
-		if (origin.z > box.max.z && direction.z < 0.0f)
-		{
-			float x = (box.max.z - origin.z) / direction.z;
-			if (x < dist)
-			{
-				auto point = origin + x * direction;
-				if (point.x >= box.min.x && point.x <= box.max.x && point.y >= box.min.y && point.y <= box.max.y)
-					dist = x;
-			}
+			enter = std::max(enter, t0);
+			exit  = std::min(exit, t1);
+			if (enter > exit)
+				return INFINITY;
 		}
 
-		return dist;
+		return enter;
 	}
 
 };
@@ -6,6 +6,7 @@
 
 #include <cstddef>
 #include <cstdint>
+#include <cstring>
 #include <tuple>
 #include <vector>
 
@@ -25,6 +26,26 @@ namespace maple
 			seed ^= hasher(v) + 0x9e3779b9 + (seed << 6) + (seed >> 2);
 			(hashCode(seed, rest), ...);
 		}
+
+		//fnv-1a over 8 byte words, used to notice that a source file changed.
+		inline auto hashBytes(const void *bytes, std::size_t size) -> uint64_t
+		{
+			constexpr uint64_t PRIME = 1099511628211ull;
+			auto               data  = static_cast<const uint8_t *>(bytes);
+			uint64_t           hash  = 14695981039346656037ull;
+			std::size_t        i     = 0;
+			for (; i + sizeof(uint64_t) <= size; i += sizeof(uint64_t))
+			{
+				uint64_t word;
+				memcpy(&word, data + i, sizeof(uint64_t));
+				hash = (hash ^ word) * PRIME;
+			}
+			for (; i < size; i++)
+			{
+				hash = (hash ^ data[i]) * PRIME;
+			}
+			return (hash ^ size) * PRIME;
+		}
 	};        // namespace HashCode
 };            // namespace maple
 
@@ -39,6 +39,24 @@ namespace maple
 		push(name, Format::R32_UINT, sizeof(uint32_t), location, normalized);
 	}
 
+	template <>
+	auto BufferLayout::push<glm::uvec2>(const std::string &name, uint32_t location, bool normalized) -> void
+	{
+		push(name, Format::R32G32_UINT, sizeof(glm::uvec2), location, normalized);
+	}
+
+	template <>
+	auto BufferLayout::push<glm::uvec3>(const std::string &name, uint32_t location, bool normalized) -> void
+	{
+		push(name, Format::R32G32B32_UINT, sizeof(glm::uvec3), location, normalized);
+	}
+
+	template <>
+	auto BufferLayout::push<glm::uvec4>(const std::string &name, uint32_t location, bool normalized) -> void
+	{
+		push(name, Format::R32G32B32A32_UINT, sizeof(glm::uvec4), location, normalized);
+	}
+
 	template <>
 	auto BufferLayout::push<uint8_t>(const std::string &name, uint32_t location, bool normalized) -> void
 	{
@@ -61,6 +61,12 @@ namespace maple
 	template <>
 	auto MAPLE_EXPORT BufferLayout::push<uint32_t>(const std::string &name, uint32_t level, bool normalized) -> void;
 	template <>
+	auto MAPLE_EXPORT BufferLayout::push<glm::uvec2>(const std::string &name, uint32_t level, bool normalized) -> void;
+	template <>
+	auto MAPLE_EXPORT BufferLayout::push<glm::uvec3>(const std::string &name, uint32_t level, bool normalized) -> void;
+	template <>
+	auto MAPLE_EXPORT BufferLayout::push<glm::uvec4>(const std::string &name, uint32_t level, bool normalized) -> void;
+	template <>
 	auto MAPLE_EXPORT BufferLayout::push<uint8_t>(const std::string &name, uint32_t level, bool normalized) -> void;
 	template <>
 	auto MAPLE_EXPORT BufferLayout::push<glm::vec2>(const std::string &name, uint32_t level, bool normalized) -> void;
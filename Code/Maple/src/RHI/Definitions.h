@@ -89,6 +89,7 @@ namespace maple
 		R32UI,
 		RG8,
 		RG16F,
+		RG16,        //unorm
 		RGB8,
 		RGBA8,
 		RGB16,
@@ -100,7 +101,9 @@ namespace maple
 		DEPTH,
 		STENCIL,
 		DEPTH_STENCIL,
-		SCREEN
+		SCREEN,
+		BC1,        //4x4 blocks of 8 bytes, opaque
+		BC3         //4x4 blocks of 16 bytes, interpolated alpha
 	};
 
 	enum class TextureType : int32_t
@@ -192,14 +195,15 @@ namespace maple
 		bool flipX;
 		bool flipY;
 		bool generateMipMaps;
+		bool compressed;        //load the block compressed copy cooked from the file, with its prebuilt mips
 
 		constexpr TextureLoadOptions() :
 		    TextureLoadOptions(false, true, false)
 		{
 		}
 
-		constexpr TextureLoadOptions(bool flipX, bool flipY, bool genMips = false) :
-		    flipX(flipX), flipY(flipY), generateMipMaps(genMips)
+		constexpr TextureLoadOptions(bool flipX, bool flipY, bool genMips = false, bool compressed = false) :
+		    flipX(flipX), flipY(flipY), generateMipMaps(genMips), compressed(compressed)
 		{
 		}
 	};
@@ -318,24 +322,47 @@ namespace maple
 		uint32_t groupCountZ = 1;
 	};
 
+	//cache key of a PipelineInfo made by Pipeline::getKey, kept next to the info so a pass does not hash every state again per draw.
+	struct PipelineKey
+	{
+		size_t   hash    = 0;
+		uint32_t version = UINT32_MAX;        //Texture::getTargetVersion the hash was made with
+	};
+
 	struct RenderCommand
 	{
 		Mesh*    mesh      = nullptr;
 		Material* material = nullptr;
 
-		std::shared_ptr<glm::mat4[]> boneTransforms;
+		const glm::mat4 *boneTransforms = nullptr;
 
 		PipelineInfo pipelineInfo;
 		PipelineInfo stencilPipelineInfo;
+		PipelineKey  pipelineKey;
 
 		glm::mat4 transform;
 
+		uint32_t lod = 0;        //index into Mesh::getLods, picked by the pass from the projected error
+
+		int32_t materialIndex = -1;        //slot in the MaterialTable when the material is drawn bindless
 	};
 
 	enum class MemoryBarrierFlags
 	{
 		None,
-		Shader_Image_Access_Barrier
+		Shader_Image_Access_Barrier,
+		//storage buffers written by a compute pass are read as draw arguments and by the vertex stage.
+		Indirect_Command_Barrier
+	};
+
+	//layout of one draw in the commands buffer of RenderDevice::drawIndexedIndirect, the same as VkDrawIndexedIndirectCommand.
+	struct DrawIndexedIndirectCommand
+	{
+		uint32_t indexCount;
+		uint32_t instanceCount;
+		uint32_t firstIndex;
+		int32_t  vertexOffset;
+		uint32_t firstInstance;
 	};
 }        // namespace maple
 
@@ -358,7 +385,7 @@ namespace std
 		size_t operator()(const maple::TextureLoadOptions &param) const
 		{
 			size_t seed = 0;
-			maple::HashCode::hashCode(seed, param.flipX, param.flipY, param.generateMipMaps);
+			maple::HashCode::hashCode(seed, param.flipX, param.flipY, param.generateMipMaps, param.compressed);
 			return seed;
 		}
 	};
@@ -4,6 +4,7 @@
 //////////////////////////////////////////////////////////////////////////////
 
 #include "DescriptorSet.h"
+#include "Others/Console.h"
 
 namespace maple
 {
@@ -18,4 +19,28 @@ namespace maple
 	{
 		updateValue = u;
 	}
+
+	auto DescriptorSet::getUniformHandle(const std::string &bufferName, const std::string &uniformName) const -> UniformHandle
+	{
+		//blocks are numbered in reflection order, the backends keep their buffers in the same order.
+		int32_t buffer = 0;
+		for (auto &descriptor : getDescriptors())
+		{
+			if (descriptor.type != DescriptorType::UniformBuffer)
+				continue;
+
+			if (descriptor.name == bufferName)
+			{
+				for (auto &member : descriptor.members)
+				{
+					if (member.name == uniformName)
+						return {buffer, member.offset, member.size};
+				}
+				break;
+			}
+			buffer++;
+		}
+		LOGW("Uniform not found {0}.{1}", bufferName, uniformName);
+		return {};
+	}
 }
@@ -13,6 +13,7 @@ namespace maple
 	class Shader;
 	class Texture;
 	class UniformBuffer;
+	class StorageBuffer;
 	enum class TextureType : int32_t;
 	enum class ShaderType : int32_t;
 	enum class TextureFormat : int32_t;
@@ -22,7 +23,8 @@ namespace maple
 		UniformBuffer,
 		UniformBufferDynamic,
 		ImageSampler,
-		Image
+		Image,
+		StorageBuffer
 	};
 
 	enum class Format
@@ -111,6 +113,7 @@ namespace maple
 	{
 		std::vector<std::shared_ptr<Texture>> textures;
 		std::shared_ptr<UniformBuffer>        buffer;
+		std::shared_ptr<StorageBuffer>        storageBuffer;
 
 		uint32_t    offset;
 		uint32_t    size;
@@ -127,6 +130,20 @@ namespace maple
 	};
 
 
+	//a member of a uniform block resolved once, writes through it skip the name lookups.
+	//valid for every set created with the same shader and layout index.
+	struct UniformHandle
+	{
+		int32_t  buffer = -1;        //index of the block among the uniform buffers of the set
+		uint32_t offset = 0;
+		uint32_t size   = 0;
+
+		inline auto isValid() const
+		{
+			return buffer >= 0;
+		}
+	};
+
 	class DescriptorSet
 	{
 	  public:
@@ -139,12 +156,18 @@ namespace maple
 		virtual auto setTexture(const std::string &name, const std::vector<std::shared_ptr<Texture>> &textures) -> void                                       = 0;
 		virtual auto setTexture(const std::string &name, const std::shared_ptr<Texture> &textures) -> void                                                    = 0;
 		virtual auto setBuffer(const std::string &name, const std::shared_ptr<UniformBuffer> &buffer) -> void                                                 = 0;
+		virtual auto setStorageBuffer(const std::string &name, const std::shared_ptr<StorageBuffer> &buffer) -> void                                          = 0;
 		virtual auto getUnifromBuffer(const std::string &name) -> std::shared_ptr<UniformBuffer>                                                              = 0;
 		virtual auto setUniform(const std::string &bufferName, const std::string &uniformName, const void *data, bool dynamic = false) -> void                = 0;
 		virtual auto setUniform(const std::string &bufferName, const std::string &uniformName, const void *data, uint32_t size, bool dynamic = false) -> void = 0;
 		virtual auto setUniformBufferData(const std::string &bufferName, const void *data) -> void                                                            = 0;
 		virtual auto getDescriptors() const -> const std::vector<Descriptor> & = 0;
 
+		virtual auto setUniform(const UniformHandle &handle, const void *data) -> void                = 0;
+		virtual auto setUniform(const UniformHandle &handle, const void *data, uint32_t size) -> void = 0;
+
+		auto getUniformHandle(const std::string &bufferName, const std::string &uniformName) const -> UniformHandle;
+
 		static auto canUpdate()->bool;
 		static auto toggleUpdate(bool update)-> void;
 	};
@@ -8,11 +8,13 @@
 #	include "RHI/Vulkan/VulkanCommandBuffer.h"
 #	include "RHI/Vulkan/VulkanContext.h"
 #	include "RHI/Vulkan/VulkanDescriptorSet.h"
+#	include "RHI/Vulkan/VulkanDevice.h"
 #	include "RHI/Vulkan/VulkanFrameBuffer.h"
 #	include "RHI/Vulkan/VulkanIndexBuffer.h"
 #	include "RHI/Vulkan/VulkanPipeline.h"
 #	include "RHI/Vulkan/VulkanRenderPass.h"
 #	include "RHI/Vulkan/VulkanShader.h"
+#	include "RHI/Vulkan/VulkanStorageBuffer.h"
 #	include "RHI/Vulkan/VulkanSwapChain.h"
 #	include "RHI/Vulkan/VulkanUniformBuffer.h"
 #	include "RHI/Vulkan/VulkanVertexBuffer.h"
@@ -28,13 +30,17 @@
 #	include "RHI/OpenGL/GLPipeline.h"
 #	include "RHI/OpenGL/GLRenderPass.h"
 #	include "RHI/OpenGL/GLShader.h"
+#	include "RHI/OpenGL/GLStorageBuffer.h"
 #	include "RHI/OpenGL/GLSwapChain.h"
 #	include "RHI/OpenGL/GLUniformBuffer.h"
 #	include "RHI/OpenGL/GLVertexBuffer.h"
 #endif
 
 #include "Engine/CaptureGraph.h"
+#include "Engine/Profiler.h"
 #include "Loaders/Loader.h"
+#include "RHI/Texture.h"
+#include "Thread/ParallelForEach.h"
 
 #include "Application.h"
 
@@ -98,6 +104,27 @@ namespace maple
 #endif
 	}
 
+	auto Shader::create(const std::vector<std::string> &filePaths) -> std::vector<std::shared_ptr<Shader>>
+	{
+		PROFILE_FUNCTION();
+		std::vector<std::shared_ptr<Shader>> shaders(filePaths.size());
+#ifdef MAPLE_VULKAN
+		//module and layout creation are free threaded, the factory constructs every path once.
+		parallelFor(0, static_cast<uint32_t>(filePaths.size()), 1, [&](uint32_t i) {
+			shaders[i] = create(filePaths[i]);
+		});
+#endif
+
+#ifdef MAPLE_OPENGL
+		//the gl context only belongs to the main thread.
+		for (size_t i = 0; i < filePaths.size(); i++)
+		{
+			shaders[i] = create(filePaths[i]);
+		}
+#endif
+		return shaders;
+	}
+
 	auto Shader::create(const std::vector<uint32_t> &vertData, const std::vector<uint32_t> &fragData) -> std::shared_ptr<Shader>
 	{
 #ifdef MAPLE_VULKAN
@@ -188,51 +215,44 @@ namespace maple
 #endif
 	}
 
-	auto Pipeline::get(const PipelineInfo &desc) -> std::shared_ptr<Pipeline>
+	auto Pipeline::getKey(const PipelineInfo &desc) -> PipelineKey
 	{
-		size_t hash = 0;
+		//states and the storage ids of the targets. a target getting new storage changes its id and the version, and its layout
+		//does not matter since the render pass is made after the targets are transitioned.
+		PipelineKey key;
+		key.version = Texture::getTargetVersion();
 
-		HashCode::hashCode(hash, desc.shader, desc.cullMode, desc.depthBiasEnabled, desc.drawType, desc.polygonMode, desc.transparencyEnabled);
-		HashCode::hashCode(hash, desc.stencilMask, desc.stencilFunc, desc.stencilFail, desc.stencilDepthFail, desc.stencilDepthPass, desc.depthTest);
+		auto targetId = [](const std::shared_ptr<Texture> &texture) -> uint32_t {
+			return texture ? texture->getTargetId() : 0;
+		};
 
-		for (auto texture : desc.colorTargets)
+		HashCode::hashCode(key.hash, desc.shader.get(), desc.cullMode, desc.depthBiasEnabled, desc.drawType, desc.polygonMode, desc.transparencyEnabled, desc.blendMode);
+		HashCode::hashCode(key.hash, desc.stencilTest, desc.stencilMask, desc.stencilFunc, desc.stencilFail, desc.stencilDepthFail, desc.stencilDepthPass, desc.depthTest);
+
+		for (auto &texture : desc.colorTargets)
 		{
-			if (texture)
-			{
-				HashCode::hashCode(hash, texture);
-				HashCode::hashCode(hash, texture->getWidth(), texture->getHeight());
-				HashCode::hashCode(hash, texture->getHandle());
-				HashCode::hashCode(hash, texture->getFormat());
-#ifdef MAPLE_VULKAN
-				VkDescriptorImageInfo *imageHandle = (VkDescriptorImageInfo *) (texture->getDescriptorInfo());
-				HashCode::hashCode(hash, imageHandle->imageLayout, imageHandle->imageView, imageHandle->sampler);
-#endif
-			}
+			HashCode::hashCode(key.hash, targetId(texture));
 		}
 
-		HashCode::hashCode(hash, desc.clearTargets);
-		HashCode::hashCode(hash, desc.depthTarget);
-		HashCode::hashCode(hash, desc.depthArrayTarget);
-		HashCode::hashCode(hash, desc.swapChainTarget);
-		HashCode::hashCode(hash, desc.groupCountX, desc.groupCountY, desc.groupCountZ);
+		//a swapchain pipeline holds a framebuffer per image, the current one is picked when it is bound.
+		HashCode::hashCode(key.hash, desc.clearTargets, targetId(desc.depthTarget), targetId(desc.depthArrayTarget), desc.swapChainTarget);
+		HashCode::hashCode(key.hash, desc.groupCountX, desc.groupCountY, desc.groupCountZ, key.version);
+		return key;
+	}
+
+	auto Pipeline::get(const PipelineInfo &desc) -> std::shared_ptr<Pipeline>
+	{
+		auto key = getKey(desc);
+		return get(desc, key);
+	}
+
+	auto Pipeline::get(const PipelineInfo &desc, PipelineKey &key) -> std::shared_ptr<Pipeline>
+	{
+		if (key.version != Texture::getTargetVersion())
+			key = getKey(desc);
 
-		if (desc.swapChainTarget)
-		{
-			auto texture = Application::getGraphicsContext()->getSwapChain()->getCurrentImage();
-			if (texture)
-			{
-				HashCode::hashCode(hash, texture);
-				HashCode::hashCode(hash, texture->getWidth(), texture->getHeight());
-				HashCode::hashCode(hash, texture->getHandle());
-				HashCode::hashCode(hash, texture->getFormat());
-#ifdef MAPLE_VULKAN
-				VkDescriptorImageInfo *imageHandle = (VkDescriptorImageInfo *) (texture->getDescriptorInfo());
-				HashCode::hashCode(hash, imageHandle->imageLayout, imageHandle->imageView, imageHandle->sampler);
-#endif
-			}
-		}
 		auto &pipelineCache = Application::getGraphicsContext()->getPipelineCache();
-		auto  found         = pipelineCache.find(hash);
+		auto  found         = pipelineCache.find(key.hash);
 
 		if (found != pipelineCache.end() && found->second.asset)
 		{
@@ -242,37 +262,71 @@ namespace maple
 
 #ifdef MAPLE_OPENGL
 		std::shared_ptr<Pipeline> pipeline = std::make_shared<GLPipeline>(desc);
-		return pipelineCache.emplace(std::piecewise_construct, std::forward_as_tuple(hash), std::forward_as_tuple(pipeline, Application::getTimer().currentTimestamp())).first->second.asset;
+		return pipelineCache.emplace(std::piecewise_construct, std::forward_as_tuple(key.hash), std::forward_as_tuple(pipeline, Application::getTimer().currentTimestamp())).first->second.asset;
 #endif        // MAPLE_OPENGL
 
 #ifdef MAPLE_VULKAN
 		std::shared_ptr<Pipeline> pipeline = std::make_shared<VulkanPipeline>(desc);
-		return pipelineCache.emplace(std::piecewise_construct, std::forward_as_tuple(hash), std::forward_as_tuple(pipeline, Application::getTimer().currentTimestamp())).first->second.asset;
+		return pipelineCache.emplace(std::piecewise_construct, std::forward_as_tuple(key.hash), std::forward_as_tuple(pipeline, Application::getTimer().currentTimestamp())).first->second.asset;
 #endif        // MAPLE_OPENGL
 	}
 
-
-	auto Pipeline::get(const PipelineInfo& desc, const std::vector<std::shared_ptr<DescriptorSet>>& sets, capture_graph::component::RenderGraph & graph) -> std::shared_ptr<Pipeline>
+	auto Pipeline::prewarm(const std::vector<PipelineInfo> &descs) -> void
 	{
-		auto pip = Pipeline::get(desc);
-		
-		for (auto set : sets)
+		PROFILE_FUNCTION();
+		auto &     pipelineCache = Application::getGraphicsContext()->getPipelineCache();
+		const auto timestamp     = Application::getTimer().currentTimestamp();
+
+		std::vector<std::pair<size_t, const PipelineInfo *>> missing;
+		for (auto &desc : descs)
 		{
-			for (auto input : set->getDescriptors())
-			{
-				capture_graph::input(desc.shader->getName(), graph, input.textures);
-			}
+			const auto key = getKey(desc);
+			if (pipelineCache.find(key.hash) != pipelineCache.end())
+				continue;
+			if (std::find_if(missing.begin(), missing.end(), [&](auto &pair) { return pair.first == key.hash; }) == missing.end())
+				missing.emplace_back(key.hash, &desc);
+		}
+
+		if (missing.empty())
+			return;
+
+#ifdef MAPLE_OPENGL
+		for (auto &[hash, desc] : missing)
+		{
+			std::shared_ptr<Pipeline> pipeline = std::make_shared<GLPipeline>(*desc);
+			pipelineCache.emplace(std::piecewise_construct, std::forward_as_tuple(hash), std::forward_as_tuple(pipeline, timestamp));
+		}
+#endif        // MAPLE_OPENGL
+
+#ifdef MAPLE_VULKAN
+		//preparing records the transitions and fills the framebuffer cache, so only the driver compilation is spread.
+		std::vector<std::shared_ptr<VulkanPipeline>> pipelines;
+		pipelines.reserve(missing.size());
+		for (auto &[hash, desc] : missing)
+		{
+			pipelines.emplace_back(std::make_shared<VulkanPipeline>(*desc, false));
 		}
 
-		capture_graph::input(desc.shader->getName(), graph, { desc.depthTarget });
-		capture_graph::output(desc.shader->getName(), graph, { desc.depthArrayTarget });
+		parallelFor(0, static_cast<uint32_t>(pipelines.size()), 1, [&](uint32_t i) {
+			pipelines[i]->compile();
+		});
 
-		for (auto color : desc.colorTargets)
-		{	
-			if(color!=nullptr)
-				capture_graph::output(desc.shader->getName(), graph, { color });
+		for (uint32_t i = 0; i < pipelines.size(); i++)
+		{
+			pipelineCache.emplace(std::piecewise_construct, std::forward_as_tuple(missing[i].first), std::forward_as_tuple(pipelines[i], timestamp));
 		}
-	
+
+		//pipelines dropped by clearUnused later on come back from the device cache.
+		VulkanDevice::get()->savePipelineCache();
+#endif        // MAPLE_VULKAN
+
+		LOGI("Pipeline : {0} pipelines prewarmed", missing.size());
+	}
+
+	auto Pipeline::get(const PipelineInfo& desc, const std::vector<std::shared_ptr<DescriptorSet>>& sets, capture_graph::component::RenderGraph & graph) -> std::shared_ptr<Pipeline>
+	{
+		auto pip = Pipeline::get(desc);
+		capture_graph::addPass(graph, desc, sets);
 		return pip;
 	}
 
@@ -308,6 +362,16 @@ namespace maple
 		return buffer;
 	}
 
+	auto StorageBuffer::create() -> std::shared_ptr<StorageBuffer>
+	{
+#ifdef MAPLE_VULKAN
+		return std::make_shared<VulkanStorageBuffer>();
+#endif
+#ifdef MAPLE_OPENGL
+		return std::make_shared<GLStorageBuffer>();
+#endif
+	}
+
 	auto VertexBuffer::create(const BufferUsage &usage) -> std::shared_ptr<VertexBuffer>
 	{
 #ifdef MAPLE_VULKAN
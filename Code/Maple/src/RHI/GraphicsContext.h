@@ -50,6 +50,10 @@ namespace maple
 		virtual auto init() -> void                                       = 0;
 		virtual auto present() -> void                                    = 0;
 		virtual auto getMinUniformBufferOffsetAlignment() const -> size_t = 0;
+		//size of the runtime sampler arrays shaders index by material, 0 without bindless support.
+		virtual auto getMaxBindlessTextures() const -> uint32_t           = 0;
+		//draws whose arguments and count are written by the gpu (drawIndexedIndirect).
+		virtual auto isIndirectCountSupported() const -> bool             = 0;
 		virtual auto waitIdle() const -> void                             = 0;
 		virtual auto onImGui() -> void                                    = 0;
 		virtual auto getGPUMemoryUsed() -> float                          = 0;
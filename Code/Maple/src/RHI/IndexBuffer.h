@@ -17,6 +17,8 @@ namespace maple
 		virtual auto unbind() const -> void                                     = 0;
 		virtual auto getCount() const -> uint32_t                               = 0;
 		virtual auto setCount(uint32_t indexCount) -> void                      = 0;
+		//writes size bytes at offset bytes, the buffer keeps its size.
+		virtual auto setDataSub(uint32_t size, const void *data, uint32_t offset) -> void = 0;
 
 		virtual auto releasePointer() -> void{};
 
@@ -30,5 +30,15 @@ namespace maple
 		{
 			return 256;
 		}
+
+		inline auto getMaxBindlessTextures() const -> uint32_t override
+		{
+			return 0;
+		}
+
+		inline auto isIndirectCountSupported() const -> bool override
+		{
+			return false;
+		}
 	};
 }        // namespace maple
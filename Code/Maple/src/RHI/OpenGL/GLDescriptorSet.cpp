@@ -6,6 +6,7 @@
 #include "Engine/Core.h"
 #include "Engine/Profiler.h"
 #include "GL.h"
+#include "GLStorageBuffer.h"
 #include "GLUniformBuffer.h"
 #include "RHI/OpenGL/GLShader.h"
 #include "RHI/Texture.h"
@@ -35,7 +36,8 @@ namespace maple
 				info.localStorage  = localStorage;
 				info.dirty         = false;
 				info.members       = descriptor.members;
-				uniformBuffers.emplace(descriptor.name, info);
+				auto iter          = uniformBuffers.emplace(descriptor.name, info).first;
+				uniformBufferSlots.emplace_back(&iter->second);
 			}
 		}
 	}
@@ -90,6 +92,21 @@ namespace maple
 		LOGW("Buffer not found {0}", name);
 	}
 
+	auto GLDescriptorSet::setStorageBuffer(const std::string &name, const std::shared_ptr<StorageBuffer> &buffer) -> void
+	{
+		PROFILE_FUNCTION();
+		for (auto &descriptor : descriptors)
+		{
+			if (descriptor.type == DescriptorType::StorageBuffer && descriptor.name == name)
+			{
+				descriptor.storageBuffer = buffer;
+				return;
+			}
+		}
+
+		LOGW("Storage buffer not found {0}", name);
+	}
+
 	auto GLDescriptorSet::setUniform(const std::string &bufferName, const std::string &uniformName, const void *data, bool dynamic) -> void
 	{
 		PROFILE_FUNCTION();
@@ -143,6 +160,21 @@ namespace maple
 		LOGW("Uniform not found {0}.", bufferName);
 	}
 
+	auto GLDescriptorSet::setUniform(const UniformHandle &handle, const void *data) -> void
+	{
+		setUniform(handle, data, handle.size);
+	}
+
+	auto GLDescriptorSet::setUniform(const UniformHandle &handle, const void *data, uint32_t size) -> void
+	{
+		if (!handle.isValid())
+			return;
+
+		auto &info = *uniformBufferSlots[handle.buffer];
+		info.localStorage.write(data, size, handle.offset);
+		info.dirty = true;
+	}
+
 	auto GLDescriptorSet::getUnifromBuffer(const std::string &name) -> std::shared_ptr<UniformBuffer>
 	{
 		PROFILE_FUNCTION();
@@ -202,6 +234,11 @@ namespace maple
 					shader->setUniform1iv(descriptor.name, samplers, descriptor.textures.size());
 				}
 			}
+			else if (descriptor.type == DescriptorType::StorageBuffer)
+			{
+				if (descriptor.storageBuffer)
+					std::static_pointer_cast<GLStorageBuffer>(descriptor.storageBuffer)->bind(descriptor.binding);
+			}
 			else
 			{
 				auto buffer = std::static_pointer_cast<GLUniformBuffer>(descriptor.buffer);
@@ -20,9 +20,12 @@ namespace maple
 		auto setTexture(const std::string &name, const std::vector<std::shared_ptr<Texture>> &textures) -> void override;
 		auto setTexture(const std::string &name, const std::shared_ptr<Texture> &textures) -> void override;
 		auto setBuffer(const std::string &name, const std::shared_ptr<UniformBuffer> &buffer) -> void override;
+		auto setStorageBuffer(const std::string &name, const std::shared_ptr<StorageBuffer> &buffer) -> void override;
 		auto setUniform(const std::string &bufferName, const std::string &uniformName, const void *data, bool dynamic) -> void override;
 		auto setUniform(const std::string &bufferName, const std::string &uniformName, const void *data, uint32_t size, bool dynamic) -> void override;
 		auto setUniformBufferData(const std::string &bufferName, const void *data) -> void override;
+		auto setUniform(const UniformHandle &handle, const void *data) -> void override;
+		auto setUniform(const UniformHandle &handle, const void *data, uint32_t size) -> void override;
 		auto getUnifromBuffer(const std::string &name) -> std::shared_ptr<UniformBuffer> override;
 		auto bind(uint32_t offset = 0) -> void;
 
@@ -50,5 +53,6 @@ namespace maple
 			bool                           dirty;
 		};
 		std::unordered_map<std::string, UniformBufferInfo> uniformBuffers;
+		std::vector<UniformBufferInfo *>                   uniformBufferSlots;        //indexed by UniformHandle::buffer
 	};
 }        // namespace maple
@@ -55,6 +55,13 @@ namespace maple
 		GLCall(glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0));
 	}
 
+	auto GLIndexBuffer::setDataSub(uint32_t size, const void *data, uint32_t offset) -> void
+	{
+		PROFILE_FUNCTION();
+		GLCall(glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, handle));
+		GLCall(glBufferSubData(GL_ELEMENT_ARRAY_BUFFER, offset, size, data));
+	}
+
 	auto GLIndexBuffer::getCount() const -> uint32_t
 	{
 		return count;
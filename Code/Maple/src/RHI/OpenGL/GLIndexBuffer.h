@@ -14,6 +14,7 @@ namespace maple
 		auto bind(CommandBuffer *commandBuffer) const -> void override;
 		auto unbind() const -> void override;
 		auto getCount() const -> uint32_t override;
+		auto setDataSub(uint32_t size, const void *data, uint32_t offset) -> void override;
 
 		auto getPointerInternal() -> void * override;
 		auto releasePointer() -> void override;
@@ -31,17 +31,18 @@ namespace maple
 				case Format::R8_UINT:
 					GLCall(glVertexAttribPointer(index, 1, GL_UNSIGNED_BYTE, false, stride, (const void *) (intptr_t) (offset)));
 					break;
+				//unsigned inputs are packed data unpacked by the shader (compact vertices), they must not be converted to float.
 				case Format::R32_UINT:
-					GLCall(glVertexAttribPointer(index, 1, GL_UNSIGNED_INT, false, stride, (const void *) (intptr_t) (offset)));
+					GLCall(glVertexAttribIPointer(index, 1, GL_UNSIGNED_INT, stride, (const void *) (intptr_t) (offset)));
 					break;
 				case Format::R32G32_UINT:
-					GLCall(glVertexAttribPointer(index, 2, GL_UNSIGNED_INT, false, stride, (const void *) (intptr_t) (offset)));
+					GLCall(glVertexAttribIPointer(index, 2, GL_UNSIGNED_INT, stride, (const void *) (intptr_t) (offset)));
 					break;
 				case Format::R32G32B32_UINT:
-					GLCall(glVertexAttribPointer(index, 3, GL_UNSIGNED_INT, false, stride, (const void *) (intptr_t) (offset)));
+					GLCall(glVertexAttribIPointer(index, 3, GL_UNSIGNED_INT, stride, (const void *) (intptr_t) (offset)));
 					break;
 				case Format::R32G32B32A32_UINT:
-					GLCall(glVertexAttribPointer(index, 4, GL_UNSIGNED_INT, false, stride, (const void *) (intptr_t) (offset)));
+					GLCall(glVertexAttribIPointer(index, 4, GL_UNSIGNED_INT, stride, (const void *) (intptr_t) (offset)));
 					break;
 				case Format::R32G32_INT:
 					GLCall(glVertexAttribPointer(index, 2, GL_INT, false, stride, (const void *) (intptr_t) (offset)));
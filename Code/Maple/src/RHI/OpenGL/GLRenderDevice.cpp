@@ -169,7 +169,15 @@ namespace maple
 	auto GLRenderDevice::memoryBarrier(CommandBuffer* commandBuffer,MemoryBarrierFlags flag) -> void
 	{
 		PROFILE_FUNCTION();
-		GLCall(glMemoryBarrier(GL_SHADER_IMAGE_ACCESS_BARRIER_BIT));
+		switch (flag)
+		{
+			case MemoryBarrierFlags::Indirect_Command_Barrier:
+				GLCall(glMemoryBarrier(GL_COMMAND_BARRIER_BIT | GL_SHADER_STORAGE_BARRIER_BIT));
+				break;
+			default:
+				GLCall(glMemoryBarrier(GL_SHADER_IMAGE_ACCESS_BARRIER_BIT));
+				break;
+		}
 	}
 
 	auto GLRenderDevice::presentInternal() -> void
@@ -321,11 +329,17 @@ namespace maple
 		GLCall(glDrawElements(drawTypeToGL(type), count, dataTypeToGL(dataType), indices));
 	}
 
-	auto GLRenderDevice::drawIndexedInternal(CommandBuffer *commandBuffer, const DrawType type, uint32_t count, uint32_t start) const -> void
+	auto GLRenderDevice::drawIndexedInternal(CommandBuffer *commandBuffer, const DrawType type, uint32_t count, uint32_t start, int32_t vertexOffset) const -> void
 	{
 		PROFILE_FUNCTION();
 		//NumDrawCalls++;
-		GLCall(	glDrawElements( drawTypeToGL(type), count, dataTypeToGL(DataType::UnsignedInt), (void*)(sizeof(uint32_t) * start) ) );
+		GLCall(	glDrawElementsBaseVertex( drawTypeToGL(type), count, dataTypeToGL(DataType::UnsignedInt), (void*)(sizeof(uint32_t) * start), vertexOffset ) );
+	}
+
+	auto GLRenderDevice::drawIndexedInstancedInternal(CommandBuffer *commandBuffer, const DrawType type, uint32_t count, uint32_t instanceCount, uint32_t start, int32_t vertexOffset) const -> void
+	{
+		PROFILE_FUNCTION();
+		GLCall(glDrawElementsInstancedBaseVertex(drawTypeToGL(type), count, dataTypeToGL(DataType::UnsignedInt), (void *) (sizeof(uint32_t) * start), instanceCount, vertexOffset));
 	}
 
 	auto GLRenderDevice::drawArraysInternal(CommandBuffer* commandBuffer, DrawType type, uint32_t count, uint32_t start /*= 0*/) const -> void
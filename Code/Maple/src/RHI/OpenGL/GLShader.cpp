@@ -53,6 +53,23 @@ namespace maple
 						break;
 					}
 					break;
+				case spirv_cross::SPIRType::UInt:
+					switch (type.vecsize)
+					{
+					case 1:
+						layout.push<uint32_t>(name, location);
+						break;
+					case 2:
+						layout.push<glm::uvec2>(name, location);
+						break;
+					case 3:
+						layout.push<glm::uvec3>(name, location);
+						break;
+					case 4:
+						layout.push<glm::uvec4>(name, location);
+						break;
+					}
+					break;
 				case spirv_cross::SPIRType::Double:
 					break;
 				default:
@@ -224,6 +241,11 @@ namespace maple
 	}
 
 	auto GLShader::bindPushConstants(CommandBuffer *cmdBuffer, Pipeline *pipeline) -> void
+	{
+		bindPushConstants(cmdBuffer, pipeline, pushConstants);
+	}
+
+	auto GLShader::bindPushConstants(CommandBuffer *cmdBuffer, Pipeline *pipeline, const std::vector<PushConstant> &pushConstants) -> void
 	{
 		PROFILE_FUNCTION();
 		int index = 0;
@@ -469,6 +491,22 @@ namespace maple
 			descriptor.type       = DescriptorType::ImageSampler;
 		}
 
+		for (auto &resource : resources.storage_buffers)
+		{
+			uint32_t set     = glsl->get_decoration(resource.id, spv::DecorationDescriptorSet);
+			uint32_t binding = glsl->get_decoration(resource.id, spv::DecorationBinding);
+
+			auto &descriptorInfo = descriptorInfos[set];
+			auto &descriptor     = descriptorInfo.emplace_back();
+
+			descriptor.offset     = 0;
+			descriptor.size       = 0;
+			descriptor.binding    = binding;
+			descriptor.name       = resource.name;
+			descriptor.shaderType = type;
+			descriptor.type       = DescriptorType::StorageBuffer;
+		}
+
 		for (auto const &uniformBuffer : resources.uniform_buffers)
 		{
 			auto set{glsl->get_decoration(uniformBuffer.id, spv::Decoration::DecorationDescriptorSet)};
@@ -0,0 +1,42 @@
+//////////////////////////////////////////////////////////////////////////////
+// This file is part of the Maple Engine                              		//
+//////////////////////////////////////////////////////////////////////////////
+#include "GLStorageBuffer.h"
+#include "Engine/Profiler.h"
+#include "GL.h"
+
+namespace maple
+{
+	GLStorageBuffer::GLStorageBuffer()
+	{
+		PROFILE_FUNCTION();
+		glGenBuffers(1, &handle);
+	}
+
+	GLStorageBuffer::~GLStorageBuffer()
+	{
+		PROFILE_FUNCTION();
+		GLCall(glDeleteBuffers(1, &handle));
+	}
+
+	auto GLStorageBuffer::setData(uint32_t size, const void *data) -> void
+	{
+		PROFILE_FUNCTION();
+		GLCall(glBindBuffer(GL_SHADER_STORAGE_BUFFER, handle));
+		if (size > this->size)
+		{
+			this->size = size;
+			GLCall(glBufferData(GL_SHADER_STORAGE_BUFFER, size, data, GL_DYNAMIC_DRAW));
+		}
+		else
+		{
+			GLCall(glBufferSubData(GL_SHADER_STORAGE_BUFFER, 0, size, data));
+		}
+	}
+
+	auto GLStorageBuffer::bind(uint32_t slot) -> void
+	{
+		PROFILE_FUNCTION();
+		GLCall(glBindBufferBase(GL_SHADER_STORAGE_BUFFER, slot, handle));
+	}
+}        // namespace maple
@@ -0,0 +1,32 @@
+//////////////////////////////////////////////////////////////////////////////
+// This file is part of the Maple Engine                              		//
+//////////////////////////////////////////////////////////////////////////////
+#pragma once
+#include "RHI/StorageBuffer.h"
+
+namespace maple
+{
+	class GLStorageBuffer : public StorageBuffer
+	{
+	  public:
+		GLStorageBuffer();
+		~GLStorageBuffer();
+
+		auto setData(uint32_t size, const void *data) -> void override;
+		auto bind(uint32_t slot) -> void;
+
+		inline auto getSize() const -> uint32_t override
+		{
+			return size;
+		}
+
+		inline auto getHandle() const
+		{
+			return handle;
+		}
+
+	  private:
+		uint32_t size   = 0;
+		uint32_t handle = 0;
+	};
+}        // namespace maple
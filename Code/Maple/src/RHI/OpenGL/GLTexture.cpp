@@ -7,6 +7,7 @@
 #include "Others/Console.h"
 
 #include "Loaders/ImageLoader.h"
+#include "Loaders/Loader.h"
 
 namespace maple
 {
@@ -48,6 +49,8 @@ namespace maple
 					return GL_RG8;
 				case TextureFormat::RG16F:
 					return GL_RG16F;
+				case TextureFormat::RG16:
+					return GL_RG16;
 				case TextureFormat::RGB8:
 					return srgb ? GL_SRGB8 : GL_RGB8;
 				case TextureFormat::RGBA8:
@@ -66,6 +69,10 @@ namespace maple
 					return GL_R32I;
 				case TextureFormat::R32UI:
 					return GL_R32UI;
+				case TextureFormat::BC1:
+					return srgb ? GL_COMPRESSED_SRGB_ALPHA_S3TC_DXT1_EXT : GL_COMPRESSED_RGBA_S3TC_DXT1_EXT;
+				case TextureFormat::BC3:
+					return srgb ? GL_COMPRESSED_SRGB_ALPHA_S3TC_DXT5_EXT : GL_COMPRESSED_RGBA_S3TC_DXT5_EXT;
 				default:
 					MAPLE_ASSERT(false, "[Texture] Unsupported TextureFormat");
 					return 0;
@@ -90,6 +97,7 @@ namespace maple
 			case TextureFormat::RGB8:
 				return sizeof(int8_t) * 3;
 			case TextureFormat::RG16F:
+			case TextureFormat::RG16:
 				return sizeof(int16_t) * 2;
 			case TextureFormat::RGB16:
 				return sizeof(int16_t) * 3;
@@ -145,6 +153,7 @@ namespace maple
 				case GL_RGB16:
 					return GL_RGB;
 				case GL_RG16F:
+				case GL_RG16:
 					return GL_RG;
 				case GL_RGBA16:
 					return GL_RGBA;
@@ -182,6 +191,16 @@ namespace maple
 	    parameters(parameters), loadOptions(loadOptions), width(width), height(height)
 	{
 		format = parameters.format;
+		if (AssetsLoaderFactory::isLoadingThread() && data != nullptr)
+		{
+			//gl calls belong to the main thread, keep a copy of the pixels until the upload step runs.
+			const auto                 bytes = static_cast<const uint8_t *>(data);
+			const std::vector<uint8_t> pixels(bytes, bytes + Texture::getStrideFromFormat(format) * width * height);
+			AssetsLoaderFactory::deferUpload(lifetime, [this, pixels]() {
+				load(pixels.data());
+			});
+			return;
+		}
 		load(data);
 	}
 
@@ -190,7 +209,9 @@ namespace maple
 	{
 		name = initName;
 
-		auto pixels = ImageLoader::loadAsset(fileName,loadOptions.generateMipMaps,loadOptions.flipY);
+		auto pixels = loadOptions.compressed && GLAD_GL_EXT_texture_compression_s3tc ?
+                          ImageLoader::loadCompressed(fileName, loadOptions.flipY) :
+                          ImageLoader::loadAsset(fileName, loadOptions.generateMipMaps, loadOptions.flipY);
 
 		format = pixels->getPixelFormat();
 		width  = pixels->getWidth();
@@ -198,7 +219,23 @@ namespace maple
 		isHDR  = pixels->isHDR();
 
 		this->parameters.format = format;
-		load(pixels->getData());
+		if (AssetsLoaderFactory::isLoadingThread())
+		{
+			//decoded on the loading thread, the texture is created by the upload step.
+			std::shared_ptr<Image> image = std::move(pixels);
+			AssetsLoaderFactory::deferUpload(lifetime, [this, image]() {
+				if (image->isCompressed())
+					loadLevels(image.get());
+				else
+					load(image->getData());
+			});
+			return;
+		}
+
+		if (pixels->isCompressed())
+			loadLevels(pixels.get());
+		else
+			load(pixels->getData());
 	}
 
 	GLTexture2D::~GLTexture2D()
@@ -228,6 +265,30 @@ namespace maple
 		GLCall(glGenerateMipmap(GL_TEXTURE_2D));
 	}
 
+	auto GLTexture2D::loadLevels(const Image *image) -> void
+	{
+		PROFILE_FUNCTION();
+		//the cooked chain is uploaded as it is, nothing is generated.
+		const auto levels = loadOptions.generateMipMaps ? static_cast<uint32_t>(image->getMips().size()) : 1;
+		const auto linear = parameters.minFilter == TextureFilter::Linear;
+
+		GLCall(glGenTextures(1, &handle));
+		GLCall(glBindTexture(GL_TEXTURE_2D, handle));
+		GLCall(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, levels > 1 ? (linear ? GL_LINEAR_MIPMAP_LINEAR : GL_NEAREST_MIPMAP_NEAREST) : (linear ? GL_LINEAR : GL_NEAREST)));
+		GLCall(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, parameters.magFilter == TextureFilter::Linear ? GL_LINEAR : GL_NEAREST));
+		GLCall(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, textureWrapToGL(parameters.wrap)));
+		GLCall(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, textureWrapToGL(parameters.wrapT)));
+		GLCall(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, levels - 1));
+
+		const auto glFormat = textureFormatToGL(parameters.format, parameters.srgb);
+		const auto data     = static_cast<const uint8_t *>(image->getData());
+		for (uint32_t level = 0; level < levels; level++)
+		{
+			const auto &mip = image->getMips()[level];
+			GLCall(glCompressedTexImage2D(GL_TEXTURE_2D, level, glFormat, std::max(1u, width >> level), std::max(1u, height >> level), 0, mip.size, data + mip.offset));
+		}
+	}
+
 	auto GLTexture2D::bind(uint32_t slot) const -> void
 	{
 		PROFILE_FUNCTION();
@@ -245,6 +306,10 @@ namespace maple
 	auto GLTexture2D::buildTexture(TextureFormat internalformat, uint32_t w, uint32_t h, bool srgb, bool depth, bool samplerShadow, bool mipmap, bool image, uint32_t accessFlag) -> void
 	{
 		PROFILE_FUNCTION();
+		//new storage for a texture which may be attached to the framebuffers of cached pipelines.
+		if (width != 0 || height != 0)
+			renewTarget();
+
 		format      = internalformat;
 		width       = w;
 		height      = h;
@@ -614,6 +679,7 @@ namespace maple
 		this->height = height;
 		this->format = stencil ? TextureFormat::DEPTH_STENCIL : TextureFormat::DEPTH;
 		init();
+		renewTarget();
 	}
 
 	auto GLTextureDepth::init() -> void
@@ -671,6 +737,7 @@ namespace maple
 		this->width  = width;
 		this->height = height;
 		this->count  = count;
+		renewTarget();
 
 		GLCall(glTexImage3D(GL_TEXTURE_2D_ARRAY, 0, GL_DEPTH_COMPONENT, width, height, count, 0, GL_DEPTH_COMPONENT, GL_UNSIGNED_BYTE, nullptr));
 		GLCall(glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_WRAP_S, GL_REPEAT));
@@ -685,6 +752,28 @@ namespace maple
 		GLCall(glBindTexture(GL_TEXTURE_2D_ARRAY, 0));
 	}
 
+	auto GLTextureDepthArray::copyLayer(const CommandBuffer *commandBuffer, TextureDepthArray *target, uint32_t layer) -> void
+	{
+		PROFILE_FUNCTION();
+		//no glCopyImageSubData on 4.1, blit between two framebuffers holding one layer each.
+		GLint  oldRead = 0, oldDraw = 0;
+		GLuint frameBuffers[2];
+		GLCall(glGetIntegerv(GL_READ_FRAMEBUFFER_BINDING, &oldRead));
+		GLCall(glGetIntegerv(GL_DRAW_FRAMEBUFFER_BINDING, &oldDraw));
+		GLCall(glGenFramebuffers(2, frameBuffers));
+
+		GLCall(glBindFramebuffer(GL_READ_FRAMEBUFFER, frameBuffers[0]));
+		GLCall(glFramebufferTextureLayer(GL_READ_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, handle, 0, layer));
+		GLCall(glBindFramebuffer(GL_DRAW_FRAMEBUFFER, frameBuffers[1]));
+		GLCall(glFramebufferTextureLayer(GL_DRAW_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, (GLuint) (size_t) target->getHandle(), 0, layer));
+
+		GLCall(glBlitFramebuffer(0, 0, width, height, 0, 0, target->getWidth(), target->getHeight(), GL_DEPTH_BUFFER_BIT, GL_NEAREST));
+
+		GLCall(glBindFramebuffer(GL_READ_FRAMEBUFFER, oldRead));
+		GLCall(glBindFramebuffer(GL_DRAW_FRAMEBUFFER, oldDraw));
+		GLCall(glDeleteFramebuffers(2, frameBuffers));
+	}
+
 	auto GLTextureDepthArray::init() -> void
 	{
 		GLCall(glGenTextures(1, &handle));
@@ -4,6 +4,8 @@
 
 namespace maple
 {
+	class Image;
+
 	class GLTexture2D : public Texture2D
 	{
 	  public:
@@ -57,6 +59,7 @@ namespace maple
 
 	  private:
 		auto               load(const void *data) -> void;
+		auto               loadLevels(const Image *image) -> void;
 		bool               isHDR  = false;
 		uint32_t           handle = 0;
 		uint32_t           width  = 0;
@@ -305,6 +308,8 @@ namespace maple
 			return count;
 		}
 
+		auto copyLayer(const CommandBuffer *commandBuffer, TextureDepthArray *target, uint32_t layer) -> void override;
+
 	  private:
 		uint32_t      handle = 0;
 		uint32_t      width  = 0;
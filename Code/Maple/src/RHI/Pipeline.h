@@ -26,6 +26,15 @@ namespace maple
 		//static auto create(const PipelineInfo &pipelineDesc) -> std::shared_ptr<Pipeline>;
 		  static auto get(const PipelineInfo& pipelineDesc)->std::shared_ptr<Pipeline>;
 		  static auto get(const PipelineInfo& pipelineDesc, const std::vector<std::shared_ptr<DescriptorSet>> & sets, capture_graph::component::RenderGraph& )->std::shared_ptr<Pipeline>;
+		  //the key is made again if a target got new storage since it was computed.
+		  static auto get(const PipelineInfo& pipelineDesc, PipelineKey& key)->std::shared_ptr<Pipeline>;
+		  static auto getKey(const PipelineInfo& pipelineDesc)->PipelineKey;
+
+		  /**
+		   * creates the pipelines of the list missing from the cache, the compilation runs in parallel where the backend allows it.
+		   * the targets are transitioned on the frame command buffer, it has to be recording and outside of a render pass.
+		   */
+		  static auto prewarm(const std::vector<PipelineInfo>& pipelineDescs)->void;
 
 		virtual ~Pipeline() = default;
 
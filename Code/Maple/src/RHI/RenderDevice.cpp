@@ -12,6 +12,7 @@
 #endif
 
 #include "RHI/FrameBuffer.h"
+#include "RHI/Pipeline.h"
 #include "RHI/RenderPass.h"
 
 namespace maple
@@ -41,9 +42,14 @@ namespace maple
 		Application::getRenderDevice()->drawInternal(commandBuffer, type, count, datayType, indices);
 	}
 
-	auto RenderDevice::drawIndexed(CommandBuffer *commandBuffer, DrawType type, uint32_t count, uint32_t start) -> void
+	auto RenderDevice::drawIndexed(CommandBuffer *commandBuffer, DrawType type, uint32_t count, uint32_t start, int32_t vertexOffset) -> void
 	{
-		Application::getRenderDevice()->drawIndexedInternal(commandBuffer, type, count, start);
+		Application::getRenderDevice()->drawIndexedInternal(commandBuffer, type, count, start, vertexOffset);
+	}
+
+	auto RenderDevice::drawIndexedInstanced(CommandBuffer *commandBuffer, DrawType type, uint32_t count, uint32_t instanceCount, uint32_t start, int32_t vertexOffset) -> void
+	{
+		Application::getRenderDevice()->drawIndexedInstancedInternal(commandBuffer, type, count, instanceCount, start, vertexOffset);
 	}
 
 	auto RenderDevice::drawArrays(CommandBuffer* commandBuffer, DrawType type, uint32_t count, uint32_t start /*= 0*/) -> void
@@ -51,6 +57,23 @@ namespace maple
 		Application::getRenderDevice()->drawArraysInternal(commandBuffer, type, count, start);
 	}
 
+	auto RenderDevice::drawIndexedIndirect(CommandBuffer *commandBuffer, StorageBuffer *commands, uint32_t offset, StorageBuffer *count, uint32_t countOffset, uint32_t maxDraws) -> void
+	{
+		Application::getRenderDevice()->drawIndexedIndirectInternal(commandBuffer, commands, offset, count, countOffset, maxDraws);
+	}
+
+	auto RenderDevice::drawParallel(CommandBuffer *commandBuffer, Pipeline *pipeline, uint32_t layer, uint32_t count, uint32_t grainSize, const std::function<void(CommandBuffer *, uint32_t, uint32_t)> &record) -> void
+	{
+		Application::getRenderDevice()->drawParallelInternal(commandBuffer, pipeline, layer, count, grainSize, record);
+	}
+
+	auto RenderDevice::drawParallelInternal(CommandBuffer *commandBuffer, Pipeline *pipeline, uint32_t layer, uint32_t count, uint32_t grainSize, const std::function<void(CommandBuffer *, uint32_t, uint32_t)> &record) -> void
+	{
+		pipeline->bind(commandBuffer, layer);
+		record(commandBuffer, 0, count);
+		pipeline->end(commandBuffer);
+	}
+
 	auto RenderDevice::setStencilOp(StencilType fail, StencilType zfail, StencilType zpass) -> void
 	{
 		Application::getRenderDevice()->setStencilOpInternal(fail, zfail, zpass);
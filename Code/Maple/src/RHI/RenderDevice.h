@@ -5,6 +5,7 @@
 
 #include "Engine/Core.h"
 #include "RHI/Definitions.h"
+#include <functional>
 #include <glm/glm.hpp>
 #include <memory>
 
@@ -13,6 +14,7 @@ namespace maple
 	class Texture;
 	class CommandBuffer;
 	class Pipeline;
+	class StorageBuffer;
 
 	class MAPLE_EXPORT RenderDevice
 	{
@@ -37,9 +39,13 @@ namespace maple
 		virtual auto memoryBarrier(CommandBuffer* commandBuffer, MemoryBarrierFlags flag) -> void {};
 
 		virtual auto drawArraysInternal(CommandBuffer* commandBuffer, DrawType type, uint32_t count, uint32_t start = 0) const -> void {};
-		virtual auto drawIndexedInternal(CommandBuffer *commandBuffer, DrawType type, uint32_t count, uint32_t start = 0) const -> void{};
+		virtual auto drawIndexedInternal(CommandBuffer *commandBuffer, DrawType type, uint32_t count, uint32_t start = 0, int32_t vertexOffset = 0) const -> void{};
+		virtual auto drawIndexedInstancedInternal(CommandBuffer *commandBuffer, DrawType type, uint32_t count, uint32_t instanceCount, uint32_t start = 0, int32_t vertexOffset = 0) const -> void{};
 		virtual auto drawInternal(CommandBuffer *commandBuffer, DrawType type, uint32_t count, DataType dataType = DataType::UnsignedInt, const void *indices = nullptr) const -> void{};
+		virtual auto drawIndexedIndirectInternal(CommandBuffer *commandBuffer, StorageBuffer *commands, uint32_t offset, StorageBuffer *count, uint32_t countOffset, uint32_t maxDraws) const -> void{};
 		virtual auto bindDescriptorSetsInternal(Pipeline *pipeline, CommandBuffer *commandBuffer, uint32_t dynamicOffset, const std::vector<std::shared_ptr<DescriptorSet>> &descriptorSets) -> void{};
+		//serial emulation, the whole range is recorded inline on the primary buffer.
+		virtual auto drawParallelInternal(CommandBuffer *commandBuffer, Pipeline *pipeline, uint32_t layer, uint32_t count, uint32_t grainSize, const std::function<void(CommandBuffer *, uint32_t, uint32_t)> &record) -> void;
 		virtual auto clearRenderTarget(const std::shared_ptr<Texture> &texture, CommandBuffer *commandBuffer, const glm::vec4 &clearColor = {0.3f, 0.3f, 0.3f, 1.0f}) -> void{};
 		virtual auto clearInternal(uint32_t bufferMask) -> void{};
 
@@ -48,8 +54,23 @@ namespace maple
 		static auto present(CommandBuffer *commandBuffer) -> void;
 		static auto bindDescriptorSets(Pipeline *pipeline, CommandBuffer *commandBuffer, uint32_t dynamicOffset, const std::vector<std::shared_ptr<DescriptorSet>> &descriptorSets) -> void;
 		static auto draw(CommandBuffer *commandBuffer, DrawType type, uint32_t count, DataType datayType = DataType::UnsignedInt, const void *indices = nullptr) -> void;
-		static auto drawIndexed(CommandBuffer* commandBuffer, DrawType type, uint32_t count, uint32_t start = 0) -> void;
+		//vertexOffset is added to every index, meshes in the GeometryPool keep indices local to their own vertices.
+		static auto drawIndexed(CommandBuffer* commandBuffer, DrawType type, uint32_t count, uint32_t start = 0, int32_t vertexOffset = 0) -> void;
+		static auto drawIndexedInstanced(CommandBuffer* commandBuffer, DrawType type, uint32_t count, uint32_t instanceCount, uint32_t start = 0, int32_t vertexOffset = 0) -> void;
 		static auto drawArrays(CommandBuffer* commandBuffer, DrawType type, uint32_t count, uint32_t start = 0) -> void;
+		/**
+		 * indexed draws whose arguments are read from commands at offset (DrawIndexedIndirectCommand each) and whose number
+		 * is the uint32_t at countOffset in count, at most maxDraws. both are usually written by a compute pass, only
+		 * available when GraphicsContext::isIndirectCountSupported.
+		 */
+		static auto drawIndexedIndirect(CommandBuffer *commandBuffer, StorageBuffer *commands, uint32_t offset, StorageBuffer *count, uint32_t countOffset, uint32_t maxDraws) -> void;
+		/**
+		 * records the draws [0, count) of one pass of the pipeline. chunks of grainSize draws are recorded on worker threads
+		 * into secondary buffers where the backend has them, record(commandBuffer, begin, end) has to record a chunk into
+		 * the buffer it is given and may not change state the other chunks use. the chunks run in order inside the pass.
+		 * no pipeline may be bound through CommandBuffer::bindPipeline at the time.
+		 */
+		static auto drawParallel(CommandBuffer *commandBuffer, Pipeline *pipeline, uint32_t layer, uint32_t count, uint32_t grainSize, const std::function<void(CommandBuffer *, uint32_t, uint32_t)> &record) -> void;
 		static auto setStencilOp(StencilType fail, StencilType zfail, StencilType zpass) -> void;
 		static auto setStencilFunction(StencilType type, uint32_t ref, uint32_t mask) -> void;
 		static auto setStencilMask(uint32_t mask) -> void;
@@ -101,6 +101,8 @@ namespace maple
 		virtual auto getHandle() const -> void *                                                 = 0;
 		virtual auto getPushConstants() -> std::vector<PushConstant> &                           = 0;
 		virtual auto bindPushConstants(CommandBuffer *commandBuffer, Pipeline *pipeline) -> void = 0;
+		//binds copies of the push constants instead of the ones the shader holds, for recording on several threads.
+		virtual auto bindPushConstants(CommandBuffer *commandBuffer, Pipeline *pipeline, const std::vector<PushConstant> &pushConstants) -> void = 0;
 		virtual auto getPushConstant(uint32_t index) -> PushConstant *
 		{
 			return nullptr;
@@ -145,6 +147,8 @@ namespace maple
 
 	  public:
 		static auto create(const std::string &filepath) -> std::shared_ptr<Shader>;
+		//creates the shaders at once, on worker threads where the api allows it. results are in the order of the paths.
+		static auto create(const std::vector<std::string> &filePaths) -> std::vector<std::shared_ptr<Shader>>;
 		static auto create(const std::vector<uint32_t> &vertData, const std::vector<uint32_t> &fragData) -> std::shared_ptr<Shader>;
 
 	  protected:
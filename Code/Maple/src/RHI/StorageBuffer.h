@@ -0,0 +1,24 @@
+//////////////////////////////////////////////////////////////////////////////
+// This file is part of the Maple Engine                              		//
+//////////////////////////////////////////////////////////////////////////////
+#pragma once
+#include <cstdint>
+#include <memory>
+
+namespace maple
+{
+	/**
+	 * buffer read by shaders through a storage block (layout(std430) buffer), bound with DescriptorSet::setStorageBuffer.
+	 * the data set during a frame is what the draws of that frame see, frames in flight keep their own copy.
+	 */
+	class StorageBuffer
+	{
+	  public:
+		virtual ~StorageBuffer() = default;
+		static auto create() -> std::shared_ptr<StorageBuffer>;
+
+		//the buffer grows to the size of the data, it never shrinks.
+		virtual auto setData(uint32_t size, const void *data) -> void = 0;
+		virtual auto getSize() const -> uint32_t                      = 0;
+	};
+}        // namespace maple
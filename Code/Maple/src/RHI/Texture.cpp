@@ -13,10 +13,20 @@
 #endif        // MAPLE_OPENGL
 
 #include "Loaders/Loader.h"
+#include "Loaders/MeshCache.h"
 #include "Application.h"
 
+#include <atomic>
+
 namespace maple
 {
+	namespace
+	{
+		//read by the passes preparing their commands in parallel.
+		std::atomic<uint32_t> targetVersion = 0;
+		std::atomic<uint32_t> targetIds     = 0;
+	}        // namespace
+
 	auto Texture::getStrideFromFormat(TextureFormat format) -> uint8_t
 	{
 		switch (format)
@@ -34,6 +44,7 @@ namespace maple
 			case TextureFormat::RGBA8:
 				return 4;
 			case TextureFormat::RG16F:
+			case TextureFormat::RG16:
 				return 4;
 			default:
 				return 0;
@@ -70,6 +81,28 @@ namespace maple
 		return levels;
 	}
 
+	auto Texture::getTargetVersion() -> uint32_t
+	{
+		return targetVersion.load(std::memory_order_relaxed);
+	}
+
+	auto Texture::invalidateTargets() -> void
+	{
+		targetVersion.fetch_add(1, std::memory_order_relaxed);
+	}
+
+	auto Texture::renewTarget() -> void
+	{
+		targetId = nextTargetId();
+		invalidateTargets();
+	}
+
+	auto Texture::nextTargetId() -> uint32_t
+	{
+		//0 stands for no target in the pipeline keys.
+		return targetIds.fetch_add(1, std::memory_order_relaxed) + 1;
+	}
+
 	//###################################################
 
 	auto Texture2D::create() -> std::shared_ptr<Texture2D>
@@ -84,22 +117,28 @@ namespace maple
 
 	auto Texture2D::create(uint32_t width, uint32_t height, void *data, TextureParameters parameters, TextureLoadOptions loadOptions) -> std::shared_ptr<Texture2D>
 	{
+		std::shared_ptr<Texture2D> texture;
 #ifdef MAPLE_OPENGL
-		return std::make_shared<GLTexture2D>(width, height, data, parameters, loadOptions);
+		texture = std::make_shared<GLTexture2D>(width, height, data, parameters, loadOptions);
 #endif        // MAPLE_OPENGL
 #ifdef MAPLE_VULKAN
-		return std::make_shared<VulkanTexture2D>(width, height, data, parameters, loadOptions);
+		texture = std::make_shared<VulkanTexture2D>(width, height, data, parameters, loadOptions);
 #endif        // MAPLE_OPENGL
+		MeshCache::record(texture.get(), width, height, data, parameters, loadOptions);
+		return texture;
 	}
 
 	auto Texture2D::create(const std::string &name, const std::string &filePath, TextureParameters parameters, TextureLoadOptions loadOptions) -> std::shared_ptr<Texture2D>
 	{
+		std::shared_ptr<Texture2D> texture;
 #ifdef MAPLE_OPENGL
-		return Application::getAssetsLoaderFactory()->emplace<GLTexture2D>(filePath, name, filePath, parameters, loadOptions);
+		texture = Application::getAssetsLoaderFactory()->emplace<GLTexture2D>(filePath, name, filePath, parameters, loadOptions);
 #endif        // MAPLE_OPENGL
 #ifdef MAPLE_VULKAN
-		return Application::getAssetsLoaderFactory()->emplace<VulkanTexture2D>(filePath, name, filePath, parameters, loadOptions);
+		texture = Application::getAssetsLoaderFactory()->emplace<VulkanTexture2D>(filePath, name, filePath, parameters, loadOptions);
 #endif        // MAPLE_VULKAN
+		MeshCache::record(texture.get(), name, filePath, parameters, loadOptions);
+		return texture;
 	}
 
 	auto Texture2D::getDefaultTexture() -> std::shared_ptr<Texture2D>
@@ -79,9 +79,30 @@ namespace maple
 		static auto bitsToTextureFormat(uint32_t bits) -> TextureFormat;
 		static auto calculateMipMapCount(uint32_t width, uint32_t height) -> uint32_t;
 
+		//changes whenever a texture which may be rendered to gets new storage (rebuilt, resized, aliased, new swapchain).
+		//pipeline keys hold the target ids and are valid for the version they were made with.
+		static auto getTargetVersion() -> uint32_t;
+		static auto invalidateTargets() -> void;
+
+		//unique for every texture and every storage it gets, unlike the pointer which may be reused by a later texture.
+		inline auto getTargetId() const
+		{
+			return targetId;
+		}
+
 	  protected:
+		//the texture got new storage, the pipelines made for the old one are not picked again.
+		auto renewTarget() -> void;
+
 		uint16_t    flags = 0;
 		std::string name;
+		//uploads deferred by the constructor only hold it weakly, they are dropped together with the texture.
+		std::shared_ptr<void> lifetime = std::make_shared<bool>();
+
+	  private:
+		static auto nextTargetId() -> uint32_t;
+
+		uint32_t targetId = nextTargetId();
 	};
 
 	class MAPLE_EXPORT Texture2D : public Texture
@@ -98,6 +119,18 @@ namespace maple
 
 		virtual auto buildTexture(TextureFormat internalformat, uint32_t width, uint32_t height, bool srgb = false, bool depth = false, bool samplerShadow = false, bool mipmap = false, bool image = false, uint32_t accessFlag = 0) -> void = 0;
 
+		//places the texture in the memory of owner, both built with buildTexture. the two must never be in use at the same time.
+		//false if the backend can not share the memory, the texture keeps its own then.
+		virtual auto aliasMemory(const std::shared_ptr<Texture2D> &owner) -> bool
+		{
+			return false;
+		}
+
+		//the content is not needed by the next use, the memory may have been written through an alias in between.
+		virtual auto discardContent() -> void
+		{
+		}
+
 		inline auto getType() const -> TextureType override
 		{
 			return TextureType::Color;
@@ -178,6 +211,8 @@ namespace maple
 		{
 			return getHandle();
 		};
+		//copies one layer into the same layer of an array with the same size.
+		virtual auto copyLayer(const CommandBuffer *commandBuffer, TextureDepthArray *target, uint32_t layer) -> void = 0;
 		inline auto getType() const -> TextureType override
 		{
 			return TextureType::DepthArray;
@@ -7,6 +7,7 @@
 #include "VulkanDevice.h"
 #include "VulkanHelper.h"
 #include "VulkanSwapChain.h"
+#include "VulkanUploader.h"
 
 namespace maple
 {
@@ -34,12 +35,12 @@ namespace maple
 		VkBufferCreateInfo bufferInfo = {};
 		bufferInfo.sType              = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO;
 		bufferInfo.size               = size;
-		bufferInfo.usage              = usage;
+		bufferInfo.usage              = deviceLocal ? usage | VK_BUFFER_USAGE_TRANSFER_DST_BIT : usage;
 		bufferInfo.sharingMode        = VK_SHARING_MODE_EXCLUSIVE;
 
 #ifdef USE_VMA_ALLOCATOR
 		VmaAllocationCreateInfo vmaAllocInfo = {};
-		vmaAllocInfo.usage                   = VMA_MEMORY_USAGE_CPU_TO_GPU;
+		vmaAllocInfo.usage                   = deviceLocal ? VMA_MEMORY_USAGE_GPU_ONLY : VMA_MEMORY_USAGE_CPU_TO_GPU;
 		vmaCreateBuffer(VulkanDevice::get()->getAllocator(), &bufferInfo, &vmaAllocInfo, &buffer, &allocation, nullptr);
 #else
 		VK_CHECK_RESULT(vkCreateBuffer(*VulkanDevice::get(), &bufferInfo, nullptr, &buffer));
@@ -52,7 +53,7 @@ namespace maple
 		allocInfo.allocationSize       = memRequirements.size;
 		allocInfo.memoryTypeIndex      = VulkanHelper::findMemoryType(
             memRequirements.memoryTypeBits,
-            VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT);
+            deviceLocal ? VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT : VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT);
 
 		VK_CHECK_RESULT(vkAllocateMemory(*VulkanDevice::get(), &allocInfo, nullptr, &memory));
 		//bind buffer ->
@@ -60,7 +61,12 @@ namespace maple
 		//if the data is not nullptr, upload the data.
 #endif
 		if (data != nullptr)
-			setVkData(size, data);
+		{
+			if (deviceLocal)
+				VulkanDevice::get()->getUploader()->uploadBuffer(buffer, data, size, 0, true);
+			else
+				setVkData(size, data);
+		}
 	}
 
 	/**
@@ -69,6 +75,7 @@ namespace maple
 	auto VulkanBuffer::map(VkDeviceSize size, VkDeviceSize offset) -> void
 	{
 		PROFILE_FUNCTION();
+		MAPLE_ASSERT(!deviceLocal, "device local buffers can not be mapped");
 #ifdef USE_VMA_ALLOCATOR
 		VK_CHECK_RESULT(vmaMapMemory(VulkanDevice::get()->getAllocator(), allocation, &mapped));
 #else
@@ -125,7 +132,13 @@ namespace maple
 	auto VulkanBuffer::setVkData(uint32_t size, const void *data, uint32_t offset) -> void
 	{
 		PROFILE_FUNCTION();
-		map(size, offset);
+		if (deviceLocal)
+		{
+			VulkanDevice::get()->getUploader()->uploadBuffer(buffer, data, size, offset, false);
+			return;
+		}
+		//mapped points at the start of the buffer, the offset is applied once.
+		map();
 		memcpy(reinterpret_cast<uint8_t *>(mapped) + offset, data, size);
 		unmap();
 	}
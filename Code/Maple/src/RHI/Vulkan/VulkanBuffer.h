@@ -27,6 +27,15 @@ namespace maple
 		{
 			usage = flags;
 		}
+		//device local buffers can not be mapped, their data goes through the VulkanUploader.
+		inline auto setDeviceLocal(bool local)
+		{
+			deviceLocal = local;
+		}
+		inline auto isDeviceLocal() const
+		{
+			return deviceLocal;
+		}
 		inline auto &getVkBuffer()
 		{
 			return buffer;
@@ -39,6 +48,10 @@ namespace maple
 		{
 			return desciptorBufferInfo;
 		}
+		inline auto getMapped() const
+		{
+			return mapped;
+		}
 
 	  protected:
 		auto release() -> void;
@@ -50,6 +63,7 @@ namespace maple
 		VkDeviceSize           alignment = 0;
 		void *                 mapped    = nullptr;
 		VkBufferUsageFlags     usage;
+		bool                   deviceLocal = false;
 
 #ifdef USE_VMA_ALLOCATOR
 		VmaAllocation allocation{};
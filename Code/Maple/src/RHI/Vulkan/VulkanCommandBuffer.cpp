@@ -134,7 +134,9 @@ namespace maple
 
 		boundPipeline = nullptr;
 #ifdef MAPLE_PROFILE
-		TracyVkCollect(VulkanDevice::get()->getTracyContext(), commandBuffer);
+		//secondary buffers end inside a render pass, where the queries can not be read back.
+		if (primary)
+			TracyVkCollect(VulkanDevice::get()->getTracyContext(), commandBuffer);
 #endif        // MAPLE_PROFILE
 
 
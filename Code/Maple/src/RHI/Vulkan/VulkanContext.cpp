@@ -193,6 +193,8 @@ namespace maple
 
 	VulkanContext::~VulkanContext()
 	{
+		VulkanDevice::get()->releaseUploader();
+
 		for (int32_t i = 0; i < 3; i++)
 		{
 			getDeletionQueue(i).flush();
@@ -248,7 +250,17 @@ namespace maple
 
 	auto VulkanContext::getMinUniformBufferOffsetAlignment() const -> size_t
 	{
-		return 0;
+		return VulkanDevice::get()->getPhysicalDevice()->getProperties().limits.minUniformBufferOffsetAlignment;
+	}
+
+	auto VulkanContext::getMaxBindlessTextures() const -> uint32_t
+	{
+		return VulkanDevice::get()->getBindlessTextureCount();
+	}
+
+	auto VulkanContext::isIndirectCountSupported() const -> bool
+	{
+		return VulkanDevice::get()->isIndirectCountSupported();
 	}
 
 	auto VulkanContext::onImGui() -> void
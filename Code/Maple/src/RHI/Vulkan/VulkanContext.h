@@ -22,6 +22,8 @@ namespace maple
 		auto init() -> void override;
 		auto present() -> void override;
 		auto getMinUniformBufferOffsetAlignment() const -> size_t override;
+		auto getMaxBindlessTextures() const -> uint32_t override;
+		auto isIndirectCountSupported() const -> bool override;
 		auto waitIdle() const -> void override;
 		auto onImGui() -> void override;
 
@@ -10,11 +10,14 @@
 #include "VulkanPipeline.h"
 #include "VulkanRenderDevice.h"
 #include "VulkanShader.h"
+#include "VulkanStorageBuffer.h"
 #include "VulkanTexture.h"
 #include "VulkanUniformBuffer.h"
 
 #include "Application.h"
 
+#include <algorithm>
+
 namespace maple
 {
 	namespace
@@ -57,48 +60,48 @@ namespace maple
 
 		VkDescriptorSetAllocateInfo descriptorSetAllocateInfo;
 		descriptorSetAllocateInfo.sType              = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO;
-		descriptorSetAllocateInfo.descriptorPool     = std::static_pointer_cast<VulkanRenderDevice>(Application::getRenderDevice())->getDescriptorPool();
 		descriptorSetAllocateInfo.pSetLayouts        = static_cast<VulkanShader *>(info.shader)->getDescriptorLayout(info.layoutIndex);
 		descriptorSetAllocateInfo.descriptorSetCount = info.count;
 		descriptorSetAllocateInfo.pNext              = nullptr;
 
 		shader      = info.shader;
+		setLayout   = *descriptorSetAllocateInfo.pSetLayouts;
 		descriptors = shader->getDescriptorInfo(info.layoutIndex);
-		uniformBuffers.resize(framesInFlight);
 		for (auto &descriptor : descriptors)
 		{
 			if (descriptor.type == DescriptorType::UniformBuffer)
 			{
-				for (uint32_t frame = 0; frame < framesInFlight; frame++)
-				{
-					auto buffer = UniformBuffer::create();
-					buffer->init(descriptor.size, nullptr);
-					uniformBuffers[frame][descriptor.name] = buffer;
-				}
-
+				//the blocks have no buffers of their own, they are copied into the uniform ring when bound.
 				Buffer localStorage;
 				localStorage.allocate(descriptor.size);
 				localStorage.initializeEmpty();
 
 				UniformBufferInfo info;
-				info.localStorage  = localStorage;
-				info.hasUpdated[0] = false;
-				info.hasUpdated[1] = false;
-				info.hasUpdated[2] = false;
+				info.localStorage = localStorage;
+				info.binding      = descriptor.binding;
+				info.ringVersion.resize(framesInFlight, 0);
 
 				info.members                        = descriptor.members;
 				uniformBuffersData[descriptor.name] = info;
+				uniformBufferSlots.emplace_back(&uniformBuffersData[descriptor.name]);
 			}
 		}
 
+		bindingOrder = uniformBufferSlots;
+		std::sort(bindingOrder.begin(), bindingOrder.end(), [](const UniformBufferInfo *a, const UniformBufferInfo *b) {
+			return a->binding < b->binding;
+		});
+		dynamicOffsets.resize(bindingOrder.size(), 0);
+
 		descriptorSet.resize(framesInFlight, nullptr);
+		descriptorDirty.resize(framesInFlight, true);
+		boundFrame.resize(framesInFlight, UINT64_MAX);
+		retiredSets.resize(framesInFlight);
+		auto renderDevice = std::static_pointer_cast<VulkanRenderDevice>(Application::getRenderDevice());
 		for (uint32_t frame = 0; frame < framesInFlight; frame++)
 		{
-			descriptorDirty[frame] = true;
-			VK_CHECK_RESULT(vkAllocateDescriptorSets(*VulkanDevice::get(), &descriptorSetAllocateInfo, &descriptorSet[frame]));
+			renderDevice->allocateDescriptorSets(descriptorSetAllocateInfo, &descriptorSet[frame]);
 		}
-
-		memset(imageInfoPool.data(), 0, sizeof(VkDescriptorImageInfo) * MAX_IMAGE_INFOS);
 	}
 
 	VulkanDescriptorSet::~VulkanDescriptorSet()
@@ -109,104 +112,225 @@ namespace maple
 	auto VulkanDescriptorSet::update() -> void
 	{
 		PROFILE_FUNCTION();
+		//the set of the frame may be replaced by a recording thread binding it.
+		std::lock_guard<std::mutex> lock(uniformMutex);
 
-		dynamic = false;
+		uint32_t currentFrame = Application::getGraphicsContext()->getSwapChain()->getCurrentBufferIndex();
+		size_t   imageCount   = 0;
+		bool     dirty        = descriptorDirty[currentFrame];
+		descriptorDirty[currentFrame] = false;
 
-		int32_t  descriptorWritesCount = 0;
-		uint32_t currentFrame          = Application::getGraphicsContext()->getSwapChain()->getCurrentBufferIndex();
-
-		for (auto &bufferInfo : uniformBuffersData)
+		//storage buffers copy their data into the buffer of this frame, which may have been created again.
+		for (auto &descriptor : descriptors)
 		{
-			if (bufferInfo.second.hasUpdated[currentFrame])
-			{
-				if (bufferInfo.second.dynamic)
-					uniformBuffers[currentFrame][bufferInfo.first]->setDynamicData(bufferInfo.second.localStorage.size, 0, bufferInfo.second.localStorage.data);
-				else
-					uniformBuffers[currentFrame][bufferInfo.first]->setData(bufferInfo.second.localStorage.data);
-
-				bufferInfo.second.hasUpdated[currentFrame] = false;
-			}
+			if (descriptor.type == DescriptorType::StorageBuffer && descriptor.storageBuffer)
+				dirty |= static_cast<VulkanStorageBuffer *>(descriptor.storageBuffer.get())->prepare(currentFrame);
+			else if (descriptor.type == DescriptorType::ImageSampler)
+				imageCount += descriptor.textures.size();
 		}
 
-		if (descriptorDirty[currentFrame])
-		{
-			descriptorDirty[currentFrame] = false;
-			int32_t imageIndex            = 0;
-			int32_t index                 = 0;
+		if (!dirty)
+			return;
+
+		//reserved up front, the writes keep pointers into both arrays.
+		imageInfos.clear();
+		bufferInfos.clear();
+		descriptorWrites.clear();
+		imageInfos.reserve(imageCount);
+		bufferInfos.reserve(descriptors.size());
 
-			for (auto &imageInfo : descriptors)
+		for (auto &descriptor : descriptors)
+		{
+			if (descriptor.type == DescriptorType::ImageSampler)
 			{
-				if (imageInfo.type == DescriptorType::ImageSampler)
+				//slots without a texture stay unwritten, arrays are partially bound. every run of set slots is one write.
+				for (uint32_t i = 0; i < descriptor.textures.size();)
 				{
-					if (!imageInfo.textures.empty())
+					if (!descriptor.textures[i])
 					{
-						auto validCount = 0;
-						for (uint32_t i = 0; i < imageInfo.textures.size(); i++)
-						{
-							if (imageInfo.textures[i])
-							{
-								transitionImageLayout(imageInfo.textures[i].get());
-
-								const auto &des               = *static_cast<VkDescriptorImageInfo *>(imageInfo.textures[i]->getDescriptorInfo());
-								imageInfoPool[i + imageIndex] = des;
-								validCount++;
-							}
-						}
-
-						if (validCount > 0)
-						{
-							VkWriteDescriptorSet writeDescriptorSet{};
-							writeDescriptorSet.sType           = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
-							writeDescriptorSet.dstSet          = descriptorSet[currentFrame];
-							writeDescriptorSet.descriptorType  = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
-							writeDescriptorSet.dstBinding      = imageInfo.binding;
-							writeDescriptorSet.pImageInfo      = &imageInfoPool[imageIndex];
-							writeDescriptorSet.descriptorCount = validCount;
-
-							MAPLE_ASSERT(writeDescriptorSet.descriptorCount != 0, "writeDescriptorSet.descriptorCount should be greater than zero");
-
-							writeDescriptorSetPool[descriptorWritesCount] = writeDescriptorSet;
-							imageIndex++;
-							descriptorWritesCount++;
-						}
+						i++;
+						continue;
 					}
-				}
-				else if (imageInfo.type == DescriptorType::UniformBuffer)
-				{
-					auto buffer = std::static_pointer_cast<VulkanUniformBuffer>(uniformBuffers[currentFrame][imageInfo.name]);
 
-					bufferInfoPool[index].buffer = buffer->getVkBuffer();
-					bufferInfoPool[index].offset = imageInfo.offset;
-					bufferInfoPool[index].range  = imageInfo.size;
+					const auto first = i;
+					const auto start = imageInfos.size();
+					for (; i < descriptor.textures.size() && descriptor.textures[i]; i++)
+					{
+						transitionImageLayout(descriptor.textures[i].get());
+						imageInfos.emplace_back(*static_cast<VkDescriptorImageInfo *>(descriptor.textures[i]->getDescriptorInfo()));
+					}
 
 					VkWriteDescriptorSet writeDescriptorSet{};
 					writeDescriptorSet.sType           = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
 					writeDescriptorSet.dstSet          = descriptorSet[currentFrame];
-					writeDescriptorSet.descriptorType  = VkConverter::descriptorTypeToVK(imageInfo.type);
-					writeDescriptorSet.dstBinding      = imageInfo.binding;
-					writeDescriptorSet.pBufferInfo     = &bufferInfoPool[index];
-					writeDescriptorSet.descriptorCount = 1;
-
-					writeDescriptorSetPool[descriptorWritesCount] = writeDescriptorSet;
-					index++;
-					descriptorWritesCount++;
-
-					if (imageInfo.type == DescriptorType::UniformBufferDynamic)
-						dynamic = true;
+					writeDescriptorSet.descriptorType  = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
+					writeDescriptorSet.dstBinding      = descriptor.binding;
+					writeDescriptorSet.dstArrayElement = first;
+					writeDescriptorSet.pImageInfo      = &imageInfos[start];
+					writeDescriptorSet.descriptorCount = i - first;
+					descriptorWrites.emplace_back(writeDescriptorSet);
 				}
 			}
-
-			if (descriptorWritesCount > 0)
-				vkUpdateDescriptorSets(*VulkanDevice::get(), descriptorWritesCount, writeDescriptorSetPool.data(), 0, nullptr);
+			else if (descriptor.type == DescriptorType::StorageBuffer && descriptor.storageBuffer)
+			{
+				//nothing uploaded yet, written once the buffer holds data.
+				const auto info = static_cast<VulkanStorageBuffer *>(descriptor.storageBuffer.get())->getBufferInfo(currentFrame);
+				if (info.buffer == VK_NULL_HANDLE)
+					continue;
+				bufferInfos.emplace_back(info);
+
+				VkWriteDescriptorSet writeDescriptorSet{};
+				writeDescriptorSet.sType           = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+				writeDescriptorSet.dstSet          = descriptorSet[currentFrame];
+				writeDescriptorSet.descriptorType  = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+				writeDescriptorSet.dstBinding      = descriptor.binding;
+				writeDescriptorSet.pBufferInfo     = &bufferInfos.back();
+				writeDescriptorSet.descriptorCount = 1;
+				descriptorWrites.emplace_back(writeDescriptorSet);
+			}
 		}
+
+		if (!descriptorWrites.empty())
+			vkUpdateDescriptorSets(*VulkanDevice::get(), static_cast<uint32_t>(descriptorWrites.size()), descriptorWrites.data(), 0, nullptr);
 	}
 
 	auto VulkanDescriptorSet::getDescriptorSet() -> VkDescriptorSet
 	{
-		auto index = Application::getGraphicsContext()->getSwapChain()->getCurrentBufferIndex();
+		auto                        index = Application::getGraphicsContext()->getSwapChain()->getCurrentBufferIndex();
+		std::lock_guard<std::mutex> lock(uniformMutex);
 		return descriptorSet[index];
 	}
 
+	auto VulkanDescriptorSet::prepareUniforms(uint32_t *offsets, VkDescriptorSet &set) -> uint32_t
+	{
+		PROFILE_FUNCTION();
+		std::lock_guard<std::mutex> lock(uniformMutex);
+		auto &     ring         = std::static_pointer_cast<VulkanRenderDevice>(Application::getRenderDevice())->getUniformRing();
+		const auto currentFrame = ring.getCurrentFrame();
+		const auto frameCounter = ring.getFrameCounter();
+		const bool bound        = boundFrame[currentFrame] == frameCounter;
+		int32_t    writes       = 0;
+
+		//first bind of the frame, its fence has signalled so the sets replaced last time it was recorded are unused.
+		if (!bound && !retiredSets[currentFrame].empty())
+		{
+			std::static_pointer_cast<VulkanRenderDevice>(Application::getRenderDevice())->freeDescriptorSets(static_cast<uint32_t>(retiredSets[currentFrame].size()), retiredSets[currentFrame].data());
+			retiredSets[currentFrame].clear();
+		}
+
+		for (size_t i = 0; i < bindingOrder.size(); i++)
+		{
+			auto &info = *bindingOrder[i];
+			//unchanged blocks are still copied once per frame, the ring does not keep data across frames.
+			if (!info.dirty && info.uploadedFrame == frameCounter)
+				continue;
+
+			const auto allocation = ring.allocate(info.localStorage.data, info.localStorage.size);
+			dynamicOffsets[i]     = allocation.offset;
+			info.dirty            = false;
+			info.uploadedFrame    = frameCounter;
+
+			//the descriptor only changes when the ring moved to another page.
+			if (info.ringVersion[currentFrame] != allocation.version)
+			{
+				info.ringVersion[currentFrame] = allocation.version;
+
+				bufferInfoPool[writes].buffer = allocation.buffer;
+				bufferInfoPool[writes].offset = 0;
+				bufferInfoPool[writes].range  = info.localStorage.size;
+
+				VkWriteDescriptorSet writeDescriptorSet{};
+				writeDescriptorSet.sType           = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+				writeDescriptorSet.descriptorType  = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC;
+				writeDescriptorSet.dstBinding      = info.binding;
+				writeDescriptorSet.pBufferInfo     = &bufferInfoPool[writes];
+				writeDescriptorSet.descriptorCount = 1;
+
+				writeDescriptorSetPool[writes] = writeDescriptorSet;
+				writes++;
+			}
+		}
+
+		if (writes > 0)
+		{
+			//the ring grew in the middle of the frame, command buffers already recorded still use the old set.
+			if (bound)
+				renew(currentFrame);
+
+			for (int32_t i = 0; i < writes; i++)
+				writeDescriptorSetPool[i].dstSet = descriptorSet[currentFrame];
+			vkUpdateDescriptorSets(*VulkanDevice::get(), writes, writeDescriptorSetPool.data(), 0, nullptr);
+		}
+
+		boundFrame[currentFrame] = frameCounter;
+		set                      = descriptorSet[currentFrame];
+		std::copy(dynamicOffsets.begin(), dynamicOffsets.end(), offsets);
+		return static_cast<uint32_t>(dynamicOffsets.size());
+	}
+
+	auto VulkanDescriptorSet::renew(uint32_t frame) -> void
+	{
+		PROFILE_FUNCTION();
+		VkDescriptorSetAllocateInfo descriptorSetAllocateInfo{};
+		descriptorSetAllocateInfo.sType              = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO;
+		descriptorSetAllocateInfo.pSetLayouts        = &setLayout;
+		descriptorSetAllocateInfo.descriptorSetCount = 1;
+
+		VkDescriptorSet fresh = VK_NULL_HANDLE;
+		std::static_pointer_cast<VulkanRenderDevice>(Application::getRenderDevice())->allocateDescriptorSets(descriptorSetAllocateInfo, &fresh);
+
+		//copies what the old set holds, only written slots are copied since arrays are partially bound.
+		descriptorCopies.clear();
+		auto copy = [&](uint32_t binding, uint32_t element, uint32_t count) {
+			VkCopyDescriptorSet copyDescriptorSet{};
+			copyDescriptorSet.sType           = VK_STRUCTURE_TYPE_COPY_DESCRIPTOR_SET;
+			copyDescriptorSet.srcSet          = descriptorSet[frame];
+			copyDescriptorSet.srcBinding      = binding;
+			copyDescriptorSet.srcArrayElement = element;
+			copyDescriptorSet.dstSet          = fresh;
+			copyDescriptorSet.dstBinding      = binding;
+			copyDescriptorSet.dstArrayElement = element;
+			copyDescriptorSet.descriptorCount = count;
+			descriptorCopies.emplace_back(copyDescriptorSet);
+		};
+
+		for (auto &descriptor : descriptors)
+		{
+			if (descriptor.type == DescriptorType::ImageSampler && !descriptorDirty[frame])
+			{
+				for (uint32_t i = 0; i < descriptor.textures.size();)
+				{
+					if (!descriptor.textures[i])
+					{
+						i++;
+						continue;
+					}
+					const auto first = i;
+					for (; i < descriptor.textures.size() && descriptor.textures[i]; i++)
+						;
+					copy(descriptor.binding, first, i - first);
+				}
+			}
+			else if (descriptor.type == DescriptorType::StorageBuffer && descriptor.storageBuffer && !descriptorDirty[frame])
+			{
+				if (static_cast<VulkanStorageBuffer *>(descriptor.storageBuffer.get())->getBufferInfo(frame).buffer != VK_NULL_HANDLE)
+					copy(descriptor.binding, 0, 1);
+			}
+		}
+
+		for (auto info : bindingOrder)
+		{
+			if (info->ringVersion[frame] != 0)
+				copy(info->binding, 0, 1);
+		}
+
+		if (!descriptorCopies.empty())
+			vkUpdateDescriptorSets(*VulkanDevice::get(), 0, nullptr, static_cast<uint32_t>(descriptorCopies.size()), descriptorCopies.data());
+
+		retiredSets[frame].emplace_back(descriptorSet[frame]);
+		descriptorSet[frame] = fresh;
+	}
+
 	auto VulkanDescriptorSet::setTexture(const std::string &name, const std::vector<std::shared_ptr<Texture>> &textures) -> void
 	{
 		for (auto &descriptor : descriptors)
@@ -214,9 +338,7 @@ namespace maple
 			if (descriptor.type == DescriptorType::ImageSampler && descriptor.name == name)
 			{
 				descriptor.textures = textures;
-				descriptorDirty[0]  = true;
-				descriptorDirty[1]  = true;
-				descriptorDirty[2]  = true;
+				std::fill(descriptorDirty.begin(), descriptorDirty.end(), true);
 			}
 		}
 	}
@@ -231,6 +353,20 @@ namespace maple
 	{
 	}
 
+	auto VulkanDescriptorSet::setStorageBuffer(const std::string &name, const std::shared_ptr<StorageBuffer> &buffer) -> void
+	{
+		for (auto &descriptor : descriptors)
+		{
+			if (descriptor.type == DescriptorType::StorageBuffer && descriptor.name == name)
+			{
+				descriptor.storageBuffer = buffer;
+				std::fill(descriptorDirty.begin(), descriptorDirty.end(), true);
+				return;
+			}
+		}
+		LOGW("Storage buffer not found {0}", name);
+	}
+
 	auto VulkanDescriptorSet::getUnifromBuffer(const std::string &name) -> std::shared_ptr<UniformBuffer>
 	{
 		return nullptr;
@@ -246,10 +382,7 @@ namespace maple
 				if (member.name == uniformName)
 				{
 					iter->second.localStorage.write(data, member.size, member.offset);
-					iter->second.hasUpdated[0] = true;
-					iter->second.hasUpdated[1] = true;
-					iter->second.hasUpdated[2] = true;
-					iter->second.dynamic       = dynamic;
+					iter->second.dirty = true;
 					return;
 				}
 			}
@@ -267,10 +400,7 @@ namespace maple
 				if (member.name == uniformName)
 				{
 					iter->second.localStorage.write(data, size, member.offset);
-					iter->second.hasUpdated[0] = true;
-					iter->second.hasUpdated[1] = true;
-					iter->second.hasUpdated[2] = true;
-					iter->second.dynamic       = dynamic;
+					iter->second.dirty = true;
 					return;
 				}
 			}
@@ -284,12 +414,24 @@ namespace maple
 		if (auto iter = uniformBuffersData.find(bufferName); iter != uniformBuffersData.end())
 		{
 			iter->second.localStorage.write(data, iter->second.localStorage.getSize(), 0);
-			iter->second.hasUpdated[0] = true;
-			iter->second.hasUpdated[1] = true;
-			iter->second.hasUpdated[2] = true;
+			iter->second.dirty = true;
 			return;
 		}
 		LOGW("Uniform not found {0}.{1}", bufferName);
 	}
 
+	auto VulkanDescriptorSet::setUniform(const UniformHandle &handle, const void *data) -> void
+	{
+		setUniform(handle, data, handle.size);
+	}
+
+	auto VulkanDescriptorSet::setUniform(const UniformHandle &handle, const void *data, uint32_t size) -> void
+	{
+		if (!handle.isValid())
+			return;
+
+		auto &info = *uniformBufferSlots[handle.buffer];
+		info.localStorage.write(data, size, handle.offset);
+		info.dirty = true;
+	}
 };        // namespace maple
@@ -7,10 +7,11 @@
 #include "RHI/DescriptorSet.h"
 #include "VulkanHelper.h"
 
+#include <mutex>
+
 namespace maple
 {
 	constexpr int32_t MAX_BUFFER_INFOS      = 32;
-	constexpr int32_t MAX_IMAGE_INFOS       = 32;
 	constexpr int32_t MAX_WRITE_DESCTIPTORS = 32;
 
 	class VulkanDescriptorSet final : public DescriptorSet
@@ -30,33 +31,43 @@ namespace maple
 			return dynamicOffset;
 		}
 
-		inline auto isDynamic() const
-		{
-			return dynamic;
-		}
-
 		auto getDescriptorSet() -> VkDescriptorSet;
+		//uploads the uniform blocks into the ring of the current frame, writes their offsets in binding order and returns the count.
+		//sets are bound from several recording threads at once, the set to bind with the offsets is returned in set.
+		auto prepareUniforms(uint32_t *offsets, VkDescriptorSet &set) -> uint32_t;
 
 		auto setTexture(const std::string &name, const std::vector<std::shared_ptr<Texture>> &textures) -> void override;
 		auto setTexture(const std::string &name, const std::shared_ptr<Texture> &textures) -> void override;
 		auto setBuffer(const std::string &name, const std::shared_ptr<UniformBuffer> &buffer) -> void override;
+		auto setStorageBuffer(const std::string &name, const std::shared_ptr<StorageBuffer> &buffer) -> void override;
 		auto getUnifromBuffer(const std::string &name) -> std::shared_ptr<UniformBuffer> override;
 		auto setUniform(const std::string &bufferName, const std::string &uniformName, const void *data, bool dynamic) -> void override;
 		auto setUniform(const std::string &bufferName, const std::string &uniformName, const void *data, uint32_t size, bool dynamic) -> void override;
 		auto setUniformBufferData(const std::string &bufferName, const void *data) -> void override;
+		auto setUniform(const UniformHandle &handle, const void *data) -> void override;
+		auto setUniform(const UniformHandle &handle, const void *data, uint32_t size) -> void override;
 		auto getDescriptors() const -> const std::vector<Descriptor>& override { return descriptors; }
 
 	  private:
-		uint32_t dynamicOffset      = 0;
-		Shader * shader             = nullptr;
-		bool     dynamic            = false;
-		bool     descriptorDirty[3] = {};
+		//a set already bound this frame is never written again, it is replaced by a copy. called with the uniform mutex held.
+		auto renew(uint32_t frame) -> void;
+
+		uint32_t              dynamicOffset = 0;
+		Shader *              shader        = nullptr;
+		VkDescriptorSetLayout setLayout     = VK_NULL_HANDLE;
+		std::vector<bool>     descriptorDirty;
 
 		std::vector<Descriptor> descriptors;
 
+		//uniform block writes of prepareUniforms.
 		std::array<VkDescriptorBufferInfo, MAX_BUFFER_INFOS>    bufferInfoPool;
-		std::array<VkDescriptorImageInfo, MAX_IMAGE_INFOS>      imageInfoPool;
 		std::array<VkWriteDescriptorSet, MAX_WRITE_DESCTIPTORS> writeDescriptorSetPool;
+		std::vector<VkCopyDescriptorSet>                        descriptorCopies;
+
+		//texture and storage buffer writes of update, sized by the descriptors (bindless arrays hold thousands of textures).
+		std::vector<VkDescriptorImageInfo>  imageInfos;
+		std::vector<VkDescriptorBufferInfo> bufferInfos;
+		std::vector<VkWriteDescriptorSet>   descriptorWrites;
 
 		uint32_t framesInFlight = 0;
 
@@ -64,12 +75,19 @@ namespace maple
 		{
 			std::vector<BufferMemberInfo> members;
 			Buffer                        localStorage;
-			bool                          dynamic        = false;
-			bool                          hasUpdated[10] = {};
+			uint32_t                      binding        = 0;
+			bool                          dirty          = true;
+			uint64_t                      uploadedFrame = UINT64_MAX;        //ring frame counter of the last upload
+			std::vector<uint64_t>         ringVersion;                       //ring page the descriptor of each frame points to
 		};
 
-		std::vector<VkDescriptorSet>                                                 descriptorSet;
-		std::vector<std::unordered_map<std::string, std::shared_ptr<UniformBuffer>>> uniformBuffers;
-		std::unordered_map<std::string, UniformBufferInfo>                           uniformBuffersData;
+		std::vector<VkDescriptorSet>                       descriptorSet;
+		std::vector<uint64_t>                              boundFrame;         //ring frame counter of the last bind, per frame in flight
+		std::vector<std::vector<VkDescriptorSet>>          retiredSets;        //replaced while bound, freed when the frame comes around again
+		std::unordered_map<std::string, UniformBufferInfo> uniformBuffersData;
+		std::vector<UniformBufferInfo *>                   uniformBufferSlots;        //indexed by UniformHandle::buffer
+		std::vector<UniformBufferInfo *>                   bindingOrder;              //dynamic offsets are consumed in binding order
+		std::vector<uint32_t>                              dynamicOffsets;
+		std::mutex                                         uniformMutex;
 	};
 };        // namespace maple
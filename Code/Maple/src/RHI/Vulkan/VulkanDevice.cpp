@@ -6,6 +6,11 @@
 #include "VulkanCommandPool.h"
 #include "VulkanContext.h"
 #include "VulkanHelper.h"
+#include "VulkanUploader.h"
+#include <algorithm>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
 #include <stdexcept>
 
 #include "Application.h"
@@ -14,6 +19,16 @@ namespace maple
 {
 	namespace
 	{
+		//start of every pipeline cache blob, VkPipelineCacheHeaderVersionOne in newer headers.
+		struct PipelineCacheHeader
+		{
+			uint32_t headerSize;
+			uint32_t headerVersion;
+			uint32_t vendorID;
+			uint32_t deviceID;
+			uint8_t  pipelineCacheUUID[VK_UUID_SIZE];
+		};
+
 		inline auto getDeviceTypeName(VkPhysicalDeviceType type) -> const std::string
 		{
 			switch (type)
@@ -57,7 +72,7 @@ namespace maple
 					auto &queueFamilyProperty = queueFamilyProperties[i];
 					if ((queueFamilyProperty.queueFlags & VK_QUEUE_TRANSFER_BIT) && ((queueFamilyProperty.queueFlags & VK_QUEUE_GRAPHICS_BIT) == 0) && ((queueFamilyProperty.queueFlags & VK_QUEUE_COMPUTE_BIT) == 0))
 					{
-						indices.presentFamily = i;
+						indices.transferFamily = i;
 						break;
 					}
 				}
@@ -65,10 +80,10 @@ namespace maple
 
 			for (uint32_t i = 0; i < queueFamilyProperties.size(); i++)
 			{
-				if ((flags & VK_QUEUE_TRANSFER_BIT) && !indices.presentFamily.has_value())
+				if ((flags & VK_QUEUE_TRANSFER_BIT) && !indices.transferFamily.has_value())
 				{
 					if (queueFamilyProperties[i].queueFlags & VK_QUEUE_TRANSFER_BIT)
-						indices.presentFamily = i;
+						indices.transferFamily = i;
 				}
 
 				if ((flags & VK_QUEUE_COMPUTE_BIT) && !indices.computeFamily.has_value())
@@ -147,7 +162,7 @@ namespace maple
 
 		static const float defaultQueuePriority(0.0f);
 
-		int32_t requestedQueueTypes = VK_QUEUE_GRAPHICS_BIT;        // | VK_QUEUE_COMPUTE_BIT | VK_QUEUE_TRANSFER_BIT;
+		int32_t requestedQueueTypes = VK_QUEUE_GRAPHICS_BIT | VK_QUEUE_TRANSFER_BIT;        // | VK_QUEUE_COMPUTE_BIT;
 		indices                     = lookupQueueFamilyIndices(requestedQueueTypes, queueFamilyProperties);
 
 		// Graphics queue
@@ -179,12 +194,12 @@ namespace maple
 		// transfer queue
 		if (requestedQueueTypes & VK_QUEUE_TRANSFER_BIT)
 		{
-			if ((indices.presentFamily != indices.graphicsFamily) && (indices.presentFamily != indices.computeFamily))
+			if ((indices.transferFamily != indices.graphicsFamily) && (indices.transferFamily != indices.computeFamily))
 			{
-				// If compute family index differs, we need an additional queue create info for the compute queue
+				// If transfer family index differs, we need an additional queue create info for the transfer queue
 				VkDeviceQueueCreateInfo queueInfo{};
 				queueInfo.sType            = VK_STRUCTURE_TYPE_DEVICE_QUEUE_CREATE_INFO;
-				queueInfo.queueFamilyIndex = indices.presentFamily.value();
+				queueInfo.queueFamilyIndex = indices.transferFamily.value();
 				queueInfo.queueCount       = 1;
 				queueInfo.pQueuePriorities = &defaultQueuePriority;
 				queueCreateInfos.emplace_back(queueInfo);
@@ -215,6 +230,8 @@ namespace maple
 
 	VulkanDevice::~VulkanDevice()
 	{
+		uploader.reset();
+		savePipelineCache();
 		vkDestroyPipelineCache(device, pipelineCache, VK_NULL_HANDLE);
 
 #ifdef USE_VMA_ALLOCATOR
@@ -262,11 +279,46 @@ namespace maple
 			enableDebugMarkers = true;
 		}
 
+		VkPhysicalDeviceDescriptorIndexingFeaturesEXT supportedIndexing{};
+		supportedIndexing.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_DESCRIPTOR_INDEXING_FEATURES_EXT;
+		VkPhysicalDeviceFeatures2 features2{};
+		features2.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_FEATURES_2;
+		features2.pNext = &supportedIndexing;
+		vkGetPhysicalDeviceFeatures2(*physicalDevice, &features2);
+
 		VkPhysicalDeviceDescriptorIndexingFeaturesEXT indexingFeatures{};
 		indexingFeatures.sType                           = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_DESCRIPTOR_INDEXING_FEATURES_EXT;
 		indexingFeatures.runtimeDescriptorArray          = VK_TRUE;
 		indexingFeatures.descriptorBindingPartiallyBound = VK_TRUE;
 
+		//materials of instanced draws differ per instance, the texture array is indexed with a non uniform index.
+		if (physicalDevice->isExtensionSupported(VK_EXT_DESCRIPTOR_INDEXING_EXTENSION_NAME) &&
+		    supportedIndexing.runtimeDescriptorArray && supportedIndexing.descriptorBindingPartiallyBound &&
+		    supportedIndexing.shaderSampledImageArrayNonUniformIndexing)
+		{
+			deviceExtensions.emplace_back(VK_EXT_DESCRIPTOR_INDEXING_EXTENSION_NAME);
+			indexingFeatures.shaderSampledImageArrayNonUniformIndexing = VK_TRUE;
+
+			auto &limits = physicalDevice->getProperties().limits;
+			bindlessTextureCount = std::min({MAX_BINDLESS_TEXTURES,
+			                                 limits.maxPerStageDescriptorSamplers,
+			                                 limits.maxPerStageDescriptorSampledImages,
+			                                 limits.maxDescriptorSetSamplers,
+			                                 limits.maxDescriptorSetSampledImages});
+			if (bindlessTextureCount < MIN_BINDLESS_TEXTURES)
+				bindlessTextureCount = 0;
+		}
+		LOGI("Bindless textures : {0}", bindlessTextureCount);
+
+		//gpu driven draws take the draw count from a buffer and the instance of a draw from its firstInstance.
+		if (physicalDevice->isExtensionSupported(VK_KHR_DRAW_INDIRECT_COUNT_EXTENSION_NAME) &&
+		    physicalDeviceFeatures.multiDrawIndirect && physicalDeviceFeatures.drawIndirectFirstInstance)
+		{
+			deviceExtensions.emplace_back(VK_KHR_DRAW_INDIRECT_COUNT_EXTENSION_NAME);
+			indirectCountSupported = true;
+		}
+		LOGI("Indirect count : {0}", indirectCountSupported);
+
 #if defined(PLATFORM_MACOS) || defined(PLATFORM_IOS)
 		// https://vulkan.lunarg.com/doc/view/1.2.162.0/mac/1.2-extensions/vkspec.html#VUID-VkDeviceCreateInfo-pProperties-04451
 		if (physicalDevice->isExtensionSupported("VK_KHR_portability_subset"))
@@ -293,8 +345,15 @@ namespace maple
 			return false;
 		}
 
+		if (indirectCountSupported)
+		{
+			drawIndexedIndirectCount = reinterpret_cast<PFN_vkCmdDrawIndexedIndirectCountKHR>(vkGetDeviceProcAddr(device, "vkCmdDrawIndexedIndirectCountKHR"));
+			indirectCountSupported   = drawIndexedIndirectCount != nullptr;
+		}
+
 		vkGetDeviceQueue(device, physicalDevice->indices.graphicsFamily.value(), 0, &graphicsQueue);
 		vkGetDeviceQueue(device, physicalDevice->indices.graphicsFamily.value(), 0, &presentQueue);
+		vkGetDeviceQueue(device, physicalDevice->indices.transferFamily.value_or(physicalDevice->indices.graphicsFamily.value()), 0, &transferQueue);
 
 #ifdef USE_VMA_ALLOCATOR
 		VmaAllocatorCreateInfo allocatorInfo = {};
@@ -339,15 +398,104 @@ namespace maple
 
 		createTracyContext();
 		createPipelineCache();
+		uploader = std::make_unique<VulkanUploader>();
 		return true;
 	}
 
 	auto VulkanDevice::createPipelineCache() -> void
 	{
+		std::vector<char> data;
+		{
+			std::ifstream file(PIPELINE_CACHE_FILE, std::ios::binary | std::ios::ate);
+			if (file)
+			{
+				data.resize(static_cast<size_t>(file.tellg()));
+				file.seekg(0);
+				file.read(data.data(), data.size());
+			}
+		}
+
+		//a blob of another driver or gpu is rejected by some drivers and crashes others, so only a matching header is passed on.
+		if (!data.empty())
+		{
+			auto &              properties = physicalDevice->getProperties();
+			PipelineCacheHeader header{};
+			if (data.size() < sizeof(header))
+			{
+				data.clear();
+			}
+			else
+			{
+				memcpy(&header, data.data(), sizeof(header));
+				if (header.headerSize < sizeof(header) ||
+				    header.headerVersion != VK_PIPELINE_CACHE_HEADER_VERSION_ONE ||
+				    header.vendorID != properties.vendorID ||
+				    header.deviceID != properties.deviceID ||
+				    memcmp(header.pipelineCacheUUID, properties.pipelineCacheUUID, VK_UUID_SIZE) != 0)
+				{
+					LOGI("PipelineCache : {0} was made by another device or driver, starting empty", PIPELINE_CACHE_FILE);
+					data.clear();
+				}
+			}
+		}
+
 		VkPipelineCacheCreateInfo pipelineCacheCI{};
-		pipelineCacheCI.sType = VK_STRUCTURE_TYPE_PIPELINE_CACHE_CREATE_INFO;
-		pipelineCacheCI.pNext = NULL;
-		vkCreatePipelineCache(device, &pipelineCacheCI, VK_NULL_HANDLE, &pipelineCache);
+		pipelineCacheCI.sType           = VK_STRUCTURE_TYPE_PIPELINE_CACHE_CREATE_INFO;
+		pipelineCacheCI.pNext           = NULL;
+		pipelineCacheCI.initialDataSize = data.size();
+		pipelineCacheCI.pInitialData    = data.empty() ? nullptr : data.data();
+
+		if (vkCreatePipelineCache(device, &pipelineCacheCI, VK_NULL_HANDLE, &pipelineCache) != VK_SUCCESS && !data.empty())
+		{
+			LOGW("PipelineCache : {0} is broken, starting empty", PIPELINE_CACHE_FILE);
+			pipelineCacheCI.initialDataSize = 0;
+			pipelineCacheCI.pInitialData    = nullptr;
+			vkCreatePipelineCache(device, &pipelineCacheCI, VK_NULL_HANDLE, &pipelineCache);
+		}
+		else if (!data.empty())
+		{
+			LOGI("PipelineCache : loaded {0} bytes from {1}", data.size(), PIPELINE_CACHE_FILE);
+		}
+	}
+
+	auto VulkanDevice::savePipelineCache() -> void
+	{
+		if (pipelineCache == VK_NULL_HANDLE)
+			return;
+
+		size_t size = 0;
+		if (vkGetPipelineCacheData(device, pipelineCache, &size, nullptr) != VK_SUCCESS || size == 0)
+			return;
+
+		std::vector<char> data(size);
+		if (vkGetPipelineCacheData(device, pipelineCache, &size, data.data()) != VK_SUCCESS)
+			return;
+
+		//written next to the final name first, a crash while writing never leaves a broken cache behind.
+		const std::string path = PIPELINE_CACHE_FILE;
+		const auto        temp = path + ".tmp";
+		std::error_code   error;
+		std::filesystem::create_directories(std::filesystem::path(path).parent_path(), error);
+		{
+			std::ofstream file(temp, std::ios::binary | std::ios::trunc);
+			if (!file)
+			{
+				LOGW("PipelineCache : can not write {0}", temp);
+				return;
+			}
+			file.write(data.data(), size);
+		}
+		std::filesystem::remove(path, error);
+		std::filesystem::rename(temp, path, error);
+		if (error)
+		{
+			LOGW("PipelineCache : can not write {0} : {1}", path, error.message());
+		}
+	}
+
+	auto VulkanDevice::releaseUploader() -> void
+	{
+		uploader.reset();
 	}
 
 	std::shared_ptr<VulkanDevice> VulkanDevice::instance;
@@ -16,6 +16,7 @@
 namespace maple
 {
 	class VulkanCommandPool;
+	class VulkanUploader;
 
 	class VulkanPhysicalDevice final
 	{
@@ -67,8 +68,18 @@ namespace maple
 		VulkanDevice();
 		~VulkanDevice();
 
+		//cache blob of the last run, kept beside the other cooked data and only used on the same device and driver.
+		static constexpr const char *PIPELINE_CACHE_FILE = "cache/pipelines.bin";
+		//upper bound of the bindless texture arrays, devices with less than MIN_BINDLESS_TEXTURES do not get them.
+		static constexpr uint32_t MAX_BINDLESS_TEXTURES = 4096;
+		static constexpr uint32_t MIN_BINDLESS_TEXTURES = 256;
+
 		auto init() -> bool;
 		auto createPipelineCache() -> void;
+		//writes the cache to PIPELINE_CACHE_FILE, also done when the device goes away.
+		auto savePipelineCache() -> void;
+		//finishes the pending uploads, the staging buffers have to go before the context.
+		auto releaseUploader() -> void;
 
 		inline const auto getPhysicalDevice() const
 		{
@@ -86,6 +97,15 @@ namespace maple
 		{
 			return presentQueue;
 		}
+		inline auto getTransferQueue()
+		{
+			return transferQueue;
+		}
+		//nullptr until the device is initialized.
+		inline auto getUploader()
+		{
+			return uploader.get();
+		}
 		inline auto getCommandPool()
 		{
 			return commandPool;
@@ -94,6 +114,20 @@ namespace maple
 		{
 			return pipelineCache;
 		}
+		//size of runtime sized sampler arrays, 0 if the device can not index them per draw.
+		inline auto getBindlessTextureCount() const
+		{
+			return bindlessTextureCount;
+		}
+		//VK_KHR_draw_indirect_count together with multi draw indirect and a non zero firstInstance.
+		inline auto isIndirectCountSupported() const
+		{
+			return indirectCountSupported;
+		}
+		inline auto getDrawIndexedIndirectCount() const
+		{
+			return drawIndexedIndirectCount;
+		}
 
 		static auto get() -> std::shared_ptr<VulkanDevice>
 		{
@@ -125,15 +159,17 @@ namespace maple
 
 		std::shared_ptr<VulkanPhysicalDevice> physicalDevice;
 		std::shared_ptr<VulkanCommandPool>    commandPool;
+		std::unique_ptr<VulkanUploader>       uploader;
 		static std::shared_ptr<VulkanDevice>  instance;
 
 		VkDevice device = nullptr;
 		VkQueue  graphicsQueue;
 		VkQueue  presentQueue;
+		VkQueue  transferQueue;
 
 		VkDescriptorPool         descriptorPool;
 		VkPhysicalDeviceFeatures enabledFeatures;
-		VkPipelineCache          pipelineCache;
+		VkPipelineCache          pipelineCache = VK_NULL_HANDLE;
 
 #if defined(MAPLE_PROFILE) && defined(TRACY_ENABLE)
 		tracy::VkCtx *tracyContext;
@@ -143,6 +179,10 @@ namespace maple
 		VmaAllocator allocator{};
 #endif
 
-		bool enableDebugMarkers = false;
+		bool     enableDebugMarkers     = false;
+		uint32_t bindlessTextureCount   = 0;
+		bool     indirectCountSupported = false;
+
+		PFN_vkCmdDrawIndexedIndirectCountKHR drawIndexedIndirectCount = nullptr;
 	};
 };        // namespace maple
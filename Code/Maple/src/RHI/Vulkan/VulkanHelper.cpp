@@ -11,6 +11,7 @@
 #include "VulkanDescriptorSet.h"
 #include "VulkanDevice.h"
 #include "VulkanSwapChain.h"
+#include "VulkanUploader.h"
 
 #include <string>
 
@@ -745,6 +746,10 @@ namespace maple
 
 	auto VulkanHelper::beginSingleTimeCommands() -> VkCommandBuffer
 	{
+		//pending uploads go first, the commands recorded here may read them.
+		if (auto uploader = VulkanDevice::get()->getUploader())
+			uploader->submit();
+
 		VkCommandBufferAllocateInfo allocInfo{};
 		allocInfo.sType              = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
 		allocInfo.level              = VK_COMMAND_BUFFER_LEVEL_PRIMARY;
@@ -1012,6 +1017,10 @@ namespace maple
 						return VK_FORMAT_R8_SRGB;
 					case TextureFormat::RG8:
 						return VK_FORMAT_R8G8_SRGB;
+					case TextureFormat::RG16F:
+						return VK_FORMAT_R16G16_SFLOAT;
+					case TextureFormat::RG16:
+						return VK_FORMAT_R16G16_UNORM;
 					case TextureFormat::RGB8:
 						return VK_FORMAT_R8G8B8A8_SRGB;
 					case TextureFormat::RGBA8:
@@ -1024,6 +1033,10 @@ namespace maple
 						return VK_FORMAT_R32G32B32_SFLOAT;
 					case TextureFormat::RGBA32:
 						return VK_FORMAT_R32G32B32A32_SFLOAT;
+					case TextureFormat::BC1:
+						return VK_FORMAT_BC1_RGBA_SRGB_BLOCK;
+					case TextureFormat::BC3:
+						return VK_FORMAT_BC3_SRGB_BLOCK;
 					default:
 						LOGC("[Texture] Unsupported image bit-depth!");
 						return VK_FORMAT_R8G8B8A8_SRGB;
@@ -1041,6 +1054,10 @@ namespace maple
 						return VK_FORMAT_R8_UNORM;
 					case TextureFormat::RG8:
 						return VK_FORMAT_R8G8_UNORM;
+					case TextureFormat::RG16F:
+						return VK_FORMAT_R16G16_SFLOAT;
+					case TextureFormat::RG16:
+						return VK_FORMAT_R16G16_UNORM;
 					case TextureFormat::RGB8:
 						return VK_FORMAT_R8G8B8A8_UNORM;
 					case TextureFormat::RGBA8:
@@ -1053,6 +1070,10 @@ namespace maple
 						return VK_FORMAT_R32G32B32_SFLOAT;
 					case TextureFormat::RGBA32:
 						return VK_FORMAT_R32G32B32A32_SFLOAT;
+					case TextureFormat::BC1:
+						return VK_FORMAT_BC1_RGBA_UNORM_BLOCK;
+					case TextureFormat::BC3:
+						return VK_FORMAT_BC3_UNORM_BLOCK;
 					default:
 						LOGC("[Texture] Unsupported image bit-depth!");
 						return VK_FORMAT_R8G8B8A8_UNORM;
@@ -1158,6 +1179,8 @@ namespace maple
 					return VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC;
 				case DescriptorType::ImageSampler:
 					return VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
+				case DescriptorType::StorageBuffer:
+					return VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
 			}
 
 			return VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER;
@@ -1171,6 +1194,8 @@ namespace maple
 					return VK_SHADER_STAGE_VERTEX_BIT;
 				case ShaderType::Fragment:
 					return VK_SHADER_STAGE_FRAGMENT_BIT;
+				case ShaderType::Compute:
+					return VK_SHADER_STAGE_COMPUTE_BIT;
 				default:
 					LOGC("Unknown Shader Type");
 					return VK_SHADER_STAGE_VERTEX_BIT;
@@ -43,6 +43,7 @@ namespace maple
 		std::optional<uint32_t> graphicsFamily;
 		std::optional<uint32_t> presentFamily;
 		std::optional<uint32_t> computeFamily;
+		std::optional<uint32_t> transferFamily;
 		auto                    isComplete()
 		{
 			return graphicsFamily.has_value() && presentFamily.has_value() && computeFamily.has_value();
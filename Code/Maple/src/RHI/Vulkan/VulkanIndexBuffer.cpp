@@ -3,18 +3,23 @@
 //////////////////////////////////////////////////////////////////////////////
 #include "VulkanIndexBuffer.h"
 #include "Engine/Profiler.h"
+#include "Others/Console.h"
 #include "VulkanCommandBuffer.h"
 
 namespace maple
 {
 	VulkanIndexBuffer::VulkanIndexBuffer(const uint16_t *data, uint32_t initCount, BufferUsage bufferUsage) :
-	    VulkanBuffer(VK_BUFFER_USAGE_INDEX_BUFFER_BIT, initCount * sizeof(uint16_t), data), size(initCount * sizeof(uint16_t)), count(initCount), usage(bufferUsage)
+	    size(initCount * sizeof(uint16_t)), count(initCount), usage(bufferUsage)
 	{
+		VulkanBuffer::setDeviceLocal(bufferUsage == BufferUsage::Static);
+		VulkanBuffer::init(VK_BUFFER_USAGE_INDEX_BUFFER_BIT, size, data);
 	}
 
 	VulkanIndexBuffer::VulkanIndexBuffer(const uint32_t *data, uint32_t initCount, BufferUsage bufferUsage) :
-	    VulkanBuffer(VK_BUFFER_USAGE_INDEX_BUFFER_BIT, initCount * sizeof(uint32_t), data), size(initCount * sizeof(uint32_t)), count(initCount), usage(bufferUsage)
+	    size(initCount * sizeof(uint32_t)), count(initCount), usage(bufferUsage)
 	{
+		VulkanBuffer::setDeviceLocal(bufferUsage == BufferUsage::Static);
+		VulkanBuffer::init(VK_BUFFER_USAGE_INDEX_BUFFER_BIT, size, data);
 	}
 
 	VulkanIndexBuffer::~VulkanIndexBuffer()
@@ -41,6 +46,12 @@ namespace maple
 		setVkData(size, data);
 	}
 
+	auto VulkanIndexBuffer::setDataSub(uint32_t size, const void *data, uint32_t offset) -> void
+	{
+		PROFILE_FUNCTION();
+		setVkData(size, data, offset);
+	}
+
 	auto VulkanIndexBuffer::releasePointer() -> void
 	{
 		PROFILE_FUNCTION();
@@ -54,6 +65,7 @@ namespace maple
 
 	auto VulkanIndexBuffer::getPointerInternal() -> void * 
 	{
+		MAPLE_ASSERT(!deviceLocal, "static index buffers can not be mapped, use setData");
 		if (!mappedBuffer)
 		{
 			VulkanBuffer::map();
@@ -29,6 +29,7 @@ namespace maple
 		auto bind(CommandBuffer *commandBuffer) const -> void override;
 		auto unbind() const -> void override;
 		auto setData(uint32_t size, const void *data) -> void;
+		auto setDataSub(uint32_t size, const void *data, uint32_t offset) -> void override;
 		auto releasePointer() -> void override;
 
 		auto getPointerInternal() -> void * override;
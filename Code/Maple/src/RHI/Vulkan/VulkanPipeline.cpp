@@ -217,9 +217,12 @@ namespace maple
 
 	}        // namespace
 
-	VulkanPipeline::VulkanPipeline(const PipelineInfo &info)
+	VulkanPipeline::VulkanPipeline(const PipelineInfo &info, bool compile)
 	{
-		init(info);
+		if (compile)
+			init(info);
+		else
+			prepare(info);
 	}
 
 	VulkanPipeline::~VulkanPipeline()
@@ -233,14 +236,46 @@ namespace maple
 	auto VulkanPipeline::init(const PipelineInfo &info) -> bool
 	{
 		PROFILE_FUNCTION();
-		shader        = info.shader;
-		auto vkShader = std::static_pointer_cast<VulkanShader>(info.shader);
+		prepare(info);
+		return compile();
+	}
 
-		description    = info;
-		pipelineLayout = vkShader->getPipelineLayout();
+	auto VulkanPipeline::prepare(const PipelineInfo &info) -> void
+	{
+		PROFILE_FUNCTION();
+		shader      = info.shader;
+		description = info;
+
+		pipelineLayout = std::static_pointer_cast<VulkanShader>(info.shader)->getPipelineLayout();
+
+		if (shader->isComputeShader())
+		{
+			bindPoint        = VK_PIPELINE_BIND_POINT_COMPUTE;
+			depthBiasEnabled = false;
+			return;
+		}
 
 		transitionAttachments();
 		createFrameBuffers();
+	}
+
+	auto VulkanPipeline::compile() -> bool
+	{
+		PROFILE_FUNCTION();
+		const auto &info     = description;
+		auto        vkShader = std::static_pointer_cast<VulkanShader>(shader);
+
+		if (bindPoint == VK_PIPELINE_BIND_POINT_COMPUTE)
+		{
+			VkComputePipelineCreateInfo computePipelineCreateInfo{};
+			computePipelineCreateInfo.sType              = VK_STRUCTURE_TYPE_COMPUTE_PIPELINE_CREATE_INFO;
+			computePipelineCreateInfo.layout             = pipelineLayout;
+			computePipelineCreateInfo.stage              = vkShader->getShaderStages()[0];
+			computePipelineCreateInfo.basePipelineHandle = VK_NULL_HANDLE;
+			computePipelineCreateInfo.basePipelineIndex  = -1;
+			VK_CHECK_RESULT(vkCreateComputePipelines(*VulkanDevice::get(), VulkanDevice::get()->getPipelineCache(), 1, &computePipelineCreateInfo, VK_NULL_HANDLE, &pipeline));
+			return true;
+		}
 
 		// Pipeline
 		std::vector<VkDynamicState>      dynamicStateDescriptors;
@@ -305,6 +340,7 @@ namespace maple
 		graphicsPipelineCreateInfo.renderPass          = *std::static_pointer_cast<VulkanRenderPass>(renderPass);
 		graphicsPipelineCreateInfo.subpass             = 0;
 
+		//the cache is synchronized by the driver, several pipelines may be compiled against it at once.
 		VK_CHECK_RESULT(vkCreateGraphicsPipelines(*VulkanDevice::get(), VulkanDevice::get()->getPipelineCache(), 1, &graphicsPipelineCreateInfo, VK_NULL_HANDLE, &pipeline));
 
 		return true;
@@ -312,6 +348,9 @@ namespace maple
 
 	auto VulkanPipeline::getWidth() -> uint32_t
 	{
+		if (bindPoint == VK_PIPELINE_BIND_POINT_COMPUTE)
+			return 0;
+
 		if (description.swapChainTarget)
 		{
 			return Application::getGraphicsContext()->getSwapChain()->getCurrentImage()->getWidth();
@@ -332,6 +371,9 @@ namespace maple
 
 	auto VulkanPipeline::getHeight() -> uint32_t
 	{
+		if (bindPoint == VK_PIPELINE_BIND_POINT_COMPUTE)
+			return 0;
+
 		if (description.swapChainTarget)
 		{
 			return Application::getGraphicsContext()->getSwapChain()->getCurrentImage()->getHeight();
@@ -353,39 +395,64 @@ namespace maple
 	auto VulkanPipeline::bind(CommandBuffer *cmdBuffer, uint32_t layer, int32_t cubeFace, int32_t mipMapLevel) -> FrameBuffer *
 	{
 		PROFILE_FUNCTION();
+		if (bindPoint == VK_PIPELINE_BIND_POINT_COMPUTE)
+		{
+			vkCmdBindPipeline(static_cast<VulkanCommandBuffer *>(cmdBuffer)->getCommandBuffer(), bindPoint, pipeline);
+			return nullptr;
+		}
+
 		transitionAttachments();
 
 		if (depthBiasEnabled)
 			vkCmdSetDepthBias(static_cast<VulkanCommandBuffer *>(cmdBuffer)->getCommandBuffer(), depthBiasConstant, 0.0f, depthBiasSlope);
 
-		FrameBuffer *framebuffer = nullptr;
-
-		if (description.swapChainTarget)
-		{
-			framebuffer = framebuffers[VulkanContext::get()->getSwapChain()->getCurrentImageIndex()].get();
-		}
-		else if (description.depthArrayTarget)
-		{
-			framebuffer = framebuffers[layer].get();
-		}
-		else
-		{
-			framebuffer = framebuffers[0].get();
-		}
-
-		auto mipScale = std::pow(0.5, mipMapLevel);
+		auto framebuffer = getFrameBuffer(layer);
+		auto mipScale    = std::pow(0.5, mipMapLevel);
 
 		renderPass->beginRenderPass(cmdBuffer, description.clearColor, framebuffer, SubPassContents::Inline, getWidth() * mipScale, getHeight() * mipScale, cubeFace, mipMapLevel);
 		vkCmdBindPipeline(static_cast<VulkanCommandBuffer *>(cmdBuffer)->getCommandBuffer(), VK_PIPELINE_BIND_POINT_GRAPHICS, pipeline);
 		return framebuffer;
 	}
 
+	auto VulkanPipeline::beginSecondary(CommandBuffer *cmdBuffer, uint32_t layer) -> FrameBuffer *
+	{
+		PROFILE_FUNCTION();
+		transitionAttachments();
+		auto framebuffer = getFrameBuffer(layer);
+		renderPass->beginRenderPass(cmdBuffer, description.clearColor, framebuffer, SubPassContents::Secondary, getWidth(), getHeight());
+		return framebuffer;
+	}
+
+	auto VulkanPipeline::bindSecondary(VulkanCommandBuffer *secondary, FrameBuffer *framebuffer) -> void
+	{
+		PROFILE_FUNCTION();
+		//dynamic state is not inherited from the primary buffer.
+		secondary->beginRecordingSecondary(renderPass.get(), framebuffer);
+		secondary->updateViewport(getWidth(), getHeight());
+		if (depthBiasEnabled)
+			vkCmdSetDepthBias(secondary->getCommandBuffer(), depthBiasConstant, 0.0f, depthBiasSlope);
+		vkCmdBindPipeline(secondary->getCommandBuffer(), VK_PIPELINE_BIND_POINT_GRAPHICS, pipeline);
+	}
+
 	auto VulkanPipeline::end(CommandBuffer *commandBuffer) -> void
 	{
 		PROFILE_FUNCTION();
+		if (bindPoint == VK_PIPELINE_BIND_POINT_COMPUTE)
+			return;
 		renderPass->endRenderPass(commandBuffer);
 	}
 
+	auto VulkanPipeline::getFrameBuffer(uint32_t layer) -> FrameBuffer *
+	{
+		if (description.swapChainTarget)
+			return framebuffers[VulkanContext::get()->getSwapChain()->getCurrentImageIndex()].get();
+
+		if (description.depthArrayTarget)
+			return framebuffers[layer].get();
+
+		return framebuffers[0].get();
+	}
+
 	auto VulkanPipeline::clearRenderTargets(CommandBuffer *commandBuffer) -> void
 	{
 		PROFILE_FUNCTION();
@@ -11,17 +11,25 @@
 
 namespace maple
 {
+	class VulkanCommandBuffer;
+
 	class VulkanPipeline : public Pipeline
 	{
 	  public:
 		constexpr static uint32_t MAX_DESCRIPTOR_SET = 1500;
 
-		VulkanPipeline(const PipelineInfo &info);
+		//without compile only prepare runs, compile has to be called before the pipeline is bound.
+		VulkanPipeline(const PipelineInfo &info, bool compile = true);
 		virtual ~VulkanPipeline();
 		NO_COPYABLE(VulkanPipeline);
 
 		auto init(const PipelineInfo &info) -> bool;
 
+		//the two steps of init. prepare transitions the targets and makes the render pass and framebuffers on the render thread,
+		//compile only creates the VkPipeline through the device pipeline cache and may run on any thread.
+		auto prepare(const PipelineInfo &info) -> void;
+		auto compile() -> bool;
+
 		auto getWidth() -> uint32_t override;
 		auto getHeight() -> uint32_t override;
 
@@ -29,6 +37,11 @@ namespace maple
 		auto end(CommandBuffer *commandBuffer) -> void override;
 		auto clearRenderTargets(CommandBuffer *commandBuffer) -> void override;
 
+		//begins the pass on the primary buffer with its content coming from secondary buffers, ended by end as usual.
+		auto beginSecondary(CommandBuffer *commandBuffer, uint32_t layer = 0) -> FrameBuffer *;
+		//starts recording a secondary buffer inside the pass begun by beginSecondary and binds the pipeline in it.
+		auto bindSecondary(VulkanCommandBuffer *secondary, FrameBuffer *framebuffer) -> void;
+
 		inline auto getShader() const -> std::shared_ptr<Shader> override
 		{
 			return shader;
@@ -39,20 +52,26 @@ namespace maple
 			return pipelineLayout;
 		}
 
-
+		//compute pipelines are bound outside of any render pass and have no targets.
+		inline auto getBindPoint() const
+		{
+			return bindPoint;
+		}
 
 	  private:
 		auto transitionAttachments() -> void;
 		auto createFrameBuffers() -> void;
+		auto getFrameBuffer(uint32_t layer) -> FrameBuffer *;
 
 		std::shared_ptr<Shader>                   shader;
 		std::shared_ptr<RenderPass>               renderPass;
 		std::vector<std::shared_ptr<FrameBuffer>> framebuffers;
 
-		VkPipelineLayout pipelineLayout;
-		VkPipeline       pipeline;
-		bool             depthBiasEnabled;
-		float            depthBiasConstant;
-		float            depthBiasSlope;
+		VkPipelineLayout    pipelineLayout;
+		VkPipeline          pipeline  = VK_NULL_HANDLE;
+		VkPipelineBindPoint bindPoint = VK_PIPELINE_BIND_POINT_GRAPHICS;
+		bool                depthBiasEnabled;
+		float               depthBiasConstant;
+		float               depthBiasSlope;
 	};
 };        // namespace maple
@@ -6,12 +6,15 @@
 #include "VulkanContext.h"
 #include "VulkanDevice.h"
 #include "VulkanPipeline.h"
+#include "VulkanStorageBuffer.h"
 #include "VulkanSwapChain.h"
 #include "VulkanTexture.h"
+#include "VulkanUploader.h"
 
 #include "Engine/Core.h"
 #include "Engine/Profiler.h"
 #include "Others/Console.h"
+#include "Thread/ParallelForEach.h"
 
 #include "VulkanDescriptorSet.h"
 #include "VulkanFramebuffer.h"
@@ -36,12 +39,19 @@ namespace maple
 	auto VulkanRenderDevice::init() -> void
 	{
 		PROFILE_FUNCTION();
-		std::array<VkDescriptorPoolSize, 5> poolSizes = {
+		auto context = Application::getGraphicsContext();
+
+		//the bindless texture array is allocated once per frame in flight.
+		const auto bindlessTextures = VulkanDevice::get()->getBindlessTextureCount() * context->getSwapChain()->getSwapChainBufferCount();
+
+		std::array<VkDescriptorPoolSize, 7> poolSizes = {
 		    VkDescriptorPoolSize{VK_DESCRIPTOR_TYPE_SAMPLER, 100},
 		    VkDescriptorPoolSize{VK_DESCRIPTOR_TYPE_SAMPLED_IMAGE, 100},
+		    VkDescriptorPoolSize{VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, MAX_DESCRIPTOR_SET_COUNT + bindlessTextures},
 		    VkDescriptorPoolSize{VK_DESCRIPTOR_TYPE_STORAGE_IMAGE, 100},
+		    VkDescriptorPoolSize{VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, 100},
 		    VkDescriptorPoolSize{VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER, 100},
-		    VkDescriptorPoolSize{VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC, 100}};
+		    VkDescriptorPoolSize{VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC, MAX_DESCRIPTOR_SET_COUNT}};
 
 		// Create info
 		VkDescriptorPoolCreateInfo poolCreateInfo = {};
@@ -53,6 +63,11 @@ namespace maple
 
 		// Pool
 		VK_CHECK_RESULT(vkCreateDescriptorPool(*VulkanDevice::get(), &poolCreateInfo, nullptr, &descriptorPool));
+
+		uniformRing  = std::make_unique<VulkanUniformRing>(
+            context->getSwapChain()->getSwapChainBufferCount(),
+            static_cast<uint32_t>(context->getMinUniformBufferOffsetAlignment()));
+		secondaryPool = std::make_unique<VulkanSecondaryPool>(context->getSwapChain()->getSwapChainBufferCount());
 	}
 
 	auto VulkanRenderDevice::begin() -> void
@@ -60,6 +75,22 @@ namespace maple
 		PROFILE_FUNCTION();
 		auto swapChain = Application::getGraphicsContext()->getSwapChain();
 		std::static_pointer_cast<VulkanSwapChain>(swapChain)->begin();
+		//begin has waited for the fence of this frame.
+		uniformRing->reset(swapChain->getCurrentBufferIndex());
+		secondaryPool->reset(swapChain->getCurrentBufferIndex());
+	}
+
+	auto VulkanRenderDevice::allocateDescriptorSets(VkDescriptorSetAllocateInfo &info, VkDescriptorSet *sets) -> void
+	{
+		std::lock_guard<std::mutex> lock(descriptorPoolMutex);
+		info.descriptorPool = descriptorPool;
+		VK_CHECK_RESULT(vkAllocateDescriptorSets(*VulkanDevice::get(), &info, sets));
+	}
+
+	auto VulkanRenderDevice::freeDescriptorSets(uint32_t count, const VkDescriptorSet *sets) -> void
+	{
+		std::lock_guard<std::mutex> lock(descriptorPoolMutex);
+		vkFreeDescriptorSets(*VulkanDevice::get(), descriptorPool, count, sets);
 	}
 
 	auto VulkanRenderDevice::presentInternal() -> void
@@ -67,6 +98,9 @@ namespace maple
 		PROFILE_FUNCTION();
 		auto swapChain = std::static_pointer_cast<VulkanSwapChain>(Application::getGraphicsContext()->getSwapChain());
 
+		uniformRing->flush();
+		//copies recorded this frame land on the queue before the frame that uses them.
+		VulkanDevice::get()->getUploader()->submit();
 		swapChain->end();
 		swapChain->queueSubmit();
 
@@ -99,32 +133,119 @@ namespace maple
 		vkCmdDraw(static_cast<VulkanCommandBuffer *>(commandBuffer)->getCommandBuffer(), count, 1, 0, 0);
 	}
 
-	auto VulkanRenderDevice::drawIndexedInternal(CommandBuffer *commandBuffer, const DrawType type, uint32_t count, uint32_t start) const -> void
+	auto VulkanRenderDevice::drawIndexedInternal(CommandBuffer *commandBuffer, const DrawType type, uint32_t count, uint32_t start, int32_t vertexOffset) const -> void
 	{
 		PROFILE_FUNCTION();
-		vkCmdDrawIndexed(static_cast<VulkanCommandBuffer *>(commandBuffer)->getCommandBuffer(), count, 1, 0, 0, 0);
+		vkCmdDrawIndexed(static_cast<VulkanCommandBuffer *>(commandBuffer)->getCommandBuffer(), count, 1, start, vertexOffset, 0);
+	}
+
+	auto VulkanRenderDevice::drawIndexedInstancedInternal(CommandBuffer *commandBuffer, const DrawType type, uint32_t count, uint32_t instanceCount, uint32_t start, int32_t vertexOffset) const -> void
+	{
+		PROFILE_FUNCTION();
+		vkCmdDrawIndexed(static_cast<VulkanCommandBuffer *>(commandBuffer)->getCommandBuffer(), count, instanceCount, start, vertexOffset, 0);
 	}
 
 	auto VulkanRenderDevice::bindDescriptorSetsInternal(Pipeline *pipeline, CommandBuffer *commandBuffer, uint32_t dynamicOffset, const std::vector<std::shared_ptr<DescriptorSet>> &descriptorSets) -> void
 	{
 		PROFILE_FUNCTION();
-		uint32_t numDynamicDescriptorSets = 0;
-		uint32_t numDesciptorSets         = 0;
+		//on the stack, secondary buffers are recorded from several threads.
+		VkDescriptorSet descriptorSetPool[16];
+		uint32_t        dynamicOffsetPool[64];
+		uint32_t        numDynamicOffsets = 0;
+		uint32_t        numDesciptorSets  = 0;
 
 		for (auto &descriptorSet : descriptorSets)
 		{
 			if (descriptorSet)
 			{
-				auto vkDesSet = std::static_pointer_cast<VulkanDescriptorSet>(descriptorSet);
-				if (vkDesSet->isDynamic())
-					numDynamicDescriptorSets++;
-
-				descriptorSetPool[numDesciptorSets] = vkDesSet->getDescriptorSet();
+				auto vkDesSet = static_cast<VulkanDescriptorSet *>(descriptorSet.get());
+				//uniform blocks are copied into the ring here, so every bind sees the values set before it.
+				numDynamicOffsets += vkDesSet->prepareUniforms(dynamicOffsetPool + numDynamicOffsets, descriptorSetPool[numDesciptorSets]);
+				MAPLE_ASSERT(numDynamicOffsets <= 64, "too many uniform blocks bound at once");
 				numDesciptorSets++;
 			}
 		}
 
-		vkCmdBindDescriptorSets(static_cast<VulkanCommandBuffer *>(commandBuffer)->getCommandBuffer(), VK_PIPELINE_BIND_POINT_GRAPHICS, static_cast<VulkanPipeline *>(pipeline)->getPipelineLayout(), 0, numDesciptorSets, descriptorSetPool, numDynamicDescriptorSets, &dynamicOffset);
+		auto vkPipeline = static_cast<VulkanPipeline *>(pipeline);
+		vkCmdBindDescriptorSets(static_cast<VulkanCommandBuffer *>(commandBuffer)->getCommandBuffer(), vkPipeline->getBindPoint(), vkPipeline->getPipelineLayout(), 0, numDesciptorSets, descriptorSetPool, numDynamicOffsets, dynamicOffsetPool);
+	}
+
+	auto VulkanRenderDevice::drawIndexedIndirectInternal(CommandBuffer *commandBuffer, StorageBuffer *commands, uint32_t offset, StorageBuffer *count, uint32_t countOffset, uint32_t maxDraws) const -> void
+	{
+		PROFILE_FUNCTION();
+		MAPLE_ASSERT(VulkanDevice::get()->isIndirectCountSupported(), "indirect count draws are not supported by the device");
+		const auto frame       = Application::getGraphicsContext()->getSwapChain()->getCurrentBufferIndex();
+		auto       vkCommands  = static_cast<VulkanStorageBuffer *>(commands);
+		auto       vkCount     = static_cast<VulkanStorageBuffer *>(count);
+		//normally done by the descriptor set of the pass writing them, a buffer only drawn from is copied here.
+		vkCommands->prepare(frame);
+		vkCount->prepare(frame);
+		if (vkCommands->getVkBuffer(frame) == VK_NULL_HANDLE || vkCount->getVkBuffer(frame) == VK_NULL_HANDLE)
+			return;
+
+		VulkanDevice::get()->getDrawIndexedIndirectCount()(static_cast<VulkanCommandBuffer *>(commandBuffer)->getCommandBuffer(),
+		                                                   vkCommands->getVkBuffer(frame), offset,
+		                                                   vkCount->getVkBuffer(frame), countOffset,
+		                                                   maxDraws, sizeof(DrawIndexedIndirectCommand));
+	}
+
+	auto VulkanRenderDevice::dispatch(CommandBuffer *commandBuffer, uint32_t x, uint32_t y, uint32_t z) -> void
+	{
+		PROFILE_FUNCTION();
+		vkCmdDispatch(static_cast<VulkanCommandBuffer *>(commandBuffer)->getCommandBuffer(), x, y, z);
+	}
+
+	auto VulkanRenderDevice::memoryBarrier(CommandBuffer *commandBuffer, MemoryBarrierFlags flag) -> void
+	{
+		PROFILE_FUNCTION();
+		VkMemoryBarrier barrier{};
+		barrier.sType         = VK_STRUCTURE_TYPE_MEMORY_BARRIER;
+		barrier.srcAccessMask = VK_ACCESS_SHADER_WRITE_BIT;
+
+		VkPipelineStageFlags dstStage = VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT | VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT;
+		switch (flag)
+		{
+			case MemoryBarrierFlags::Indirect_Command_Barrier:
+				barrier.dstAccessMask = VK_ACCESS_INDIRECT_COMMAND_READ_BIT | VK_ACCESS_SHADER_READ_BIT;
+				dstStage              = VK_PIPELINE_STAGE_DRAW_INDIRECT_BIT | VK_PIPELINE_STAGE_VERTEX_SHADER_BIT;
+				break;
+			case MemoryBarrierFlags::Shader_Image_Access_Barrier:
+				barrier.dstAccessMask = VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_SHADER_WRITE_BIT;
+				break;
+			default:
+				return;
+		}
+
+		vkCmdPipelineBarrier(static_cast<VulkanCommandBuffer *>(commandBuffer)->getCommandBuffer(), VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, dstStage, 0, 1, &barrier, 0, nullptr, 0, nullptr);
+	}
+
+	auto VulkanRenderDevice::drawParallelInternal(CommandBuffer *commandBuffer, Pipeline *pipeline, uint32_t layer, uint32_t count, uint32_t grainSize, const std::function<void(CommandBuffer *, uint32_t, uint32_t)> &record) -> void
+	{
+		PROFILE_FUNCTION();
+		grainSize = std::max(grainSize, 1u);
+		if (commandBuffer == nullptr || count <= grainSize || JobSystem::get() == nullptr)
+		{
+			RenderDevice::drawParallelInternal(commandBuffer, pipeline, layer, count, grainSize, record);
+			return;
+		}
+
+		auto       vkPipeline  = static_cast<VulkanPipeline *>(pipeline);
+		auto       framebuffer = vkPipeline->beginSecondary(commandBuffer, layer);
+		const auto chunks      = (count + grainSize - 1) / grainSize;
+
+		std::vector<VkCommandBuffer> secondaries(chunks);
+		parallelFor(0, chunks, 1, [&](uint32_t chunk) {
+			auto secondary = secondaryPool->get();
+			vkPipeline->bindSecondary(secondary, framebuffer);
+			const auto begin = chunk * grainSize;
+			record(secondary, begin, std::min(count, begin + grainSize));
+			secondary->endRecording();
+			secondaries[chunk] = secondary->getCommandBuffer();
+		});
+
+		//executed in chunk order, the pass ends up the same as if it was recorded inline.
+		vkCmdExecuteCommands(static_cast<VulkanCommandBuffer *>(commandBuffer)->getCommandBuffer(), chunks, secondaries.data());
+		vkPipeline->end(commandBuffer);
 	}
 
 	auto VulkanRenderDevice::clearRenderTarget(const std::shared_ptr<Texture> &texture, CommandBuffer *commandBuffer, const glm::vec4 &clearColor) -> void
@@ -5,7 +5,11 @@
 
 #include "RHI/Pipeline.h"
 #include "RHI/RenderDevice.h"
+#include "VulkanSecondaryPool.h"
 #include "VulkanSwapChain.h"
+#include "VulkanUniformRing.h"
+
+#include <mutex>
 
 namespace maple
 {
@@ -27,9 +31,14 @@ namespace maple
 		auto onResize(uint32_t width, uint32_t height) -> void override;
 		auto presentInternal() -> void override;
 		auto presentInternal(CommandBuffer *commandBuffer) -> void override;
-		auto drawIndexedInternal(CommandBuffer *commandBuffer, DrawType type, uint32_t count, uint32_t start) const -> void override;
+		auto drawIndexedInternal(CommandBuffer *commandBuffer, DrawType type, uint32_t count, uint32_t start, int32_t vertexOffset) const -> void override;
+		auto drawIndexedInstancedInternal(CommandBuffer *commandBuffer, DrawType type, uint32_t count, uint32_t instanceCount, uint32_t start, int32_t vertexOffset) const -> void override;
 		auto drawInternal(CommandBuffer *commandBuffer, DrawType type, uint32_t count, DataType datayType, const void *indices) const -> void override;
+		auto drawIndexedIndirectInternal(CommandBuffer *commandBuffer, StorageBuffer *commands, uint32_t offset, StorageBuffer *count, uint32_t countOffset, uint32_t maxDraws) const -> void override;
+		auto dispatch(CommandBuffer *commandBuffer, uint32_t x, uint32_t y, uint32_t z) -> void override;
+		auto memoryBarrier(CommandBuffer *commandBuffer, MemoryBarrierFlags flag) -> void override;
 		auto bindDescriptorSetsInternal(Pipeline *pipeline, CommandBuffer *commandBuffer, uint32_t dynamicOffset, const std::vector<std::shared_ptr<DescriptorSet>> &sets) -> void override;
+		auto drawParallelInternal(CommandBuffer *commandBuffer, Pipeline *pipeline, uint32_t layer, uint32_t count, uint32_t grainSize, const std::function<void(CommandBuffer *, uint32_t, uint32_t)> &record) -> void override;
 		auto clearRenderTarget(const std::shared_ptr<Texture> &texture, CommandBuffer *commandBuffer, const glm::vec4 &clearColor) -> void override;
 
 		inline auto getDescriptorPool() const
@@ -37,11 +46,23 @@ namespace maple
 			return descriptorPool;
 		}
 
+		//the pool is shared by every descriptor set, drawParallel workers renew and free theirs while recording.
+		auto allocateDescriptorSets(VkDescriptorSetAllocateInfo &info, VkDescriptorSet *sets) -> void;
+		auto freeDescriptorSets(uint32_t count, const VkDescriptorSet *sets) -> void;
+
+		inline auto &getUniformRing()
+		{
+			return *uniformRing;
+		}
+
 	  protected:
 		const std::string rendererName = "Vulkan-Renderer";
 
 		uint32_t         currentSemaphoreIndex = 0;
 		VkDescriptorPool descriptorPool;
-		VkDescriptorSet  descriptorSetPool[16] = {};
+		std::mutex       descriptorPoolMutex;
+
+		std::unique_ptr<VulkanUniformRing>   uniformRing;
+		std::unique_ptr<VulkanSecondaryPool> secondaryPool;
 	};
 }        // namespace maple
@@ -220,7 +220,9 @@ namespace maple
 		MAPLE_ASSERT(vkCmd->isRecording(), "must recording");
 
 		vkCmdBeginRenderPass(vkCmd->getCommandBuffer(), &info, subPassContentsToVK(contents));
-		commandBuffer->updateViewport(width, height);
+		//only secondary buffers may record into the pass then, they set their own viewport.
+		if (contents == SubPassContents::Inline)
+			commandBuffer->updateViewport(width, height);
 	}
 
 	auto VulkanRenderPass::endRenderPass(CommandBuffer *commandBuffer) -> void
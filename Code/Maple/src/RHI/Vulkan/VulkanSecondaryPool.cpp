@@ -0,0 +1,61 @@
+//////////////////////////////////////////////////////////////////////////////
+// This file is part of the Maple Engine                              		//
+//////////////////////////////////////////////////////////////////////////////
+#include "VulkanSecondaryPool.h"
+#include "Engine/Profiler.h"
+#include "VulkanDevice.h"
+
+namespace maple
+{
+	VulkanSecondaryPool::VulkanSecondaryPool(uint32_t framesInFlight) :
+	    framesInFlight(framesInFlight)
+	{
+	}
+
+	VulkanSecondaryPool::~VulkanSecondaryPool()
+	{
+	}
+
+	auto VulkanSecondaryPool::reset(uint32_t frame) -> void
+	{
+		PROFILE_FUNCTION();
+		std::lock_guard<std::mutex> lock(mutex);
+		currentFrame = frame;
+		for (auto &thread : threads)
+		{
+			auto &pool = (*thread.second)[frame];
+			if (pool.used > 0)
+			{
+				pool.pool->reset();
+				pool.used = 0;
+			}
+		}
+	}
+
+	auto VulkanSecondaryPool::get() -> VulkanCommandBuffer *
+	{
+		PROFILE_FUNCTION();
+		ThreadPool *pool = nullptr;
+		{
+			std::lock_guard<std::mutex> lock(mutex);
+			auto &                      thread = threads[std::this_thread::get_id()];
+			if (thread == nullptr)
+			{
+				thread = std::make_unique<ThreadPools>(framesInFlight);
+				for (auto &frame : *thread)
+				{
+					frame.pool = std::make_unique<VulkanCommandPool>(VulkanDevice::get()->getPhysicalDevice()->getQueueFamilyIndices().graphicsFamily.value(), 0);
+				}
+			}
+			pool = &(*thread)[currentFrame];
+		}
+
+		//only the calling thread touches its own pool from here on.
+		if (pool->used == pool->buffers.size())
+		{
+			auto &buffer = pool->buffers.emplace_back(std::make_unique<VulkanCommandBuffer>());
+			buffer->init(false, pool->pool->getHandle());
+		}
+		return pool->buffers[pool->used++].get();
+	}
+}        // namespace maple
@@ -0,0 +1,50 @@
+//////////////////////////////////////////////////////////////////////////////
+// This file is part of the Maple Engine                              		//
+//////////////////////////////////////////////////////////////////////////////
+#pragma once
+#include "Engine/Core.h"
+#include "VulkanCommandBuffer.h"
+#include "VulkanCommandPool.h"
+
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+namespace maple
+{
+	/**
+	 * secondary command buffers for recording on worker threads. a pool can only be used by one thread at a time,
+	 * so every recording thread owns a command pool per frame in flight, reset once the fence of the frame has signalled.
+	 */
+	class VulkanSecondaryPool
+	{
+	  public:
+		VulkanSecondaryPool(uint32_t framesInFlight);
+		~VulkanSecondaryPool();
+		NO_COPYABLE(VulkanSecondaryPool);
+
+		//the gpu has finished the frame, its buffers can be recorded again.
+		auto reset(uint32_t frame) -> void;
+
+		//a buffer of the calling thread which is not used yet in the current frame. thread safe.
+		auto get() -> VulkanCommandBuffer *;
+
+	  private:
+		struct ThreadPool
+		{
+			std::unique_ptr<VulkanCommandPool>                pool;
+			std::vector<std::unique_ptr<VulkanCommandBuffer>> buffers;        //declared after the pool, they are freed before it is destroyed
+			uint32_t                                          used = 0;
+		};
+
+		//indexed by frame in flight.
+		using ThreadPools = std::vector<ThreadPool>;
+
+		std::unordered_map<std::thread::id, std::unique_ptr<ThreadPools>> threads;
+		std::mutex                                                        mutex;
+		uint32_t                                                          framesInFlight = 0;
+		uint32_t                                                          currentFrame   = 0;
+	};
+}        // namespace maple
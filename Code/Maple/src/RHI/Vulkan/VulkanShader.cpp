@@ -8,6 +8,9 @@
 #include "VulkanCommandBuffer.h"
 #include "VulkanDevice.h"
 #include "VulkanPipeline.h"
+#include "VulkanShaderCache.h"
+#include "Engine/Profiler.h"
+#include <algorithm>
 #include <spirv_cross.hpp>
 
 namespace maple
@@ -134,6 +137,168 @@ namespace maple
 			LOGW("Unknown spirv type!");
 			return ShaderDataType::None;
 		}
+
+		inline auto reflect(const std::vector<uint32_t> &spvCode, ShaderType shaderType) -> ShaderStageReflection
+		{
+			PROFILE_FUNCTION();
+			ShaderStageReflection reflection;
+
+			spirv_cross::Compiler        comp(spvCode.data(), spvCode.size());
+			spirv_cross::ShaderResources resources = comp.get_shader_resources();
+
+			if (shaderType == ShaderType::Vertex)
+			{
+				//Vertex Layout
+
+				for (const spirv_cross::Resource &resource : resources.stage_inputs)
+				{
+					const spirv_cross::SPIRType &InputType = comp.get_type(resource.type_id);
+
+					VkVertexInputAttributeDescription description = {};
+					description.binding                           = comp.get_decoration(resource.id, spv::DecorationBinding);
+					description.location                          = comp.get_decoration(resource.id, spv::DecorationLocation);
+					description.offset                            = reflection.vertexInputStride;
+					description.format                            = getVulkanFormat(InputType);
+					reflection.vertexInputs.emplace_back(description);
+					reflection.vertexInputStride += getStrideFromVulkanFormat(description.format);
+				}
+			}
+
+			//Descriptor Layout
+			for (auto &u : resources.uniform_buffers)
+			{
+				uint32_t set     = comp.get_decoration(u.id, spv::DecorationDescriptorSet);
+				uint32_t binding = comp.get_decoration(u.id, spv::DecorationBinding);
+				auto &   type    = comp.get_type(u.type_id);
+
+				LOGI("Uniform {0} at set = {1}, binding = {2}", u.name, set, binding);
+				reflection.layouts.push_back({DescriptorType::UniformBuffer, shaderType, binding, set, type.array.size() ? uint32_t(type.array[0]) : 1});
+
+				auto &bufferType  = comp.get_type(u.base_type_id);
+				auto  bufferSize  = comp.get_declared_struct_size(bufferType);
+				auto  memberCount = (int32_t) bufferType.member_types.size();
+
+				auto &descriptor      = reflection.descriptors.emplace_back(set, Descriptor{}).second;
+				descriptor.binding    = binding;
+				descriptor.size       = (uint32_t) bufferSize;
+				descriptor.name       = u.name;
+				descriptor.offset     = 0;
+				descriptor.shaderType = shaderType;
+				descriptor.type       = DescriptorType::UniformBuffer;
+				descriptor.buffer     = nullptr;
+
+				for (int32_t i = 0; i < memberCount; i++)
+				{
+					auto        type       = comp.get_type(bufferType.member_types[i]);
+					const auto &memberName = comp.get_member_name(bufferType.self, i);
+					auto        size       = comp.get_declared_struct_member_size(bufferType, i);
+					auto        offset     = comp.type_struct_member_offset(bufferType, i);
+
+					std::string uniformName = u.name + "." + memberName;
+
+					auto &member  = descriptor.members.emplace_back();
+					member.name   = memberName;
+					member.offset = offset;
+					member.size   = (uint32_t) size;
+
+					LOGI("{0} - Size {1}, offset {2}", uniformName, size, offset);
+				}
+			}
+
+			for (auto &u : resources.push_constant_buffers)
+			{
+				uint32_t set      = comp.get_decoration(u.id, spv::DecorationDescriptorSet);
+				uint32_t binding  = comp.get_decoration(u.id, spv::DecorationBinding);
+				uint32_t binding3 = comp.get_decoration(u.id, spv::DecorationOffset);
+
+				auto &type = comp.get_type(u.type_id);
+
+				auto ranges = comp.get_active_buffer_ranges(u.id);
+
+				//members are aligned, the block ends where the last used member does.
+				uint32_t size = 0;
+				for (auto &range : ranges)
+				{
+					LOGI("\tAccessing Member {0} offset {1}, size {2}", range.index, range.offset, range.range);
+					size = std::max(size, uint32_t(range.offset + range.range));
+				}
+
+				LOGI("Push Constant {0} at set = {1}, binding = {2}", u.name.c_str(), set, binding);
+
+				auto &push       = reflection.pushConstants.emplace_back();
+				push.size        = size;
+				push.shaderStage = shaderType;
+				push.data.resize(size);
+				push.name = u.name;
+
+				auto &  bufferType  = comp.get_type(u.base_type_id);
+				auto    bufferSize  = comp.get_declared_struct_size(bufferType);
+				int32_t memberCount = (int32_t) bufferType.member_types.size();
+
+				for (int32_t i = 0; i < memberCount; i++)
+				{
+					auto        type       = comp.get_type(bufferType.member_types[i]);
+					const auto &memberName = comp.get_member_name(bufferType.self, i);
+					auto        size       = comp.get_declared_struct_member_size(bufferType, i);
+					auto        offset     = comp.type_struct_member_offset(bufferType, i);
+
+					std::string uniformName = u.name + "." + memberName;
+
+					auto &member    = push.members.emplace_back();
+					member.size     = (uint32_t) size;
+					member.offset   = offset;
+					member.type     = sprivTypeToDataType(type);
+					member.fullName = uniformName;
+					member.name     = memberName;
+				}
+			}
+
+			for (auto &u : resources.sampled_images)
+			{
+				uint32_t set     = comp.get_decoration(u.id, spv::DecorationDescriptorSet);
+				uint32_t binding = comp.get_decoration(u.id, spv::DecorationBinding);
+
+				auto &descriptor = reflection.descriptors.emplace_back(set, Descriptor{}).second;
+
+				auto &type = comp.get_type(u.type_id);
+				LOGI("Found Sampled Image {0} at set = {1}, binding = {2}", u.name.c_str(), set, binding);
+
+				//a runtime sized array (uniform sampler2D name[]) has a count of 0, its size is decided by the device.
+				reflection.layouts.push_back({DescriptorType::ImageSampler, shaderType, binding, set, type.array.size() ? uint32_t(type.array[0]) : 1});
+				descriptor.binding    = binding;
+				descriptor.name       = u.name;
+				descriptor.offset     = 0;
+				descriptor.size       = 0;
+				descriptor.shaderType = shaderType;
+			}
+
+			for (auto &u : resources.storage_buffers)
+			{
+				uint32_t set     = comp.get_decoration(u.id, spv::DecorationDescriptorSet);
+				uint32_t binding = comp.get_decoration(u.id, spv::DecorationBinding);
+
+				LOGI("Storage Buffer {0} at set = {1}, binding = {2}", u.name, set, binding);
+				reflection.layouts.push_back({DescriptorType::StorageBuffer, shaderType, binding, set, 1});
+
+				auto &descriptor      = reflection.descriptors.emplace_back(set, Descriptor{}).second;
+				descriptor.binding    = binding;
+				descriptor.name       = u.name;
+				descriptor.offset     = 0;
+				descriptor.size       = (uint32_t) comp.get_declared_struct_size(comp.get_type(u.base_type_id));
+				descriptor.shaderType = shaderType;
+				descriptor.type       = DescriptorType::StorageBuffer;
+			}
+
+			if (shaderType == ShaderType::Compute)
+			{
+				for (uint32_t i = 0; i < 3; i++)
+				{
+					reflection.localSize[i] = comp.get_execution_mode_argument(spv::ExecutionMode::ExecutionModeLocalSize, i);
+				}
+			}
+
+			return reflection;
+		}
 	}        // namespace
 
 	VulkanShader::VulkanShader(const std::string &path) :
@@ -159,6 +324,11 @@ namespace maple
 	}
 
 	auto VulkanShader::bindPushConstants(CommandBuffer *cmdBuffer, Pipeline *pipeline) -> void
+	{
+		bindPushConstants(cmdBuffer, pipeline, pushConstants);
+	}
+
+	auto VulkanShader::bindPushConstants(CommandBuffer *cmdBuffer, Pipeline *pipeline, const std::vector<PushConstant> &pushConstants) -> void
 	{
 		uint32_t index = 0;
 		for (auto &pc : pushConstants)
@@ -204,6 +374,7 @@ namespace maple
 	auto VulkanShader::createPipelineLayout() -> void
 	{
 		std::vector<std::vector<DescriptorLayoutInfo>> layouts;
+		uint32_t                                       uniformBlocks = 0;
 
 		for (auto &descriptorLayout : descriptorLayoutInfo)
 		{
@@ -212,6 +383,13 @@ namespace maple
 				layouts.emplace_back();
 			}
 			layouts[descriptorLayout.setID].emplace_back(descriptorLayout);
+			if (descriptorLayout.type == DescriptorType::UniformBuffer)
+				uniformBlocks++;
+		}
+
+		if (uniformBlocks > VulkanDevice::get()->getPhysicalDevice()->getProperties().limits.maxDescriptorSetUniformBuffersDynamic)
+		{
+			LOGE("{0} uses {1} uniform blocks, the device only supports {2} dynamic ones", name, uniformBlocks, VulkanDevice::get()->getPhysicalDevice()->getProperties().limits.maxDescriptorSetUniformBuffersDynamic);
 		}
 
 		for (auto &l : layouts)
@@ -225,13 +403,14 @@ namespace maple
 			{
 				auto &info = l[i];
 
+				//uniform blocks live in the per frame ring and are bound with dynamic offsets.
 				VkDescriptorSetLayoutBinding setLayoutBinding{};
-				setLayoutBinding.descriptorType  = VkConverter::descriptorTypeToVK(info.type);
+				setLayoutBinding.descriptorType  = info.type == DescriptorType::UniformBuffer ? VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC : VkConverter::descriptorTypeToVK(info.type);
 				setLayoutBinding.stageFlags      = VkConverter::shaderTypeToVK(info.stage);
 				setLayoutBinding.binding         = info.binding;
-				setLayoutBinding.descriptorCount = info.count;
+				setLayoutBinding.descriptorCount = info.count > 0 ? info.count : VulkanDevice::get()->getBindlessTextureCount();
 
-				bool isArray = info.count > 1;
+				bool isArray = setLayoutBinding.descriptorCount > 1;
 				layoutBindingFlags.emplace_back(isArray ? VK_DESCRIPTOR_BINDING_PARTIALLY_BOUND_BIT : 0);
 				setLayoutBindings.emplace_back(setLayoutBinding);
 			}
@@ -294,134 +473,39 @@ namespace maple
 		shaderCreateInfo.pCode    = spvCode.data();
 		shaderCreateInfo.pNext    = VK_NULL_HANDLE;
 
-		spirv_cross::Compiler        comp(spvCode.data(), spvCode.size());
-		spirv_cross::ShaderResources resources = comp.get_shader_resources();
-
-		if (shaderType == ShaderType::Vertex)
+		//reflection results only depend on the SPIR-V, they are taken from the cache when the stage was seen before.
+		const auto            key = ShaderCache::getKey(spvCode, shaderType);
+		ShaderStageReflection reflection;
+		if (!ShaderCache::load(key, reflection))
 		{
-			//Vertex Layout
-			vertexInputStride = 0;
-
-			for (const spirv_cross::Resource &resource : resources.stage_inputs)
-			{
-				const spirv_cross::SPIRType &InputType = comp.get_type(resource.type_id);
-
-				VkVertexInputAttributeDescription description = {};
-				description.binding                           = comp.get_decoration(resource.id, spv::DecorationBinding);
-				description.location                          = comp.get_decoration(resource.id, spv::DecorationLocation);
-				description.offset                            = vertexInputStride;
-				description.format                            = getVulkanFormat(InputType);
-				vertexInputAttributeDescriptions.emplace_back(description);
-				vertexInputStride += getStrideFromVulkanFormat(description.format);
-			}
+			reflection = reflect(spvCode, shaderType);
+			ShaderCache::save(key, reflection);
 		}
 
-		//Descriptor Layout
-		for (auto &u : resources.uniform_buffers)
+		if (shaderType == ShaderType::Vertex)
 		{
-			uint32_t set     = comp.get_decoration(u.id, spv::DecorationDescriptorSet);
-			uint32_t binding = comp.get_decoration(u.id, spv::DecorationBinding);
-			auto &   type    = comp.get_type(u.type_id);
-
-			LOGI("Uniform {0} at set = {1}, binding = {2}", u.name, set, binding);
-			descriptorLayoutInfo.push_back({DescriptorType::UniformBuffer, shaderType, binding, set, type.array.size() ? uint32_t(type.array[0]) : 1});
-
-			auto &bufferType  = comp.get_type(u.base_type_id);
-			auto  bufferSize  = comp.get_declared_struct_size(bufferType);
-			auto  memberCount = (int32_t) bufferType.member_types.size();
-
-			auto &descriptorInfo  = descriptorInfos[set];
-			auto &descriptor      = descriptorInfo.emplace_back();
-			descriptor.binding    = binding;
-			descriptor.size       = (uint32_t) bufferSize;
-			descriptor.name       = u.name;
-			descriptor.offset     = 0;
-			descriptor.shaderType = shaderType;
-			descriptor.type       = DescriptorType::UniformBuffer;
-			descriptor.buffer     = nullptr;
-
-			for (int32_t i = 0; i < memberCount; i++)
-			{
-				auto        type       = comp.get_type(bufferType.member_types[i]);
-				const auto &memberName = comp.get_member_name(bufferType.self, i);
-				auto        size       = comp.get_declared_struct_member_size(bufferType, i);
-				auto        offset     = comp.type_struct_member_offset(bufferType, i);
-
-				std::string uniformName = u.name + "." + memberName;
-
-				auto &member  = descriptor.members.emplace_back();
-				member.name   = memberName;
-				member.offset = offset;
-				member.size   = (uint32_t) size;
-
-				LOGI("{0} - Size {1}, offset {2}", uniformName, size, offset);
-			}
+			vertexInputStride                = reflection.vertexInputStride;
+			vertexInputAttributeDescriptions = std::move(reflection.vertexInputs);
 		}
 
-		for (auto &u : resources.push_constant_buffers)
+		if (shaderType == ShaderType::Compute)
 		{
-			uint32_t set      = comp.get_decoration(u.id, spv::DecorationDescriptorSet);
-			uint32_t binding  = comp.get_decoration(u.id, spv::DecorationBinding);
-			uint32_t binding3 = comp.get_decoration(u.id, spv::DecorationOffset);
-
-			auto &type = comp.get_type(u.type_id);
-
-			auto ranges = comp.get_active_buffer_ranges(u.id);
-
-			uint32_t size = 0;
-			for (auto &range : ranges)
-			{
-				LOGI("\tAccessing Member {0} offset {1}, size {2}", range.index, range.offset, range.range);
-				size += uint32_t(range.range);
-			}
-
-			LOGI("Push Constant {0} at set = {1}, binding = {2}", u.name.c_str(), set, binding);
-
-			auto &push       = pushConstants.emplace_back();
-			push.size        = size;
-			push.shaderStage = shaderType;
-			push.data.resize(size);
-			push.name = u.name;
+			computeShader = true;
+			localSizeX    = reflection.localSize[0];
+			localSizeY    = reflection.localSize[1];
+			localSizeZ    = reflection.localSize[2];
+		}
 
-			auto &  bufferType  = comp.get_type(u.base_type_id);
-			auto    bufferSize  = comp.get_declared_struct_size(bufferType);
-			int32_t memberCount = (int32_t) bufferType.member_types.size();
+		descriptorLayoutInfo.insert(descriptorLayoutInfo.end(), reflection.layouts.begin(), reflection.layouts.end());
 
-			for (int32_t i = 0; i < memberCount; i++)
-			{
-				auto        type       = comp.get_type(bufferType.member_types[i]);
-				const auto &memberName = comp.get_member_name(bufferType.self, i);
-				auto        size       = comp.get_declared_struct_member_size(bufferType, i);
-				auto        offset     = comp.type_struct_member_offset(bufferType, i);
-
-				std::string uniformName = u.name + "." + memberName;
-
-				auto &member    = push.members.emplace_back();
-				member.size     = (uint32_t) size;
-				member.offset   = offset;
-				member.type     = sprivTypeToDataType(type);
-				member.fullName = uniformName;
-				member.name     = memberName;
-			}
+		for (auto &[set, descriptor] : reflection.descriptors)
+		{
+			descriptorInfos[set].emplace_back(std::move(descriptor));
 		}
 
-		for (auto &u : resources.sampled_images)
+		for (auto &push : reflection.pushConstants)
 		{
-			uint32_t set     = comp.get_decoration(u.id, spv::DecorationDescriptorSet);
-			uint32_t binding = comp.get_decoration(u.id, spv::DecorationBinding);
-
-			auto &descriptorInfo = descriptorInfos[set];
-			auto &descriptor     = descriptorInfo.emplace_back();
-
-			auto &type = comp.get_type(u.type_id);
-			LOGI("Found Sampled Image {0} at set = {1}, binding = {2}", u.name.c_str(), set, binding);
-
-			descriptorLayoutInfo.push_back({DescriptorType::ImageSampler, shaderType, binding, set, type.array.size() ? uint32_t(type.array[0]) : 1});
-			descriptor.binding    = binding;
-			descriptor.name       = u.name;
-			descriptor.offset     = 0;
-			descriptor.size       = 0;
-			descriptor.shaderType = shaderType;
+			pushConstants.emplace_back(std::move(push));
 		}
 
 		shaderStages[currentShaderStage].sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO;
@@ -22,6 +22,7 @@ namespace maple
 		~VulkanShader();
 		NO_COPYABLE(VulkanShader);
 		auto bindPushConstants(CommandBuffer *commandBuffer, Pipeline *pipeline) -> void override;
+		auto bindPushConstants(CommandBuffer *commandBuffer, Pipeline *pipeline, const std::vector<PushConstant> &pushConstants) -> void override;
 
 		auto bind() const -> void override{};
 		auto unbind() const -> void override{};
@@ -0,0 +1,301 @@
+//////////////////////////////////////////////////////////////////////////////
+// This file is part of the Maple Engine                              		//
+//////////////////////////////////////////////////////////////////////////////
+#include "VulkanShaderCache.h"
+#include "Engine/Profiler.h"
+#include "Others/Console.h"
+#include "Others/HashCode.h"
+
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <thread>
+
+namespace maple
+{
+	namespace ShaderCache
+	{
+		namespace
+		{
+			constexpr const char *CACHE_FOLDER = "cache/shaders";
+
+			inline auto getCacheFile(uint64_t key) -> std::string
+			{
+				char name[32];
+				snprintf(name, sizeof(name), "%016llx.refl", static_cast<unsigned long long>(key));
+				return std::string(CACHE_FOLDER) + "/" + name;
+			}
+
+			class Writer
+			{
+			  public:
+				template <typename T>
+				inline auto write(const T &value)
+				{
+					static_assert(std::is_trivially_copyable<T>::value, "only plain data can be written");
+					write(&value, sizeof(T));
+				}
+
+				inline auto write(const void *data, size_t size) -> void
+				{
+					auto bytes = static_cast<const uint8_t *>(data);
+					buffer.insert(buffer.end(), bytes, bytes + size);
+				}
+
+				inline auto write(const std::string &str) -> void
+				{
+					write(static_cast<uint32_t>(str.size()));
+					write(str.data(), str.size());
+				}
+
+				inline auto write(const std::vector<BufferMemberInfo> &members) -> void
+				{
+					write(static_cast<uint32_t>(members.size()));
+					for (auto &member : members)
+					{
+						write(member.size);
+						write(member.offset);
+						write(member.type);
+						write(member.name);
+						write(member.fullName);
+					}
+				}
+
+				inline auto &getBuffer() const
+				{
+					return buffer;
+				}
+
+			  private:
+				std::vector<uint8_t> buffer;
+			};
+
+			class Reader
+			{
+			  public:
+				Reader(const uint8_t *data, size_t size) :
+				    data(data), size(size)
+				{
+				}
+
+				template <typename T>
+				inline auto read() -> T
+				{
+					T value{};
+					if (auto ptr = read(sizeof(T)))
+						memcpy(&value, ptr, sizeof(T));
+					return value;
+				}
+
+				inline auto read(size_t bytes) -> const uint8_t *
+				{
+					if (!valid || offset + bytes > size)
+					{
+						valid = false;
+						return nullptr;
+					}
+					auto ptr = data + offset;
+					offset += bytes;
+					return ptr;
+				}
+
+				inline auto readString() -> std::string
+				{
+					const auto length = read<uint32_t>();
+					auto       ptr    = read(length);
+					return ptr != nullptr ? std::string(reinterpret_cast<const char *>(ptr), length) : std::string{};
+				}
+
+				//counts come from the file, a broken one must not make us allocate gigabytes.
+				inline auto readCount() -> uint32_t
+				{
+					const auto count = read<uint32_t>();
+					if (count > size - offset)
+						valid = false;
+					return valid ? count : 0;
+				}
+
+				inline auto readMembers(std::vector<BufferMemberInfo> &members) -> void
+				{
+					members.resize(readCount());
+					for (auto &member : members)
+					{
+						member.size     = read<uint32_t>();
+						member.offset   = read<uint32_t>();
+						member.type     = read<ShaderDataType>();
+						member.name     = readString();
+						member.fullName = readString();
+					}
+				}
+
+				inline auto isValid() const
+				{
+					return valid && offset == size;
+				}
+
+			  private:
+				const uint8_t *data;
+				size_t         size;
+				size_t         offset = 0;
+				bool           valid  = true;
+			};
+
+			struct Header
+			{
+				uint32_t magic;
+				uint32_t version;
+				uint64_t key;
+			};
+		}        // namespace
+
+		auto getKey(const std::vector<uint32_t> &spvCode, ShaderType type) -> uint64_t
+		{
+			auto key = HashCode::hashBytes(spvCode.data(), spvCode.size() * sizeof(uint32_t));
+			return key ^ (static_cast<uint64_t>(type) + 1) * 0x9e3779b97f4a7c15ull;
+		}
+
+		auto load(uint64_t key, ShaderStageReflection &reflection) -> bool
+		{
+			PROFILE_FUNCTION();
+			std::vector<uint8_t> bytes;
+			{
+				std::ifstream file(getCacheFile(key), std::ios::binary | std::ios::ate);
+				if (!file)
+					return false;
+				bytes.resize(static_cast<size_t>(file.tellg()));
+				file.seekg(0);
+				file.read(reinterpret_cast<char *>(bytes.data()), bytes.size());
+			}
+
+			Reader reader(bytes.data(), bytes.size());
+			const auto header = reader.read<Header>();
+			if (header.magic != MAGIC || header.version != VERSION || header.key != key)
+				return false;
+
+			reflection.vertexInputStride = reader.read<uint32_t>();
+			reflection.vertexInputs.resize(reader.readCount());
+			for (auto &input : reflection.vertexInputs)
+			{
+				input = reader.read<VkVertexInputAttributeDescription>();
+			}
+
+			reflection.layouts.resize(reader.readCount());
+			for (auto &layout : reflection.layouts)
+			{
+				layout = reader.read<DescriptorLayoutInfo>();
+			}
+
+			reflection.descriptors.resize(reader.readCount());
+			for (auto &[set, descriptor] : reflection.descriptors)
+			{
+				set                   = reader.read<uint32_t>();
+				descriptor.binding    = reader.read<uint32_t>();
+				descriptor.size       = reader.read<uint32_t>();
+				descriptor.offset     = reader.read<uint32_t>();
+				descriptor.type       = reader.read<DescriptorType>();
+				descriptor.shaderType = reader.read<ShaderType>();
+				descriptor.name       = reader.readString();
+				reader.readMembers(descriptor.members);
+			}
+
+			reflection.pushConstants.resize(reader.readCount());
+			for (auto &push : reflection.pushConstants)
+			{
+				push.size        = reader.read<uint32_t>();
+				push.offset      = reader.read<uint32_t>();
+				push.shaderStage = reader.read<ShaderType>();
+				push.name        = reader.readString();
+				reader.readMembers(push.members);
+			}
+
+			for (auto &size : reflection.localSize)
+			{
+				size = reader.read<uint32_t>();
+			}
+
+			if (!reader.isValid())
+			{
+				LOGW("ShaderCache : {0} is broken", getCacheFile(key));
+				reflection = {};
+				return false;
+			}
+
+			for (auto &push : reflection.pushConstants)
+			{
+				push.data.resize(push.size);
+			}
+			return true;
+		}
+
+		auto save(uint64_t key, const ShaderStageReflection &reflection) -> bool
+		{
+			PROFILE_FUNCTION();
+			Writer writer;
+			writer.write(Header{MAGIC, VERSION, key});
+
+			writer.write(reflection.vertexInputStride);
+			writer.write(static_cast<uint32_t>(reflection.vertexInputs.size()));
+			for (auto &input : reflection.vertexInputs)
+			{
+				writer.write(input);
+			}
+
+			writer.write(static_cast<uint32_t>(reflection.layouts.size()));
+			for (auto &layout : reflection.layouts)
+			{
+				writer.write(layout);
+			}
+
+			writer.write(static_cast<uint32_t>(reflection.descriptors.size()));
+			for (auto &[set, descriptor] : reflection.descriptors)
+			{
+				writer.write(set);
+				writer.write(descriptor.binding);
+				writer.write(descriptor.size);
+				writer.write(descriptor.offset);
+				writer.write(descriptor.type);
+				writer.write(descriptor.shaderType);
+				writer.write(descriptor.name);
+				writer.write(descriptor.members);
+			}
+
+			writer.write(static_cast<uint32_t>(reflection.pushConstants.size()));
+			for (auto &push : reflection.pushConstants)
+			{
+				writer.write(push.size);
+				writer.write(push.offset);
+				writer.write(push.shaderStage);
+				writer.write(push.name);
+				writer.write(push.members);
+			}
+
+			for (auto size : reflection.localSize)
+			{
+				writer.write(size);
+			}
+
+			//shaders are loaded in parallel, two of them sharing a stage write the same entry at once.
+			const auto      path = getCacheFile(key);
+			const auto      temp = path + "." + std::to_string(std::hash<std::thread::id>{}(std::this_thread::get_id())) + ".tmp";
+			std::error_code error;
+			std::filesystem::create_directories(CACHE_FOLDER, error);
+			{
+				std::ofstream file(temp, std::ios::binary | std::ios::trunc);
+				if (!file)
+				{
+					LOGW("ShaderCache : can not write {0}", temp);
+					return false;
+				}
+				file.write(reinterpret_cast<const char *>(writer.getBuffer().data()), writer.getBuffer().size());
+			}
+			std::filesystem::remove(path, error);
+			std::filesystem::rename(temp, path, error);
+			if (error)
+			{
+				std::filesystem::remove(temp, error);
+				return false;
+			}
+			return true;
+		}
+	};        // namespace ShaderCache
+};            // namespace maple
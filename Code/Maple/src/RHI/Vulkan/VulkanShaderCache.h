@@ -0,0 +1,43 @@
+//////////////////////////////////////////////////////////////////////////////
+// This file is part of the Maple Engine                              		//
+//////////////////////////////////////////////////////////////////////////////
+#pragma once
+#include "RHI/DescriptorSet.h"
+#include "RHI/Shader.h"
+#include "VulkanHelper.h"
+
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+namespace maple
+{
+	//everything VulkanShader takes from the reflection of one SPIR-V stage, in the order spirv_cross reports it.
+	struct ShaderStageReflection
+	{
+		uint32_t                                       vertexInputStride = 0;
+		std::vector<VkVertexInputAttributeDescription> vertexInputs;
+		std::vector<DescriptorLayoutInfo>              layouts;
+		std::vector<std::pair<uint32_t, Descriptor>>   descriptors;        //set, descriptor without resources
+		std::vector<PushConstant>                      pushConstants;
+		uint32_t                                       localSize[3] = {1, 1, 1};        //compute stages only
+	};
+
+	/**
+	 * reflection results stored in cache/shaders and keyed by a hash of the SPIR-V of the stage, running spirv_cross
+	 * over every stage is what shader loading spends its time on. stages shared by several shaders share one entry.
+	 */
+	namespace ShaderCache
+	{
+		static constexpr uint32_t MAGIC   = 0x46524853;        //SHRF
+		static constexpr uint32_t VERSION = 3;
+
+		auto getKey(const std::vector<uint32_t> &spvCode, ShaderType type) -> uint64_t;
+
+		//false if there is no valid entry.
+		auto load(uint64_t key, ShaderStageReflection &reflection) -> bool;
+
+		//may be called from several threads, also for the same key.
+		auto save(uint64_t key, const ShaderStageReflection &reflection) -> bool;
+	};        // namespace ShaderCache
+};            // namespace maple
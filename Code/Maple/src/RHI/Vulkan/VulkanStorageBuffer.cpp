@@ -0,0 +1,65 @@
+//////////////////////////////////////////////////////////////////////////////
+// This file is part of the Maple Engine                              		//
+//////////////////////////////////////////////////////////////////////////////
+#include "VulkanStorageBuffer.h"
+#include "Engine/Profiler.h"
+#include "RHI/SwapChain.h"
+
+#include "Application.h"
+
+#include <cstring>
+
+namespace maple
+{
+	VulkanStorageBuffer::VulkanStorageBuffer()
+	{
+		frames.resize(Application::getGraphicsContext()->getSwapChain()->getSwapChainBufferCount());
+	}
+
+	VulkanStorageBuffer::~VulkanStorageBuffer()
+	{
+	}
+
+	auto VulkanStorageBuffer::setData(uint32_t size, const void *data) -> void
+	{
+		PROFILE_FUNCTION();
+		if (size > localStorage.size())
+			localStorage.resize(size);
+		memcpy(localStorage.data(), data, size);
+		version++;
+	}
+
+	auto VulkanStorageBuffer::prepare(uint32_t frame) -> bool
+	{
+		PROFILE_FUNCTION();
+		auto &current = frames[frame];
+		if (current.version == version || localStorage.empty())
+			return false;
+
+		bool created = false;
+		if (current.capacity < localStorage.size())
+		{
+			//released buffers go through the deletion queue, the other frames may still read them.
+			//compute passes write draw arguments into storage buffers, any of them may be read by an indirect draw.
+			current.buffer   = std::make_unique<VulkanBuffer>(VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_INDIRECT_BUFFER_BIT, static_cast<uint32_t>(localStorage.size()), nullptr);
+			current.capacity = static_cast<uint32_t>(localStorage.size());
+			created          = true;
+		}
+
+		current.buffer->setVkData(static_cast<uint32_t>(localStorage.size()), localStorage.data());
+		current.version = version;
+		return created;
+	}
+
+	auto VulkanStorageBuffer::getBufferInfo(uint32_t frame) const -> VkDescriptorBufferInfo
+	{
+		VkDescriptorBufferInfo info{};
+		if (auto &buffer = frames[frame].buffer)
+		{
+			info.buffer = buffer->getVkBuffer();
+			info.offset = 0;
+			info.range  = VK_WHOLE_SIZE;
+		}
+		return info;
+	}
+};        // namespace maple
@@ -0,0 +1,49 @@
+//////////////////////////////////////////////////////////////////////////////
+// This file is part of the Maple Engine                              		//
+//////////////////////////////////////////////////////////////////////////////
+#pragma once
+#include "RHI/StorageBuffer.h"
+#include "VulkanBuffer.h"
+
+#include <memory>
+#include <vector>
+
+namespace maple
+{
+	//one host visible buffer per frame in flight, a frame copies the latest data into its own buffer when it binds it.
+	class VulkanStorageBuffer final : public StorageBuffer
+	{
+	  public:
+		VulkanStorageBuffer();
+		~VulkanStorageBuffer();
+		NO_COPYABLE(VulkanStorageBuffer);
+
+		auto setData(uint32_t size, const void *data) -> void override;
+
+		inline auto getSize() const -> uint32_t override
+		{
+			return static_cast<uint32_t>(localStorage.size());
+		}
+
+		//brings the buffer of the frame up to date, true if it was created again and the descriptors pointing to it are stale.
+		auto prepare(uint32_t frame) -> bool;
+		auto getBufferInfo(uint32_t frame) const -> VkDescriptorBufferInfo;
+
+		inline auto getVkBuffer(uint32_t frame) const -> VkBuffer
+		{
+			return frames[frame].buffer ? frames[frame].buffer->getVkBuffer() : VK_NULL_HANDLE;
+		}
+
+	  private:
+		struct FrameBuffer
+		{
+			std::unique_ptr<VulkanBuffer> buffer;
+			uint32_t                      capacity = 0;
+			uint64_t                      version  = 0;
+		};
+
+		std::vector<uint8_t>     localStorage;
+		uint64_t                 version = 1;
+		std::vector<FrameBuffer> frames;
+	};
+};        // namespace maple
@@ -423,6 +423,8 @@ namespace maple
 		{
 			init(vsync);
 		}
+		//pipelines drawing to the swapchain hold a framebuffer per image.
+		Texture::invalidateTargets();
 	}
 
 };        // namespace maple
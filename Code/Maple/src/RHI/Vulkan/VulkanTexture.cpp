@@ -5,6 +5,7 @@
 #include "VulkanTexture.h"
 #include "FileSystem/Image.h"
 #include "Loaders/ImageLoader.h"
+#include "Loaders/Loader.h"
 #include "Others/Console.h"
 #include "Others/StringUtils.h"
 #include "VulkanBuffer.h"
@@ -13,6 +14,7 @@
 #include "VulkanDevice.h"
 #include "VulkanFrameBuffer.h"
 #include "VulkanSwapChain.h"
+#include "VulkanUploader.h"
 
 #include "Application.h"
 #include <cassert>
@@ -157,6 +159,9 @@ namespace maple
 					return 1;
 				case TextureFormat::RG8:
 					return 2;
+				case TextureFormat::RG16F:
+				case TextureFormat::RG16:
+					return 4;
 				case TextureFormat::RGB8:
 				case TextureFormat::RGB:
 					return 3;
@@ -179,8 +184,29 @@ namespace maple
 					return 0;
 				case TextureFormat::SCREEN:
 					return 0;
+				case TextureFormat::BC1:        //bytes of a 4x4 block
+					return 8;
+				case TextureFormat::BC3:
+					return 16;
 			}
 		}
+
+		inline auto isCompressionSupported()
+		{
+			static const bool supported = [] {
+				VkPhysicalDeviceFeatures features;
+				vkGetPhysicalDeviceFeatures(*VulkanDevice::get()->getPhysicalDevice(), &features);
+				return features.textureCompressionBC == VK_TRUE;
+			}();
+			return supported;
+		}
+
+		inline auto loadImage(const std::string &fileName, const TextureLoadOptions &loadOptions)
+		{
+			if (loadOptions.compressed && isCompressionSupported())
+				return maple::ImageLoader::loadCompressed(fileName, loadOptions.flipY);
+			return maple::ImageLoader::loadAsset(fileName);
+		}
 	}        // namespace
 
 	VulkanTexture2D::VulkanTexture2D(uint32_t width, uint32_t height, const void *data, TextureParameters parameters, TextureLoadOptions loadOptions) :
@@ -192,6 +218,19 @@ namespace maple
 	{
 		vkFormat = VkConverter::textureFormatToVK(parameters.format, parameters.srgb);
 
+		if (AssetsLoaderFactory::isLoadingThread() && data != nullptr)
+		{
+			//the caller's pixels do not outlive the loader, keep a copy until the upload step runs.
+			const auto                bytes = static_cast<const uint8_t *>(data);
+			const std::vector<uint8_t> pixels(bytes, bytes + getFormatSize(parameters.format) * width * height);
+			this->data = nullptr;
+			AssetsLoaderFactory::deferUpload(lifetime, [this, pixels]() {
+				buildTexture(this->parameters.format, this->width, this->height, this->parameters.srgb, false, false, this->loadOptions.generateMipMaps, false, 0);
+				update(0, 0, this->width, this->height, pixels.data());
+			});
+			return;
+		}
+
 		buildTexture(parameters.format, width, height, parameters.srgb, false, false, loadOptions.generateMipMaps, false, 0);
 		update(0, 0, width, height, data);
 	}
@@ -201,7 +240,21 @@ namespace maple
 	    loadOptions(loadOptions),
 	    fileName(fileName)
 	{
-		this->name  = name;
+		this->name = name;
+		if (AssetsLoaderFactory::isLoadingThread())
+		{
+			//decoded on the loading thread, the image is created by the upload step.
+			std::shared_ptr<maple::Image> image = loadImage(fileName, loadOptions);
+			width                               = image->getWidth();
+			height                              = image->getHeight();
+			AssetsLoaderFactory::deferUpload(lifetime, [this, image]() {
+				deleteImage = load(image.get());
+				if (deleteImage)
+					createSampler();
+			});
+			return;
+		}
+
 		deleteImage = load();
 		if (!deleteImage)
 			return;
@@ -250,31 +303,46 @@ namespace maple
 
 	auto VulkanTexture2D::update(int32_t x, int32_t y, int32_t w, int32_t h, const void *buffer) -> void
 	{
-		auto stagingBuffer = std::make_unique<VulkanBuffer>(VK_BUFFER_USAGE_TRANSFER_SRC_BIT, w * h * getFormatSize(parameters.format), buffer);
-		auto oldLayout     = imageLayout;
-		transitionImage(VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL);
-		VulkanHelper::copyBufferToImage(stagingBuffer->getVkBuffer(), textureImage, static_cast<uint32_t>(w), static_cast<uint32_t>(h), x, y);
-		transitionImage(oldLayout);
+		PROFILE_FUNCTION();
+		//only mip 0 is updated, the image goes back to the layout it was sampled in.
+		const auto texelSize = getFormatSize(parameters.format);
+		const auto format    = VkConverter::textureFormatToVK(parameters.format, parameters.srgb);
+		const auto newLayout = imageLayout == VK_IMAGE_LAYOUT_UNDEFINED ? VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL : imageLayout;
+		VulkanDevice::get()->getUploader()->uploadImage(textureImage, imageLayout, mipLevels, buffer, w * h * texelSize, texelSize,
+		                                                static_cast<uint32_t>(w), static_cast<uint32_t>(h), x, y,
+		                                                [&](VkCommandBuffer cmd) {
+			                                                VulkanHelper::transitionImageLayout(textureImage, format, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, newLayout, mipLevels, 1, cmd, false);
+		                                                });
+		imageLayout = newLayout;
+		updateDescriptor();
 	}
 
 	auto VulkanTexture2D::load() -> bool
+	{
+		std::unique_ptr<maple::Image> image;
+		if (data == nullptr && fileName != "")
+			image = loadImage(fileName, loadOptions);
+		return load(image.get());
+	}
+
+	auto VulkanTexture2D::load(const maple::Image *image) -> bool
 	{
 		PROFILE_FUNCTION();
+		if (data == nullptr && image != nullptr && image->isCompressed())
+			return loadLevels(image);
+
 		auto imageSize = getFormatSize(parameters.format) * width * height;
 
 		const uint8_t *pixel = nullptr;
 
-		std::unique_ptr<maple::Image> image;
-
 		if (data != nullptr)
 		{
 			pixel = data;
 			//imageSize         = width * height * 4;
 			//parameters.format = TextureFormat::RGBA8;
 		}
-		else if (fileName != "")
+		else if (image != nullptr)
 		{
-			image             = maple::ImageLoader::loadAsset(fileName);
 			width             = image->getWidth();
 			height            = image->getHeight();
 			imageSize         = image->getImageSize();
@@ -295,19 +363,61 @@ namespace maple
 #else
 		VulkanHelper::createImage(width, height, mipLevels, VkConverter::textureFormatToVK(parameters.format, parameters.srgb), VK_IMAGE_TYPE_2D, VK_IMAGE_TILING_OPTIMAL, VK_IMAGE_USAGE_TRANSFER_SRC_BIT | VK_IMAGE_USAGE_TRANSFER_DST_BIT | VK_IMAGE_USAGE_SAMPLED_BIT, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, textureImage, textureImageMemory, 1, 0);
 #endif
-		VulkanHelper::transitionImageLayout(textureImage, VkConverter::textureFormatToVK(parameters.format, parameters.srgb),
-		                                    VK_IMAGE_LAYOUT_UNDEFINED,
-		                                    VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
-		                                    mipLevels, 1, nullptr, false);
+		//the copy is batched with the other uploads of the frame, mips are generated on the graphics queue right behind it.
+		const auto format = VkConverter::textureFormatToVK(parameters.format, parameters.srgb);
+		VulkanDevice::get()->getUploader()->uploadImage(textureImage, VK_IMAGE_LAYOUT_UNDEFINED, mipLevels, pixel, imageSize, getFormatSize(parameters.format),
+		                                                width, height, 0, 0,
+		                                                [&](VkCommandBuffer cmd) {
+			                                                if (mipLevels > 1)
+				                                                generateMipmaps(textureImage, format, width, height, mipLevels, 1, cmd);
+			                                                else
+				                                                VulkanHelper::transitionImageLayout(textureImage, format, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL, 1, 1, cmd, false);
+		                                                });
 
-		auto stagingBuffer = std::make_unique<VulkanBuffer>(VK_BUFFER_USAGE_TRANSFER_SRC_BIT, imageSize, pixel);
-		VulkanHelper::copyBufferToImage(stagingBuffer->getVkBuffer(), textureImage, static_cast<uint32_t>(width), static_cast<uint32_t>(height));
+		imageLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+		updateDescriptor();
 
-		if (loadOptions.generateMipMaps && mipLevels > 1)
-			generateMipmaps(textureImage, VkConverter::textureFormatToVK(parameters.format, parameters.srgb), width, height, mipLevels);
+		return true;
+	}
 
-		transitionImage(VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL);
+	auto VulkanTexture2D::loadLevels(const maple::Image *image) -> bool
+	{
+		PROFILE_FUNCTION();
+		width             = image->getWidth();
+		height            = image->getHeight();
+		parameters.format = image->getPixelFormat();
+		vkFormat          = VkConverter::textureFormatToVK(parameters.format, parameters.srgb);
+		//the cooked chain is used as it is, nothing is blitted.
+		mipLevels = loadOptions.generateMipMaps ? static_cast<uint32_t>(image->getMips().size()) : 1;
+
+#ifdef USE_VMA_ALLOCATOR
+		VulkanHelper::createImage(width, height, mipLevels, vkFormat, VK_IMAGE_TYPE_2D, VK_IMAGE_TILING_OPTIMAL, VK_IMAGE_USAGE_TRANSFER_SRC_BIT | VK_IMAGE_USAGE_TRANSFER_DST_BIT | VK_IMAGE_USAGE_SAMPLED_BIT, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, textureImage, textureImageMemory, 1, 0, allocation);
+#else
+		VulkanHelper::createImage(width, height, mipLevels, vkFormat, VK_IMAGE_TYPE_2D, VK_IMAGE_TILING_OPTIMAL, VK_IMAGE_USAGE_TRANSFER_SRC_BIT | VK_IMAGE_USAGE_TRANSFER_DST_BIT | VK_IMAGE_USAGE_SAMPLED_BIT, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, textureImage, textureImageMemory, 1, 0);
+#endif
 
+		std::vector<VkBufferImageCopy> regions(mipLevels);
+		for (uint32_t level = 0; level < mipLevels; level++)
+		{
+			auto &region                           = regions[level];
+			region.bufferOffset                    = image->getMips()[level].offset;
+			region.imageSubresource.aspectMask     = VK_IMAGE_ASPECT_COLOR_BIT;
+			region.imageSubresource.mipLevel       = level;
+			region.imageSubresource.baseArrayLayer = 0;
+			region.imageSubresource.layerCount     = 1;
+			region.imageOffset                     = {0, 0, 0};
+			region.imageExtent                     = {std::max(1u, width >> level), std::max(1u, height >> level), 1};
+		}
+
+		const auto &last = image->getMips()[mipLevels - 1];
+		VulkanDevice::get()->getUploader()->uploadImageLevels(textureImage, mipLevels, image->getData(), last.offset + last.size, getFormatSize(parameters.format),
+		                                                      std::move(regions),
+		                                                      [&](VkCommandBuffer cmd) {
+			                                                      VulkanHelper::transitionImageLayout(textureImage, vkFormat, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL, mipLevels, 1, cmd, false);
+		                                                      });
+
+		imageLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+		updateDescriptor();
 		return true;
 	}
 
@@ -322,12 +432,17 @@ namespace maple
 	{
 		PROFILE_FUNCTION();
 
+		//the pipelines made for the old image keep its framebuffers.
+		if (textureImage != VK_NULL_HANDLE)
+			renewTarget();
+
 		deleteSampler();
 
 		this->width  = width;
 		this->height = height;
 		deleteImage  = true;
 		mipLevels    = 1;
+		aliasOwner   = nullptr;
 
 		constexpr uint32_t FLAGS = VK_IMAGE_USAGE_TRANSFER_SRC_BIT | VK_IMAGE_USAGE_TRANSFER_DST_BIT | VK_IMAGE_USAGE_SAMPLED_BIT | VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT;
 
@@ -358,6 +473,81 @@ namespace maple
 		updateDescriptor();
 	}
 
+	auto VulkanTexture2D::aliasMemory(const std::shared_ptr<Texture2D> &owner) -> bool
+	{
+		PROFILE_FUNCTION();
+		auto vkOwner = std::dynamic_pointer_cast<VulkanTexture2D>(owner);
+		if (vkOwner == nullptr || vkOwner.get() == this || vkOwner->aliasOwner != nullptr || !vkOwner->deleteImage || !deleteImage)
+			return false;
+
+		VkImageCreateInfo imageInfo = {};
+		imageInfo.sType             = VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO;
+		imageInfo.imageType         = VK_IMAGE_TYPE_2D;
+		imageInfo.extent            = {width, height, 1};
+		imageInfo.mipLevels         = mipLevels;
+		imageInfo.format            = vkFormat;
+		imageInfo.tiling            = VK_IMAGE_TILING_OPTIMAL;
+		imageInfo.initialLayout     = VK_IMAGE_LAYOUT_UNDEFINED;
+		imageInfo.usage             = VK_IMAGE_USAGE_TRANSFER_SRC_BIT | VK_IMAGE_USAGE_TRANSFER_DST_BIT | VK_IMAGE_USAGE_SAMPLED_BIT | VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT;
+		imageInfo.samples           = VK_SAMPLE_COUNT_1_BIT;
+		imageInfo.sharingMode       = VK_SHARING_MODE_EXCLUSIVE;
+		imageInfo.arrayLayers       = 1;
+
+		VkImage image = VK_NULL_HANDLE;
+		if (vkCreateImage(*VulkanDevice::get(), &imageInfo, nullptr, &image) != VK_SUCCESS)
+			return false;
+
+		VkMemoryRequirements requirements;
+		vkGetImageMemoryRequirements(*VulkanDevice::get(), image, &requirements);
+
+#ifdef USE_VMA_ALLOCATOR
+		VmaAllocationInfo ownerInfo;
+		vmaGetAllocationInfo(VulkanDevice::get()->getAllocator(), vkOwner->allocation, &ownerInfo);
+
+		const bool fits = requirements.size <= ownerInfo.size &&
+		                  ownerInfo.offset % requirements.alignment == 0 &&
+		                  (requirements.memoryTypeBits & (1u << ownerInfo.memoryType)) != 0;
+
+		if (!fits || vmaBindImageMemory(VulkanDevice::get()->getAllocator(), vkOwner->allocation, image) != VK_SUCCESS)
+#else
+		VkMemoryRequirements ownerRequirements;
+		vkGetImageMemoryRequirements(*VulkanDevice::get(), vkOwner->textureImage, &ownerRequirements);
+
+		const bool fits = requirements.size <= ownerRequirements.size &&
+		                  VulkanHelper::findMemoryType(requirements.memoryTypeBits, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT) ==
+		                      VulkanHelper::findMemoryType(ownerRequirements.memoryTypeBits, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT);
+
+		if (!fits || vkBindImageMemory(*VulkanDevice::get(), image, vkOwner->textureImageMemory, 0) != VK_SUCCESS)
+#endif
+		{
+			vkDestroyImage(*VulkanDevice::get(), image, nullptr);
+			return false;
+		}
+
+		//the own image and its memory go away, views and sampler are created again for the new image.
+		deleteSampler();
+
+		textureImage       = image;
+		textureImageMemory = VK_NULL_HANDLE;
+		aliasOwner         = vkOwner;
+#ifdef USE_VMA_ALLOCATOR
+		allocation = VK_NULL_HANDLE;
+#endif
+		createSampler();
+		renewTarget();
+
+		imageLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+		transitionImage(VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL);
+		return true;
+	}
+
+	auto VulkanTexture2D::discardContent() -> void
+	{
+		//the next transition starts from undefined, so it also waits for whatever used the shared memory before.
+		imageLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+		updateDescriptor();
+	}
+
 	auto VulkanTexture2D::transitionImage(VkImageLayout newLayout, const VulkanCommandBuffer *commandBuffer) -> void
 	{
 		PROFILE_FUNCTION();
@@ -420,7 +610,13 @@ namespace maple
 			deletionQueue.emplace([imageView] { vkDestroyImageView(*VulkanDevice::get(), imageView, nullptr); });
 		}
 
-		if (deleteImage)
+		if (deleteImage && aliasOwner != nullptr)
+		{
+			//the memory belongs to the owner.
+			auto image = textureImage;
+			deletionQueue.emplace([image] { vkDestroyImage(*VulkanDevice::get(), image, nullptr); });
+		}
+		else if (deleteImage)
 		{
 			auto image = textureImage;
 
@@ -491,6 +687,7 @@ namespace maple
 		this->height = height;
 		release();
 		init(commandBuffer);
+		renewTarget();
 	}
 
 	auto VulkanTextureDepth::updateDescriptor() -> void
@@ -757,6 +954,7 @@ namespace maple
 
 		release();
 		init();
+		renewTarget();
 	}
 
 	auto VulkanTextureDepthArray::getHandleArray(uint32_t index) -> void *
@@ -777,9 +975,9 @@ namespace maple
 		auto depthFormat = VulkanHelper::getDepthFormat();
 
 #ifdef USE_VMA_ALLOCATOR
-		VulkanHelper::createImage(width, height, 1, depthFormat, VK_IMAGE_TYPE_2D, VK_IMAGE_TILING_OPTIMAL, VK_IMAGE_USAGE_DEPTH_STENCIL_ATTACHMENT_BIT | VK_IMAGE_USAGE_SAMPLED_BIT, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, textureImage, textureImageMemory, count, 0, allocation);
+		VulkanHelper::createImage(width, height, 1, depthFormat, VK_IMAGE_TYPE_2D, VK_IMAGE_TILING_OPTIMAL, VK_IMAGE_USAGE_DEPTH_STENCIL_ATTACHMENT_BIT | VK_IMAGE_USAGE_SAMPLED_BIT | VK_IMAGE_USAGE_TRANSFER_SRC_BIT | VK_IMAGE_USAGE_TRANSFER_DST_BIT, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, textureImage, textureImageMemory, count, 0, allocation);
 #else
-		VulkanHelper::createImage(width, height, 1, depthFormat, VK_IMAGE_TYPE_2D, VK_IMAGE_TILING_OPTIMAL, VK_IMAGE_USAGE_DEPTH_STENCIL_ATTACHMENT_BIT | VK_IMAGE_USAGE_SAMPLED_BIT, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, textureImage, textureImageMemory, count, 0);
+		VulkanHelper::createImage(width, height, 1, depthFormat, VK_IMAGE_TYPE_2D, VK_IMAGE_TILING_OPTIMAL, VK_IMAGE_USAGE_DEPTH_STENCIL_ATTACHMENT_BIT | VK_IMAGE_USAGE_SAMPLED_BIT | VK_IMAGE_USAGE_TRANSFER_SRC_BIT | VK_IMAGE_USAGE_TRANSFER_DST_BIT, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, textureImage, textureImageMemory, count, 0);
 #endif
 		textureImageView = VulkanHelper::createImageView(textureImage, depthFormat, 1, VK_IMAGE_VIEW_TYPE_2D_ARRAY, VK_IMAGE_ASPECT_DEPTH_BIT, count);
 		for (uint32_t i = 0; i < count; i++)
@@ -827,6 +1025,46 @@ namespace maple
 #endif
 	}
 
+	auto VulkanTextureDepthArray::copyLayer(const CommandBuffer *commandBuffer, TextureDepthArray *target, uint32_t layer) -> void
+	{
+		PROFILE_FUNCTION();
+		auto cmd = static_cast<const VulkanCommandBuffer *>(commandBuffer);
+		auto dst = static_cast<VulkanTextureDepthArray *>(target);
+
+		MAPLE_ASSERT(dst->width == width && dst->height == height && layer < count && layer < dst->count, "copyLayer : incompatible depth arrays");
+
+		const auto srcLayout = imageLayout;
+
+		transitionImage(VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL, cmd);
+		dst->transitionImage(VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, cmd);
+
+		VkImageCopy copyRegion = {};
+
+		copyRegion.srcSubresource.aspectMask     = VK_IMAGE_ASPECT_DEPTH_BIT;
+		copyRegion.srcSubresource.baseArrayLayer = layer;
+		copyRegion.srcSubresource.mipLevel       = 0;
+		copyRegion.srcSubresource.layerCount     = 1;
+		copyRegion.srcOffset                     = {0, 0, 0};
+		copyRegion.dstSubresource                = copyRegion.srcSubresource;
+		copyRegion.dstOffset                     = {0, 0, 0};
+		copyRegion.extent.width                  = width;
+		copyRegion.extent.height                 = height;
+		copyRegion.extent.depth                  = 1;
+
+		vkCmdCopyImage(
+		    cmd->getCommandBuffer(),
+		    textureImage,
+		    VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL,
+		    dst->textureImage,
+		    VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+		    1,
+		    &copyRegion);
+
+		//the target is drawn into next, render passes expect the attachment layout they were created with.
+		transitionImage(srcLayout, cmd);
+		dst->transitionImage(VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL, cmd);
+	}
+
 	auto VulkanTextureDepthArray::transitionImage(VkImageLayout newLayout, const VulkanCommandBuffer *commandBuffer) -> void
 	{
 		PROFILE_FUNCTION();
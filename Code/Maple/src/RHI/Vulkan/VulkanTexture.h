@@ -8,6 +8,8 @@
 
 namespace maple
 {
+	class Image;
+
 	class VkTexture
 	{
 	  public:
@@ -104,8 +106,12 @@ namespace maple
 		}
 
 		auto load() -> bool;
+		auto load(const Image *image) -> bool;
+		auto loadLevels(const Image *image) -> bool;
 		auto updateDescriptor() -> void;
 		auto buildTexture(TextureFormat internalformat, uint32_t width, uint32_t height, bool srgb, bool depth, bool samplerShadow, bool mipmap,bool image, uint32_t accessFlag) -> void override;
+		auto aliasMemory(const std::shared_ptr<Texture2D> &owner) -> bool override;
+		auto discardContent() -> void override;
 
 		auto transitionImage(VkImageLayout newLayout, const VulkanCommandBuffer *commandBuffer = nullptr) -> void override;
 
@@ -144,6 +150,8 @@ namespace maple
 #ifdef USE_VMA_ALLOCATOR
 		VmaAllocation allocation{};
 #endif
+		//set when the image is bound to the memory of another texture, the owner keeps the allocation.
+		std::shared_ptr<VulkanTexture2D> aliasOwner;
 	};
 
 	class VulkanTextureDepth : public TextureDepth, public VkTexture
@@ -437,6 +445,7 @@ namespace maple
 
 		auto getHandleArray(uint32_t index) -> void * override;
 		auto updateDescriptor() -> void;
+		auto copyLayer(const CommandBuffer *commandBuffer, TextureDepthArray *target, uint32_t layer) -> void override;
 
 		auto transitionImage(VkImageLayout newLayout, const VulkanCommandBuffer *commandBuffer) -> void override;
 
@@ -0,0 +1,95 @@
+//////////////////////////////////////////////////////////////////////////////
+// This file is part of the Maple Engine                              		//
+//////////////////////////////////////////////////////////////////////////////
+#include "VulkanUniformRing.h"
+#include "Engine/Profiler.h"
+#include "Others/Console.h"
+
+#include <algorithm>
+#include <cstring>
+
+namespace maple
+{
+	VulkanUniformRing::Page::Page(uint32_t capacity, uint64_t version) :
+	    capacity(capacity), version(version)
+	{
+		buffer.init(VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT, capacity, nullptr);
+		buffer.map();
+		mapped = static_cast<uint8_t *>(buffer.getMapped());
+	}
+
+	VulkanUniformRing::Page::~Page()
+	{
+		buffer.unmap();
+	}
+
+	VulkanUniformRing::VulkanUniformRing(uint32_t framesInFlight, uint32_t alignment, uint32_t pageSize) :
+	    alignment(std::max<uint32_t>(alignment, 16))
+	{
+		for (uint32_t i = 0; i < framesInFlight; i++)
+		{
+			auto &frame = frames.emplace_back(std::make_unique<Frame>());
+			frame->pages.emplace_back(std::make_unique<Page>(pageSize, nextVersion++));
+			frame->active = frame->pages.back().get();
+		}
+	}
+
+	VulkanUniformRing::~VulkanUniformRing()
+	{
+	}
+
+	auto VulkanUniformRing::reset(uint32_t frame) -> void
+	{
+		PROFILE_FUNCTION();
+		auto &current = *frames[frame];
+		if (current.pages.size() > 1)
+		{
+			//the frame overflowed, keep the biggest page only.
+			current.pages.erase(current.pages.begin(), current.pages.end() - 1);
+		}
+		current.pages.back()->head.store(0, std::memory_order_relaxed);
+		current.active = current.pages.back().get();
+		currentFrame   = frame;
+		frameCounter++;
+	}
+
+	auto VulkanUniformRing::allocate(const void *data, uint32_t size) -> Allocation
+	{
+		const uint32_t alignedSize = (size + alignment - 1) & ~(alignment - 1);
+		auto &         frame       = *frames[currentFrame];
+		while (true)
+		{
+			auto page   = frame.active.load(std::memory_order_acquire);
+			auto offset = page->head.fetch_add(alignedSize, std::memory_order_relaxed);
+			if (offset + alignedSize <= page->capacity)
+			{
+				memcpy(page->mapped + offset, data, size);
+				return {page->buffer.getVkBuffer(), page->version, offset};
+			}
+			grow(frame, page, alignedSize);
+		}
+	}
+
+	auto VulkanUniformRing::grow(Frame &frame, Page *full, uint32_t size) -> void
+	{
+		std::lock_guard<std::mutex> locker(growMutex);
+		//another thread has already replaced the page.
+		if (frame.active.load(std::memory_order_acquire) != full)
+			return;
+
+		const auto capacity = std::max(full->capacity * 2, size);
+		LOGW("VulkanUniformRing : frame {0} overflowed, growing to {1} bytes", currentFrame, capacity);
+		frame.pages.emplace_back(std::make_unique<Page>(capacity, nextVersion++));
+		frame.active.store(frame.pages.back().get(), std::memory_order_release);
+	}
+
+	auto VulkanUniformRing::flush() -> void
+	{
+		PROFILE_FUNCTION();
+		//no-op on coherent memory, CPU_TO_GPU does not guarantee it though.
+		for (auto &page : frames[currentFrame]->pages)
+		{
+			page->buffer.flush();
+		}
+	}
+}        // namespace maple
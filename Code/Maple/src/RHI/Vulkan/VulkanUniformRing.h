@@ -0,0 +1,80 @@
+//////////////////////////////////////////////////////////////////////////////
+// This file is part of the Maple Engine                              		//
+//////////////////////////////////////////////////////////////////////////////
+#pragma once
+#include "Engine/Core.h"
+#include "VulkanBuffer.h"
+
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace maple
+{
+	/**
+	 * linear allocator for uniform data, every frame in flight owns persistently mapped pages.
+	 * blocks are bound with dynamic offsets and a frame is recycled once its fence has signalled.
+	 */
+	class VulkanUniformRing
+	{
+	  public:
+		static constexpr uint32_t DEFAULT_PAGE_SIZE = 4 * 1024 * 1024;
+
+		struct Allocation
+		{
+			VkBuffer buffer  = VK_NULL_HANDLE;
+			uint64_t version = 0;        //changes whenever the page behind the allocation changes
+			uint32_t offset  = 0;
+		};
+
+		VulkanUniformRing(uint32_t framesInFlight, uint32_t alignment, uint32_t pageSize = DEFAULT_PAGE_SIZE);
+		~VulkanUniformRing();
+		NO_COPYABLE(VulkanUniformRing);
+
+		//the gpu has finished the frame, its pages can be reused.
+		auto reset(uint32_t frame) -> void;
+		//copies the data into the current frame. thread safe.
+		auto allocate(const void *data, uint32_t size) -> Allocation;
+		auto flush() -> void;
+
+		inline auto getFrameCounter() const
+		{
+			return frameCounter;
+		}
+
+		inline auto getCurrentFrame() const
+		{
+			return currentFrame;
+		}
+
+	  private:
+		struct Page
+		{
+			Page(uint32_t capacity, uint64_t version);
+			~Page();
+
+			VulkanBuffer          buffer;
+			uint8_t *             mapped = nullptr;
+			uint32_t              capacity;
+			uint64_t              version;
+			std::atomic<uint32_t> head{0};
+		};
+
+		struct Frame
+		{
+			//the last page is the active one, older pages are only kept until the frame is recycled.
+			std::vector<std::unique_ptr<Page>> pages;
+			std::atomic<Page *>                active{nullptr};
+		};
+
+		auto grow(Frame &frame, Page *full, uint32_t size) -> void;
+
+		std::vector<std::unique_ptr<Frame>> frames;
+		std::mutex                          growMutex;
+		uint32_t                            alignment    = 256;
+		uint32_t                            currentFrame = 0;
+		uint64_t                            frameCounter = 0;
+		uint64_t                            nextVersion  = 1;
+	};
+}        // namespace maple
@@ -0,0 +1,342 @@
+//////////////////////////////////////////////////////////////////////////////
+// This file is part of the Maple Engine                              		//
+//////////////////////////////////////////////////////////////////////////////
+#include "VulkanUploader.h"
+#include "Engine/Profiler.h"
+#include "Others/Console.h"
+#include "VulkanCommandPool.h"
+#include "VulkanDevice.h"
+#include "VulkanFence.h"
+
+#include <algorithm>
+#include <cstring>
+#include <numeric>
+
+namespace maple
+{
+	namespace
+	{
+		inline auto allocateCommandBuffer(VkCommandPool pool)
+		{
+			VkCommandBufferAllocateInfo allocInfo{};
+			allocInfo.sType              = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
+			allocInfo.level              = VK_COMMAND_BUFFER_LEVEL_PRIMARY;
+			allocInfo.commandPool        = pool;
+			allocInfo.commandBufferCount = 1;
+
+			VkCommandBuffer commandBuffer;
+			VK_CHECK_RESULT(vkAllocateCommandBuffers(*VulkanDevice::get(), &allocInfo, &commandBuffer));
+			return commandBuffer;
+		}
+
+		inline auto beginCommandBuffer(VkCommandBuffer commandBuffer)
+		{
+			VkCommandBufferBeginInfo beginInfo{};
+			beginInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
+			beginInfo.flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT;
+			VK_CHECK_RESULT(vkBeginCommandBuffer(commandBuffer, &beginInfo));
+		}
+	}        // namespace
+
+	VulkanUploader::VulkanUploader(uint32_t stagingSize) :
+	    stagingSize(stagingSize)
+	{
+		auto  device  = VulkanDevice::get();
+		auto &indices = device->getPhysicalDevice()->getQueueFamilyIndices();
+
+		graphicsFamily = indices.graphicsFamily.value();
+		transferFamily = indices.transferFamily.value_or(graphicsFamily);
+		graphicsQueue  = device->getGraphicsQueue();
+		transferQueue  = device->getTransferQueue();
+
+		graphicsPool = std::make_shared<VulkanCommandPool>(graphicsFamily, VK_COMMAND_POOL_CREATE_RESET_COMMAND_BUFFER_BIT | VK_COMMAND_POOL_CREATE_TRANSIENT_BIT);
+		if (hasTransferQueue())
+			transferPool = std::make_shared<VulkanCommandPool>(transferFamily, VK_COMMAND_POOL_CREATE_RESET_COMMAND_BUFFER_BIT | VK_COMMAND_POOL_CREATE_TRANSIENT_BIT);
+
+		LOGI("VulkanUploader : uploading on the {0} queue", hasTransferQueue() ? "transfer" : "graphics");
+
+		VkSemaphoreCreateInfo semaphoreInfo{};
+		semaphoreInfo.sType = VK_STRUCTURE_TYPE_SEMAPHORE_CREATE_INFO;
+
+		batches.resize(BATCH_COUNT);
+		for (auto &batch : batches)
+		{
+			batch.staging = std::make_unique<VulkanBuffer>(VK_BUFFER_USAGE_TRANSFER_SRC_BIT, stagingSize, nullptr);
+			batch.staging->map();
+			batch.fence       = std::make_unique<VulkanFence>(false);
+			batch.graphicsCmd = allocateCommandBuffer(*graphicsPool);
+			if (hasTransferQueue())
+			{
+				batch.transferCmd = allocateCommandBuffer(*transferPool);
+				VK_CHECK_RESULT(vkCreateSemaphore(*device, &semaphoreInfo, nullptr, &batch.semaphore));
+			}
+		}
+	}
+
+	VulkanUploader::~VulkanUploader()
+	{
+		submit();
+		for (auto &batch : batches)
+		{
+			if (batch.submitted)
+				batch.fence->waitAndReset();
+			batch.staging->unmap();
+			if (batch.semaphore != VK_NULL_HANDLE)
+				vkDestroySemaphore(*VulkanDevice::get(), batch.semaphore, nullptr);
+		}
+	}
+
+	auto VulkanUploader::uploadBuffer(VkBuffer buffer, const void *data, uint32_t size, uint32_t offset, bool initial) -> void
+	{
+		PROFILE_FUNCTION();
+		std::lock_guard<std::mutex> locker(mutex);
+
+		auto staging = stage(data, size, 4);
+
+		VkBufferCopy region{};
+		region.srcOffset = staging.offset;
+		region.dstOffset = offset;
+		region.size      = size;
+
+		VkBufferMemoryBarrier barrier{};
+		barrier.sType               = VK_STRUCTURE_TYPE_BUFFER_MEMORY_BARRIER;
+		barrier.buffer              = buffer;
+		barrier.offset              = offset;
+		barrier.size                = size;
+		barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+		barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+
+		if (!initial || !hasTransferQueue())
+		{
+			//the buffer may still be read by a previous frame, so the copy stays on the graphics queue behind it.
+			auto cmd = getGraphicsCmd();
+			if (!initial)
+			{
+				barrier.srcAccessMask = VK_ACCESS_MEMORY_READ_BIT;
+				barrier.dstAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+				vkCmdPipelineBarrier(cmd, VK_PIPELINE_STAGE_ALL_COMMANDS_BIT, VK_PIPELINE_STAGE_TRANSFER_BIT, 0, 0, nullptr, 1, &barrier, 0, nullptr);
+			}
+			vkCmdCopyBuffer(cmd, staging.buffer, buffer, 1, &region);
+			barrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+			barrier.dstAccessMask = VK_ACCESS_MEMORY_READ_BIT;
+			vkCmdPipelineBarrier(cmd, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_ALL_COMMANDS_BIT, 0, 0, nullptr, 1, &barrier, 0, nullptr);
+			return;
+		}
+
+		vkCmdCopyBuffer(getTransferCmd(), staging.buffer, buffer, 1, &region);
+
+		//release on the transfer queue and acquire on the graphics queue.
+		barrier.srcQueueFamilyIndex = transferFamily;
+		barrier.dstQueueFamilyIndex = graphicsFamily;
+		barrier.srcAccessMask       = VK_ACCESS_TRANSFER_WRITE_BIT;
+		barrier.dstAccessMask       = 0;
+		vkCmdPipelineBarrier(getTransferCmd(), VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT, 0, 0, nullptr, 1, &barrier, 0, nullptr);
+
+		barrier.srcAccessMask = 0;
+		barrier.dstAccessMask = VK_ACCESS_MEMORY_READ_BIT;
+		vkCmdPipelineBarrier(getGraphicsCmd(), VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT, VK_PIPELINE_STAGE_ALL_COMMANDS_BIT, 0, 0, nullptr, 1, &barrier, 0, nullptr);
+	}
+
+	auto VulkanUploader::uploadImage(VkImage image, VkImageLayout oldLayout, uint32_t mipLevels,
+	                                 const void *data, uint32_t size, uint32_t texelSize,
+	                                 uint32_t width, uint32_t height, int32_t offsetX, int32_t offsetY,
+	                                 const std::function<void(VkCommandBuffer)> &onGraphics) -> void
+	{
+		PROFILE_FUNCTION();
+		std::lock_guard<std::mutex> locker(mutex);
+
+		//no data only moves the image into TRANSFER_DST_OPTIMAL.
+		if (data == nullptr)
+		{
+			copyImage(image, oldLayout, mipLevels, VK_NULL_HANDLE, {}, onGraphics);
+			return;
+		}
+
+		//staging first, a full ring submits the current batch.
+		//buffer offsets of image copies have to be a multiple of the texel size and of 4.
+		auto staging = stage(data, size, std::lcm<uint32_t>(std::max<uint32_t>(texelSize, 1), 16));
+
+		VkBufferImageCopy region{};
+		region.bufferOffset                    = staging.offset;
+		region.imageSubresource.aspectMask     = VK_IMAGE_ASPECT_COLOR_BIT;
+		region.imageSubresource.mipLevel       = 0;
+		region.imageSubresource.baseArrayLayer = 0;
+		region.imageSubresource.layerCount     = 1;
+		region.imageOffset                     = {offsetX, offsetY, 0};
+		region.imageExtent                     = {width, height, 1};
+		copyImage(image, oldLayout, mipLevels, staging.buffer, {region}, onGraphics);
+	}
+
+	auto VulkanUploader::uploadImageLevels(VkImage image, uint32_t mipLevels, const void *data, uint32_t size, uint32_t blockSize,
+	                                       std::vector<VkBufferImageCopy> regions, const std::function<void(VkCommandBuffer)> &onGraphics) -> void
+	{
+		PROFILE_FUNCTION();
+		std::lock_guard<std::mutex> locker(mutex);
+
+		//the levels are staged as one block, their offsets stay multiples of the block size.
+		auto staging = stage(data, size, std::lcm<uint32_t>(std::max<uint32_t>(blockSize, 1), 16));
+		for (auto &region : regions)
+		{
+			region.bufferOffset += staging.offset;
+		}
+		copyImage(image, VK_IMAGE_LAYOUT_UNDEFINED, mipLevels, staging.buffer, regions, onGraphics);
+	}
+
+	auto VulkanUploader::copyImage(VkImage image, VkImageLayout oldLayout, uint32_t mipLevels, VkBuffer buffer, const std::vector<VkBufferImageCopy> &regions,
+	                               const std::function<void(VkCommandBuffer)> &onGraphics) -> void
+	{
+		const bool useTransfer = hasTransferQueue() && oldLayout == VK_IMAGE_LAYOUT_UNDEFINED && !regions.empty();
+		auto       cmd         = useTransfer ? getTransferCmd() : getGraphicsCmd();
+
+		VkImageMemoryBarrier barrier{};
+		barrier.sType                           = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
+		barrier.image                           = image;
+		barrier.srcQueueFamilyIndex             = VK_QUEUE_FAMILY_IGNORED;
+		barrier.dstQueueFamilyIndex             = VK_QUEUE_FAMILY_IGNORED;
+		barrier.subresourceRange.aspectMask     = VK_IMAGE_ASPECT_COLOR_BIT;
+		barrier.subresourceRange.baseMipLevel   = 0;
+		barrier.subresourceRange.levelCount     = mipLevels;
+		barrier.subresourceRange.baseArrayLayer = 0;
+		barrier.subresourceRange.layerCount     = 1;
+		barrier.oldLayout                       = oldLayout;
+		barrier.newLayout                       = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
+		barrier.srcAccessMask                   = oldLayout == VK_IMAGE_LAYOUT_UNDEFINED ? 0 : VK_ACCESS_MEMORY_READ_BIT;
+		barrier.dstAccessMask                   = VK_ACCESS_TRANSFER_WRITE_BIT;
+		vkCmdPipelineBarrier(cmd, oldLayout == VK_IMAGE_LAYOUT_UNDEFINED ? VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT : VK_PIPELINE_STAGE_ALL_COMMANDS_BIT,
+		                     VK_PIPELINE_STAGE_TRANSFER_BIT, 0, 0, nullptr, 0, nullptr, 1, &barrier);
+
+		if (!regions.empty())
+			vkCmdCopyBufferToImage(cmd, buffer, image, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, static_cast<uint32_t>(regions.size()), regions.data());
+
+		if (useTransfer)
+		{
+			barrier.oldLayout           = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
+			barrier.newLayout           = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
+			barrier.srcQueueFamilyIndex = transferFamily;
+			barrier.dstQueueFamilyIndex = graphicsFamily;
+			barrier.srcAccessMask       = VK_ACCESS_TRANSFER_WRITE_BIT;
+			barrier.dstAccessMask       = 0;
+			vkCmdPipelineBarrier(cmd, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT, 0, 0, nullptr, 0, nullptr, 1, &barrier);
+
+			barrier.srcAccessMask = 0;
+			barrier.dstAccessMask = VK_ACCESS_TRANSFER_READ_BIT | VK_ACCESS_TRANSFER_WRITE_BIT;
+			vkCmdPipelineBarrier(getGraphicsCmd(), VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT, VK_PIPELINE_STAGE_TRANSFER_BIT, 0, 0, nullptr, 0, nullptr, 1, &barrier);
+		}
+
+		if (onGraphics)
+			onGraphics(getGraphicsCmd());
+	}
+
+	auto VulkanUploader::submit() -> void
+	{
+		PROFILE_FUNCTION();
+		std::lock_guard<std::mutex> locker(mutex);
+		submitLocked();
+	}
+
+	auto VulkanUploader::stage(const void *data, uint32_t size, uint32_t alignment) -> Staging
+	{
+		auto *batch  = &batches[current];
+		auto  offset = (batch->head + alignment - 1) / alignment * alignment;
+
+		if (offset + size > stagingSize && size <= stagingSize)
+		{
+			//the ring is full, kick the copies recorded so far and continue in the next batch.
+			submitLocked();
+			batch  = &batches[current];
+			offset = 0;
+		}
+
+		if (size > stagingSize)
+		{
+			auto &buffer = batch->dedicated.emplace_back(std::make_unique<VulkanBuffer>(VK_BUFFER_USAGE_TRANSFER_SRC_BIT, size, data));
+			return {buffer->getVkBuffer(), 0};
+		}
+
+		memcpy(static_cast<uint8_t *>(batch->staging->getMapped()) + offset, data, size);
+		batch->head = offset + size;
+		return {batch->staging->getVkBuffer(), offset};
+	}
+
+	auto VulkanUploader::getTransferCmd() -> VkCommandBuffer
+	{
+		if (!hasTransferQueue())
+			return getGraphicsCmd();
+
+		auto &batch = batches[current];
+		if (!batch.transferRecording)
+		{
+			beginCommandBuffer(batch.transferCmd);
+			batch.transferRecording = true;
+		}
+		return batch.transferCmd;
+	}
+
+	auto VulkanUploader::getGraphicsCmd() -> VkCommandBuffer
+	{
+		auto &batch = batches[current];
+		if (!batch.graphicsRecording)
+		{
+			beginCommandBuffer(batch.graphicsCmd);
+			batch.graphicsRecording = true;
+		}
+		return batch.graphicsCmd;
+	}
+
+	auto VulkanUploader::submitLocked() -> void
+	{
+		auto &batch = batches[current];
+		if (!batch.transferRecording && !batch.graphicsRecording)
+			return;
+
+		batch.staging->flush(batch.head);
+
+		const bool waitTransfer = batch.transferRecording;
+		if (waitTransfer)
+		{
+			VK_CHECK_RESULT(vkEndCommandBuffer(batch.transferCmd));
+
+			VkSubmitInfo submitInfo{};
+			submitInfo.sType                = VK_STRUCTURE_TYPE_SUBMIT_INFO;
+			submitInfo.commandBufferCount   = 1;
+			submitInfo.pCommandBuffers      = &batch.transferCmd;
+			submitInfo.signalSemaphoreCount = 1;
+			submitInfo.pSignalSemaphores    = &batch.semaphore;
+			VK_CHECK_RESULT(vkQueueSubmit(transferQueue, 1, &submitInfo, VK_NULL_HANDLE));
+		}
+
+		//the acquire barriers are always recorded when something went through the transfer queue.
+		VK_CHECK_RESULT(vkEndCommandBuffer(batch.graphicsCmd));
+
+		//graphics work submitted later is ordered behind this submission.
+		VkPipelineStageFlags waitStage = VK_PIPELINE_STAGE_ALL_COMMANDS_BIT;
+		VkSubmitInfo         submitInfo{};
+		submitInfo.sType              = VK_STRUCTURE_TYPE_SUBMIT_INFO;
+		submitInfo.waitSemaphoreCount = waitTransfer ? 1 : 0;
+		submitInfo.pWaitSemaphores    = &batch.semaphore;
+		submitInfo.pWaitDstStageMask  = &waitStage;
+		submitInfo.commandBufferCount = 1;
+		submitInfo.pCommandBuffers    = &batch.graphicsCmd;
+
+		batch.fence->reset();
+		VK_CHECK_RESULT(vkQueueSubmit(graphicsQueue, 1, &submitInfo, *batch.fence));
+
+		batch.submitted         = true;
+		batch.transferRecording = false;
+		batch.graphicsRecording = false;
+
+		//recycle the next batch, it was submitted BATCH_COUNT submissions ago so the fence is normally signalled already.
+		current    = (current + 1) % BATCH_COUNT;
+		auto &next = batches[current];
+		if (next.submitted)
+		{
+			next.fence->waitAndReset();
+			next.submitted = false;
+		}
+		VK_CHECK_RESULT(vkResetCommandBuffer(next.graphicsCmd, 0));
+		if (next.transferCmd != VK_NULL_HANDLE)
+			VK_CHECK_RESULT(vkResetCommandBuffer(next.transferCmd, 0));
+		next.dedicated.clear();
+		next.head = 0;
+	}
+}        // namespace maple
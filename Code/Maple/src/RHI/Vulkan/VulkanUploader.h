@@ -0,0 +1,97 @@
+//////////////////////////////////////////////////////////////////////////////
+// This file is part of the Maple Engine                              		//
+//////////////////////////////////////////////////////////////////////////////
+#pragma once
+#include "Engine/Core.h"
+#include "VulkanBuffer.h"
+#include "VulkanHelper.h"
+
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace maple
+{
+	class VulkanFence;
+	class VulkanCommandPool;
+
+	/**
+	 * copies data into device local buffers and images through a persistently mapped staging ring.
+	 * copies are batched and submitted once per frame on the transfer queue (the graphics queue if there is no dedicated one),
+	 * the graphics queue waits on a semaphore and a batch is recycled after its fence has signalled, nothing waits on a whole queue.
+	 */
+	class VulkanUploader
+	{
+	  public:
+		static constexpr uint32_t STAGING_SIZE = 16 * 1024 * 1024;
+		static constexpr uint32_t BATCH_COUNT  = 3;
+
+		VulkanUploader(uint32_t stagingSize = STAGING_SIZE);
+		~VulkanUploader();
+		NO_COPYABLE(VulkanUploader);
+
+		//initial is true when the buffer has never been used, so the copy does not have to wait on previous reads.
+		auto uploadBuffer(VkBuffer buffer, const void *data, uint32_t size, uint32_t offset = 0, bool initial = true) -> void;
+
+		//copies into mip 0, the image is left in TRANSFER_DST_OPTIMAL on the graphics queue where onGraphics is recorded (mip generation, layout transitions).
+		//an image coming from VK_IMAGE_LAYOUT_UNDEFINED has no content to keep, so it is copied on the transfer queue. null data only changes the layout.
+		auto uploadImage(VkImage image, VkImageLayout oldLayout, uint32_t mipLevels,
+		                 const void *data, uint32_t size, uint32_t texelSize,
+		                 uint32_t width, uint32_t height, int32_t offsetX, int32_t offsetY,
+		                 const std::function<void(VkCommandBuffer)> &onGraphics) -> void;
+
+		//copies levels that come with the data (block compressed images are cooked with their mips) into a new image,
+		//the buffer offsets of the regions are relative to data. the image is left in TRANSFER_DST_OPTIMAL like above.
+		auto uploadImageLevels(VkImage image, uint32_t mipLevels, const void *data, uint32_t size, uint32_t blockSize,
+		                       std::vector<VkBufferImageCopy> regions, const std::function<void(VkCommandBuffer)> &onGraphics) -> void;
+
+		//submits the recorded copies, called before the frame is submitted and before any single time command.
+		auto submit() -> void;
+
+		inline auto hasTransferQueue() const
+		{
+			return transferQueue != graphicsQueue;
+		}
+
+	  private:
+		struct Batch
+		{
+			std::unique_ptr<VulkanBuffer>              staging;
+			std::vector<std::unique_ptr<VulkanBuffer>> dedicated;        //uploads bigger than the staging buffer
+			std::unique_ptr<VulkanFence>               fence;
+			VkSemaphore                                semaphore         = VK_NULL_HANDLE;
+			VkCommandBuffer                            transferCmd       = VK_NULL_HANDLE;
+			VkCommandBuffer                            graphicsCmd       = VK_NULL_HANDLE;
+			uint32_t                                   head              = 0;
+			bool                                       transferRecording = false;
+			bool                                       graphicsRecording = false;
+			bool                                       submitted         = false;
+		};
+
+		struct Staging
+		{
+			VkBuffer buffer;
+			uint32_t offset;
+		};
+
+		auto stage(const void *data, uint32_t size, uint32_t alignment) -> Staging;
+		auto copyImage(VkImage image, VkImageLayout oldLayout, uint32_t mipLevels, VkBuffer buffer, const std::vector<VkBufferImageCopy> &regions,
+		               const std::function<void(VkCommandBuffer)> &onGraphics) -> void;
+		auto getTransferCmd() -> VkCommandBuffer;
+		auto getGraphicsCmd() -> VkCommandBuffer;
+		auto submitLocked() -> void;
+
+		std::vector<Batch>                 batches;
+		std::shared_ptr<VulkanCommandPool> transferPool;
+		std::shared_ptr<VulkanCommandPool> graphicsPool;
+		std::mutex                         mutex;
+
+		VkQueue  transferQueue  = VK_NULL_HANDLE;
+		VkQueue  graphicsQueue  = VK_NULL_HANDLE;
+		uint32_t transferFamily = 0;
+		uint32_t graphicsFamily = 0;
+		uint32_t stagingSize    = STAGING_SIZE;
+		uint32_t current        = 0;
+	};
+}        // namespace maple
@@ -12,6 +12,7 @@ namespace maple
 	    bufferUsage(usage)
 	{
 		VulkanBuffer::setUsage(VK_BUFFER_USAGE_VERTEX_BUFFER_BIT);
+		VulkanBuffer::setDeviceLocal(usage == BufferUsage::Static);
 	}
 
 	VulkanVertexBuffer::~VulkanVertexBuffer()
@@ -44,14 +45,8 @@ namespace maple
 	auto VulkanVertexBuffer::setDataSub(uint32_t size, const void *data, uint32_t offset) -> void
 	{
 		PROFILE_FUNCTION();
-		if (size != this->size)
-		{
-			VulkanBuffer::resize(size, data);
-		}
-		else
-		{
-			VulkanBuffer::setVkData(size, data);
-		}
+		MAPLE_ASSERT(offset + size <= this->size, "setDataSub writes past the end of the vertex buffer");
+		VulkanBuffer::setVkData(size, data, offset);
 	}
 
 	auto VulkanVertexBuffer::releasePointer() -> void
@@ -80,6 +75,7 @@ namespace maple
 	auto VulkanVertexBuffer::getPointerInternal() -> void *
 	{
 		PROFILE_FUNCTION();
+		MAPLE_ASSERT(!deviceLocal, "static vertex buffers can not be mapped, use setData");
 		if (!mappedBuffer)
 		{
 			VulkanBuffer::map();
@@ -3,7 +3,11 @@
 //////////////////////////////////////////////////////////////////////////////
 #pragma once
 #include "Math/BoundingBox.h"
+#include "Math/BoundingBoxSoA.h"
+#include "Math/DynamicAABBTree.h"
 #include <glm/glm.hpp>
+#include <entt/entity/entity.hpp>
+#include <vector>
 
 #include <IconsMaterialDesignIcons.h>
 
@@ -17,5 +21,40 @@ namespace maple
 
 			BoundingBox* box;
 		};
+
+		//world space bounds of every mesh renderer, refreshed by the scene when transforms change.
+		//the tree is shared by camera/shadow culling and picking, its user data is the index into the arrays.
+		struct CullingData
+		{
+			BoundingBoxSoA            worldBounds;
+			DynamicAABBTree           tree;
+			std::vector<int32_t>      proxies;
+			std::vector<entt::entity> entities;
+			std::vector<uint8_t>      skinned;
+			//meshes without bounds, never culled.
+			std::vector<uint32_t> unbounded;
+
+			//a mesh which kept its bounds for STATIC_FRAMES frames is a static shadow caster.
+			constexpr static uint32_t STATIC_FRAMES = 60;
+			std::vector<uint32_t>     movedFrame;
+			std::vector<uint32_t>     moving;
+			uint32_t                  frame = 0;
+			//bumped when the set of static meshes or one of their bounds changes.
+			uint32_t staticVersion = 0;
+
+			inline auto isStatic(uint32_t index) const
+			{
+				return frame - movedFrame[index] >= STATIC_FRAMES;
+			}
+
+			inline auto cull(const Frustum &frustum, std::vector<uint32_t> &visible) const -> void
+			{
+				visible.insert(visible.end(), unbounded.begin(), unbounded.end());
+				const auto first = visible.size();
+				tree.query(frustum, [&](uint32_t index) { visible.emplace_back(index); });
+				//the tree only tests the fattened boxes, the candidates are checked against the tight bounds in batches.
+				worldBounds.refine(frustum, visible, first);
+			}
+		};
 	}
 };        // namespace maple
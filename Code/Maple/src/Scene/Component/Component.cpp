@@ -14,6 +14,8 @@ namespace maple
 {
 	namespace component 
 	{
+		uint32_t Hierarchy::version = 0;
+
 		Hierarchy::Hierarchy(entt::entity p) :
 			parent(p)
 		{
@@ -57,6 +59,7 @@ namespace maple
 
 		auto Hierarchy::onConstruct(entt::registry& registry, entt::entity entity) -> void
 		{
+			version++;
 			auto& hierarchy = registry.get<Hierarchy>(entity);
 			if (hierarchy.parent != entt::null)
 			{
@@ -84,6 +87,7 @@ namespace maple
 
 		auto Hierarchy::onDestroy(entt::registry& registry, entt::entity entity) -> void
 		{
+			version++;
 			auto& hierarchy = registry.get<Hierarchy>(entity);
 			if (hierarchy.prev == entt::null || !registry.valid(hierarchy.prev))
 			{
@@ -124,6 +128,7 @@ namespace maple
 
 		auto Hierarchy::onUpdate(entt::registry& registry, entt::entity entity) -> void
 		{
+			version++;
 			auto& hierarchy = registry.get<Hierarchy>(entity);
 			// if is the first child
 			if (hierarchy.prev == entt::null)
@@ -165,6 +170,7 @@ namespace maple
 
 		auto Hierarchy::reparent(entt::entity ent, entt::entity parent, entt::registry& registry, Hierarchy& hierarchy) -> void
 		{
+			version++;
 			Hierarchy::onDestroy(registry, ent);
 
 			hierarchy.parent = entt::null;
@@ -120,6 +120,12 @@ namespace maple
 			//adjust the parent
 			static auto reparent(entt::entity entity, entt::entity parent, entt::registry& registry, Hierarchy& hierarchy) -> void;
 
+			//bumped whenever any hierarchy link changes, the scene graph rebuilds its flattened order on change.
+			inline static auto getVersion()
+			{
+				return version;
+			}
+
 			entt::entity parent = entt::null;
 			entt::entity first = entt::null;
 			entt::entity next = entt::null;
@@ -130,6 +136,9 @@ namespace maple
 			{
 				archive(cereal::make_nvp("First", first), cereal::make_nvp("Next", next), cereal::make_nvp("Previous", prev), cereal::make_nvp("Parent", parent), entity);
 			}
+
+		private:
+			static uint32_t version;
 		};
 
 		class MAPLE_EXPORT Environment : public Component
@@ -40,7 +40,8 @@ namespace maple
 					mesh = Mesh::createSphere();
 					break;
 				case PrimitiveType::File:
-					mesh = model->resource->find(name);
+					if (model->poll() && model->resource != nullptr)
+						mesh = model->resource->find(name);
 					break;
 				case PrimitiveType::Pyramid:
 					mesh = Mesh::createPyramid();
@@ -50,7 +51,9 @@ namespace maple
 			else
 			{
 				model = ent.tryGetComponentFromParent<Model>();
-				mesh = model->resource->find(name);
+				//stays null while the file is still loading.
+				if (model != nullptr && model->poll() && model->resource != nullptr)
+					mesh = model->resource->find(name);
 			}
 		}
 
@@ -71,7 +74,24 @@ namespace maple
 			if (type == PrimitiveType::File)
 			{
 				resources.clear();
-				Loader::load(filePath, resources);
+				resource = nullptr;
+				skeleton = nullptr;
+				loading  = Application::getAssetsLoaderFactory()->loadAsync(filePath);
+				poll();
+			}
+		}
+
+		auto Model::poll() -> bool
+		{
+			if (loading == nullptr)
+				return true;
+
+			if (!loading->isDone())
+				return false;
+
+			if (loading->isReady())
+			{
+				resources = loading->getResources();
 				for (auto res : resources)
 				{
 					if (res->getResourceType() == FileType::Model)
@@ -84,6 +104,8 @@ namespace maple
 					}
 				}
 			}
+			loading = nullptr;
+			return true;
 		}
 
 
@@ -100,6 +122,8 @@ namespace maple
 			auto currentScene = Application::get()->getSceneManager()->getCurrentScene();
 			Entity ent{ entity, currentScene->getRegistry() };
 			auto model = ent.tryGetComponentFromParent<Model>();
+			if (model == nullptr || !model->poll() || model->resource == nullptr)
+				return;
 			mesh = model->resource->find(name);
 			skeleton = model->skeleton;
 		}
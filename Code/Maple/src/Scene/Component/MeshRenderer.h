@@ -16,6 +16,7 @@ namespace maple
 	class Mesh;
 	class MeshResource;
 	class Skeleton;
+	class AssetsLoadHandle;
 
 	namespace component
 	{
@@ -53,6 +54,14 @@ namespace maple
 				load();
 			}
 
+			//picks up the resources once the background load has finished, true if nothing is pending anymore.
+			auto poll() -> bool;
+
+			inline auto isLoading() const
+			{
+				return loading != nullptr;
+			}
+
 			std::string                   filePath;
 			PrimitiveType                 type = PrimitiveType::Length;
 			std::shared_ptr<MeshResource> resource;
@@ -60,6 +69,7 @@ namespace maple
 			std::shared_ptr<Skeleton> skeleton;
 		  private:
 			auto load() -> void;
+			std::shared_ptr<AssetsLoadHandle> loading;
 		};
 
 		class MAPLE_EXPORT SkinnedMeshRenderer : public Component 
@@ -49,6 +49,12 @@ namespace maple
 				return worldMatrix;
 			}
 
+			//systems reading transforms only, the world matrix is the one the scene graph wrote last.
+			inline auto& getWorldMatrix() const
+			{
+				return worldMatrix;
+			}
+
 			inline const auto& getWorldMatrixInverse()
 			{
 				if (dirty)
@@ -24,6 +24,8 @@
 #include "Engine/Material.h"
 #include "Engine/Profiler.h"
 #include "Engine/Mesh.h"
+#include "Engine/Renderer/SkinningPalette.h"
+#include "Loaders/Loader.h"
 
 #include "Others/Serialization.h"
 #include "Others/StringUtils.h"
@@ -80,11 +82,19 @@ namespace maple
 		sceneGraph = std::make_shared<SceneGraph>();
 		sceneGraph->init(entityManager->getRegistry());
 		entityManager->getRegistry().on_construct<component::MeshRenderer>().connect<&Scene::onMeshRenderCreated>(this);
+		entityManager->getRegistry().on_construct<component::SkinnedMeshRenderer>().connect<&Scene::onMeshRenderCreated>(this);
+		entityManager->getRegistry().on_destroy<component::MeshRenderer>().connect<&Scene::onMeshRenderDestroyed>(this);
+		entityManager->getRegistry().on_destroy<component::SkinnedMeshRenderer>().connect<&Scene::onMeshRenderDestroyed>(this);
+		entityManager->getRegistry().on_construct<component::SkinnedMeshRenderer>().connect<&skinning_palette::onSkinningChanged>();
+		entityManager->getRegistry().on_destroy<component::SkinnedMeshRenderer>().connect<&skinning_palette::onSkinningChanged>();
+		entityManager->getRegistry().on_construct<component::BoneComponent>().connect<&skinning_palette::onSkinningChanged>();
+		entityManager->getRegistry().on_destroy<component::BoneComponent>().connect<&skinning_palette::onSkinningChanged>();
 
 		globalEntity = createEntity("Global");
 
 		getGlobalComponent<component::BoundingBoxComponent>();
 		getGlobalComponent<component::DeltaTime>();
+		getGlobalComponent<component::CullingData>();
 	}
 
 	auto Scene::getRegistry() -> entt::registry &
@@ -227,34 +237,210 @@ namespace maple
 		aabb.box = &sceneBox;
 	}
 
-	auto Scene::onMeshRenderCreated() -> void
+	auto Scene::onMeshRenderCreated(entt::registry &registry, entt::entity entity) -> void
 	{
 		boxDirty = true;
+		cullingAdded.emplace_back(entity);
 	}
 
-	auto Scene::addMesh(const std::string& file) -> Entity
+	auto Scene::onMeshRenderDestroyed() -> void
+	{
+		boxDirty = true;
+		cullingDirty = true;
+	}
+
+	auto Scene::updateCulling() -> void
+	{
+		PROFILE_FUNCTION();
+		auto &registry = entityManager->getRegistry();
+		auto &culling  = getGlobalComponent<component::CullingData>();
+		culling.frame++;
+
+		auto updateBounds = [&](uint32_t index, const std::shared_ptr<Mesh> &mesh, component::Transform &transform) {
+			auto &proxy = culling.proxies[index];
+			if (mesh != nullptr && mesh->getBoundingBox() != nullptr && mesh->getBoundingBox()->isDefined())
+			{
+				culling.worldBounds.set(index, *mesh->getBoundingBox(), transform.getWorldMatrix());
+				//the fat box in the tree absorbs small movements, only larger ones reinsert.
+				if (proxy == DynamicAABBTree::NullNode)
+				{
+					proxy = culling.tree.createProxy(culling.worldBounds.get(index), index);
+					//a mesh which finished loading is culled by the tree from now on.
+					if (auto iter = std::find(culling.unbounded.begin(), culling.unbounded.end(), index); iter != culling.unbounded.end())
+						culling.unbounded.erase(iter);
+				}
+				else
+					culling.tree.moveProxy(proxy, culling.worldBounds.get(index));
+			}
+			else
+			{
+				culling.worldBounds.set(index, BoundingBox{});
+				if (proxy != DynamicAABBTree::NullNode)
+				{
+					culling.tree.destroyProxy(proxy);
+					proxy = DynamicAABBTree::NullNode;
+				}
+				//a null mesh is still loading, it is culled until the scene is refreshed after the load.
+				if (mesh != nullptr && std::find(culling.unbounded.begin(), culling.unbounded.end(), index) == culling.unbounded.end())
+					culling.unbounded.emplace_back(index);
+			}
+		};
+
+		if (cullingDirty)
+		{
+			cullingDirty   = false;
+			unboundedDirty = false;
+			cullingAdded.clear();
+			cullingIndices.clear();
+			culling.entities.clear();
+			culling.skinned.clear();
+			culling.unbounded.clear();
+			culling.tree.clear();
+
+			auto meshView    = registry.view<component::MeshRenderer, component::Transform>();
+			auto skinnedView = registry.view<component::SkinnedMeshRenderer, component::Transform>();
+			culling.worldBounds.resize(static_cast<uint32_t>(meshView.size() + skinnedView.size()));
+			culling.proxies.assign(meshView.size() + skinnedView.size(), DynamicAABBTree::NullNode);
+
+			for (auto entity : meshView)
+			{
+				auto [mesh, transform] = meshView.get<component::MeshRenderer, component::Transform>(entity);
+				const auto index       = static_cast<uint32_t>(culling.entities.size());
+				updateBounds(index, mesh.getMesh(), transform);
+				cullingIndices[entity] = index;
+				culling.entities.emplace_back(entity);
+				culling.skinned.emplace_back(0);
+			}
+
+			for (auto entity : skinnedView)
+			{
+				auto [mesh, transform] = skinnedView.get<component::SkinnedMeshRenderer, component::Transform>(entity);
+				const auto index       = static_cast<uint32_t>(culling.entities.size());
+				updateBounds(index, mesh.getMesh(), transform);
+				cullingIndices[entity] = index;
+				culling.entities.emplace_back(entity);
+				culling.skinned.emplace_back(1);
+			}
+			culling.worldBounds.resize(static_cast<uint32_t>(culling.entities.size()));
+			culling.proxies.resize(culling.entities.size(), DynamicAABBTree::NullNode);
+			//everything starts as static, meshes which move afterwards leave the static set.
+			culling.movedFrame.assign(culling.entities.size(), culling.frame - component::CullingData::STATIC_FRAMES);
+			culling.moving.clear();
+			culling.staticVersion++;
+			return;
+		}
+
+		//renderers added since the last frame (e.g. a streamed model was expanded) are inserted on their own,
+		//they start as moving and join the static set once they kept still.
+		for (auto entity : cullingAdded)
+		{
+			if (!registry.valid(entity) || cullingIndices.count(entity) > 0)
+				continue;
+
+			const auto mesh    = registry.try_get<component::MeshRenderer>(entity);
+			const auto skinned = mesh == nullptr ? registry.try_get<component::SkinnedMeshRenderer>(entity) : nullptr;
+			auto       transform = registry.try_get<component::Transform>(entity);
+			if ((mesh == nullptr && skinned == nullptr) || transform == nullptr)
+				continue;
+
+			const auto index = static_cast<uint32_t>(culling.entities.size());
+			culling.worldBounds.resize(index + 1);
+			culling.proxies.emplace_back(DynamicAABBTree::NullNode);
+			culling.entities.emplace_back(entity);
+			culling.skinned.emplace_back(skinned != nullptr ? 1 : 0);
+			culling.movedFrame.emplace_back(culling.frame);
+			culling.moving.emplace_back(index);
+			cullingIndices[entity] = index;
+			updateBounds(index, mesh != nullptr ? mesh->getMesh() : skinned->getMesh(), *transform);
+		}
+		cullingAdded.clear();
+
+		if (unboundedDirty)
+		{
+			unboundedDirty = false;
+			//updateBounds takes the meshes which got their bounds out of the list.
+			const auto unbounded = culling.unbounded;
+			for (auto index : unbounded)
+			{
+				const auto entity    = culling.entities[index];
+				auto &     transform = registry.get<component::Transform>(entity);
+				if (culling.skinned[index])
+					updateBounds(index, registry.get<component::SkinnedMeshRenderer>(entity).getMesh(), transform);
+				else
+					updateBounds(index, registry.get<component::MeshRenderer>(entity).getMesh(), transform);
+			}
+		}
+
+		//only boxes whose world matrix changed this frame are refreshed.
+		for (auto entity : sceneGraph->getUpdatedEntities())
+		{
+			auto iter = cullingIndices.find(entity);
+			if (iter == cullingIndices.end())
+				continue;
+
+			if (culling.isStatic(iter->second))
+			{
+				culling.moving.emplace_back(iter->second);
+				culling.staticVersion++;
+			}
+			culling.movedFrame[iter->second] = culling.frame;
+
+			auto &transform = registry.get<component::Transform>(entity);
+			if (culling.skinned[iter->second])
+				updateBounds(iter->second, registry.get<component::SkinnedMeshRenderer>(entity).getMesh(), transform);
+			else
+				updateBounds(iter->second, registry.get<component::MeshRenderer>(entity).getMesh(), transform);
+		}
+
+		//meshes which came to rest join the static set again.
+		const auto settled = std::remove_if(culling.moving.begin(), culling.moving.end(), [&](uint32_t index) {
+			return culling.isStatic(index);
+		});
+		if (settled != culling.moving.end())
+		{
+			culling.moving.erase(settled, culling.moving.end());
+			culling.staticVersion++;
+		}
+	}
+
+	auto Scene::addMesh(const std::string& file, bool useSkeleton) -> Entity
 	{
 		PROFILE_FUNCTION();
 
 		auto  name = StringUtils::getFileNameWithoutExtension(file);
 		auto  modelEntity = createEntity(name);
 		auto& model = modelEntity.addComponent<component::Model>(file);
+		if (model.isLoading())
+			pendingModels.push_back({modelEntity.getHandle(), useSkeleton});
+		else
+			expandModel(modelEntity, useSkeleton);
+		return modelEntity;
+	}
+
+	auto Scene::expandModel(Entity modelEntity, bool useSkeleton) -> void
+	{
+		PROFILE_FUNCTION();
+		auto& model = modelEntity.getComponent<component::Model>();
+		if (model.resource == nullptr)
+			return;
+
 		if (model.resource->getMeshes().size() == 1)
 		{
 			modelEntity.addComponent<component::MeshRenderer>(model.resource->getMeshes().begin()->second);
 		}
 		else
 		{
-			if (model.skeleton)
+			const auto skeleton = useSkeleton ? model.skeleton : nullptr;
+			if (skeleton)
 			{
-				model.skeleton->buildRoot();
-				auto rootEntity = addEntity(this, modelEntity, model.skeleton.get(), model.skeleton->getRoot());
+				skeleton->buildRoot();
+				auto rootEntity = addEntity(this, modelEntity, skeleton.get(), skeleton->getRoot());
 			}
 
 			for (auto& mesh : model.resource->getMeshes())
 			{
 				auto child = createEntity(mesh.first);
-				if (model.skeleton)
+				if (skeleton)
 				{
 					auto & meshRenderer = child.addComponent<component::SkinnedMeshRenderer>(mesh.second);
 				}
@@ -265,8 +451,39 @@ namespace maple
 				child.setParent(modelEntity);
 			}
 		}
-		model.type = component::PrimitiveType::File;
-		return modelEntity;
+	}
+
+	auto Scene::updatePendingModels() -> void
+	{
+		PROFILE_FUNCTION();
+		const auto completed = Application::getAssetsLoaderFactory()->getCompletedCount();
+		if (completed == loadedAssets)
+			return;
+
+		//meshes which were still loading are resolved again.
+		loadedAssets   = completed;
+		unboundedDirty = true;
+		boxDirty       = true;
+
+		auto &registry = entityManager->getRegistry();
+		for (auto iter = pendingModels.begin(); iter != pendingModels.end();)
+		{
+			auto model = registry.valid(iter->entity) ? registry.try_get<component::Model>(iter->entity) : nullptr;
+			if (model == nullptr)
+			{
+				//removed before the load has finished.
+				iter = pendingModels.erase(iter);
+				continue;
+			}
+
+			if (model->poll())
+			{
+				expandModel({iter->entity, registry}, iter->useSkeleton);
+				iter = pendingModels.erase(iter);
+				continue;
+			}
+			iter++;
+		}
 	}
 
 	auto Scene::copyComponents(const Entity& from, const Entity& to) -> void
@@ -313,13 +530,9 @@ namespace maple
 		auto& deltaTime = getGlobalComponent<component::DeltaTime>();
 		deltaTime.dt = dt;
 		updateCameraController(dt);
+		updatePendingModels();
 		getBoundingBox();
 		sceneGraph->update(entityManager->getRegistry());
-		auto view = entityManager->getRegistry().view<component::AnimatedSprite, component::Transform>();
-		for (auto entity : view)
-		{
-			const auto &[anim, trans] = view.get<component::AnimatedSprite, component::Transform>(entity);
-			anim.onUpdate(dt);
-		}
+		updateCulling();
 	}
 };        // namespace maple
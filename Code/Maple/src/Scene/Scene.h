@@ -122,12 +122,18 @@ namespace maple
 		inline auto& getBoundingBox() { if (boxDirty) calculateBoundingBox();  return sceneBox; }
 
 		auto calculateBoundingBox() -> void;
-		auto onMeshRenderCreated() -> void;
+		//new renderers are appended to the culling data, removing one rebuilds it.
+		auto onMeshRenderCreated(entt::registry &registry, entt::entity entity) -> void;
+		auto onMeshRenderDestroyed() -> void;
 		
-		auto addMesh(const std::string& file) -> Entity;
+		//the file is loaded in the background, child entities for its meshes are added once it has finished.
+		auto addMesh(const std::string& file, bool useSkeleton = true) -> Entity;
 
 	  protected:
 		auto updateCameraController(float dt) -> void;
+		auto updateCulling() -> void;
+		auto updatePendingModels() -> void;
+		auto expandModel(Entity modelEntity, bool useSkeleton) -> void;
 		auto copyComponents(const Entity &from, const Entity &to) -> void;
 
 		std::shared_ptr<SceneGraph>    sceneGraph;
@@ -154,5 +160,19 @@ namespace maple
 
 		BoundingBox sceneBox;
 		bool boxDirty = false;
+
+		std::unordered_map<entt::entity, uint32_t> cullingIndices;
+		std::vector<entt::entity>                  cullingAdded;
+		bool cullingDirty = true;
+		//a load finished, meshes without bounds are looked at again.
+		bool unboundedDirty = false;
+
+		struct PendingModel
+		{
+			entt::entity entity;
+			bool         useSkeleton;
+		};
+		std::vector<PendingModel> pendingModels;
+		uint32_t                  loadedAssets = 0;
 	};
 };        // namespace maple
@@ -6,15 +6,27 @@
 #include "Component/Component.h"
 #include "Component/Transform.h"
 #include "Component/MeshRenderer.h"
+#include "Thread/ParallelForEach.h"
 
 #include "Engine/Profiler.h"
 namespace maple 
 {
+	namespace
+	{
+		//below this amount of transforms the job overhead is bigger than the work.
+		constexpr uint32_t PARALLEL_THRESHOLD = 4096;
+		constexpr uint32_t FLAT_GRAIN_SIZE    = 1024;
+	}
+
 	auto SceneGraph::init(entt::registry& registry) -> void
 	{
 		registry.on_construct<component::Hierarchy>().connect<&component::Hierarchy::onConstruct>();
 		registry.on_update<component::Hierarchy>().connect<&component::Hierarchy::onUpdate>();
 		registry.on_destroy<component::Hierarchy>().connect<&component::Hierarchy::onDestroy>();
+
+		//cached transform pointers are invalidated when the storage grows or is compacted.
+		registry.on_construct<component::Transform>().connect<&SceneGraph::onTransformChanged>(this);
+		registry.on_destroy<component::Transform>().connect<&SceneGraph::onTransformChanged>(this);
 	}
 
 	auto SceneGraph::disconnectOnConstruct(bool disable, entt::registry& registry)  -> void
@@ -25,27 +37,130 @@ namespace maple
 			registry.on_construct<component::Hierarchy>().connect<&component::Hierarchy::onConstruct>();
 	}
 
-	auto SceneGraph::update(entt::registry& registry)  -> void
+	auto SceneGraph::onTransformChanged(entt::registry& registry, entt::entity entity) -> void
+	{
+		structureChanged = true;
+	}
+
+	auto SceneGraph::rebuild(entt::registry& registry) -> void
 	{
 		PROFILE_FUNCTION();
-		auto nonHierarchyView = registry.view<component::Transform>(entt::exclude<component::Hierarchy>);
+		nodes.clear();
+		entities.clear();
+		roots.clear();
 
+		auto nonHierarchyView = registry.view<component::Transform>(entt::exclude<component::Hierarchy>);
 		for (auto entity : nonHierarchyView)
 		{
-			registry.get<component::Transform>(entity).setWorldMatrix(glm::mat4{1.f});
+			nodes.push_back({&nonHierarchyView.get<component::Transform>(entity), -1});
+			entities.emplace_back(entity);
 		}
+		flatCount = static_cast<uint32_t>(nodes.size());
 
-		auto view = registry.view<component::Transform, component::Hierarchy>();
+		std::vector<std::pair<entt::entity, int32_t>> stack;
+
+		auto view = registry.view<component::Hierarchy>();
 		for (auto entity : view)
 		{
-			const auto hierarchy = registry.try_get<component::Hierarchy>(entity);
-			if (hierarchy && hierarchy->getParent() == entt::null)
+			if (view.get<component::Hierarchy>(entity).getParent() != entt::null)
+				continue;
+
+			const auto begin = static_cast<uint32_t>(nodes.size());
+			stack.emplace_back(entity, -1);
+			while (!stack.empty())
 			{
-				//Recursively update children
-				updateTransform(entity, registry);
+				auto [current, parent] = stack.back();
+				stack.pop_back();
+
+				//entities without transform are skipped, their children attach to the closest transformed ancestor.
+				if (auto transform = registry.try_get<component::Transform>(current))
+				{
+					nodes.push_back({transform, parent});
+					entities.emplace_back(current);
+					parent = static_cast<int32_t>(nodes.size()) - 1;
+				}
+
+				auto &hierarchy = registry.get<component::Hierarchy>(current);
+				for (auto child = hierarchy.getFirst(); child != entt::null;)
+				{
+					auto childHierarchy = registry.try_get<component::Hierarchy>(child);
+					if (childHierarchy == nullptr)
+						break;
+					stack.emplace_back(child, parent);
+					child = childHierarchy->getNext();
+				}
+			}
+
+			if (nodes.size() > begin)
+			{
+				roots.emplace_back(begin, static_cast<uint32_t>(nodes.size()));
 			}
 		}
 
+		changed.assign(nodes.size(), 0);
+		hierarchyVersion = component::Hierarchy::getVersion();
+		structureChanged = false;
+	}
+
+	auto SceneGraph::updateRange(uint32_t begin, uint32_t end, bool force) -> void
+	{
+		static const glm::mat4 identity{1.f};
+
+		for (auto i = begin; i < end; i++)
+		{
+			auto &node      = nodes[i];
+			auto &transform = *node.transform;
+
+			//resolves pending setLocal* calls, which raises the hasUpdate flag.
+			transform.getLocalMatrix();
+
+			const bool parentChanged = node.parent >= 0 && changed[node.parent];
+			changed[i]               = parentChanged || transform.hasUpdated();
+
+			if (changed[i] || force)
+			{
+				//a forced pass recomputes every matrix, but only the ones which really moved count as updated.
+				const glm::mat4 previous = transform.getWorldMatrix();
+				transform.setWorldMatrix(node.parent >= 0 ? nodes[node.parent].transform->getWorldMatrix() : identity);
+				transform.setHasUpdated(false);
+				changed[i] = changed[i] || transform.getWorldMatrix() != previous;
+			}
+		}
+	}
+
+	auto SceneGraph::update(entt::registry& registry)  -> void
+	{
+		PROFILE_FUNCTION();
+		const bool force = structureChanged || hierarchyVersion != component::Hierarchy::getVersion();
+		if (force)
+		{
+			rebuild(registry);
+		}
+
+		const auto count = static_cast<uint32_t>(nodes.size());
+		if (count < PARALLEL_THRESHOLD)
+		{
+			updateRange(0, count, force);
+		}
+		else
+		{
+			//transforms without hierarchy are independent, split them freely.
+			parallelForChunk(0, flatCount, FLAT_GRAIN_SIZE, [&](uint32_t begin, uint32_t end) {
+				updateRange(begin, end, force);
+			});
+
+			//each root owns its subtree, so different roots never touch each other.
+			parallelFor(0, static_cast<uint32_t>(roots.size()), 16, [&](uint32_t i) {
+				updateRange(roots[i].first, roots[i].second, force);
+			});
+		}
+
+		updatedEntities.clear();
+		for (uint32_t i = 0; i < count; i++)
+		{
+			if (changed[i])
+				updatedEntities.emplace_back(entities[i]);
+		}
 	}
 
 	auto SceneGraph::updateTransform(entt::entity entity, entt::registry& registry)  -> void
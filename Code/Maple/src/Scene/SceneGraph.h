@@ -3,12 +3,18 @@
 //////////////////////////////////////////////////////////////////////////////
 #pragma once
 #include <string>
+#include <vector>
 #include "Engine/Core.h"
 
 #include <entt/entity/fwd.hpp>
 
 namespace maple
 {
+	namespace component
+	{
+		class Transform;
+	}
+
 	class MAPLE_EXPORT SceneGraph final
 	{
 	public:
@@ -18,7 +24,33 @@ namespace maple
 		auto disconnectOnConstruct(bool disable, entt::registry & registry) -> void;
 		auto update(entt::registry & registry) -> void;
 		auto updateTransform(entt::entity entity, entt::registry & registry)-> void;
+
+		//entities whose world matrix was recomputed by the last update.
+		inline auto& getUpdatedEntities() const
+		{
+			return updatedEntities;
+		}
 	private:
+		struct Node
+		{
+			component::Transform *transform;
+			int32_t               parent;        //index into nodes, -1 for roots
+		};
+
+		auto onTransformChanged(entt::registry & registry, entt::entity entity) -> void;
+		auto rebuild(entt::registry & registry) -> void;
+		auto updateRange(uint32_t begin, uint32_t end, bool force) -> void;
+
+		//[0, flatCount) are transforms without hierarchy, followed by every hierarchy in depth first order,
+		//so a parent is always placed before its children and each root owns a contiguous range.
+		std::vector<Node>                             nodes;
+		std::vector<entt::entity>                     entities;
+		std::vector<uint8_t>                          changed;
+		std::vector<std::pair<uint32_t, uint32_t>>    roots;
+		std::vector<entt::entity>                     updatedEntities;
+		uint32_t                                      flatCount        = 0;
+		uint32_t                                      hierarchyVersion = UINT32_MAX;
+		bool                                          structureChanged = true;
 	};
 
-};
\ No newline at end of file
+};
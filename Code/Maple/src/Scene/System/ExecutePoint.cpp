@@ -1,3 +1,95 @@
 //////////////////////////////////////////////////////////////////////////////
 // This file is part of the Maple Engine                              		//
 //////////////////////////////////////////////////////////////////////////////
+
+#include "ExecutePoint.h"
+#include "Thread/JobSystem.h"
+
+namespace maple
+{
+	auto ExecutePoint::buildDependencies(ExecuteQueue &queue) -> void
+	{
+		PROFILE_FUNCTION();
+		const auto count = static_cast<uint32_t>(queue.jobs.size());
+
+		queue.dependencies.assign(count, {});
+		std::vector<std::vector<bool>> ancestors(count, std::vector<bool>(count, false));
+		std::vector<uint32_t>          dependents(count, 0);
+		std::vector<uint32_t>          lastDependent(count, 0);
+
+		for (uint32_t i = 0; i < count; i++)
+		{
+			//jobs without access information (e.g. pushed manually) run alone.
+			const SystemAccess exclusive{{}, {}, true};
+			const auto &       access = i < queue.access.size() ? queue.access[i] : exclusive;
+
+			//walk backwards so the closest conflicting system is picked first,
+			//systems which are already ordered through another dependency are skipped.
+			for (int32_t j = static_cast<int32_t>(i) - 1; j >= 0; j--)
+			{
+				if (ancestors[i][j])
+					continue;
+
+				const auto &other = static_cast<uint32_t>(j) < queue.access.size() ? queue.access[j] : exclusive;
+				if (!access.conflictWith(other))
+					continue;
+
+				//a job only keeps a few continuations, hang onto one of its dependents instead.
+				uint32_t carrier = j;
+				while (dependents[carrier] >= Job::MAX_CONTINUATIONS)
+				{
+					carrier = lastDependent[carrier];
+				}
+
+				queue.dependencies[i].emplace_back(carrier);
+				dependents[carrier]++;
+				lastDependent[carrier] = i;
+				ancestors[i][carrier]  = true;
+				for (uint32_t k = 0; k < i; k++)
+				{
+					if (ancestors[carrier][k])
+						ancestors[i][k] = true;
+				}
+			}
+		}
+	}
+
+	auto ExecutePoint::run(ExecuteQueue &queue, entt::registry &reg) -> void
+	{
+		auto jobSystem = JobSystem::get();
+		if (!queue.parallel || jobSystem == nullptr || queue.jobs.size() < 2)
+		{
+			for (auto &job : queue.jobs)
+			{
+				job(reg);
+			}
+			return;
+		}
+
+		if (queue.dependencies.size() != queue.jobs.size())
+		{
+			buildDependencies(queue);
+		}
+
+		std::vector<JobHandle> handles;
+		handles.reserve(queue.jobs.size());
+
+		auto group = jobSystem->createGroup();
+		for (size_t i = 0; i < queue.jobs.size(); i++)
+		{
+			auto handle = jobSystem->create([&job = queue.jobs[i], &reg]() { job(reg); }, group);
+			for (auto dep : queue.dependencies[i])
+			{
+				jobSystem->addDependency(handle, handles[dep]);
+			}
+			handles.emplace_back(handle);
+		}
+
+		for (auto handle : handles)
+		{
+			jobSystem->run(handle);
+		}
+		jobSystem->run(group);
+		jobSystem->wait(group);
+	}
+};        // namespace maple
@@ -6,6 +6,7 @@
 
 #include "Engine/Core.h"
 #include "Engine/Profiler.h"
+#include "SystemAccess.h"
 
 #include <ecs/SystemBuilder.h>
 #include <ecs/World.h>
@@ -16,13 +17,23 @@ namespace maple
 	{
 		std::string name;
 		std::vector<std::function<void(entt::registry& )>> jobs;
+		std::vector<SystemAccess> access;
 		std::function<void(ecs::World)> preCall =  [](ecs::World) {};
 		std::function<void(ecs::World)> postCall = [](ecs::World) {};
+		//systems without conflicting component access run on the job system at the same time.
+		bool parallel = false;
+		//dependencies[i] are the systems which must be finished before jobs[i] starts.
+		std::vector<std::vector<uint32_t>> dependencies;
 	};
 
 	class ExecutePoint
 	{
 	  public:
+		ExecutePoint()
+		{
+			updateQueue.parallel = true;
+		}
+
 		inline auto registerQueue(ExecuteQueue &queue)
 		{
 			graph.emplace_back(&queue);
@@ -36,12 +47,30 @@ namespace maple
 				if (onInit != nullptr)
 					onInit(comp);
 			});
+			factoryQueue.access.push_back({{}, {}, true});
 		}
 
-		template <auto System>
+		//shaders the registered components create, RenderGraph builds them together before the factory queue runs.
+		inline auto registerShaders(const std::vector<std::string> &paths) -> void
+		{
+			for (auto &path : paths)
+			{
+				if (std::find(shaders.begin(), shaders.end(), path) == shaders.end())
+					shaders.emplace_back(path);
+			}
+		}
+
+		inline auto getShaders() const -> const std::vector<std::string> &
+		{
+			return shaders;
+		}
+
+		//Extra : ecs::Chain of the components the system reaches through ecs::World or pointers, it is scheduled as writing
+		//everything when it takes the world without one.
+		template <auto System, typename Extra = void>
 		inline auto registerSystem() -> void
 		{
-			expand(ecs::FunctionConstant<System>{}, updateQueue);
+			expand<System, Extra>(ecs::FunctionConstant<System>{}, updateQueue);
 		}
 
 		template <auto System>
@@ -50,10 +79,10 @@ namespace maple
 			expand(ecs::FunctionConstant<System>{}, imGuiQueue);
 		}
 
-		template <auto System>
+		template <auto System, typename Extra = void>
 		inline auto registerWithinQueue(ExecuteQueue &queue)
 		{
-			expand(ecs::FunctionConstant<System>{}, queue);
+			expand<System, Extra>(ecs::FunctionConstant<System>{}, queue);
 		}
 
 	  private:
@@ -66,10 +95,7 @@ namespace maple
 
 		  inline auto onUpdate(float dt, entt::registry& reg)
 		  {
-			  for (auto& job : updateQueue.jobs)
-			  {
-				  job(reg);
-			  }
+			  run(updateQueue, reg);
 		  }
 
 		  inline auto executeImGui(entt::registry& reg)
@@ -94,17 +120,15 @@ namespace maple
 			  for (auto g : graph)
 			  {
 				  g->preCall(ecs::World{ reg,globalEntity });
-				  for (auto& func : g->jobs)
-				  {
-					  func(reg);
-				  }
+				  run(*g, reg);
 				  g->postCall(ecs::World{ reg,globalEntity });
 			  }
 		  }
 
-		template <auto System>
+		template <auto System, typename Extra = void>
 		inline auto expand(ecs::FunctionConstant<System> system, ExecuteQueue &queue) -> void
 		{
+			queue.access.emplace_back(system_access::build<Extra>(System));
 			build(system, queue);
 		}
 
@@ -119,6 +143,9 @@ namespace maple
 			});
 		}
 
+		auto run(ExecuteQueue &queue, entt::registry &reg) -> void;
+		auto buildDependencies(ExecuteQueue &queue) -> void;
+
 		ExecuteQueue updateQueue;
 
 		ExecuteQueue imGuiQueue;
@@ -127,6 +154,8 @@ namespace maple
 
 		std::vector<ExecuteQueue *> graph;
 
+		std::vector<std::string> shaders;
+
 		entt::entity globalEntity = entt::null;
 	};
 };        // namespace maple
@@ -0,0 +1,144 @@
+//////////////////////////////////////////////////////////////////////////////
+// This file is part of the Maple Engine                              		//
+//////////////////////////////////////////////////////////////////////////////
+#pragma once
+
+#include <algorithm>
+#include <cctype>
+#include <string_view>
+#include <type_traits>
+#include <vector>
+
+#include <ecs/World.h>
+#include <entt/core/type_info.hpp>
+
+namespace maple
+{
+	/**
+	 * component access of one system, gathered from the ecs::Chain Read/Write declarations of its parameters.
+	 * components which are only exposed as const are reads, everything else is a write.
+	 * ecs::World reaches any component, a system taking it counts as writing everything unless it is registered
+	 * with an explicit chain of what it uses besides its parameters.
+	 */
+	struct SystemAccess
+	{
+		std::vector<entt::id_type> reads;
+		std::vector<entt::id_type> writes;
+		//the system can not be reasoned about, it runs alone.
+		bool exclusive = false;
+
+		inline auto conflictWith(const SystemAccess &other) const -> bool
+		{
+			if (exclusive || other.exclusive)
+				return true;
+
+			auto contains = [](const std::vector<entt::id_type> &ids, entt::id_type id) {
+				return std::find(ids.begin(), ids.end(), id) != ids.end();
+			};
+
+			for (auto id : writes)
+			{
+				if (contains(other.writes, id) || contains(other.reads, id))
+					return true;
+			}
+
+			for (auto id : reads)
+			{
+				if (contains(other.writes, id))
+					return true;
+			}
+			return false;
+		}
+	};
+
+	namespace system_access
+	{
+		template <typename T>
+		auto collect(SystemAccess &access) -> void;
+
+		template <typename T>
+		struct Unwrap
+		{
+			static constexpr bool value = false;
+		};
+
+		template <template <typename...> class TT, typename... Args>
+		struct Unwrap<TT<Args...>>
+		{
+			static constexpr bool value = true;
+
+			//read permissions (Read/ReadIfExist) pass their component on as const.
+			template <bool ReadOnly>
+			static auto collect(SystemAccess &access) -> void
+			{
+				(system_access::collect<std::conditional_t<ReadOnly, const Args, Args>>(access), ...);
+			}
+		};
+
+		inline auto isEcsType(std::string_view name) -> bool
+		{
+			auto pos = name.find("ecs::");
+			return pos != std::string_view::npos && (pos == 0 || !(std::isalnum(name[pos - 1]) || name[pos - 1] == '_'));
+		}
+
+		inline auto isReadPermission(std::string_view name) -> bool
+		{
+			name = name.substr(0, name.find('<'));
+			return isEcsType(name) && name.find("Read") != std::string_view::npos;
+		}
+
+		template <typename T>
+		auto collect(SystemAccess &access) -> void
+		{
+			using Type = std::remove_pointer_t<std::remove_reference_t<T>>;
+			using Raw  = std::remove_cv_t<Type>;
+
+			if constexpr (std::is_same_v<Raw, ecs::World> || !std::is_class_v<Raw>)
+			{
+				//what is fetched through the world comes from the declared chain, see build.
+			}
+			else if constexpr (Unwrap<Raw>::value)
+			{
+				if (isReadPermission(entt::type_info<Raw>::name()))
+					Unwrap<Raw>::template collect<true>(access);
+				else
+					Unwrap<Raw>::template collect<false>(access);
+			}
+			else
+			{
+				if (isEcsType(entt::type_info<Raw>::name()))
+				{
+					//empty types inside the chain are tags (Entity/Query...), anything else is opaque to us.
+					access.exclusive |= !std::is_empty_v<Raw>;
+					return;
+				}
+
+				auto &ids = std::is_const_v<Type> ? access.reads : access.writes;
+				const auto id = entt::type_info<Raw>::id();
+				if (std::find(ids.begin(), ids.end(), id) == ids.end())
+					ids.emplace_back(id);
+			}
+		}
+
+		template <typename T>
+		constexpr bool isWorld = std::is_same_v<std::remove_cv_t<std::remove_pointer_t<std::remove_reference_t<T>>>, ecs::World>;
+
+		//Extra is an ecs::Chain of the components reached without the parameters (through the world or stored pointers), or void.
+		template <typename Extra, typename R, typename... Args>
+		inline auto build(R (*)(Args...)) -> SystemAccess
+		{
+			SystemAccess access;
+			(collect<Args>(access), ...);
+			if constexpr (std::is_void_v<Extra>)
+				access.exclusive |= (isWorld<Args> || ...);
+			else
+				collect<Extra>(access);
+			//a component which is read and written somewhere counts as written.
+			access.reads.erase(std::remove_if(access.reads.begin(), access.reads.end(), [&](auto id) {
+				                   return std::find(access.writes.begin(), access.writes.end(), id) != access.writes.end();
+			                   }),
+			                   access.reads.end());
+			return access;
+		}
+	}        // namespace system_access
+};           // namespace maple
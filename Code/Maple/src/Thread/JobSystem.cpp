@@ -0,0 +1,430 @@
+//////////////////////////////////////////////////////////////////////////////
+// This file is part of the Maple Engine                              		//
+//////////////////////////////////////////////////////////////////////////////
+
+#include "JobSystem.h"
+#include "Engine/Profiler.h"
+#include "Others/Console.h"
+
+#include <string>
+
+namespace maple
+{
+	namespace
+	{
+		thread_local int32_t  workerIndex = -1;
+		thread_local uint32_t randomSeed  = 0x9E3779B9u;
+
+		inline auto nextRandom() -> uint32_t
+		{
+			//xorshift32, only used to pick a victim to steal from.
+			randomSeed ^= randomSeed << 13;
+			randomSeed ^= randomSeed >> 17;
+			randomSeed ^= randomSeed << 5;
+			return randomSeed;
+		}
+
+		inline auto lock(Job *job) -> void
+		{
+			while (job->continuationLock.exchange(true, std::memory_order_acquire))
+			{
+				std::this_thread::yield();
+			}
+		}
+
+		inline auto unlock(Job *job) -> void
+		{
+			job->continuationLock.store(false, std::memory_order_release);
+		}
+
+		constexpr int32_t SPIN_COUNT = 64;
+	}        // namespace
+
+	auto WorkStealingQueue::push(Job *job) -> bool
+	{
+		auto b = bottom.load(std::memory_order_relaxed);
+		auto t = top.load(std::memory_order_acquire);
+		if (b - t >= CAPACITY)
+		{
+			return false;
+		}
+		jobs[b & MASK].store(job, std::memory_order_relaxed);
+		std::atomic_thread_fence(std::memory_order_release);
+		bottom.store(b + 1, std::memory_order_relaxed);
+		return true;
+	}
+
+	auto WorkStealingQueue::pop() -> Job *
+	{
+		auto b = bottom.load(std::memory_order_relaxed) - 1;
+		bottom.store(b, std::memory_order_relaxed);
+		std::atomic_thread_fence(std::memory_order_seq_cst);
+		auto t = top.load(std::memory_order_relaxed);
+
+		if (t <= b)
+		{
+			Job *job = jobs[b & MASK].load(std::memory_order_relaxed);
+			if (t == b)
+			{
+				//last job, race against the thieves.
+				if (!top.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed))
+				{
+					job = nullptr;
+				}
+				bottom.store(b + 1, std::memory_order_relaxed);
+			}
+			return job;
+		}
+		bottom.store(b + 1, std::memory_order_relaxed);
+		return nullptr;
+	}
+
+	auto WorkStealingQueue::steal() -> Job *
+	{
+		auto t = top.load(std::memory_order_acquire);
+		std::atomic_thread_fence(std::memory_order_seq_cst);
+		auto b = bottom.load(std::memory_order_acquire);
+
+		if (t < b)
+		{
+			Job *job = jobs[t & MASK].load(std::memory_order_relaxed);
+			if (!top.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed))
+			{
+				return nullptr;
+			}
+			return job;
+		}
+		return nullptr;
+	}
+
+	auto WorkStealingQueue::size() const -> int64_t
+	{
+		return bottom.load(std::memory_order_relaxed) - top.load(std::memory_order_relaxed);
+	}
+
+	JobSystem *JobSystem::instance = nullptr;
+
+	JobSystem::JobSystem(uint32_t workerCount)
+	{
+		MAPLE_ASSERT(instance == nullptr, "JobSystem should be created only once");
+		instance = this;
+
+		//queue 0 belongs to the creating (main) thread.
+		const uint32_t count = workerCount + 1;
+		for (uint32_t i = 0; i < count; i++)
+		{
+			queues.emplace_back(std::make_unique<WorkStealingQueue>());
+			pools.emplace_back(std::make_unique<JobPool>());
+		}
+
+		workerIndex = 0;
+
+		for (uint32_t i = 1; i < count; i++)
+		{
+			threads.emplace_back(&JobSystem::workerLoop, this, i);
+		}
+	}
+
+	JobSystem::~JobSystem()
+	{
+		running = false;
+		{
+			std::lock_guard<std::mutex> locker(sleepMutex);
+			sleepCondition.notify_all();
+		}
+		for (auto &thread : threads)
+		{
+			if (thread.joinable())
+				thread.join();
+		}
+		instance = nullptr;
+	}
+
+	auto JobSystem::getWorkerIndex() -> int32_t
+	{
+		return workerIndex;
+	}
+
+	auto JobSystem::allocate() -> Job *
+	{
+		Job *job = tryAllocate();
+		MAPLE_ASSERT(job != nullptr, "JobSystem : job pool exhausted");
+		return job;
+	}
+
+	auto JobSystem::tryAllocate() -> Job *
+	{
+		auto allocateFrom = [](JobPool &pool) -> Job * {
+			//skip slots which are still in flight (e.g. long running asset tasks).
+			for (uint32_t i = 0; i < JobPool::SIZE; i++)
+			{
+				Job *job = &pool.jobs[pool.current++ & (JobPool::SIZE - 1)];
+				if (job->isFinished())
+				{
+					return job;
+				}
+			}
+			return nullptr;
+		};
+
+		Job *job = nullptr;
+		if (workerIndex >= 0)
+		{
+			job = allocateFrom(*pools[workerIndex]);
+		}
+		else
+		{
+			std::lock_guard<std::mutex> locker(externalMutex);
+			job = allocateFrom(externalPool);
+		}
+		if (job == nullptr)
+			return nullptr;
+
+		//a stale handle may be looking at the slot in addDependency, the reset happens under the same lock.
+		lock(job);
+		job->generation.fetch_add(1, std::memory_order_relaxed);
+		job->finished.store(false, std::memory_order_relaxed);
+		job->function          = nullptr;
+		job->parent            = nullptr;
+		job->sealed            = false;
+		job->background        = false;
+		job->continuationCount = 0;
+		job->pendingDependencies.store(1, std::memory_order_relaxed);
+		job->unfinishedJobs.store(1, std::memory_order_relaxed);
+		unlock(job);
+		return job;
+	}
+
+	auto JobSystem::createGroup(JobHandle parent) -> JobHandle
+	{
+		return create([]() {}, parent);
+	}
+
+	auto JobSystem::addDependency(JobHandle handle, JobHandle dependency) -> void
+	{
+		if (!handle.isValid() || !dependency.isValid())
+			return;
+
+		Job *job = handle.get();
+		Job *dep = dependency.get();
+
+		lock(dep);
+		if (dep->generation.load(std::memory_order_relaxed) != dependency.getGeneration() || dep->sealed || dep->isFinished())
+		{
+			unlock(dep);
+			return;
+		}
+		if (dep->continuationCount < Job::MAX_CONTINUATIONS)
+		{
+			job->pendingDependencies.fetch_add(1, std::memory_order_relaxed);
+			dep->continuations[dep->continuationCount++] = job;
+			unlock(dep);
+			return;
+		}
+		unlock(dep);
+		//too many continuations on one job, resolve the dependency right away.
+		wait(dependency);
+	}
+
+	auto JobSystem::run(JobHandle handle) -> void
+	{
+		Job *job = handle.get();
+		if (job != nullptr && job->pendingDependencies.fetch_sub(1, std::memory_order_acq_rel) == 1)
+		{
+			push(job);
+		}
+	}
+
+	auto JobSystem::wait(JobHandle handle) -> void
+	{
+		PROFILE_FUNCTION();
+		if (!handle.isValid())
+			return;
+
+		int32_t spin = 0;
+		while (!handle.isFinished())
+		{
+			if (auto next = getJob())
+			{
+				execute(next);
+				spin = 0;
+			}
+			else if (++spin > SPIN_COUNT)
+			{
+				std::this_thread::yield();
+			}
+		}
+	}
+
+	auto JobSystem::push(Job *job) -> void
+	{
+		queuedJobs.fetch_add(1, std::memory_order_seq_cst);
+
+		bool pushed = false;
+		if (job->background)
+		{
+			std::lock_guard<std::mutex> locker(backgroundMutex);
+			backgroundQueue.emplace_back(job);
+			pushed = true;
+		}
+		else if (workerIndex >= 0)
+		{
+			pushed = queues[workerIndex]->push(job);
+		}
+		else
+		{
+			std::lock_guard<std::mutex> locker(externalMutex);
+			externalQueue.emplace_back(job);
+			externalJobs.fetch_add(1, std::memory_order_release);
+			pushed = true;
+		}
+
+		if (!pushed)
+		{
+			//queue is full, do the work right now instead of dropping it.
+			queuedJobs.fetch_sub(1, std::memory_order_relaxed);
+			execute(job);
+			return;
+		}
+
+		if (sleepingWorkers.load(std::memory_order_seq_cst) > 0)
+		{
+			std::lock_guard<std::mutex> locker(sleepMutex);
+			sleepCondition.notify_one();
+		}
+	}
+
+	auto JobSystem::getJob() -> Job *
+	{
+		Job *job = nullptr;
+
+		if (workerIndex >= 0)
+		{
+			job = queues[workerIndex]->pop();
+		}
+
+		if (job == nullptr && externalJobs.load(std::memory_order_acquire) > 0)
+		{
+			std::unique_lock<std::mutex> locker(externalMutex, std::try_to_lock);
+			if (locker.owns_lock() && !externalQueue.empty())
+			{
+				job = externalQueue.front();
+				externalQueue.pop_front();
+				externalJobs.fetch_sub(1, std::memory_order_relaxed);
+			}
+		}
+
+		if (job == nullptr)
+		{
+			const uint32_t count  = static_cast<uint32_t>(queues.size());
+			const uint32_t offset = nextRandom() % count;
+			for (uint32_t i = 0; i < count && job == nullptr; i++)
+			{
+				const uint32_t victim = (offset + i) % count;
+				if (victim != static_cast<uint32_t>(workerIndex))
+				{
+					job = queues[victim]->steal();
+				}
+			}
+		}
+
+		if (job != nullptr)
+		{
+			queuedJobs.fetch_sub(1, std::memory_order_relaxed);
+		}
+		return job;
+	}
+
+	auto JobSystem::getBackgroundJob() -> Job *
+	{
+		std::lock_guard<std::mutex> locker(backgroundMutex);
+		if (backgroundQueue.empty())
+			return nullptr;
+
+		auto job = backgroundQueue.front();
+		backgroundQueue.pop_front();
+		queuedJobs.fetch_sub(1, std::memory_order_relaxed);
+		return job;
+	}
+
+	auto JobSystem::execute(Job *job) -> void
+	{
+		job->function(job, job->data);
+		finish(job);
+	}
+
+	auto JobSystem::finish(Job *job) -> void
+	{
+		if (job->unfinishedJobs.fetch_sub(1, std::memory_order_acq_rel) != 1)
+		{
+			return;
+		}
+
+		//everything needed afterwards is copied out before the slot is released, allocate() may reuse it right away.
+		Job *    continuations[Job::MAX_CONTINUATIONS];
+		Job *    parent = nullptr;
+		uint32_t count  = 0;
+		{
+			lock(job);
+			job->sealed = true;
+			parent      = job->parent;
+			count       = job->continuationCount;
+			for (uint32_t i = 0; i < count; i++)
+			{
+				continuations[i] = job->continuations[i];
+			}
+			unlock(job);
+		}
+		job->finished.store(true, std::memory_order_release);
+
+		if (parent != nullptr)
+		{
+			finish(parent);
+		}
+
+		for (uint32_t i = 0; i < count; i++)
+		{
+			run(continuations[i]);
+		}
+	}
+
+	auto JobSystem::workerLoop(uint32_t index) -> void
+	{
+		workerIndex = static_cast<int32_t>(index);
+		randomSeed  = 0x9E3779B9u * (index + 1);
+
+		const auto name = "Worker:" + std::to_string(index);
+		PROFILE_SETTHREADNAME(name.c_str());
+
+		int32_t spin = 0;
+		while (running.load(std::memory_order_relaxed))
+		{
+			auto job = getJob();
+			if (job == nullptr)
+			{
+				job = getBackgroundJob();
+			}
+
+			if (job != nullptr)
+			{
+				execute(job);
+				spin = 0;
+				continue;
+			}
+
+			if (++spin < SPIN_COUNT)
+			{
+				std::this_thread::yield();
+				continue;
+			}
+
+			std::unique_lock<std::mutex> locker(sleepMutex);
+			sleepingWorkers.fetch_add(1, std::memory_order_seq_cst);
+			sleepCondition.wait(locker, [this]() {
+				return queuedJobs.load(std::memory_order_seq_cst) > 0 || !running.load();
+			});
+			sleepingWorkers.fetch_sub(1, std::memory_order_relaxed);
+			spin = 0;
+		}
+	}
+};        // namespace maple
@@ -0,0 +1,276 @@
+//////////////////////////////////////////////////////////////////////////////
+// This file is part of the Maple Engine                              		//
+//////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "Engine/Core.h"
+
+namespace maple
+{
+	class JobSystem;
+
+	struct alignas(64) Job
+	{
+		static constexpr uint32_t MAX_CONTINUATIONS = 8;
+		static constexpr uint32_t DATA_SIZE         = 64;
+
+		using Function = void (*)(Job *, void *);
+
+		Function              function = nullptr;
+		Job *                 parent   = nullptr;
+		std::atomic<int32_t>  unfinishedJobs{0};             // self + children
+		std::atomic<int32_t>  pendingDependencies{0};        // unfinished dependencies + 1 until run() is called
+		std::atomic<bool>     continuationLock{false};
+		std::atomic<bool>     finished{true};                // set once finish() is done with the job, the slot may be reused after that
+		std::atomic<uint32_t> generation{0};                 // bumped whenever the slot is reused, see JobHandle
+		bool                  sealed            = false;
+		bool                  background        = false;        // long running, never picked up by wait()
+		uint32_t              continuationCount = 0;
+		Job *                 continuations[MAX_CONTINUATIONS] = {};
+		alignas(16) uint8_t   data[DATA_SIZE];
+
+		inline auto isFinished() const
+		{
+			return finished.load(std::memory_order_acquire);
+		}
+	};
+
+	/**
+	 * Lock free single-producer / multi-consumer deque (Chase-Lev).
+	 * The owner thread pushes and pops at the bottom, other workers steal from the top.
+	 */
+	class MAPLE_EXPORT WorkStealingQueue
+	{
+	  public:
+		static constexpr int64_t CAPACITY = 4096;
+		static constexpr int64_t MASK     = CAPACITY - 1;
+
+		auto push(Job *job) -> bool;
+		auto pop() -> Job *;
+		auto steal() -> Job *;
+		auto size() const -> int64_t;
+
+	  private:
+		alignas(64) std::atomic<int64_t> top{0};
+		alignas(64) std::atomic<int64_t> bottom{0};
+		std::atomic<Job *> jobs[CAPACITY] = {};
+	};
+
+	//job slots are pooled, the handle remembers the generation of the slot so a handle outliving its job reads as finished.
+	class MAPLE_EXPORT JobHandle
+	{
+	  public:
+		JobHandle() = default;
+		JobHandle(Job *job) :
+		    job(job), generation(job != nullptr ? job->generation.load(std::memory_order_acquire) : 0)
+		{
+		}
+
+		inline auto isValid() const
+		{
+			return job != nullptr;
+		}
+
+		//the generation is read first, a slot reused in between is caught on the next call.
+		inline auto isFinished() const
+		{
+			return job == nullptr || job->generation.load(std::memory_order_acquire) != generation || job->isFinished();
+		}
+
+		inline auto getGeneration() const
+		{
+			return generation;
+		}
+
+		inline auto get() const
+		{
+			return job;
+		}
+
+		inline operator Job *() const
+		{
+			return job;
+		}
+
+	  private:
+		Job *    job        = nullptr;
+		uint32_t generation = 0;
+	};
+
+	class MAPLE_EXPORT JobSystem final
+	{
+	  public:
+		//the thread constructing the JobSystem is registered as worker 0 and helps while waiting.
+		JobSystem(uint32_t workerCount);
+		~JobSystem();
+		NO_COPYABLE(JobSystem);
+
+		/**
+		 * create a job from any callable. small callables are stored inside the job itself,
+		 * so creating them does not touch the heap. the job does nothing until run() is called.
+		 */
+		template <typename Func>
+		inline auto create(Func &&func, JobHandle parent = {}) -> JobHandle;
+
+		//same as create, but returns an invalid handle instead of asserting when the pool of the calling thread is full.
+		template <typename Func>
+		inline auto tryCreate(Func &&func, JobHandle parent = {}) -> JobHandle;
+
+		//create + dependencies + run in one call.
+		template <typename Func, typename... Dependencies>
+		inline auto schedule(Func &&func, Dependencies... dependencies) -> JobHandle;
+
+		//long running work (asset loading, compiling...) which only idle workers pick up.
+		template <typename Func>
+		inline auto scheduleBackground(Func &&func) -> JobHandle;
+
+		//create a job with no body, useful as a counter for a group of children.
+		auto createGroup(JobHandle parent = {}) -> JobHandle;
+
+		//the job will not start before the dependency is finished. must be called before run().
+		auto addDependency(JobHandle job, JobHandle dependency) -> void;
+		auto run(JobHandle job) -> void;
+		//execute other jobs until the job (and all its children) has been finished.
+		auto wait(JobHandle job) -> void;
+
+		inline auto getWorkerCount() const
+		{
+			return static_cast<uint32_t>(queues.size());
+		}
+
+		static auto getWorkerIndex() -> int32_t;
+
+		inline static auto get() -> JobSystem *
+		{
+			return instance;
+		}
+
+	  private:
+		auto allocate() -> Job *;
+		auto tryAllocate() -> Job *;
+		template <typename Func>
+		auto construct(Job *job, Func &&func, JobHandle parent) -> void;
+		auto push(Job *job) -> void;
+		auto getJob() -> Job *;
+		auto getBackgroundJob() -> Job *;
+		auto execute(Job *job) -> void;
+		auto finish(Job *job) -> void;
+		auto workerLoop(uint32_t index) -> void;
+
+		template <typename Func>
+		static auto invoke(Job *job, void *data) -> void
+		{
+			auto &func = *reinterpret_cast<Func *>(data);
+			func();
+			func.~Func();
+		}
+
+		template <typename Func>
+		static auto invokeHeap(Job *job, void *data) -> void
+		{
+			auto func = *reinterpret_cast<Func **>(data);
+			(*func)();
+			delete func;
+		}
+
+		struct JobPool
+		{
+			static constexpr uint32_t SIZE = 4096;
+			std::unique_ptr<Job[]>    jobs = std::make_unique<Job[]>(SIZE);
+			uint32_t                  current = 0;
+		};
+
+		std::vector<std::unique_ptr<WorkStealingQueue>> queues;
+		std::vector<std::unique_ptr<JobPool>>           pools;
+		std::vector<std::thread>                        threads;
+
+		//jobs created or pushed from threads that are not part of the job system.
+		std::mutex       externalMutex;
+		std::deque<Job *> externalQueue;
+		std::atomic<int32_t> externalJobs{0};
+		JobPool          externalPool;
+
+		std::mutex        backgroundMutex;
+		std::deque<Job *> backgroundQueue;
+
+		std::mutex              sleepMutex;
+		std::condition_variable sleepCondition;
+		std::atomic<int32_t>    queuedJobs{0};
+		std::atomic<int32_t>    sleepingWorkers{0};
+		std::atomic<bool>       running{true};
+
+		static JobSystem *instance;
+	};
+
+	template <typename Func>
+	inline auto JobSystem::construct(Job *job, Func &&func, JobHandle parent) -> void
+	{
+		using FuncType = std::decay_t<Func>;
+		job->parent    = parent;
+		if (parent.isValid())
+		{
+			parent.get()->unfinishedJobs.fetch_add(1, std::memory_order_relaxed);
+		}
+
+		if constexpr (sizeof(FuncType) <= Job::DATA_SIZE && alignof(FuncType) <= 16)
+		{
+			new (job->data) FuncType(std::forward<Func>(func));
+			job->function = &JobSystem::invoke<FuncType>;
+		}
+		else
+		{
+			//big captures fall back to the heap.
+			*reinterpret_cast<FuncType **>(job->data) = new FuncType(std::forward<Func>(func));
+			job->function                              = &JobSystem::invokeHeap<FuncType>;
+		}
+	}
+
+	template <typename Func>
+	inline auto JobSystem::create(Func &&func, JobHandle parent) -> JobHandle
+	{
+		Job *job = allocate();
+		construct(job, std::forward<Func>(func), parent);
+		return job;
+	}
+
+	template <typename Func>
+	inline auto JobSystem::tryCreate(Func &&func, JobHandle parent) -> JobHandle
+	{
+		Job *job = tryAllocate();
+		if (job == nullptr)
+			return {};
+		construct(job, std::forward<Func>(func), parent);
+		return job;
+	}
+
+	template <typename Func, typename... Dependencies>
+	inline auto JobSystem::schedule(Func &&func, Dependencies... dependencies) -> JobHandle
+	{
+		auto job = create(std::forward<Func>(func));
+		(addDependency(job, dependencies), ...);
+		run(job);
+		return job;
+	}
+
+	template <typename Func>
+	inline auto JobSystem::scheduleBackground(Func &&func) -> JobHandle
+	{
+		auto job              = create(std::forward<Func>(func));
+		job.get()->background = true;
+		run(job);
+		return job;
+	}
+};        // namespace maple
@@ -4,12 +4,92 @@
 
 #pragma once
 
-#include <thread>
-#include <mutex>
-#include <condition_variable>
-#include <functional>
+#include <algorithm>
+#include <cstdint>
+#include <iterator>
+
+#include "JobSystem.h"
 
 namespace maple
 {
+	//upper bound of jobs one call creates, a small grain over a big range would otherwise exhaust the job pool.
+	constexpr uint32_t MAX_PARALLEL_CHUNKS = 256;
+
+	/**
+	 * split [begin, end) into chunks of grainSize and call func(chunkBegin, chunkEnd) on the job system.
+	 * the calling thread helps executing chunks and returns when all of them are done.
+	 * the grain grows if the range would need more than MAX_PARALLEL_CHUNKS chunks, chunks which find no free
+	 * job slot run inline.
+	 */
+	template <typename Func>
+	inline auto parallelForChunk(uint32_t begin, uint32_t end, uint32_t grainSize, const Func &func) -> void
+	{
+		if (begin >= end)
+			return;
+
+		auto jobSystem   = JobSystem::get();
+		const auto count = end - begin;
+		grainSize        = std::max({grainSize, 1u, (count - 1) / MAX_PARALLEL_CHUNKS + 1});
+
+		if (jobSystem == nullptr || count <= grainSize)
+		{
+			func(begin, end);
+			return;
+		}
+
+		auto group = jobSystem->tryCreate([]() {});
+		if (!group.isValid())
+		{
+			func(begin, end);
+			return;
+		}
+
+		//only the pointer and the range are captured, so chunks never allocate.
+		auto funcPtr = &func;
+		for (uint32_t start = begin; start < end; start += grainSize)
+		{
+			const uint32_t stop = std::min(end, start + grainSize);
+			auto           job  = jobSystem->tryCreate([funcPtr, start, stop]() { (*funcPtr)(start, stop); }, group);
+			if (job.isValid())
+				jobSystem->run(job);
+			else
+				func(start, stop);
+		}
+		jobSystem->run(group);
+		jobSystem->wait(group);
+	}
+
+	//call func(i) for every i in [begin, end).
+	template <typename Func>
+	inline auto parallelFor(uint32_t begin, uint32_t end, uint32_t grainSize, const Func &func) -> void
+	{
+		parallelForChunk(begin, end, grainSize, [&func](uint32_t start, uint32_t stop) {
+			for (auto i = start; i < stop; i++)
+			{
+				func(i);
+			}
+		});
+	}
+
+	//call func(element) for every element of a random access container.
+	template <typename Container, typename Func>
+	inline auto parallelForEach(Container &container, uint32_t grainSize, const Func &func) -> void
+	{
+		auto first = std::begin(container);
+		parallelForChunk(0, static_cast<uint32_t>(std::size(container)), grainSize, [&func, first](uint32_t start, uint32_t stop) {
+			for (auto i = start; i < stop; i++)
+			{
+				func(*(first + i));
+			}
+		});
+	}
 
-};
\ No newline at end of file
+	template <typename Container, typename Func>
+	inline auto parallelForEach(Container &container, const Func &func) -> void
+	{
+		const auto workers = JobSystem::get() != nullptr ? JobSystem::get()->getWorkerCount() : 1;
+		const auto size    = static_cast<uint32_t>(std::size(container));
+		//a few chunks per worker so stealing can balance uneven elements.
+		parallelForEach(container, std::max(1u, size / (workers * 4)), func);
+	}
+};        // namespace maple
@@ -13,73 +13,36 @@ namespace maple
 		std::this_thread::sleep_for(std::chrono::milliseconds(ms));
 	}
 
-	Thread::Thread(const std::string& name)
-		:name(name)
-	{
-		thread = std::make_shared<std::thread>(&Thread::run, this);
-	}
-
-	Thread::~Thread()
+	ThreadPool::ThreadPool(int32_t count)
 	{
-		if (thread->joinable())
-		{
-			wait();
-			mutex.lock();
-			close = true;
-			condition.notify_one();
-			mutex.unlock();
-			thread->join();
-		}
+		jobSystem = std::make_unique<JobSystem>(std::max(count, 1));
 	}
 
-	auto Thread::wait() -> void
-	{
-		std::unique_lock<std::mutex> lock(mutex);
-		condition.wait(lock, [this]() {
-			return jobs.empty();
-			});
-	}
-	auto Thread::getTaskSize() -> int32_t
+	ThreadPool::~ThreadPool()
 	{
-		std::lock_guard<std::mutex> lock(mutex);
-		return jobs.size();
+		waitAll();
+		jobSystem.reset();
 	}
 
-	auto Thread::addTask(const Task& task) -> void
+	auto ThreadPool::waitAll() -> void
 	{
-		std::lock_guard<std::mutex> lock(mutex);
-		jobs.emplace_back(task);
-		condition.notify_one();
+		PROFILE_FUNCTION();
+		//tasks run in the background queue which only the workers drain, the caller sleeps until the last one is done.
+		std::unique_lock<std::mutex> locker(taskMutex);
+		taskCondition.wait(locker, [this]() {
+			return pendingTasks.load(std::memory_order_acquire) <= 0;
+		});
 	}
 
-	auto Thread::addTask(const std::function<void*()> & job, const std::function<void(void*)> & complete) -> void
+	auto ThreadPool::addTask(const std::function<void*()> & job, const std::function<void(void*)> & complete, int32_t threadIndex) -> JobHandle
 	{
-		std::lock_guard<std::mutex> lock(mutex);
-		jobs.emplace_back(job, complete);
-		condition.notify_one();
+		return addTask(Thread::Task(job, complete), threadIndex);
 	}
 
-	auto Thread::run() -> void
+	auto ThreadPool::addTask(const Thread::Task& task, int32_t threadIndex) -> JobHandle
 	{
-		PROFILE_SETTHREADNAME(name.c_str());
-		PROFILE_FUNCTION();
-		while (true)
-		{
-			Task task;
-			{
-				std::unique_lock<std::mutex> lock(mutex);
-				condition.wait(lock, [this] {
-					return !jobs.empty() || close;
-					});
-
-				if (close)
-				{
-					break;
-				}
-
-				task = jobs.front();
-			}
-
+		pendingTasks++;
+		return jobSystem->scheduleBackground([task, this]() {
 			if (task.job)
 			{
 				void* result = task.job();
@@ -89,90 +52,11 @@ namespace maple
 						task.complete(result);
 						return true;
 					});
-					/*if (task.wait)
-					{
-						future.wait();
-					}*/
-				}
-			}
-			{
-				std::lock_guard<std::mutex> lock(mutex);
-				jobs.pop_front();
-				condition.notify_one();
-			}
-		}
-	}
-
-
-	ThreadPool::ThreadPool(int32_t count)
-	{
-		for (int32_t i = 0; i < count; i++)
-		{
-			threads.emplace_back(std::make_shared<Thread>("Thread:"+std::to_string(i)));
-		}
-	}
-
-	auto ThreadPool::waitAll() -> void
-	{
-		for (auto& i : threads)
-		{
-			i->wait();
-		}
-	}
-
-	auto ThreadPool::addTask(const std::function<void*()> & job, const std::function<void(void*)> & complete, int32_t threadIndex) -> void
-	{
-		if (threadIndex >= 0 && threadIndex < threads.size())
-		{
-			threads[threadIndex]->addTask(job, complete);
-		}
-		else
-		{
-			int32_t minLen = INT32_MAX;
-			int32_t minIndex = -1;
-
-			for (int32_t i = 0; i < threads.size(); ++i)
-			{
-				auto len = threads[i]->getTaskSize();
-				if (minLen > len)
-				{
-					minLen = len;
-					minIndex = i;
-					if (minLen == 0)
-					{
-						break;
-					}
-				}
-			}
-			threads[minIndex]->addTask(job, complete);
-		}
-	}
-
-	auto ThreadPool::addTask(const Thread::Task& task, int32_t threadIndex) -> void
-	{
-		if (threadIndex >= 0 && threadIndex < threads.size())
-		{
-			threads[threadIndex]->addTask(task);
-		}
-		else
-		{
-			int32_t minLen = INT32_MAX;
-			int32_t minIndex = -1;
-
-			for (int32_t i = 0; i < threads.size(); ++i)
-			{
-				auto len = threads[i]->getTaskSize();
-				if (minLen > len)
-				{
-					minLen = len;
-					minIndex = i;
-					if (minLen == 0)
-					{
-						break;
-					}
 				}
 			}
-			threads[minIndex]->addTask(task);
-		}
+			std::lock_guard<std::mutex> locker(taskMutex);
+			if (--pendingTasks == 0)
+				taskCondition.notify_all();
+		});
 	}
-};
\ No newline at end of file
+};
@@ -5,13 +5,12 @@
 #pragma once
 
 #include <memory>
-#include <thread>
-#include <mutex>
+#include <atomic>
 #include <condition_variable>
-#include <list>
 #include <functional>
-#include <vector>
+#include <mutex>
 #include "Engine/Core.h"
+#include "JobSystem.h"
 
 namespace maple 
 {
@@ -28,33 +27,28 @@ namespace maple
 		};
 
 		static auto sleep(int64_t ms) -> void;
-		Thread(const std::string & name);
-		~Thread();
-		auto wait() -> void;
-		auto getTaskSize()->int32_t;
-		auto addTask(const Task & task) -> void;
-		auto addTask(const std::function<void*()> & job, const std::function<void(void*)> & complete) -> void;
-	private:
-		auto run() -> void;
-		std::shared_ptr<std::thread> thread;
-		std::list<Task> jobs;
-		std::mutex mutex;
-		std::condition_variable condition;
-		bool close = false;
-		std::string name;
 	};
 
+	/**
+	 * coarse task api on top of the JobSystem.
+	 * tasks are stolen by whichever worker is idle, so a slow task never blocks the others.
+	 */
 	class MAPLE_EXPORT ThreadPool
 	{
 	public:
 		ThreadPool(int32_t threadCount);
+		~ThreadPool();
 		auto waitAll() -> void;
-		auto addTask(const Thread::Task& task, int32_t threadIndex = -1)  -> void;
-		auto addTask(const std::function<void*()> & job, const std::function<void(void*)> & complete = nullptr, int32_t threadIndex = -1) -> void;
-		inline auto& getThreads() { return threads; };
-		inline auto getThreadCount() const { return threads.size(); }
+		//threadIndex is kept for compatibility, tasks are balanced by work stealing.
+		auto addTask(const Thread::Task& task, int32_t threadIndex = -1)  -> JobHandle;
+		auto addTask(const std::function<void*()> & job, const std::function<void(void*)> & complete = nullptr, int32_t threadIndex = -1) -> JobHandle;
+		//threads the pool started, the thread owning the pool is not counted.
+		inline auto getThreadCount() const { return jobSystem->getWorkerCount() - 1; }
+		inline auto& getJobSystem() { return jobSystem; }
 	private:
-		std::vector<std::shared_ptr<Thread>> threads;
+		std::unique_ptr<JobSystem> jobSystem;
+		std::atomic<int32_t> pendingTasks{0};
+		std::mutex taskMutex;
+		std::condition_variable taskCondition;
 	};
 };
-